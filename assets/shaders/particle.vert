@@ -0,0 +1,42 @@
+#version 460
+
+struct Particle {
+    vec4 positionLife;
+    vec4 velocityMaxLife;
+    vec4 color;
+};
+
+layout(std430, set = 0, binding = 0) readonly buffer Particles {
+    Particle particles[];
+};
+
+layout(std430, set = 0, binding = 1) readonly buffer AliveList {
+    uint alive[];
+};
+
+layout(push_constant) uniform RenderConstants {
+    mat4 viewProjection;
+    vec4 cameraRight; // xyz, w particle size
+    vec4 cameraUp;
+    uint renderList;
+    uint capacity;
+} constants;
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec2 fragCorner;
+
+const vec2 corners[6] = vec2[](
+    vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(1.0, 1.0),
+    vec2(-1.0, -1.0), vec2(1.0, 1.0), vec2(-1.0, 1.0));
+
+// One camera-facing quad per instance, expanded from the particle buffer without any vertex input.
+void main() {
+    Particle particle = particles[alive[constants.renderList * constants.capacity + gl_InstanceIndex]];
+    vec2 corner = corners[gl_VertexIndex];
+
+    vec3 offset = (constants.cameraRight.xyz * corner.x + constants.cameraUp.xyz * corner.y) * constants.cameraRight.w;
+    gl_Position = constants.viewProjection * vec4(particle.positionLife.xyz + offset, 1.0);
+
+    fragColor = particle.color;
+    fragCorner = corner;
+}
@@ -1,9 +1,76 @@
 #version 460
 
+struct PointLight {
+    vec4 positionRadius;
+    vec4 colorIntensity;
+};
+
+layout(std140, set = 0, binding = 0) uniform ClusterUniforms {
+    mat4 view;
+    mat4 inverseProjection;
+    uvec4 gridSize;
+    vec4 screen;
+    vec4 sliceParams;
+    vec4 cameraPosition;
+    vec4 ambient;
+} clusters;
+
+layout(std430, set = 0, binding = 1) readonly buffer Lights {
+    PointLight lights[];
+};
+
+layout(std430, set = 0, binding = 2) readonly buffer LightGrid {
+    uvec2 lightGrid[];
+};
+
+layout(std430, set = 0, binding = 3) readonly buffer LightIndices {
+    uint lightIndices[];
+};
+
+// RenderLayer's MaterialSet, rewritten whenever the streamer swaps the texture's resident mips.
+layout(set = 1, binding = 0) uniform sampler2D meshTexture;
+
 layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec3 fragWorldPosition;
+layout(location = 2) in vec2 fragUV;
 
 layout(location = 0) out vec4 outColor;
 
+uint ClusterIndex(vec3 worldPosition) {
+    float depth = -(clusters.view * vec4(worldPosition, 1.0)).z;
+    float slice = log(max(depth, 1e-4)) * clusters.sliceParams.x - clusters.sliceParams.y;
+    uint z = uint(clamp(slice, 0.0, float(clusters.gridSize.z - 1)));
+
+    uvec2 tile = min(uvec2(gl_FragCoord.xy / clusters.sliceParams.zw), clusters.gridSize.xy - 1);
+    return tile.x + tile.y * clusters.gridSize.x + z * clusters.gridSize.x * clusters.gridSize.y;
+}
+
 void main() {
-    outColor = vec4(fragColor, 1.0);
-}
\ No newline at end of file
+    vec3 normal = normalize(cross(dFdx(fragWorldPosition), dFdy(fragWorldPosition)));
+    vec3 toCamera = clusters.cameraPosition.xyz - fragWorldPosition;
+    if (dot(normal, toCamera) < 0.0) {
+        normal = -normal;
+    }
+
+    vec3 lighting = clusters.ambient.rgb;
+
+    // Only the lights assigned to this fragment's cluster.
+    uvec2 range = lightGrid[ClusterIndex(fragWorldPosition)];
+    for (uint i = 0; i < range.y; i++) {
+        PointLight light = lights[lightIndices[range.x + i]];
+
+        vec3 toLight = light.positionRadius.xyz - fragWorldPosition;
+        float distanceSquared = dot(toLight, toLight);
+        float radius = light.positionRadius.w;
+
+        // Windowed inverse square falloff, reaching zero at the light range.
+        float window = clamp(1.0 - pow(distanceSquared / (radius * radius), 2.0), 0.0, 1.0);
+        float attenuation = window * window / (distanceSquared + 1.0);
+
+        float diffuse = max(dot(normal, toLight * inversesqrt(max(distanceSquared, 1e-8))), 0.0);
+        lighting += light.colorIntensity.rgb * light.colorIntensity.w * diffuse * attenuation;
+    }
+
+    vec3 albedo = fragColor * texture(meshTexture, fragUV).rgb;
+    outColor = vec4(albedo * lighting, 1.0);
+}
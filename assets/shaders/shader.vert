@@ -2,10 +2,24 @@
 
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inColor;
+layout(location = 2) in vec2 inUV;
+
+layout(push_constant) uniform PushConstants {
+    mat4 mvp;
+    mat4 model;
+} pushConstants;
 
 layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec3 fragWorldPosition;
+layout(location = 2) out vec2 fragUV;
+
+// The depth pre-pass and the color pass run this shader in separate pipelines, and the color pass tests
+// EQUAL against the pre-pass depth. Both must compute bit-identical positions.
+invariant gl_Position;
 
 void main() {
-    gl_Position = vec4(inPosition, 1.0);
+    gl_Position = pushConstants.mvp * vec4(inPosition, 1.0);
     fragColor = inColor;
-}
\ No newline at end of file
+    fragWorldPosition = (pushConstants.model * vec4(inPosition, 1.0)).xyz;
+    fragUV = inUV;
+}
@@ -0,0 +1,62 @@
+#version 460
+#extension GL_EXT_buffer_reference : require
+
+// Vertices are fetched from a device address instead of the vertex input stage, so one pipeline draws every
+// VertexFormat. The formats match Renderer::VertexFormat.
+const uint FORMAT_POSITION_COLOR_UV = 0;
+const uint FORMAT_POSITION_COLOR_UV_PACKED = 1;
+
+layout(buffer_reference, std430, buffer_reference_align = 4) readonly buffer VertexWords {
+    uint words[];
+};
+
+// Scene::WorldRows, the rows of every instance's affine world matrix.
+layout(buffer_reference, std430, buffer_reference_align = 16) readonly buffer InstanceRows {
+    vec4 rows[];
+};
+
+// Within 128 bytes, the smallest push constant size every device supports.
+layout(push_constant) uniform PushConstants {
+    mat4 viewProjection;
+    InstanceRows instances;
+    VertexWords vertices;
+    uint vertexFormat;
+    // In 32-bit words.
+    uint vertexStride;
+    uint instance;
+} pushConstants;
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec3 fragWorldPosition;
+layout(location = 2) out vec2 fragUV;
+
+// The depth pre-pass and the color pass run this shader in separate pipelines, and the color pass tests
+// EQUAL against the pre-pass depth. Both must compute bit-identical positions.
+invariant gl_Position;
+
+void main() {
+    uint base = uint(gl_VertexIndex) * pushConstants.vertexStride;
+    VertexWords vertices = pushConstants.vertices;
+
+    vec4 position = vec4(uintBitsToFloat(vertices.words[base]), uintBitsToFloat(vertices.words[base + 1]), uintBitsToFloat(vertices.words[base + 2]), 1.0);
+
+    vec3 color;
+    vec2 uv;
+    if (pushConstants.vertexFormat == FORMAT_POSITION_COLOR_UV_PACKED) {
+        color = unpackUnorm4x8(vertices.words[base + 3]).rgb;
+        uv = unpackHalf2x16(vertices.words[base + 4]);
+    } else {
+        color = vec3(uintBitsToFloat(vertices.words[base + 3]), uintBitsToFloat(vertices.words[base + 4]), uintBitsToFloat(vertices.words[base + 5]));
+        uv = vec2(uintBitsToFloat(vertices.words[base + 6]), uintBitsToFloat(vertices.words[base + 7]));
+    }
+
+    InstanceRows instances = pushConstants.instances;
+    uint row = pushConstants.instance * 3;
+
+    vec3 worldPosition = vec3(dot(instances.rows[row], position), dot(instances.rows[row + 1], position), dot(instances.rows[row + 2], position));
+
+    gl_Position = pushConstants.viewProjection * vec4(worldPosition, 1.0);
+    fragColor = color;
+    fragWorldPosition = worldPosition;
+    fragUV = uv;
+}
@@ -0,0 +1,252 @@
+#include "Bench.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <sstream>
+
+namespace
+{
+    std::atomic<uint64_t> s_AllocationCount{0};
+    std::atomic<uint64_t> s_AllocatedBytes{0};
+
+    // Absolute slack of the comparison, below timer and scheduler noise.
+    constexpr double MS_SLACK = 0.05;
+    constexpr double ALLOCATION_SLACK = 1.0;
+
+    void WriteDistribution(std::ostream &stream, const char *name, const Bench::Distribution &distribution, bool last)
+    {
+        stream << "    \"" << name << "\": {"
+               << "\"samples\": " << distribution.samples << ", "
+               << "\"mean\": " << distribution.mean << ", "
+               << "\"p50\": " << distribution.p50 << ", "
+               << "\"p95\": " << distribution.p95 << ", "
+               << "\"p99\": " << distribution.p99 << ", "
+               << "\"max\": " << distribution.max << "}" << (last ? "\n" : ",\n");
+    };
+
+    // Only reads back what WriteResult writes: keys are unique within their object and objects are not nested
+    // deeper than one level.
+    bool FindValue(const std::string &json, const char *section, const char *key, std::string &value)
+    {
+        size_t begin = 0;
+        size_t end = json.size();
+
+        if (section != nullptr)
+        {
+            begin = json.find(std::string("\"") + section + "\"");
+            if (begin == std::string::npos)
+            {
+                return false;
+            };
+
+            end = json.find('}', begin);
+        };
+
+        size_t position = json.find(std::string("\"") + key + "\"", begin);
+        if (position == std::string::npos || position > end)
+        {
+            return false;
+        };
+
+        position = json.find(':', position);
+        if (position == std::string::npos)
+        {
+            return false;
+        };
+
+        size_t valueBegin = json.find_first_not_of(" \t\r\n\"", position + 1);
+        size_t valueEnd = json.find_first_of(",}\"\r\n", valueBegin);
+        if (valueBegin == std::string::npos || valueEnd == std::string::npos)
+        {
+            return false;
+        };
+
+        value = json.substr(valueBegin, valueEnd - valueBegin);
+        return true;
+    };
+
+    double FindNumber(const std::string &json, const char *section, const char *key)
+    {
+        std::string value;
+        return FindValue(json, section, key, value) ? std::strtod(value.c_str(), nullptr) : 0.0;
+    };
+
+    void ReadDistribution(const std::string &json, const char *section, Bench::Distribution &distribution)
+    {
+        distribution.samples = static_cast<uint32_t>(FindNumber(json, section, "samples"));
+        distribution.mean = FindNumber(json, section, "mean");
+        distribution.p50 = FindNumber(json, section, "p50");
+        distribution.p95 = FindNumber(json, section, "p95");
+        distribution.p99 = FindNumber(json, section, "p99");
+        distribution.max = FindNumber(json, section, "max");
+    };
+
+    void CompareMetric(std::vector<Bench::Regression> &regressions, const char *metric, double baseline, double current, double threshold, double slack)
+    {
+        if (current > baseline * (1.0 + threshold) + slack)
+        {
+            regressions.push_back({metric, baseline, current});
+        };
+    };
+
+};
+
+// Counting allocator of the bench executable. The array and nothrow forms forward to these.
+void *operator new(std::size_t size)
+{
+    s_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+    s_AllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+    void *pointer = std::malloc(size == 0 ? 1 : size);
+    if (pointer == nullptr)
+    {
+        throw std::bad_alloc();
+    };
+
+    return pointer;
+};
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+};
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+};
+
+namespace Bench
+{
+    AllocationCounters GetAllocationCounters()
+    {
+        AllocationCounters counters;
+        counters.count = s_AllocationCount.load(std::memory_order_relaxed);
+        counters.bytes = s_AllocatedBytes.load(std::memory_order_relaxed);
+        return counters;
+    };
+
+    Distribution Summarize(std::vector<double> samples)
+    {
+        Distribution distribution;
+        if (samples.empty())
+        {
+            return distribution;
+        };
+
+        std::sort(samples.begin(), samples.end());
+
+        auto percentile = [&samples](double p)
+        {
+            size_t rank = static_cast<size_t>(std::ceil(p * static_cast<double>(samples.size())));
+            return samples[(std::min)((std::max)(rank, size_t(1)), samples.size()) - 1];
+        };
+
+        double sum = 0.0;
+        for (double sample : samples)
+        {
+            sum += sample;
+        };
+
+        distribution.samples = static_cast<uint32_t>(samples.size());
+        distribution.mean = sum / static_cast<double>(samples.size());
+        distribution.p50 = percentile(0.50);
+        distribution.p95 = percentile(0.95);
+        distribution.p99 = percentile(0.99);
+        distribution.max = samples.back();
+
+        return distribution;
+    };
+
+    bool WriteResult(const Result &result, const std::string &path)
+    {
+        std::filesystem::path filePath(path);
+        if (filePath.has_parent_path())
+        {
+            std::error_code error;
+            std::filesystem::create_directories(filePath.parent_path(), error);
+        };
+
+        std::ofstream file(path, std::ios::trunc);
+        if (!file.is_open())
+        {
+            return false;
+        };
+
+        file << "{\n"
+             << "    \"scene\": \"" << result.scene << "\",\n"
+             << "    \"warmupFrames\": " << result.warmupFrames << ",\n"
+             << "    \"measuredFrames\": " << result.measuredFrames << ",\n"
+             << "    \"width\": " << result.width << ",\n"
+             << "    \"height\": " << result.height << ",\n";
+
+        WriteDistribution(file, "cpuFrameMs", result.cpuFrameMs, false);
+        WriteDistribution(file, "gpuFrameMs", result.gpuFrameMs, false);
+        WriteDistribution(file, "submitToPresentMs", result.submitToPresentMs, false);
+
+        file << "    \"allocationsPerFrame\": " << result.allocationsPerFrame << ",\n"
+             << "    \"allocatedBytesPerFrame\": " << result.allocatedBytesPerFrame << "\n"
+             << "}\n";
+
+        return file.good();
+    };
+
+    bool ReadResult(const std::string &path, Result &result)
+    {
+        std::ifstream file(path);
+        if (!file.is_open())
+        {
+            return false;
+        };
+
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        std::string json = buffer.str();
+
+        if (!FindValue(json, nullptr, "scene", result.scene))
+        {
+            return false;
+        };
+
+        result.warmupFrames = static_cast<uint32_t>(FindNumber(json, nullptr, "warmupFrames"));
+        result.measuredFrames = static_cast<uint32_t>(FindNumber(json, nullptr, "measuredFrames"));
+        result.width = static_cast<uint32_t>(FindNumber(json, nullptr, "width"));
+        result.height = static_cast<uint32_t>(FindNumber(json, nullptr, "height"));
+
+        ReadDistribution(json, "cpuFrameMs", result.cpuFrameMs);
+        ReadDistribution(json, "gpuFrameMs", result.gpuFrameMs);
+        ReadDistribution(json, "submitToPresentMs", result.submitToPresentMs);
+
+        result.allocationsPerFrame = FindNumber(json, nullptr, "allocationsPerFrame");
+        result.allocatedBytesPerFrame = FindNumber(json, nullptr, "allocatedBytesPerFrame");
+
+        return true;
+    };
+
+    std::vector<Regression> Compare(const Result &baseline, const Result &current, double threshold)
+    {
+        std::vector<Regression> regressions;
+
+        CompareMetric(regressions, "cpuFrameMs.p50", baseline.cpuFrameMs.p50, current.cpuFrameMs.p50, threshold, MS_SLACK);
+        CompareMetric(regressions, "cpuFrameMs.p95", baseline.cpuFrameMs.p95, current.cpuFrameMs.p95, threshold, MS_SLACK);
+
+        // GPU times exist only where timestamps are supported on both runs.
+        if (baseline.gpuFrameMs.samples > 0 && current.gpuFrameMs.samples > 0)
+        {
+            CompareMetric(regressions, "gpuFrameMs.p50", baseline.gpuFrameMs.p50, current.gpuFrameMs.p50, threshold, MS_SLACK);
+            CompareMetric(regressions, "gpuFrameMs.p95", baseline.gpuFrameMs.p95, current.gpuFrameMs.p95, threshold, MS_SLACK);
+        };
+
+        CompareMetric(regressions, "allocationsPerFrame", baseline.allocationsPerFrame, current.allocationsPerFrame, threshold, ALLOCATION_SLACK);
+
+        return regressions;
+    };
+
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Bench
+{
+    // Heap activity of the process, counted by the replaced global operator new of the bench executable.
+    // Over-aligned allocations bypass it and are not counted.
+    struct AllocationCounters
+    {
+        uint64_t count = 0;
+        uint64_t bytes = 0;
+    };
+
+    AllocationCounters GetAllocationCounters();
+
+    struct Distribution
+    {
+        uint32_t samples = 0;
+        double mean = 0.0;
+        double p50 = 0.0;
+        double p95 = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+    };
+
+    // Nearest-rank percentiles, an empty sample set summarizes to zeros.
+    Distribution Summarize(std::vector<double> samples);
+
+    struct Result
+    {
+        std::string scene;
+        uint32_t warmupFrames = 0;
+        uint32_t measuredFrames = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        Distribution cpuFrameMs;
+        Distribution gpuFrameMs;
+        Distribution submitToPresentMs;
+        double allocationsPerFrame = 0.0;
+        double allocatedBytesPerFrame = 0.0;
+    };
+
+    // Results and baselines share one JSON layout, a results file can be promoted to a baseline as is.
+    bool WriteResult(const Result &result, const std::string &path);
+    bool ReadResult(const std::string &path, Result &result);
+
+    struct Regression
+    {
+        std::string metric;
+        double baseline;
+        double current;
+    };
+
+    // p50 and p95 of the CPU and GPU frame times and the allocations per frame. A metric regresses when it grows
+    // by more than threshold (relative) plus a small absolute slack that keeps near-zero metrics from flapping.
+    std::vector<Regression> Compare(const Result &baseline, const Result &current, double threshold);
+
+};
@@ -0,0 +1,260 @@
+#include "Bench.h"
+#include "Scenes.h"
+
+#include "Application.h"
+#include "RenderLayer.h"
+#include "Profiling/Clock.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    struct Recording
+    {
+        std::vector<double> cpuFrameMs;
+        std::vector<double> gpuFrameMs;
+        std::vector<double> submitToPresentMs;
+        uint64_t allocations = 0;
+        uint64_t allocatedBytes = 0;
+    };
+
+    // Runs the render layer and times every frame past the warm-up. The recording outlives the layer, the
+    // application deletes its layer on shutdown.
+    class BenchLayer : public Layer
+    {
+    public:
+        BenchLayer(const RenderSettings &settings, uint32_t warmupFrames, Recording &recording) : m_RenderLayer(settings), m_WarmupFrames(warmupFrames), m_Recording(recording){};
+
+        virtual void OnInit(const AppInstanceData &appData) override { m_RenderLayer.OnInit(appData); };
+
+        virtual void OnPrepareFrame() override
+        {
+            m_FrameStartNs = Profiling::NowNs();
+            m_FrameAllocations = Bench::GetAllocationCounters();
+            m_RenderLayer.OnPrepareFrame();
+        };
+
+        virtual void OnRenderFrame() override
+        {
+            m_RenderLayer.OnRenderFrame();
+
+            Bench::AllocationCounters allocations = Bench::GetAllocationCounters();
+            uint64_t frameEndNs = Profiling::NowNs();
+
+            if (m_Frame++ < m_WarmupFrames)
+            {
+                return;
+            };
+
+            m_Recording.cpuFrameMs.push_back(static_cast<double>(frameEndNs - m_FrameStartNs) / 1e6);
+            m_Recording.allocations += allocations.count - m_FrameAllocations.count;
+            m_Recording.allocatedBytes += allocations.bytes - m_FrameAllocations.bytes;
+
+            // GPU results are a few frames late and zero until the first one resolves.
+            const Renderer::FrameStats &stats = m_RenderLayer.GetFrameStats();
+            if (stats.gpuFrameMs > 0.0f)
+            {
+                m_Recording.gpuFrameMs.push_back(stats.gpuFrameMs);
+            };
+
+            if (stats.submitToPresentMs > 0.0f)
+            {
+                m_Recording.submitToPresentMs.push_back(stats.submitToPresentMs);
+            };
+        };
+
+        virtual void OnCleanup() override { m_RenderLayer.OnCleanup(); };
+        virtual void OnResize(int width, int height) override { m_RenderLayer.OnResize(width, height); };
+
+    private:
+        RenderLayer m_RenderLayer;
+        uint32_t m_WarmupFrames;
+        uint32_t m_Frame = 0;
+        Recording &m_Recording;
+        uint64_t m_FrameStartNs = 0;
+        Bench::AllocationCounters m_FrameAllocations;
+    };
+
+    void PrintDistribution(const char *name, const Bench::Distribution &distribution)
+    {
+        if (distribution.samples == 0)
+        {
+            std::printf("  %-20s n/a\n", name);
+            return;
+        };
+
+        std::printf("  %-20s mean %8.3f  p50 %8.3f  p95 %8.3f  p99 %8.3f  max %8.3f ms\n", name, distribution.mean, distribution.p50, distribution.p95, distribution.p99, distribution.max);
+    };
+
+    void PrintUsage()
+    {
+        std::printf("Usage: sandbox_bench --scene <name> [--warmup N] [--frames N] [--width N] [--height N] [--windowed]\n"
+                    "                     [--output results.json] [--baseline baseline.json] [--threshold 0.10] [--update-baseline]\n"
+                    "       sandbox_bench --list\n");
+    };
+
+};
+
+// Exit codes: 0 within the baseline (or none to compare against), 1 regressed, 2 usage or I/O error.
+int main(int argc, char *argv[])
+{
+    const char *sceneName = nullptr;
+    const char *outputPath = nullptr;
+    const char *baselinePath = nullptr;
+    uint32_t warmupFrames = 60;
+    uint32_t measuredFrames = 600;
+    uint32_t width = 1280;
+    uint32_t height = 720;
+    double threshold = 0.10;
+    bool windowed = false;
+    bool updateBaseline = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+
+        if (std::strcmp(argv[i], "--list") == 0)
+        {
+            for (const Bench::Scene &scene : Bench::GetScenes())
+            {
+                std::printf("%-16s %s\n", scene.name, scene.description);
+            };
+            return 0;
+        }
+        else if (std::strcmp(argv[i], "--scene") == 0 && hasValue)
+        {
+            sceneName = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--warmup") == 0 && hasValue)
+        {
+            warmupFrames = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--frames") == 0 && hasValue)
+        {
+            measuredFrames = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--width") == 0 && hasValue)
+        {
+            width = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--height") == 0 && hasValue)
+        {
+            height = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--output") == 0 && hasValue)
+        {
+            outputPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--baseline") == 0 && hasValue)
+        {
+            baselinePath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--threshold") == 0 && hasValue)
+        {
+            threshold = std::strtod(argv[++i], nullptr);
+        }
+        else if (std::strcmp(argv[i], "--windowed") == 0)
+        {
+            windowed = true;
+        }
+        else if (std::strcmp(argv[i], "--update-baseline") == 0)
+        {
+            updateBaseline = true;
+        }
+        else
+        {
+            PrintUsage();
+            return 2;
+        };
+    };
+
+    const Bench::Scene *scene = sceneName != nullptr ? Bench::FindScene(sceneName) : nullptr;
+    if (scene == nullptr || measuredFrames == 0)
+    {
+        PrintUsage();
+        return 2;
+    };
+
+    Recording recording;
+    recording.cpuFrameMs.reserve(measuredFrames);
+    recording.gpuFrameMs.reserve(measuredFrames);
+    recording.submitToPresentMs.reserve(measuredFrames);
+
+    {
+        ApplicationConfig config;
+        config.width = width;
+        config.height = height;
+        config.title = "Vulkan Sandbox Bench";
+        config.headless = !windowed;
+        config.frameCount = warmupFrames + measuredFrames;
+        config.layer = new BenchLayer(scene->settings, warmupFrames, recording);
+
+        Application benchApp(config);
+        benchApp.Run();
+    };
+
+    Bench::Result result;
+    result.scene = scene->name;
+    result.warmupFrames = warmupFrames;
+    result.measuredFrames = static_cast<uint32_t>(recording.cpuFrameMs.size());
+    result.width = width;
+    result.height = height;
+    result.cpuFrameMs = Bench::Summarize(recording.cpuFrameMs);
+    result.gpuFrameMs = Bench::Summarize(recording.gpuFrameMs);
+    result.submitToPresentMs = Bench::Summarize(recording.submitToPresentMs);
+
+    double frames = result.measuredFrames > 0 ? static_cast<double>(result.measuredFrames) : 1.0;
+    result.allocationsPerFrame = static_cast<double>(recording.allocations) / frames;
+    result.allocatedBytesPerFrame = static_cast<double>(recording.allocatedBytes) / frames;
+
+    std::printf("%s: %u warm-up + %u measured frames at %ux%u\n", result.scene.c_str(), result.warmupFrames, result.measuredFrames, width, height);
+    PrintDistribution("CPU frame", result.cpuFrameMs);
+    PrintDistribution("GPU frame", result.gpuFrameMs);
+    PrintDistribution("Submit to present", result.submitToPresentMs);
+    std::printf("  %-20s %.2f allocations, %.0f bytes per frame\n", "Heap", result.allocationsPerFrame, result.allocatedBytesPerFrame);
+
+    if (outputPath != nullptr && !Bench::WriteResult(result, outputPath))
+    {
+        std::fprintf(stderr, "Failed to write %s\n", outputPath);
+        return 2;
+    };
+
+    if (baselinePath == nullptr)
+    {
+        return 0;
+    };
+
+    Bench::Result baseline;
+    if (updateBaseline || !Bench::ReadResult(baselinePath, baseline))
+    {
+        if (!Bench::WriteResult(result, baselinePath))
+        {
+            std::fprintf(stderr, "Failed to write baseline %s\n", baselinePath);
+            return 2;
+        };
+
+        std::printf("Baseline recorded: %s\n", baselinePath);
+        return 0;
+    };
+
+    if (baseline.scene != result.scene || baseline.width != result.width || baseline.height != result.height)
+    {
+        std::fprintf(stderr, "Baseline %s was recorded for %s at %ux%u\n", baselinePath, baseline.scene.c_str(), baseline.width, baseline.height);
+        return 2;
+    };
+
+    std::vector<Bench::Regression> regressions = Bench::Compare(baseline, result, threshold);
+    for (const Bench::Regression &regression : regressions)
+    {
+        std::printf("REGRESSION %-22s %.3f -> %.3f (+%.1f%%)\n", regression.metric.c_str(), regression.baseline, regression.current, regression.baseline > 0.0 ? (regression.current / regression.baseline - 1.0) * 100.0 : 100.0);
+    };
+
+    if (regressions.empty())
+    {
+        std::printf("Within %.0f%% of the baseline.\n", threshold * 100.0);
+    };
+
+    return regressions.empty() ? 0 : 1;
+};
@@ -0,0 +1,255 @@
+#include "Microbench.h"
+
+#include "Profiling/Clock.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+    struct Registration
+    {
+        std::string name;
+        Bench::MicrobenchFunction function;
+        int64_t argument;
+    };
+
+    // Function-local, registrations run during static initialization of other translation units.
+    std::vector<Registration> &GetRegistry()
+    {
+        static std::vector<Registration> registry;
+        return registry;
+    };
+
+    std::vector<void (*)()> &GetTeardowns()
+    {
+        static std::vector<void (*)()> teardowns;
+        return teardowns;
+    };
+
+    // Below timer resolution and scheduling noise.
+    constexpr double NS_SLACK = 2.0;
+    constexpr uint64_t MAX_ITERATIONS = 1000000000ull;
+
+};
+
+namespace Bench
+{
+    bool State::KeepRunning()
+    {
+        if (!m_Started)
+        {
+            m_Started = true;
+            ResumeTiming();
+        };
+
+        if (m_Remaining == 0 || m_Error != nullptr)
+        {
+            if (m_Running)
+            {
+                PauseTiming();
+            };
+            return false;
+        };
+
+        m_Remaining--;
+        return true;
+    };
+
+    void State::PauseTiming()
+    {
+        m_ElapsedNs += Profiling::NowNs() - m_StartNs;
+        m_Allocations += GetAllocationCounters().count - m_StartAllocations;
+        m_Running = false;
+    };
+
+    void State::ResumeTiming()
+    {
+        m_StartAllocations = GetAllocationCounters().count;
+        m_StartNs = Profiling::NowNs();
+        m_Running = true;
+    };
+
+    void State::SkipWithError(const char *message)
+    {
+        m_Error = message;
+    };
+
+    bool RegisterMicrobench(const char *name, MicrobenchFunction function, std::vector<int64_t> arguments)
+    {
+        if (arguments.empty())
+        {
+            GetRegistry().push_back({name, function, 0});
+            return true;
+        };
+
+        for (int64_t argument : arguments)
+        {
+            GetRegistry().push_back({std::string(name) + "/" + std::to_string(argument), function, argument});
+        };
+
+        return true;
+    };
+
+    void RegisterTeardown(void (*teardown)())
+    {
+        GetTeardowns().push_back(teardown);
+    };
+
+    std::vector<MicrobenchResult> RunMicrobenchmarks(const std::string &filter, double minTimeSeconds)
+    {
+        std::vector<MicrobenchResult> results;
+        uint64_t minTimeNs = static_cast<uint64_t>(minTimeSeconds * 1e9);
+
+        for (const Registration &registration : GetRegistry())
+        {
+            if (!filter.empty() && registration.name.find(filter) == std::string::npos)
+            {
+                continue;
+            };
+
+            MicrobenchResult result;
+            result.name = registration.name;
+
+            uint64_t iterations = 1;
+            while (true)
+            {
+                State state(iterations, registration.argument);
+                registration.function(state);
+
+                if (state.GetError() != nullptr)
+                {
+                    result.error = state.GetError();
+                    break;
+                };
+
+                uint64_t elapsedNs = (std::max)(state.GetElapsedNs(), uint64_t(1));
+                if (elapsedNs >= minTimeNs || iterations >= MAX_ITERATIONS)
+                {
+                    result.iterations = iterations;
+                    result.nsPerIteration = static_cast<double>(elapsedNs) / static_cast<double>(iterations);
+                    result.itemsPerSecond = state.GetItemsProcessed() > 0 ? static_cast<double>(state.GetItemsProcessed()) * 1e9 / static_cast<double>(elapsedNs) : 0.0;
+                    result.allocationsPerIteration = static_cast<double>(state.GetAllocations()) / static_cast<double>(iterations);
+                    break;
+                };
+
+                // Aim a little past the minimum time, but never grow more than 10x from a run too short to trust.
+                double predicted = static_cast<double>(iterations) * static_cast<double>(minTimeNs) * 1.4 / static_cast<double>(elapsedNs);
+                iterations = (std::min)(static_cast<uint64_t>((std::min)(predicted, static_cast<double>(iterations) * 10.0)) + 1, MAX_ITERATIONS);
+            };
+
+            results.push_back(result);
+        };
+
+        return results;
+    };
+
+    void RunTeardowns()
+    {
+        for (void (*teardown)() : GetTeardowns())
+        {
+            teardown();
+        };
+
+        GetTeardowns().clear();
+    };
+
+    bool WriteMicrobenchResults(const std::vector<MicrobenchResult> &results, const std::string &path)
+    {
+        std::filesystem::path filePath(path);
+        if (filePath.has_parent_path())
+        {
+            std::error_code error;
+            std::filesystem::create_directories(filePath.parent_path(), error);
+        };
+
+        std::ofstream file(path, std::ios::trunc);
+        if (!file.is_open())
+        {
+            return false;
+        };
+
+        file << "{\n    \"microbenchmarks\": [\n";
+
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            const MicrobenchResult &result = results[i];
+            file << "        {\"name\": \"" << result.name << "\", "
+                 << "\"iterations\": " << result.iterations << ", "
+                 << "\"nsPerIteration\": " << result.nsPerIteration << ", "
+                 << "\"itemsPerSecond\": " << result.itemsPerSecond << ", "
+                 << "\"allocationsPerIteration\": " << result.allocationsPerIteration << ", "
+                 << "\"error\": \"" << result.error << "\"}" << (i + 1 < results.size() ? ",\n" : "\n");
+        };
+
+        file << "    ]\n}\n";
+
+        return file.good();
+    };
+
+    bool ReadMicrobenchResults(const std::string &path, std::vector<MicrobenchResult> &results)
+    {
+        std::ifstream file(path);
+        if (!file.is_open())
+        {
+            return false;
+        };
+
+        // One object per line, as WriteMicrobenchResults writes them.
+        auto number = [](const std::string &line, const char *key)
+        {
+            size_t position = line.find(std::string("\"") + key + "\": ");
+            return position == std::string::npos ? 0.0 : std::strtod(line.c_str() + position + std::char_traits<char>::length(key) + 4, nullptr);
+        };
+
+        std::string line;
+        while (std::getline(file, line))
+        {
+            size_t nameBegin = line.find("{\"name\": \"");
+            if (nameBegin == std::string::npos)
+            {
+                continue;
+            };
+
+            nameBegin += 10;
+            size_t nameEnd = line.find('"', nameBegin);
+
+            MicrobenchResult result;
+            result.name = line.substr(nameBegin, nameEnd - nameBegin);
+            result.iterations = static_cast<uint64_t>(number(line, "iterations"));
+            result.nsPerIteration = number(line, "nsPerIteration");
+            result.itemsPerSecond = number(line, "itemsPerSecond");
+            result.allocationsPerIteration = number(line, "allocationsPerIteration");
+            results.push_back(result);
+        };
+
+        return !results.empty();
+    };
+
+    std::vector<Regression> CompareMicrobenchmarks(const std::vector<MicrobenchResult> &baseline, const std::vector<MicrobenchResult> &current, double threshold)
+    {
+        std::vector<Regression> regressions;
+
+        for (const MicrobenchResult &result : current)
+        {
+            auto reference = std::find_if(baseline.begin(), baseline.end(), [&result](const MicrobenchResult &candidate)
+                                          { return candidate.name == result.name; });
+
+            if (reference == baseline.end() || !result.error.empty() || reference->iterations == 0)
+            {
+                continue;
+            };
+
+            if (result.nsPerIteration > reference->nsPerIteration * (1.0 + threshold) + NS_SLACK)
+            {
+                regressions.push_back({result.name, reference->nsPerIteration, result.nsPerIteration});
+            };
+        };
+
+        return regressions;
+    };
+
+};
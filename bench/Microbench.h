@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Bench.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Registers a microbenchmark, optionally once per argument: VKS_MICROBENCH(BM_Sort, 1024, 16384).
+#define VKS_MICROBENCH_CONCAT_INNER(a, b) a##b
+#define VKS_MICROBENCH_CONCAT(a, b) VKS_MICROBENCH_CONCAT_INNER(a, b)
+#define VKS_MICROBENCH(function, ...) static const bool VKS_MICROBENCH_CONCAT(s_Microbench, __LINE__) = Bench::RegisterMicrobench(#function, function, {__VA_ARGS__})
+
+namespace Bench
+{
+    // Iteration state handed to a microbenchmark, in the manner of Google Benchmark:
+    //
+    //     void BM_Thing(Bench::State &state)
+    //     {
+    //         // setup, not timed
+    //         while (state.KeepRunning())
+    //         {
+    //             Bench::DoNotOptimize(Thing());
+    //         };
+    //     };
+    class State
+    {
+    public:
+        State(uint64_t iterations, int64_t argument) : m_Iterations(iterations), m_Remaining(iterations), m_Argument(argument){};
+
+        // Starts the clock on the first call and stops it on the last.
+        bool KeepRunning();
+
+        // Excludes per-iteration setup or teardown from the time and the allocation count.
+        void PauseTiming();
+        void ResumeTiming();
+
+        int64_t Argument() { return m_Argument; };
+        void SetItemsProcessed(uint64_t items) { m_ItemsProcessed = items; };
+        // Marks the run as not measurable (missing device, missing file), the message is reported instead.
+        void SkipWithError(const char *message);
+
+        uint64_t GetIterations() { return m_Iterations; };
+        uint64_t GetElapsedNs() { return m_ElapsedNs; };
+        uint64_t GetAllocations() { return m_Allocations; };
+        uint64_t GetItemsProcessed() { return m_ItemsProcessed; };
+        const char *GetError() { return m_Error; };
+
+    private:
+        uint64_t m_Iterations;
+        uint64_t m_Remaining;
+        int64_t m_Argument;
+        bool m_Started = false;
+        bool m_Running = false;
+        uint64_t m_StartNs = 0;
+        uint64_t m_ElapsedNs = 0;
+        uint64_t m_StartAllocations = 0;
+        uint64_t m_Allocations = 0;
+        uint64_t m_ItemsProcessed = 0;
+        const char *m_Error = nullptr;
+    };
+
+    typedef void (*MicrobenchFunction)(State &state);
+
+    bool RegisterMicrobench(const char *name, MicrobenchFunction function, std::vector<int64_t> arguments);
+    // Runs after every microbenchmark, for shared fixtures such as the headless device.
+    void RegisterTeardown(void (*teardown)());
+
+    // Keeps the compiler from discarding a result that is otherwise unused.
+    template <typename T>
+    inline void DoNotOptimize(const T &value)
+    {
+#if defined(_MSC_VER)
+        static const volatile void *sink;
+        sink = &value;
+        _ReadWriteBarrier();
+#else
+        asm volatile("" : : "r,m"(value) : "memory");
+#endif
+    };
+
+    struct MicrobenchResult
+    {
+        std::string name;
+        uint64_t iterations = 0;
+        double nsPerIteration = 0.0;
+        double itemsPerSecond = 0.0;
+        double allocationsPerIteration = 0.0;
+        std::string error;
+    };
+
+    // Grows the iteration count until a run lasts at least minTimeSeconds. filter is a substring of the name.
+    std::vector<MicrobenchResult> RunMicrobenchmarks(const std::string &filter, double minTimeSeconds);
+    void RunTeardowns();
+
+    bool WriteMicrobenchResults(const std::vector<MicrobenchResult> &results, const std::string &path);
+    bool ReadMicrobenchResults(const std::string &path, std::vector<MicrobenchResult> &results);
+
+    // Time per iteration of every microbenchmark present in both runs, same policy as Compare.
+    std::vector<Regression> CompareMicrobenchmarks(const std::vector<MicrobenchResult> &baseline, const std::vector<MicrobenchResult> &current, double threshold);
+
+};
@@ -0,0 +1,124 @@
+#include "Microbench.h"
+
+#include "Log.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    void PrintUsage()
+    {
+        std::printf("Usage: sandbox_microbench [--filter substring] [--min-time seconds] [--output results.json]\n"
+                    "                          [--baseline baseline.json] [--threshold 0.10] [--update-baseline]\n");
+    };
+
+};
+
+// Exit codes: 0 within the baseline (or none to compare against), 1 regressed, 2 usage or I/O error.
+// VK_DRIVER_FILES (VK_ICD_FILENAMES on older loaders) pointing at a software ICD such as lavapipe runs the
+// device microbenchmarks on machines without a GPU.
+int main(int argc, char *argv[])
+{
+    std::string filter;
+    const char *outputPath = nullptr;
+    const char *baselinePath = nullptr;
+    double minTime = 0.5;
+    double threshold = 0.10;
+    bool updateBaseline = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+
+        if (std::strcmp(argv[i], "--filter") == 0 && hasValue)
+        {
+            filter = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--min-time") == 0 && hasValue)
+        {
+            minTime = std::strtod(argv[++i], nullptr);
+        }
+        else if (std::strcmp(argv[i], "--output") == 0 && hasValue)
+        {
+            outputPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--baseline") == 0 && hasValue)
+        {
+            baselinePath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--threshold") == 0 && hasValue)
+        {
+            threshold = std::strtod(argv[++i], nullptr);
+        }
+        else if (std::strcmp(argv[i], "--update-baseline") == 0)
+        {
+            updateBaseline = true;
+        }
+        else
+        {
+            PrintUsage();
+            return 2;
+        };
+    };
+
+    // Logging from the device setup only, frames logging mid-measurement would skew them.
+    LogConfig logConfig;
+    logConfig.level = spdlog::level::warn;
+    Log::Init(logConfig);
+
+    std::vector<Bench::MicrobenchResult> results = Bench::RunMicrobenchmarks(filter, minTime);
+    Bench::RunTeardowns();
+
+    Log::Shutdown();
+
+    std::printf("%-36s %14s %12s %16s %12s\n", "Microbenchmark", "Time", "Iterations", "Items/s", "Allocs/iter");
+    for (const Bench::MicrobenchResult &result : results)
+    {
+        if (!result.error.empty())
+        {
+            std::printf("%-36s SKIPPED: %s\n", result.name.c_str(), result.error.c_str());
+            continue;
+        };
+
+        std::printf("%-36s %11.1f ns %12llu %16.4g %12.2f\n", result.name.c_str(), result.nsPerIteration, static_cast<unsigned long long>(result.iterations), result.itemsPerSecond, result.allocationsPerIteration);
+    };
+
+    if (outputPath != nullptr && !Bench::WriteMicrobenchResults(results, outputPath))
+    {
+        std::fprintf(stderr, "Failed to write %s\n", outputPath);
+        return 2;
+    };
+
+    if (baselinePath == nullptr)
+    {
+        return 0;
+    };
+
+    std::vector<Bench::MicrobenchResult> baseline;
+    if (updateBaseline || !Bench::ReadMicrobenchResults(baselinePath, baseline))
+    {
+        if (!Bench::WriteMicrobenchResults(results, baselinePath))
+        {
+            std::fprintf(stderr, "Failed to write baseline %s\n", baselinePath);
+            return 2;
+        };
+
+        std::printf("Baseline recorded: %s\n", baselinePath);
+        return 0;
+    };
+
+    std::vector<Bench::Regression> regressions = Bench::CompareMicrobenchmarks(baseline, results, threshold);
+    for (const Bench::Regression &regression : regressions)
+    {
+        std::printf("REGRESSION %-36s %.1f -> %.1f ns (+%.1f%%)\n", regression.metric.c_str(), regression.baseline, regression.current, regression.baseline > 0.0 ? (regression.current / regression.baseline - 1.0) * 100.0 : 100.0);
+    };
+
+    if (regressions.empty())
+    {
+        std::printf("Within %.0f%% of the baseline.\n", threshold * 100.0);
+    };
+
+    return regressions.empty() ? 0 : 1;
+};
@@ -0,0 +1,526 @@
+#include "Microbench.h"
+
+#include "RenderLayer.h"
+#include "Utils.h"
+#include "Vulkan-Core/ShaderModule.h"
+#include "Vulkan-Core/Utils.h"
+#include "Renderer/DrawList.h"
+#include "Renderer/MeshLOD.h"
+#include "Vulkan-Core/HandlePool.h"
+#include "Scene/Registry.h"
+#include "Scene/TransformSystem.h"
+#include "Scene/TransformHierarchy.h"
+
+#include <random>
+
+namespace Bench
+{
+    // RenderLayer's buffer creation and pass recording are private, the microbenchmarks reach them through here.
+    struct RenderLayerAccess
+    {
+        static void CreateBuffer(RenderLayer &renderLayer, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer &buffer, VkDeviceMemory &bufferMemory)
+        {
+            Bench::RenderLayerAccess::CreateBuffer(renderLayer, size, usage, properties, buffer, bufferMemory);
+        };
+
+        static void BeginPass(RenderLayer &renderLayer, VkCommandBuffer commandBuffer, bool depthPrePass) { Bench::RenderLayerAccess::BeginPass(renderLayer, commandBuffer, depthPrePass); };
+        static void EndPass(RenderLayer &renderLayer, VkCommandBuffer commandBuffer, bool depthPrePass) { Bench::RenderLayerAccess::EndPass(renderLayer, commandBuffer, depthPrePass); };
+        static VkDrawIndexedIndirectCommand BindColorPassState(RenderLayer &renderLayer, VkCommandBuffer commandBuffer) { return Bench::RenderLayerAccess::BindColorPassState(renderLayer, commandBuffer); };
+
+        static VkPipeline GetColorPipeline(RenderLayer &renderLayer)
+        {
+            return renderLayer.m_VulkanContext.resources.GetPipeline(renderLayer.m_VulkanContext.graphicsPipeline)->pipeline;
+        };
+
+        static bool HasDepthPrePass(const RenderLayer &renderLayer) { return renderLayer.m_Settings.depthPrePass; };
+    };
+};
+
+namespace
+{
+    const char *SHADER_PATH = "assets/shaders/spv/shader.vert.spv";
+
+    // One headless render layer shared by every microbenchmark that needs a device, created on first use so a
+    // filtered run without them never touches Vulkan.
+    RenderLayer *s_RenderLayer = nullptr;
+
+    void DestroyRenderLayer()
+    {
+        vkDeviceWaitIdle(s_RenderLayer->GetDevice().Get());
+        s_RenderLayer->OnCleanup();
+        delete s_RenderLayer;
+        s_RenderLayer = nullptr;
+    };
+
+    RenderLayer &GetRenderLayer()
+    {
+        if (s_RenderLayer == nullptr)
+        {
+            AppInstanceData appData;
+            appData.width = 1280;
+            appData.height = 720;
+            appData.title = "Vulkan Sandbox Microbench";
+            appData.headless = true;
+
+            s_RenderLayer = new RenderLayer();
+            s_RenderLayer->OnInit(appData);
+
+            Bench::RegisterTeardown(DestroyRenderLayer);
+        };
+
+        return *s_RenderLayer;
+    };
+
+    // Triangulated size x size vertex grid with a gentle height field, enough structure for the simplifier.
+    void CreateGridMesh(uint32_t size, std::vector<glm::vec3> &positions, std::vector<uint32_t> &indices)
+    {
+        for (uint32_t y = 0; y < size; y++)
+        {
+            for (uint32_t x = 0; x < size; x++)
+            {
+                float u = static_cast<float>(x) / static_cast<float>(size - 1);
+                float v = static_cast<float>(y) / static_cast<float>(size - 1);
+                positions.push_back(glm::vec3(u, v, 0.05f * std::sin(u * 12.0f) * std::cos(v * 9.0f)));
+            };
+        };
+
+        for (uint32_t y = 0; y + 1 < size; y++)
+        {
+            for (uint32_t x = 0; x + 1 < size; x++)
+            {
+                uint32_t i = y * size + x;
+                indices.insert(indices.end(), {i, i + 1, i + size, i + 1, i + size + 1, i + size});
+            };
+        };
+    };
+
+    void BM_FindMemoryType(Bench::State &state)
+    {
+        const VkPhysicalDeviceMemoryProperties &memoryProperties = GetRenderLayer().GetDevice().GetMemoryProperties();
+
+        while (state.KeepRunning())
+        {
+            Bench::DoNotOptimize(VulkanCore::Utils::FindMemoryType(memoryProperties, ~0u, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
+        };
+    };
+
+    // Argument: buffer size in bytes. Destruction is not timed.
+    void BM_CreateBuffer(Bench::State &state)
+    {
+        RenderLayer &renderLayer = GetRenderLayer();
+        VkDevice device = renderLayer.GetDevice().Get();
+
+        while (state.KeepRunning())
+        {
+            VkBuffer buffer;
+            VkDeviceMemory bufferMemory;
+            Bench::RenderLayerAccess::CreateBuffer(renderLayer, static_cast<VkDeviceSize>(state.Argument()), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, buffer, bufferMemory);
+
+            state.PauseTiming();
+            vkDestroyBuffer(device, buffer, nullptr);
+            vkFreeMemory(device, bufferMemory, nullptr);
+            state.ResumeTiming();
+        };
+    };
+
+    // Command recording only: the device is idle before each frame so the frame fence never blocks, and the
+    // submit in OnRenderFrame is not timed.
+    void BM_OnPrepareFrame(Bench::State &state)
+    {
+        RenderLayer &renderLayer = GetRenderLayer();
+        VkDevice device = renderLayer.GetDevice().Get();
+
+        while (state.KeepRunning())
+        {
+            state.PauseTiming();
+            vkDeviceWaitIdle(device);
+            state.ResumeTiming();
+
+            renderLayer.OnPrepareFrame();
+
+            state.PauseTiming();
+            renderLayer.OnRenderFrame();
+            state.ResumeTiming();
+        };
+    };
+
+    // Records argument draws of the mesh into the color pass of a fresh command buffer, a pipeline bind and an
+    // indexed draw each, through either the exported loader functions or the device's dispatch table. The passes
+    // and the state they share are recorded the same way for both. The buffer is never submitted and the pool reset
+    // is not timed.
+    template <bool UseDispatchTable>
+    void RecordDraws(Bench::State &state)
+    {
+        RenderLayer &renderLayer = GetRenderLayer();
+        VulkanCore::Device &device = renderLayer.GetDevice();
+        const VulkanCore::DeviceDispatch &dispatch = device.GetDispatch();
+
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.queueFamilyIndex = device.GetQueueFamilies().graphicsFamily.value();
+
+        VkCommandPool commandPool;
+        VkResult result = vkCreateCommandPool(device.Get(), &poolInfo, nullptr, &commandPool);
+        if (result != VK_SUCCESS)
+        {
+            state.SkipWithError("failed to create a command pool");
+            return;
+        };
+
+        VkCommandBufferAllocateInfo allocateInfo{};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocateInfo.commandPool = commandPool;
+        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocateInfo.commandBufferCount = 1;
+
+        VkCommandBuffer commandBuffer;
+        vkAllocateCommandBuffers(device.Get(), &allocateInfo, &commandBuffer);
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        VkPipeline pipeline = Bench::RenderLayerAccess::GetColorPipeline(renderLayer);
+        uint32_t drawCount = static_cast<uint32_t>(state.Argument());
+        uint64_t items = 0;
+
+        while (state.KeepRunning())
+        {
+            state.PauseTiming();
+            vkResetCommandPool(device.Get(), commandPool, 0);
+            state.ResumeTiming();
+
+            dispatch.vkBeginCommandBuffer(commandBuffer, &beginInfo);
+            if (Bench::RenderLayerAccess::HasDepthPrePass(renderLayer))
+            {
+                Bench::RenderLayerAccess::BeginPass(renderLayer, commandBuffer, true);
+                Bench::RenderLayerAccess::EndPass(renderLayer, commandBuffer, true);
+            };
+            Bench::RenderLayerAccess::BeginPass(renderLayer, commandBuffer, false);
+            VkDrawIndexedIndirectCommand draw = Bench::RenderLayerAccess::BindColorPassState(renderLayer, commandBuffer);
+
+            if (UseDispatchTable)
+            {
+                for (uint32_t i = 0; i < drawCount; i++)
+                {
+                    dispatch.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+                    dispatch.vkCmdDrawIndexed(commandBuffer, draw.indexCount, draw.instanceCount, draw.firstIndex, draw.vertexOffset, draw.firstInstance);
+                };
+            }
+            else
+            {
+                for (uint32_t i = 0; i < drawCount; i++)
+                {
+                    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+                    vkCmdDrawIndexed(commandBuffer, draw.indexCount, draw.instanceCount, draw.firstIndex, draw.vertexOffset, draw.firstInstance);
+                };
+            };
+
+            Bench::RenderLayerAccess::EndPass(renderLayer, commandBuffer, false);
+            dispatch.vkEndCommandBuffer(commandBuffer);
+
+            items += drawCount * 2;
+        };
+
+        vkDestroyCommandPool(device.Get(), commandPool, nullptr);
+        state.SetItemsProcessed(items);
+    };
+
+    // Argument: draws per command buffer. Both variants hit the validation layer when it is enabled, the
+    // difference between them is the loader trampoline.
+    void BM_RecordThroughLoader(Bench::State &state)
+    {
+        RecordDraws<false>(state);
+    };
+
+    void BM_RecordThroughDispatchTable(Bench::State &state)
+    {
+        RecordDraws<true>(state);
+    };
+
+    void BM_ReadFile(Bench::State &state)
+    {
+        if (!std::ifstream(SHADER_PATH).is_open())
+        {
+            state.SkipWithError("shader binaries missing, run from the project root after building the shaders");
+            return;
+        };
+
+        uint64_t bytes = 0;
+        while (state.KeepRunning())
+        {
+            std::vector<char> code = ReadFile(SHADER_PATH);
+            bytes += code.size();
+            Bench::DoNotOptimize(code.data());
+        };
+
+        state.SetItemsProcessed(bytes);
+    };
+
+    // Reading the file is part of ShaderModule::Create and is timed with it. Destruction is not timed.
+    void BM_ShaderModuleCreate(Bench::State &state)
+    {
+        if (!std::ifstream(SHADER_PATH).is_open())
+        {
+            state.SkipWithError("shader binaries missing, run from the project root after building the shaders");
+            return;
+        };
+
+        VulkanCore::Device &device = GetRenderLayer().GetDevice();
+
+        while (state.KeepRunning())
+        {
+            VulkanCore::ShaderModule shaderModule;
+            shaderModule.Create(device, SHADER_PATH);
+
+            state.PauseTiming();
+            shaderModule.Destroy();
+            state.ResumeTiming();
+        };
+    };
+
+    // Argument: draw count. Every iteration sorts a freshly shuffled list.
+    void BM_DrawListSortFrontToBack(Bench::State &state)
+    {
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<float> depth(0.1f, 100.0f);
+
+        std::vector<Renderer::DrawCommand> commands(static_cast<size_t>(state.Argument()));
+        for (Renderer::DrawCommand &command : commands)
+        {
+            command.viewDepth = depth(generator);
+        };
+
+        Renderer::DrawList drawList;
+        uint64_t items = 0;
+
+        while (state.KeepRunning())
+        {
+            state.PauseTiming();
+            std::shuffle(commands.begin(), commands.end(), generator);
+            drawList.Clear();
+            for (const Renderer::DrawCommand &command : commands)
+            {
+                drawList.Add(command);
+            };
+            state.ResumeTiming();
+
+            drawList.SortFrontToBack();
+            items += commands.size();
+        };
+
+        state.SetItemsProcessed(items);
+    };
+
+    // Argument: live entries. Half the pool was removed and refilled first so slots and dense order differ, then
+    // every iteration resolves each handle once in a shuffled order.
+    void BM_HandlePoolGet(Bench::State &state)
+    {
+        struct Tag
+        {
+        };
+
+        size_t count = static_cast<size_t>(state.Argument());
+        VulkanCore::HandlePool<Tag, VulkanCore::BufferResource> pool;
+        std::vector<VulkanCore::Handle<Tag>> handles;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            handles.push_back(pool.Add(VulkanCore::BufferResource{}));
+        };
+
+        std::mt19937 generator(42);
+        std::shuffle(handles.begin(), handles.end(), generator);
+        for (size_t i = 0; i < count / 2; i++)
+        {
+            pool.Remove(handles[i]);
+            handles[i] = pool.Add(VulkanCore::BufferResource{});
+        };
+        std::shuffle(handles.begin(), handles.end(), generator);
+
+        uint64_t items = 0;
+        while (state.KeepRunning())
+        {
+            VkDeviceSize size = 0;
+            for (VulkanCore::Handle<Tag> handle : handles)
+            {
+                size += pool.Get(handle)->size;
+            };
+
+            Bench::DoNotOptimize(size);
+            items += handles.size();
+        };
+
+        state.SetItemsProcessed(items);
+    };
+
+    // Argument: grid size of the source mesh.
+    void BM_BuildLODChain(Bench::State &state)
+    {
+        std::vector<glm::vec3> positions;
+        std::vector<uint32_t> indices;
+        CreateGridMesh(static_cast<uint32_t>(state.Argument()), positions, indices);
+
+        uint64_t items = 0;
+        while (state.KeepRunning())
+        {
+            Renderer::LODChain chain = Renderer::BuildLODChain(&positions[0].x, positions.size(), sizeof(glm::vec3), indices, Renderer::LODChainConfig{});
+            Bench::DoNotOptimize(chain.levels.size());
+            items += indices.size() / 3;
+        };
+
+        state.SetItemsProcessed(items);
+    };
+
+    // 1024 objects spread in depth, each keeping its level across frames as the renderer does.
+    void BM_SelectLOD(Bench::State &state)
+    {
+        std::vector<glm::vec3> positions;
+        std::vector<uint32_t> indices;
+        CreateGridMesh(64, positions, indices);
+        Renderer::LODChain chain = Renderer::BuildLODChain(&positions[0].x, positions.size(), sizeof(glm::vec3), indices, Renderer::LODChainConfig{});
+
+        Renderer::Camera camera;
+        camera.SetPerspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+        camera.viewportHeight = 720.0f;
+        camera.LookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+        std::vector<glm::vec3> centers(1024);
+        std::vector<uint32_t> levels(centers.size(), 0);
+        for (size_t i = 0; i < centers.size(); i++)
+        {
+            centers[i] = glm::vec3(0.0f, 0.0f, -1.0f - static_cast<float>(i) * 0.25f);
+        };
+
+        Renderer::LODSelectionConfig selectionConfig;
+        uint64_t items = 0;
+
+        while (state.KeepRunning())
+        {
+            for (size_t i = 0; i < centers.size(); i++)
+            {
+                levels[i] = Renderer::SelectLOD(chain, centers[i], 1.0f, camera, levels[i], selectionConfig);
+            };
+
+            Bench::DoNotOptimize(levels.data());
+            items += centers.size();
+        };
+
+        state.SetItemsProcessed(items);
+    };
+
+    struct Velocity
+    {
+        glm::vec3 linear;
+    };
+
+    // Argument: entities. Every iteration is one frame of a fully dynamic scene: each entity moves, then its
+    // world matrix and bounds are rebuilt. Without workers the pool runs every chunk on the calling thread.
+    void RunSceneUpdate(Bench::State &state, Scene::WorkerPool &pool)
+    {
+        Scene::Registry registry;
+        Scene::MeshInstance mesh;
+        mesh.localBounds = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+
+        uint32_t count = static_cast<uint32_t>(state.Argument());
+        for (uint32_t i = 0; i < count; i++)
+        {
+            Scene::Transform transform;
+            transform.position = glm::vec3(static_cast<float>(i % 1024), static_cast<float>(i / 1024), 0.0f);
+
+            registry.Create(transform, Scene::LocalToWorld{}, mesh, Scene::WorldBounds{}, Velocity{glm::vec3(0.0f, 0.0f, 0.01f)});
+        };
+
+        auto move = [](const Scene::Entity *, uint32_t chunkCount, Scene::Transform *transforms, const Velocity *velocities)
+        {
+            for (uint32_t i = 0; i < chunkCount; i++)
+            {
+                transforms[i].position += velocities[i].linear;
+            };
+        };
+
+        uint64_t version = 0;
+        uint64_t items = 0;
+        while (state.KeepRunning())
+        {
+            registry.ParallelForEachChunk<Scene::Transform, const Velocity>(pool, move);
+            version = Scene::UpdateWorldTransforms(registry, pool, version);
+            items += count;
+        };
+
+        Bench::DoNotOptimize(version);
+        state.SetItemsProcessed(items);
+    };
+
+    void BM_SceneUpdate(Bench::State &state)
+    {
+        Scene::WorkerPool pool;
+        RunSceneUpdate(state, pool);
+    };
+
+    void BM_SceneUpdateParallel(Bench::State &state)
+    {
+        Scene::WorkerPool pool;
+        pool.Create();
+        RunSceneUpdate(state, pool);
+        pool.Destroy();
+    };
+
+    // Argument: nodes, in random trees of 64 roots. Every iteration moves every root, so all world matrices are
+    // recomputed and written to an instance array as the renderer does.
+    void BM_PropagateTransforms(Bench::State &state)
+    {
+        Scene::TransformHierarchy hierarchy;
+        std::vector<Scene::HierarchyNode> nodes;
+        std::mt19937 generator(42);
+
+        uint32_t count = static_cast<uint32_t>(state.Argument());
+        for (uint32_t i = 0; i < count; i++)
+        {
+            Scene::Transform local;
+            local.position = glm::vec3(1.0f, 0.0f, 0.0f);
+            local.rotation = glm::angleAxis(0.1f, glm::vec3(0.0f, 1.0f, 0.0f));
+
+            Scene::HierarchyNode parent = i < 64 ? Scene::HierarchyNode{} : nodes[generator() % i];
+            nodes.push_back(hierarchy.Add(local, parent));
+        };
+
+        std::vector<Scene::WorldRows> instances(hierarchy.GetInstanceCapacity());
+        uint64_t version = 0;
+        uint64_t items = 0;
+        float offset = 0.0f;
+
+        while (state.KeepRunning())
+        {
+            offset += 0.01f;
+            for (uint32_t i = 0; i < 64; i++)
+            {
+                Scene::Transform local;
+                local.position = glm::vec3(offset, 0.0f, 0.0f);
+                hierarchy.SetLocal(nodes[i], local);
+            };
+
+            items += hierarchy.Propagate();
+            version = hierarchy.WriteInstances(instances.data(), version);
+        };
+
+        Bench::DoNotOptimize(instances.data());
+        state.SetItemsProcessed(items);
+    };
+
+};
+
+VKS_MICROBENCH(BM_FindMemoryType);
+VKS_MICROBENCH(BM_CreateBuffer, 256, 65536, 4194304);
+VKS_MICROBENCH(BM_OnPrepareFrame);
+VKS_MICROBENCH(BM_RecordThroughLoader, 1024);
+VKS_MICROBENCH(BM_RecordThroughDispatchTable, 1024);
+VKS_MICROBENCH(BM_ReadFile);
+VKS_MICROBENCH(BM_ShaderModuleCreate);
+VKS_MICROBENCH(BM_DrawListSortFrontToBack, 1024, 16384);
+VKS_MICROBENCH(BM_BuildLODChain, 32, 128);
+VKS_MICROBENCH(BM_HandlePoolGet, 4096, 262144);
+VKS_MICROBENCH(BM_SelectLOD);
+VKS_MICROBENCH(BM_SceneUpdate, 1000000);
+VKS_MICROBENCH(BM_SceneUpdateParallel, 1000000);
+VKS_MICROBENCH(BM_PropagateTransforms, 16384, 262144);
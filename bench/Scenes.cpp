@@ -0,0 +1,87 @@
+#include "Scenes.h"
+
+namespace
+{
+    // GPU time and submit-to-present latency come from the GPU profiler, every scene runs with it.
+    RenderSettings ProfiledSettings()
+    {
+        RenderSettings settings;
+        settings.gpuProfiling = true;
+        return settings;
+    };
+
+    std::vector<Bench::Scene> CreateScenes()
+    {
+        std::vector<Bench::Scene> scenes;
+
+        {
+            RenderSettings settings = ProfiledSettings();
+            scenes.push_back({"triangle", "Default scene, the fixed cost of a frame", settings});
+        };
+
+        {
+            RenderSettings settings = ProfiledSettings();
+            settings.depthPrePass = true;
+            settings.sortFrontToBack = true;
+            scenes.push_back({"depth_prepass", "Depth pre-pass with front-to-back opaque draws", settings});
+        };
+
+        {
+            RenderSettings settings = ProfiledSettings();
+            settings.lightCount = 256;
+            scenes.push_back({"lights", "Clustered forward shading of 256 orbiting point lights", settings});
+        };
+
+        {
+            RenderSettings settings = ProfiledSettings();
+            settings.maxParticles = 262144;
+            settings.particleBenchmark = true;
+            scenes.push_back({"particles", "Saturated GPU particle pool of 262144 particles", settings});
+        };
+
+        {
+            RenderSettings settings = ProfiledSettings();
+            settings.transientDepth = false;
+            settings.occlusionCulling = true;
+            scenes.push_back({"occlusion", "GPU frustum and Hi-Z occlusion culling", settings});
+        };
+
+        {
+            RenderSettings settings = ProfiledSettings();
+            settings.vertexPulling = true;
+            scenes.push_back({"vertex_pulling", "Vertices fetched through buffer device addresses, no vertex input", settings});
+        };
+
+        {
+            RenderSettings settings = ProfiledSettings();
+            settings.sphereRings = 64;
+            scenes.push_back({"mesh_lod", "Tessellated sphere drawn at the LOD level its projected error allows", settings});
+        };
+
+        return scenes;
+    };
+
+};
+
+namespace Bench
+{
+    const std::vector<Scene> &GetScenes()
+    {
+        static const std::vector<Scene> scenes = CreateScenes();
+        return scenes;
+    };
+
+    const Scene *FindScene(const std::string &name)
+    {
+        for (const Scene &scene : GetScenes())
+        {
+            if (name == scene.name)
+            {
+                return &scene;
+            };
+        };
+
+        return nullptr;
+    };
+
+};
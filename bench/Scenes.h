@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "RenderLayer.h"
+
+namespace Bench
+{
+    // A scripted scene: fixed render settings, run headless at a fixed size so runs are comparable.
+    struct Scene
+    {
+        const char *name;
+        const char *description;
+        RenderSettings settings;
+    };
+
+    const std::vector<Scene> &GetScenes();
+    const Scene *FindScene(const std::string &name);
+
+};
@@ -1,31 +1,44 @@
 #include "Application.h"
 #include "Log.h"
+#include "Profiling/Profiler.h"
+
+#include <chrono>
 
 Application::Application(const ApplicationConfig &config)
 {
+    Log::Init(config.log);
+
     CORE_LOG_INFO("Application Initialized.");
 
     m_Layer = config.layer;
 
     CORE_ASSERT(m_Layer != nullptr, "Render layer not passed!");
 
-    glfwInit();
-    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+    m_Headless = config.headless;
+    m_FrameCount = config.frameCount;
 
-    m_Window = glfwCreateWindow(config.width, config.height, config.title, nullptr, nullptr);
+    // Headless runs never touch the window system, display-less machines have none.
+    if (!m_Headless)
+    {
+        glfwInit();
+        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
 
-    CORE_ASSERT(m_Window != nullptr, "Failed to create window!");
+        m_Window = glfwCreateWindow(config.width, config.height, config.title, nullptr, nullptr);
 
-    glfwSetWindowUserPointer(m_Window, m_Layer);
-    glfwSetFramebufferSizeCallback(m_Window, [](GLFWwindow *window, int width, int height)
-                                   { 
-        auto layer = reinterpret_cast<Layer *>(glfwGetWindowUserPointer(window));
-        layer->OnResize(width, height); });
+        CORE_ASSERT(m_Window != nullptr, "Failed to create window!");
+
+        glfwSetWindowUserPointer(m_Window, m_Layer);
+        glfwSetFramebufferSizeCallback(m_Window, [](GLFWwindow *window, int width, int height)
+                                       { 
+            auto layer = reinterpret_cast<Layer *>(glfwGetWindowUserPointer(window));
+            layer->OnResize(width, height); });
+    };
 
     m_AppData.width = config.width;
     m_AppData.height = config.height;
     m_AppData.title = config.title;
     m_AppData.window = m_Window;
+    m_AppData.headless = m_Headless;
 
     m_Layer->OnInit(m_AppData);
 };
@@ -33,20 +46,41 @@ Application::Application(const ApplicationConfig &config)
 Application::~Application()
 {
     delete m_Layer;
-    glfwDestroyWindow(m_Window);
-    glfwTerminate();
+    if (!m_Headless)
+    {
+        glfwDestroyWindow(m_Window);
+        glfwTerminate();
+    };
 
     CORE_LOG_INFO("Application Shutdown.");
+
+    Log::Shutdown();
 };
 
 void Application::Run()
 {
-    while (!glfwWindowShouldClose(m_Window))
+    VKS_PROFILE_THREAD("Main Thread");
+
+    auto startTime = std::chrono::steady_clock::now();
+    uint32_t frame = 0;
+
+    while ((m_Headless || !glfwWindowShouldClose(m_Window)) && (m_FrameCount == 0 || frame < m_FrameCount))
     {
+        VKS_PROFILE_FRAME();
+
         m_Layer->OnPrepareFrame();
         m_Layer->OnRenderFrame();
-        glfwPollEvents();
+        frame++;
+
+        if (!m_Headless)
+        {
+            VKS_PROFILE_ZONE("Poll Events");
+            glfwPollEvents();
+        };
     };
 
+    float seconds = std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count();
+    CORE_LOG_INFO("{0} frames in {1:.3f} s, {2:.1f} fps", frame, seconds, seconds > 0.0f ? frame / seconds : 0.0f);
+
     m_Layer->OnCleanup();
 };
\ No newline at end of file
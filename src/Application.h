@@ -2,17 +2,23 @@
 
 #include <GLFW/glfw3.h>
 
+#include "Log.h"
+
 struct AppInstanceData
 {
     uint32_t width;
     uint32_t height;
     const char * title;
     void *window = nullptr;
+    // No window: the layer renders offscreen at width x height and never presents.
+    bool headless = false;
 };
 
 class Layer
 {
 public:
+    virtual ~Layer() = default;
+
     virtual void OnInit(const AppInstanceData &appInstanceData) = 0;
     virtual void OnPrepareFrame() = 0;
     virtual void OnRenderFrame() = 0;
@@ -26,6 +32,10 @@ struct ApplicationConfig
     uint32_t height;
     const char *title;
     Layer *layer = nullptr;
+    LogConfig log;
+    bool headless = false;
+    // Frames rendered before Run returns, 0 runs until the window is closed.
+    uint32_t frameCount = 0;
 };
 
 class Application
@@ -41,5 +51,7 @@ private:
     Layer *m_Layer = nullptr;
     GLFWwindow *m_Window = nullptr;
     AppInstanceData m_AppData;
+    bool m_Headless = false;
+    uint32_t m_FrameCount = 0;
 };
 
@@ -0,0 +1,92 @@
+#include "Debug.h"
+
+#include <chrono>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace
+{
+    const uint32_t LOGGED_REPEATS = 3;
+    const std::chrono::seconds REPEAT_INTERVAL(1);
+
+    struct MessageHistory
+    {
+        uint64_t count = 0;
+        uint64_t suppressed = 0;
+        std::chrono::steady_clock::time_point lastLogged;
+    };
+
+    // Layers may call back from any thread that issues Vulkan commands.
+    std::mutex s_HistoryMutex;
+    std::unordered_map<size_t, MessageHistory> s_History;
+
+    // Returns false when the message should be dropped, otherwise how many repeats were dropped before it.
+    bool ShouldLog(size_t messageId, uint64_t &suppressed)
+    {
+        std::lock_guard<std::mutex> lock(s_HistoryMutex);
+
+        MessageHistory &history = s_History[messageId];
+        auto now = std::chrono::steady_clock::now();
+
+        history.count++;
+        if (history.count > LOGGED_REPEATS && now - history.lastLogged < REPEAT_INTERVAL)
+        {
+            history.suppressed++;
+            return false;
+        };
+
+        suppressed = history.suppressed;
+        history.suppressed = 0;
+        history.lastLogged = now;
+
+        return true;
+    };
+};
+
+VKAPI_ATTR VkBool32 VKAPI_CALL DebugCallback(VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity, VkDebugUtilsMessageTypeFlagsEXT messageType, const VkDebugUtilsMessengerCallbackDataEXT *pCallbackData, void *pUserData)
+{
+    // Verbose messages are trace level, compiled out of release builds before anything is formatted.
+#if SPDLOG_ACTIVE_LEVEL > SPDLOG_LEVEL_TRACE
+    if (messageSeverity == VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT)
+    {
+        return VK_FALSE;
+    };
+#endif
+
+    // Loader and driver messages carry no ID number, their text identifies them instead.
+    size_t messageId = static_cast<size_t>(static_cast<uint32_t>(pCallbackData->messageIdNumber));
+    if (pCallbackData->messageIdNumber == 0)
+    {
+        messageId = std::hash<std::string_view>{}(pCallbackData->pMessageIdName != nullptr ? pCallbackData->pMessageIdName : pCallbackData->pMessage);
+    };
+
+    uint64_t suppressed = 0;
+    if (!ShouldLog(messageId, suppressed))
+    {
+        return VK_FALSE;
+    };
+
+    std::string repeats = suppressed > 0 ? fmt::format(" ({0} repeats suppressed)", suppressed) : std::string();
+
+    switch (messageSeverity)
+    {
+    case VkDebugUtilsMessageSeverityFlagBitsEXT::VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT:
+        CORE_LOG_TRACE("Validation Layer: {0}{1}", pCallbackData->pMessage, repeats);
+        break;
+
+    case VkDebugUtilsMessageSeverityFlagBitsEXT::VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT:
+        CORE_LOG_WARN("Validation Layer: {0}{1}", pCallbackData->pMessage, repeats);
+        break;
+
+    case VkDebugUtilsMessageSeverityFlagBitsEXT::VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT:
+        CORE_LOG_ERROR("Validation Layer: {0}{1}", pCallbackData->pMessage, repeats);
+        break;
+
+    default:
+        CORE_LOG_INFO("Validation Layer: {0}{1}", pCallbackData->pMessage, repeats);
+        break;
+    };
+
+    return VK_FALSE;
+};
@@ -0,0 +1,50 @@
+#include "Log.h"
+
+#include <spdlog/async.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+namespace Log
+{
+    void Init(const LogConfig &config)
+    {
+        spdlog::init_thread_pool(config.queueSize, 1);
+
+        auto sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+        auto overflowPolicy = config.blockWhenFull ? spdlog::async_overflow_policy::block : spdlog::async_overflow_policy::overrun_oldest;
+        auto logger = std::make_shared<spdlog::async_logger>("core", sink, spdlog::thread_pool(), overflowPolicy);
+
+        logger->set_level(config.level);
+        // Errors are rare and usually precede a crash, get them out without waiting for the next flush.
+        logger->flush_on(spdlog::level::err);
+
+        spdlog::set_default_logger(logger);
+    };
+
+    void Shutdown()
+    {
+        std::shared_ptr<spdlog::logger> asyncLogger = spdlog::default_logger();
+        if (std::dynamic_pointer_cast<spdlog::async_logger>(asyncLogger) == nullptr)
+        {
+            return;
+        };
+
+        // Later messages go straight to the same sinks.
+        auto logger = std::make_shared<spdlog::logger>("core", asyncLogger->sinks().begin(), asyncLogger->sinks().end());
+        logger->set_level(asyncLogger->level());
+        spdlog::set_default_logger(logger);
+
+        // Releasing the last reference to the pool joins the logging thread once it has written the queue.
+        std::shared_ptr<spdlog::details::thread_pool> threadPool = spdlog::thread_pool();
+        size_t overruns = threadPool->overrun_counter();
+
+        spdlog::details::registry::instance().set_tp(nullptr);
+        threadPool.reset();
+        asyncLogger.reset();
+
+        if (overruns > 0)
+        {
+            CORE_LOG_WARN("Log queue overflowed, {0} messages dropped.", overruns);
+        };
+    };
+
+};
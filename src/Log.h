@@ -1,5 +1,6 @@
 #pragma once
 
+// Levels below SPDLOG_ACTIVE_LEVEL (set per configuration by CMake) compile out of the CORE_LOG_* macros.
 #include <spdlog/spdlog.h>
 
 #if _MSC_VER
@@ -9,20 +10,41 @@
 #endif
 
 // Logging macros
-#define CORE_LOG_INFO(...) spdlog::info(__VA_ARGS__)
-#define CORE_LOG_ERROR(...) spdlog::error(__VA_ARGS__)
-#define CORE_LOG_TRACE(...) spdlog::trace(__VA_ARGS__)
-// #define CORE_LOG_DEBUG(...) spdlog::debug(__VA_ARGS__)
+#define CORE_LOG_INFO(...) SPDLOG_INFO(__VA_ARGS__)
+#define CORE_LOG_WARN(...) SPDLOG_WARN(__VA_ARGS__)
+#define CORE_LOG_ERROR(...) SPDLOG_ERROR(__VA_ARGS__)
+#define CORE_LOG_DEBUG(...) SPDLOG_DEBUG(__VA_ARGS__)
+#define CORE_LOG_TRACE(...) SPDLOG_TRACE(__VA_ARGS__)
 
+// The logger is asynchronous, shutting it down drains the queue so the message is out before the trap.
 #ifdef VKS_DEBUG
 #define CORE_ASSERT(check, ...)                                   \
     {                                                             \
         if (!(check))                                             \
         {                                                         \
             CORE_LOG_ERROR("Assertion Failed: {0}", __VA_ARGS__); \
+            Log::Shutdown();                                      \
             debugBreak();                                         \
         }                                                         \
     }
 #else
 #define CORE_ASSERT(check, ...)
 #endif
+
+struct LogConfig
+{
+    // Messages queued for the logging thread, a full queue applies the overflow policy.
+    size_t queueSize = 8192;
+    // Drop the oldest queued message instead of blocking the caller until the logging thread catches up.
+    bool blockWhenFull = false;
+    // Runtime level on top of the compile-time one.
+    spdlog::level::level_enum level = spdlog::level::trace;
+};
+
+namespace Log
+{
+    // Replaces the default synchronous logger with an asynchronous one, before anything logs.
+    void Init(const LogConfig &config);
+    // Flushes every queued message and stops the logging thread, safe to call more than once.
+    void Shutdown();
+};
@@ -1,17 +1,60 @@
 #include "RenderLayer.h"
 #include "Application.h"
 
+#include <cstdlib>
+#include <cstring>
 
+// --headless renders offscreen without a window, --frames N exits after N frames, --width/--height size the
+// window or the offscreen target, --capture <dir> writes every frame (--capture-format png, raw or exr),
+// --device <index or name> overrides the physical device ranking.
 int main(int argc, char *argv[])
 {
     ApplicationConfig config;
     config.width = 800;
     config.height = 600;
     config.title = "Vulkan Sandbox";
-    config.layer = new RenderLayer();
+
+    RenderSettings settings;
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+
+        if (std::strcmp(argv[i], "--headless") == 0)
+        {
+            config.headless = true;
+        }
+        else if (std::strcmp(argv[i], "--frames") == 0 && hasValue)
+        {
+            config.frameCount = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--width") == 0 && hasValue)
+        {
+            config.width = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--height") == 0 && hasValue)
+        {
+            config.height = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--device") == 0 && hasValue)
+        {
+            settings.preferredDevice = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--capture") == 0 && hasValue)
+        {
+            settings.capturePath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--capture-format") == 0 && hasValue)
+        {
+            const char *format = argv[++i];
+            settings.captureFormat = std::strcmp(format, "raw") == 0 ? Renderer::ImageFileFormat::Raw : std::strcmp(format, "exr") == 0 ? Renderer::ImageFileFormat::Exr : Renderer::ImageFileFormat::Png;
+        };
+    };
+
+    config.layer = new RenderLayer(settings);
 
     Application sandboxApp(config);
     sandboxApp.Run();
 
     return 0;
-};
\ No newline at end of file
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define VKS_PROFILE_TSC
+#endif
+
+namespace Profiling
+{
+    // Host time base of every trace event. steady_clock is CLOCK_MONOTONIC on Linux and the performance
+    // counter on Windows, the host domains GPU timestamps are calibrated against.
+    inline uint64_t NowNs()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    };
+
+    // Raw counter for the hot path, a fraction of a steady_clock read. The invariant TSC on x86-64, converted
+    // to NowNs() time by whoever reads the events back, and NowNs() itself elsewhere.
+    inline uint64_t Ticks()
+    {
+#ifdef VKS_PROFILE_TSC
+        return __rdtsc();
+#else
+        return NowNs();
+#endif
+    };
+
+};
@@ -0,0 +1,251 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace Profiling
+{
+    namespace
+    {
+        struct ThreadRing
+        {
+            EventRing ring;
+            uint32_t track = 0;
+            std::string name;
+        };
+
+        // Rings outlive their threads so the collector can drain what a finished thread left behind.
+        struct Registry
+        {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<ThreadRing>> rings;
+        };
+
+        Registry &GetRegistry()
+        {
+            static Registry registry;
+            return registry;
+        };
+
+        thread_local ThreadRing *t_ThreadRing = nullptr;
+
+        ThreadRing *GetThreadRing()
+        {
+            if (t_ThreadRing == nullptr)
+            {
+                Registry &registry = GetRegistry();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+
+                registry.rings.push_back(std::make_unique<ThreadRing>());
+                t_ThreadRing = registry.rings.back().get();
+                // The first thread to record is the main thread, it gets MAIN_THREAD_TRACK.
+                t_ThreadRing->track = static_cast<uint32_t>(registry.rings.size());
+            };
+
+            return t_ThreadRing;
+        };
+
+        // Deeper nesting is a leak from dropped end events.
+        const size_t MAX_OPEN_ZONES = 256;
+    };
+
+    void Record(EventType type, const char *name, double value)
+    {
+        GetThreadRing()->ring.Push({name, Ticks(), value, type});
+    };
+
+    void SetThreadName(const char *name)
+    {
+        ThreadRing *threadRing = GetThreadRing();
+
+        std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+        threadRing->name = name;
+    };
+
+    void Collector::Create(const CollectorConfig &config, TraceWriter *traceWriter)
+    {
+        m_Config = config;
+        m_TraceWriter = traceWriter;
+        m_ReferenceTicks = Ticks();
+        m_ReferenceNs = NowNs();
+        m_Running = true;
+        m_Thread = std::thread(&Collector::Run, this);
+    };
+
+    void Collector::Destroy()
+    {
+        if (!m_Running)
+        {
+            return;
+        };
+
+        m_Running = false;
+        m_Thread.join();
+    };
+
+    std::vector<ZoneStats> Collector::GetFrameZoneStats()
+    {
+        std::lock_guard<std::mutex> lock(m_StatsMutex);
+        return m_LastFrame;
+    };
+
+    uint64_t Collector::GetDroppedEvents()
+    {
+        Registry &registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+
+        uint64_t dropped = 0;
+        for (const std::unique_ptr<ThreadRing> &threadRing : registry.rings)
+        {
+            dropped += threadRing->ring.GetDropped();
+        };
+
+        return dropped;
+    };
+
+    void Collector::Run()
+    {
+        while (m_Running)
+        {
+            DrainAll();
+            std::this_thread::sleep_for(std::chrono::microseconds(m_Config.drainIntervalUs));
+        };
+
+        // Whatever was recorded before shutdown still reaches the trace.
+        DrainAll();
+    };
+
+    void Collector::UpdateTickRate()
+    {
+#ifdef VKS_PROFILE_TSC
+        uint64_t ticks = Ticks();
+        uint64_t ns = NowNs();
+
+        if (ticks > m_ReferenceTicks && ns > m_ReferenceNs)
+        {
+            m_NsPerTick = static_cast<double>(ns - m_ReferenceNs) / static_cast<double>(ticks - m_ReferenceTicks);
+        };
+#endif
+    };
+
+    uint64_t Collector::ToNs(uint64_t ticks)
+    {
+        // Events recorded before the collector started lie before the reference.
+        if (ticks >= m_ReferenceTicks)
+        {
+            return m_ReferenceNs + static_cast<uint64_t>(static_cast<double>(ticks - m_ReferenceTicks) * m_NsPerTick);
+        };
+
+        return m_ReferenceNs - static_cast<uint64_t>(static_cast<double>(m_ReferenceTicks - ticks) * m_NsPerTick);
+    };
+
+    void Collector::DrainAll()
+    {
+        UpdateTickRate();
+
+        Registry &registry = GetRegistry();
+        std::vector<ThreadRing *> rings;
+
+        {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+
+            for (size_t i = 0; i < registry.rings.size(); i++)
+            {
+                ThreadRing *threadRing = registry.rings[i].get();
+                rings.push_back(threadRing);
+
+                if (i >= m_ThreadStates.size())
+                {
+                    m_ThreadStates.push_back({threadRing->track, false, {}});
+                };
+
+                if (!m_ThreadStates[i].named && !threadRing->name.empty())
+                {
+                    m_ThreadStates[i].named = true;
+                    if (m_TraceWriter != nullptr)
+                    {
+                        m_TraceWriter->SetTrackName(threadRing->track, threadRing->name);
+                    };
+                };
+            };
+        };
+
+        for (size_t i = 0; i < rings.size(); i++)
+        {
+            ThreadState &state = m_ThreadStates[i];
+            rings[i]->ring.Drain([this, &state](const Event &event)
+                                 { Process(state, event); });
+        };
+    };
+
+    void Collector::Process(ThreadState &state, const Event &event)
+    {
+        switch (event.type)
+        {
+        case EventType::ZoneBegin:
+            if (state.openZones.size() < MAX_OPEN_ZONES)
+            {
+                state.openZones.push_back(event);
+            };
+            break;
+
+        case EventType::ZoneEnd:
+        {
+            // A begin lost to a full ring leaves its end unmatched, skip it.
+            if (state.openZones.empty() || state.openZones.back().name != event.name)
+            {
+                break;
+            };
+
+            const Event &begin = state.openZones.back();
+            uint64_t beginNs = ToNs(begin.ticks);
+            uint64_t durationNs = static_cast<uint64_t>(static_cast<double>(event.ticks - begin.ticks) * m_NsPerTick);
+
+            if (m_TraceWriter != nullptr)
+            {
+                m_TraceWriter->AddComplete(event.name, "cpu", state.track, beginNs, durationNs);
+            };
+
+            ZoneStats &stats = m_CurrentFrame[event.name];
+            stats.name = event.name;
+            stats.calls++;
+            stats.totalNs += durationNs;
+            stats.maxNs = (std::max)(stats.maxNs, durationNs);
+
+            state.openZones.pop_back();
+            break;
+        }
+
+        case EventType::Counter:
+            if (m_TraceWriter != nullptr)
+            {
+                m_TraceWriter->AddCounter(event.name, ToNs(event.ticks), event.value);
+            };
+            break;
+
+        case EventType::Frame:
+        {
+            if (m_TraceWriter != nullptr)
+            {
+                m_TraceWriter->AddInstant(event.name, state.track, ToNs(event.ticks));
+            };
+
+            std::vector<ZoneStats> frameStats;
+            for (const auto &entry : m_CurrentFrame)
+            {
+                frameStats.push_back(entry.second);
+            };
+
+            std::sort(frameStats.begin(), frameStats.end(), [](const ZoneStats &a, const ZoneStats &b)
+                      { return a.totalNs > b.totalNs; });
+
+            m_CurrentFrame.clear();
+
+            std::lock_guard<std::mutex> lock(m_StatsMutex);
+            m_LastFrame = std::move(frameStats);
+            break;
+        }
+        };
+    };
+
+};
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Clock.h"
+#include "TraceWriter.h"
+
+// CPU instrumentation. Zones, counters and frame markers go into a lock-free ring per thread and a collector
+// thread drains them into the trace. Without VKS_PROFILE (CMake option) the macros compile to nothing.
+#ifdef VKS_PROFILE
+#define VKS_PROFILE_CONCAT_INNER(a, b) a##b
+#define VKS_PROFILE_CONCAT(a, b) VKS_PROFILE_CONCAT_INNER(a, b)
+// Name must be a string literal, only the pointer is recorded.
+#define VKS_PROFILE_ZONE(name) ::Profiling::ScopedZone VKS_PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define VKS_PROFILE_FUNCTION() VKS_PROFILE_ZONE(__func__)
+#define VKS_PROFILE_COUNTER(name, value) ::Profiling::Record(::Profiling::EventType::Counter, name, static_cast<double>(value))
+#define VKS_PROFILE_FRAME() ::Profiling::Record(::Profiling::EventType::Frame, "Frame", 0.0)
+#define VKS_PROFILE_THREAD(name) ::Profiling::SetThreadName(name)
+#else
+#define VKS_PROFILE_ZONE(name) ((void)0)
+#define VKS_PROFILE_FUNCTION() ((void)0)
+#define VKS_PROFILE_COUNTER(name, value) ((void)0)
+#define VKS_PROFILE_FRAME() ((void)0)
+#define VKS_PROFILE_THREAD(name) ((void)0)
+#endif
+
+namespace Profiling
+{
+    enum class EventType : uint32_t
+    {
+        ZoneBegin,
+        ZoneEnd,
+        Counter,
+        Frame
+    };
+
+    struct Event
+    {
+        const char *name;
+        // Profiling::Ticks(), the collector converts them to NowNs() time.
+        uint64_t ticks;
+        double value;
+        EventType type;
+    };
+
+    // Single producer (the owning thread), single consumer (the collector). Full rings drop events.
+    class EventRing
+    {
+    public:
+        static const uint32_t CAPACITY = 1 << 16;
+
+        bool Push(const Event &event)
+        {
+            uint64_t head = m_Head.load(std::memory_order_relaxed);
+            if (head - m_Tail.load(std::memory_order_acquire) >= CAPACITY)
+            {
+                m_Dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            };
+
+            m_Events[head & (CAPACITY - 1)] = event;
+            m_Head.store(head + 1, std::memory_order_release);
+
+            return true;
+        };
+
+        template <typename Function>
+        void Drain(Function &&function)
+        {
+            uint64_t tail = m_Tail.load(std::memory_order_relaxed);
+            uint64_t head = m_Head.load(std::memory_order_acquire);
+
+            for (; tail != head; tail++)
+            {
+                function(m_Events[tail & (CAPACITY - 1)]);
+            };
+
+            m_Tail.store(tail, std::memory_order_release);
+        };
+
+        uint64_t GetDropped() { return m_Dropped.load(std::memory_order_relaxed); };
+
+    private:
+        alignas(64) std::atomic<uint64_t> m_Head{0};
+        alignas(64) std::atomic<uint64_t> m_Tail{0};
+        std::atomic<uint64_t> m_Dropped{0};
+        std::unique_ptr<Event[]> m_Events{new Event[CAPACITY]};
+    };
+
+    // Hot path: a clock read and a store into the calling thread's ring, registered on first use.
+    void Record(EventType type, const char *name, double value);
+    void SetThreadName(const char *name);
+
+    struct ScopedZone
+    {
+        const char *name;
+
+        ScopedZone(const char *zoneName) : name(zoneName) { Record(EventType::ZoneBegin, name, 0.0); };
+        ~ScopedZone() { Record(EventType::ZoneEnd, name, 0.0); };
+        ScopedZone(const ScopedZone &) = delete;
+        ScopedZone &operator=(const ScopedZone &) = delete;
+    };
+
+    struct ZoneStats
+    {
+        const char *name = nullptr;
+        uint32_t calls = 0;
+        uint64_t totalNs = 0;
+        uint64_t maxNs = 0;
+    };
+
+    struct CollectorConfig
+    {
+        // Sleep between two drains of the rings.
+        uint32_t drainIntervalUs = 1000;
+    };
+
+    // Drains every thread's ring on a background thread: zones become complete events of the trace (when a
+    // writer is given) and per-zone totals of the last finished frame are kept for in-process display.
+    class Collector
+    {
+    public:
+        Collector() = default;
+        ~Collector() = default;
+
+        void Create(const CollectorConfig &config, TraceWriter *traceWriter);
+        void Destroy();
+
+        // Zones of the last frame delimited by VKS_PROFILE_FRAME, sorted by total time.
+        std::vector<ZoneStats> GetFrameZoneStats();
+        uint64_t GetDroppedEvents();
+
+    private:
+        struct ThreadState
+        {
+            uint32_t track;
+            bool named;
+            std::vector<Event> openZones;
+        };
+
+        void Run();
+        void DrainAll();
+        void Process(ThreadState &state, const Event &event);
+        void UpdateTickRate();
+        uint64_t ToNs(uint64_t ticks);
+
+    private:
+        CollectorConfig m_Config;
+        TraceWriter *m_TraceWriter = nullptr;
+        std::thread m_Thread;
+        std::atomic<bool> m_Running{false};
+
+        // Ticks to nanoseconds, refined on every drain as the baseline grows.
+        uint64_t m_ReferenceTicks = 0;
+        uint64_t m_ReferenceNs = 0;
+        double m_NsPerTick = 1.0;
+
+        // Drain thread only.
+        std::vector<ThreadState> m_ThreadStates;
+        std::unordered_map<const char *, ZoneStats> m_CurrentFrame;
+
+        std::mutex m_StatsMutex;
+        std::vector<ZoneStats> m_LastFrame;
+    };
+
+};
@@ -0,0 +1,108 @@
+#include "TraceWriter.h"
+
+namespace Profiling
+{
+    namespace
+    {
+        std::string Escape(const char *text)
+        {
+            std::string escaped;
+            for (const char *c = text; *c != '\0'; c++)
+            {
+                if (*c == '"' || *c == '\\')
+                {
+                    escaped += '\\';
+                };
+                escaped += (static_cast<unsigned char>(*c) < 0x20) ? ' ' : *c;
+            };
+
+            return escaped;
+        };
+
+        // Trace timestamps are in microseconds, fractional digits keep the nanoseconds.
+        std::string Microseconds(uint64_t ns)
+        {
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%llu.%03u", static_cast<unsigned long long>(ns / 1000), static_cast<unsigned>(ns % 1000));
+
+            return buffer;
+        };
+    };
+
+    bool TraceWriter::Open(const std::string &path)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        m_File = std::fopen(path.c_str(), "w");
+        if (m_File == nullptr)
+        {
+            return false;
+        };
+
+        m_FirstEvent = true;
+        std::fputs("{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n", m_File);
+
+        return true;
+    };
+
+    void TraceWriter::Close()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        if (m_File == nullptr)
+        {
+            return;
+        };
+
+        std::fputs("\n]}\n", m_File);
+        std::fclose(m_File);
+        m_File = nullptr;
+    };
+
+    void TraceWriter::SetTrackName(uint32_t track, const std::string &name)
+    {
+        WriteEvent("{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " + std::to_string(track) + ", \"args\": {\"name\": \"" + Escape(name.c_str()) + "\"}}");
+    };
+
+    void TraceWriter::AddComplete(const char *name, const char *category, uint32_t track, uint64_t beginNs, uint64_t durationNs, const std::string &args)
+    {
+        std::string event = "{\"name\": \"" + Escape(name) + "\", \"cat\": \"" + category + "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " + std::to_string(track) +
+                            ", \"ts\": " + Microseconds(beginNs) + ", \"dur\": " + Microseconds(durationNs);
+
+        if (!args.empty())
+        {
+            event += ", \"args\": {" + args + "}";
+        };
+
+        WriteEvent(event + "}");
+    };
+
+    void TraceWriter::AddInstant(const char *name, uint32_t track, uint64_t timeNs)
+    {
+        WriteEvent("{\"name\": \"" + Escape(name) + "\", \"ph\": \"i\", \"s\": \"t\", \"pid\": 1, \"tid\": " + std::to_string(track) + ", \"ts\": " + Microseconds(timeNs) + "}");
+    };
+
+    void TraceWriter::AddCounter(const char *name, uint64_t timeNs, double value)
+    {
+        WriteEvent("{\"name\": \"" + Escape(name) + "\", \"ph\": \"C\", \"pid\": 1, \"ts\": " + Microseconds(timeNs) + ", \"args\": {\"value\": " + std::to_string(value) + "}}");
+    };
+
+    void TraceWriter::WriteEvent(const std::string &event)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        if (m_File == nullptr)
+        {
+            return;
+        };
+
+        if (!m_FirstEvent)
+        {
+            std::fputs(",\n", m_File);
+        };
+        m_FirstEvent = false;
+
+        std::fputs(event.c_str(), m_File);
+    };
+
+};
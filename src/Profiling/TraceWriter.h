@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+
+namespace Profiling
+{
+    // Track ids of the trace, CPU threads use their own small ids below GPU_TRACK.
+    const uint32_t MAIN_THREAD_TRACK = 1;
+    const uint32_t GPU_TRACK = 1000;
+
+    // Streams Chrome trace event JSON (chrome://tracing, ui.perfetto.dev), one event per call.
+    // Timestamps are host nanoseconds of Profiling::NowNs(). Safe to call from any thread.
+    class TraceWriter
+    {
+    public:
+        TraceWriter() = default;
+        ~TraceWriter() = default;
+
+        bool Open(const std::string &path);
+        void Close();
+        bool IsOpen() { return m_File != nullptr; };
+
+        void SetTrackName(uint32_t track, const std::string &name);
+        // A duration event, args is an optional JSON object body ("\"key\": value, ...").
+        void AddComplete(const char *name, const char *category, uint32_t track, uint64_t beginNs, uint64_t durationNs, const std::string &args = {});
+        void AddInstant(const char *name, uint32_t track, uint64_t timeNs);
+        void AddCounter(const char *name, uint64_t timeNs, double value);
+
+    private:
+        void WriteEvent(const std::string &event);
+
+    private:
+        std::FILE *m_File = nullptr;
+        bool m_FirstEvent = true;
+        std::mutex m_Mutex;
+    };
+
+};
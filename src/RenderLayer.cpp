@@ -4,81 +4,141 @@
 void RenderLayer::OnInit(const AppInstanceData &appInstanceData)
 {
     m_Window = appInstanceData.window;
+    m_Headless = appInstanceData.headless;
+    m_OffscreenExtent = {appInstanceData.width, appInstanceData.height};
 
     // Instance and Validation layer
     VulkanCore::InstanceConfig instanceConfig;
     instanceConfig.appName = appInstanceData.title;
     instanceConfig.enableValidation = true;
     instanceConfig.debugCallback = DebugCallback;
+    // Clamped to the loader and then the device, the feature chain only asks for what that version knows.
+    instanceConfig.apiVersion = VK_API_VERSION_1_3;
+    instanceConfig.headless = m_Headless;
 
     m_VulkanContext.instance.Create(instanceConfig);
 
-    // Surface (Window for rendering)
-    m_VulkanContext.surface.Create(m_VulkanContext.instance, m_Window);
+    // Surface (Window for rendering, none when headless)
+    if (!m_Headless)
+    {
+        m_VulkanContext.surface.Create(m_VulkanContext.instance, m_Window);
+    };
 
     // Device
     VulkanCore::DeviceConfig deviceConfig;
     deviceConfig.requiredExtensions = {};
+    deviceConfig.optionalExtensions = {VK_EXT_MEMORY_BUDGET_EXTENSION_NAME};
     deviceConfig.requireGraphicsQueue = true;
-    deviceConfig.requirePresentQueue = true;
-    deviceConfig.isDiscrete = true;
+    deviceConfig.requirePresentQueue = !m_Headless;
+    deviceConfig.preferredDevice = m_Settings.preferredDevice;
+    deviceConfig.optionalFeatures = {
+        VulkanCore::DeviceFeature::TextureCompressionBC,
+        VulkanCore::DeviceFeature::TextureCompressionASTC,
+        VulkanCore::DeviceFeature::SamplerAnisotropy,
+        VulkanCore::DeviceFeature::OcclusionQueryPrecise,
+        VulkanCore::DeviceFeature::PipelineStatisticsQuery,
+        VulkanCore::DeviceFeature::TimelineSemaphore,
+        VulkanCore::DeviceFeature::Synchronization2,
+        VulkanCore::DeviceFeature::DescriptorIndexing,
+        VulkanCore::DeviceFeature::RuntimeDescriptorArray,
+        VulkanCore::DeviceFeature::DescriptorBindingPartiallyBound,
+        VulkanCore::DeviceFeature::ShaderSampledImageArrayNonUniformIndexing,
+        VulkanCore::DeviceFeature::BufferDeviceAddress};
+    if (m_Settings.dynamicRendering)
+    {
+        deviceConfig.optionalFeatures.push_back(VulkanCore::DeviceFeature::DynamicRendering);
+    };
+    if (m_Settings.gpuProfiling)
+    {
+        deviceConfig.optionalExtensions.push_back(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME);
+    };
 
     m_VulkanContext.device.Create(deviceConfig, m_VulkanContext.instance, m_VulkanContext.surface);
 
+    m_UseDynamicRendering = m_VulkanContext.device.IsFeatureEnabled(VulkanCore::DeviceFeature::DynamicRendering);
+    if (m_Settings.dynamicRendering && !m_UseDynamicRendering)
+    {
+        CORE_LOG_INFO("Dynamic rendering not supported, falling back to render passes.");
+    };
+
+    m_VertexPulling = m_Settings.vertexPulling && m_VulkanContext.device.IsFeatureEnabled(VulkanCore::DeviceFeature::BufferDeviceAddress);
+    if (m_Settings.vertexPulling && !m_VertexPulling)
+    {
+        CORE_LOG_INFO("Buffer device address not supported, falling back to vertex input.");
+    };
+
     CORE_LOG_INFO("Device Name: {0}", m_VulkanContext.device.GetDeviceName());
 
-    // SwapChain
-    VulkanCore::SwapChainConfig swapChainConfig;
-    swapChainConfig.format = VK_FORMAT_B8G8R8A8_SRGB;
-    swapChainConfig.colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
-    swapChainConfig.presentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+    // SwapChain (offscreen color images when headless)
+    if (m_Headless)
+    {
+        CreateOffscreenTargets();
+    }
+    else
+    {
+        VulkanCore::SwapChainConfig swapChainConfig;
+        swapChainConfig.format = VK_FORMAT_B8G8R8A8_SRGB;
+        swapChainConfig.colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
+        swapChainConfig.presentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+        swapChainConfig.imageUsage = m_Settings.capturePath.empty() ? 0 : VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
 
-    m_VulkanContext.swapChain.Create(swapChainConfig, m_VulkanContext.device, m_VulkanContext.surface);
+        m_VulkanContext.swapChain.Create(swapChainConfig, m_VulkanContext.device, m_VulkanContext.surface);
+    };
 
-    // RenderPass
-    VkAttachmentDescription colorAttachment{};
-    colorAttachment.format = m_VulkanContext.swapChain.GetImageFormat();
-    colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-    colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-    colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    // Depth
+    // A depth pre-pass in its own rendering scope must store depth for the color pass to load it.
+    m_TransientDepth = m_Settings.transientDepth && !(m_UseDynamicRendering && m_Settings.depthPrePass);
 
-    VkAttachmentReference colorAttachmentRef{};
-    colorAttachmentRef.attachment = 0;
-    colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    std::optional<VkFormat> depthFormat = VulkanCore::Utils::FindDepthFormat(m_VulkanContext.device.GetPhysical());
 
-    VkSubpassDescription subpass{};
-    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-    subpass.colorAttachmentCount = 1;
-    subpass.pColorAttachments = &colorAttachmentRef;
+    CORE_ASSERT(depthFormat.has_value(), "Failed to find a supported depth format!");
 
-    VkSubpassDependency dependency{};
-    dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-    dependency.dstSubpass = 0;
-    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    dependency.srcAccessMask = 0;
-    dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    m_VulkanContext.depthFormat = depthFormat.value();
 
-    VkRenderPassCreateInfo renderPassInfo{};
-    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-    renderPassInfo.attachmentCount = 1;
-    renderPassInfo.pAttachments = &colorAttachment;
-    renderPassInfo.subpassCount = 1;
-    renderPassInfo.pSubpasses = &subpass;
-    renderPassInfo.dependencyCount = 1;
-    renderPassInfo.pDependencies = &dependency;
+    // Hi-Z culling samples the stored depth, which rules out a transient attachment.
+    VkFormatProperties depthFormatProperties;
+    vkGetPhysicalDeviceFormatProperties(m_VulkanContext.device.GetPhysical(), m_VulkanContext.depthFormat, &depthFormatProperties);
 
-    VkResult result = vkCreateRenderPass(m_VulkanContext.device.Get(), &renderPassInfo, nullptr, &(m_VulkanContext.renderPass));
+    m_OcclusionCulling = m_Settings.occlusionCulling && (depthFormatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT);
 
-    CORE_ASSERT(result == VK_SUCCESS, "Failed to create render pass!");
+    if (m_Settings.occlusionCulling && !m_OcclusionCulling)
+    {
+        CORE_LOG_INFO("Depth format cannot be sampled, occlusion culling disabled.");
+    };
+
+    m_TransientDepth = m_TransientDepth && !m_OcclusionCulling;
+
+    CreateDepthResources();
+
+    // RenderPass (the dynamic rendering path begins rendering directly against image views)
+    if (!m_UseDynamicRendering)
+    {
+        CreateRenderPass();
+    };
+
+    VkResult result;
+
+    // Resources (buffers, images and pipelines behind generational handles)
+    m_VulkanContext.resources.Create(m_VulkanContext.device);
+
+    // Descriptors (sets of the compute passes and of the shading pipelines)
+    m_VulkanContext.descriptorPool.Create(m_VulkanContext.device, 64, {{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 256}, {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 64}, {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 64}, {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 64}});
+
+    // Lighting (clustered, set 0 of the graphics pipeline)
+    Renderer::ClusteredLightingConfig lightingConfig;
+    lightingConfig.maxLights = (std::max)(m_Settings.lightCount, 1u);
+    lightingConfig.framesInFlight = m_MAX_FRAMES_IN_FLIGHT;
+
+    m_ClusteredLighting.Create(lightingConfig, m_VulkanContext.device, m_VulkanContext.descriptorPool);
+
+    if (m_Settings.lightCount > 0)
+    {
+        CreateLightScene();
+    };
 
     // Graphics Pipeline
     VulkanCore::ShaderModule vertexShaderModule;
-    vertexShaderModule.Create(m_VulkanContext.device, "assets/shaders/spv/shader.vert.spv");
+    vertexShaderModule.Create(m_VulkanContext.device, m_VertexPulling ? "assets/shaders/spv/vertex_pull.vert.spv" : "assets/shaders/spv/shader.vert.spv");
 
     VulkanCore::ShaderModule fragmentShaderModule;
     fragmentShaderModule.Create(m_VulkanContext.device, "assets/shaders/spv/shader.frag.spv");
@@ -100,12 +160,16 @@ void RenderLayer::OnInit(const AppInstanceData &appInstanceData)
     auto bindingDescription = Vertex::getBindingDescription();
     auto attributeDescriptions = Vertex::getAttributeDescriptions();
 
+    // Pulled vertices declare no input at all, the pipeline is the same for every vertex layout.
     VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
     vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInputInfo.vertexBindingDescriptionCount = 1;
-    vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
-    vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
-    vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+    if (!m_VertexPulling)
+    {
+        vertexInputInfo.vertexBindingDescriptionCount = 1;
+        vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
+        vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
+        vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+    };
 
     VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
     inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
@@ -132,6 +196,15 @@ void RenderLayer::OnInit(const AppInstanceData &appInstanceData)
     multisampling.sampleShadingEnable = VK_FALSE;
     multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
 
+    // Opaque geometry after a pre-pass only shades the fragments whose depth matches the stored one.
+    VkPipelineDepthStencilStateCreateInfo depthStencil{};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencil.depthTestEnable = VK_TRUE;
+    depthStencil.depthWriteEnable = m_Settings.depthPrePass ? VK_FALSE : VK_TRUE;
+    depthStencil.depthCompareOp = m_Settings.depthPrePass ? VK_COMPARE_OP_EQUAL : VK_COMPARE_OP_LESS;
+    depthStencil.depthBoundsTestEnable = VK_FALSE;
+    depthStencil.stencilTestEnable = VK_FALSE;
+
     VkPipelineColorBlendAttachmentState colorBlendAttachment{};
     colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
     colorBlendAttachment.blendEnable = VK_FALSE;
@@ -157,10 +230,35 @@ void RenderLayer::OnInit(const AppInstanceData &appInstanceData)
     dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
     dynamicState.pDynamicStates = dynamicStates.data();
 
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(PushConstants);
+
+    // Material (set 1, the mesh texture sampled by the fragment shader)
+    VkDescriptorSetLayoutBinding textureBinding{};
+    textureBinding.binding = 0;
+    textureBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    textureBinding.descriptorCount = 1;
+    textureBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    VkDescriptorSetLayoutCreateInfo materialLayoutInfo{};
+    materialLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    materialLayoutInfo.bindingCount = 1;
+    materialLayoutInfo.pBindings = &textureBinding;
+
+    result = vkCreateDescriptorSetLayout(m_VulkanContext.device.Get(), &materialLayoutInfo, nullptr, &(m_VulkanContext.materialSetLayout));
+
+    CORE_ASSERT(result == VK_SUCCESS, "Failed to create descriptor set layout!");
+
+    std::array<VkDescriptorSetLayout, 2> setLayouts = {m_ClusteredLighting.GetDescriptorSetLayout(), m_VulkanContext.materialSetLayout};
+
     VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
     pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = 0;
-    pipelineLayoutInfo.pushConstantRangeCount = 0;
+    pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+    pipelineLayoutInfo.pSetLayouts = setLayouts.data();
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
 
     result = vkCreatePipelineLayout(m_VulkanContext.device.Get(), &pipelineLayoutInfo, nullptr, &(m_VulkanContext.graphicsPipelineLayout));
 
@@ -175,38 +273,65 @@ void RenderLayer::OnInit(const AppInstanceData &appInstanceData)
     pipelineInfo.pViewportState = &viewportState;
     pipelineInfo.pRasterizationState = &rasterizer;
     pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pDepthStencilState = &depthStencil;
     pipelineInfo.pColorBlendState = &colorBlending;
     pipelineInfo.pDynamicState = &dynamicState;
     pipelineInfo.layout = m_VulkanContext.graphicsPipelineLayout;
     pipelineInfo.renderPass = m_VulkanContext.renderPass;
-    pipelineInfo.subpass = 0;
+
+    // Pipelines for dynamic rendering only declare attachment formats, there is no render pass to be compatible with.
+    VkFormat colorFormat = GetColorFormat();
+
+    VkPipelineRenderingCreateInfo renderingInfo{};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachmentFormats = &colorFormat;
+    renderingInfo.depthAttachmentFormat = m_VulkanContext.depthFormat;
+
+    if (m_UseDynamicRendering)
+    {
+        pipelineInfo.pNext = &renderingInfo;
+        pipelineInfo.renderPass = VK_NULL_HANDLE;
+    };
+    pipelineInfo.subpass = (m_Settings.depthPrePass && !m_UseDynamicRendering) ? 1 : 0;
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 
-    result = vkCreateGraphicsPipelines(m_VulkanContext.device.Get(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &(m_VulkanContext.graphicsPipeline));
+    VkPipeline pipeline;
+    result = vkCreateGraphicsPipelines(m_VulkanContext.device.Get(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline);
 
     CORE_ASSERT(result == VK_SUCCESS, "Failed to create graphics pipeline!");
 
-    vertexShaderModule.Destroy();
-    fragmentShaderModule.Destroy();
+    m_VulkanContext.graphicsPipeline = m_VulkanContext.resources.AddPipeline(pipeline, m_VulkanContext.graphicsPipelineLayout, VK_PIPELINE_BIND_POINT_GRAPHICS);
 
-    // FrameBuffer
-    m_VulkanContext.swapChainFrameBuffers.resize(m_VulkanContext.swapChain.GetImageViews().size());
-    for (size_t i = 0; i < m_VulkanContext.swapChain.GetImageViews().size(); i++)
+    // Depth-only variant for the pre-pass: no fragment stage and no color attachment.
+    if (m_Settings.depthPrePass)
     {
-        VkImageView attachments[] = {m_VulkanContext.swapChain.GetImageViews()[i]};
+        depthStencil.depthWriteEnable = VK_TRUE;
+        depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
 
-        VkFramebufferCreateInfo framebufferInfo{};
-        framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-        framebufferInfo.renderPass = m_VulkanContext.renderPass;
-        framebufferInfo.attachmentCount = 1;
-        framebufferInfo.pAttachments = attachments;
-        framebufferInfo.width = m_VulkanContext.swapChain.GetExtent().width;
-        framebufferInfo.height = m_VulkanContext.swapChain.GetExtent().height;
-        framebufferInfo.layers = 1;
+        colorBlending.attachmentCount = 0;
+        colorBlending.pAttachments = nullptr;
 
-        result = vkCreateFramebuffer(m_VulkanContext.device.Get(), &framebufferInfo, nullptr, &(m_VulkanContext.swapChainFrameBuffers[i]));
+        pipelineInfo.stageCount = 1;
+        pipelineInfo.subpass = 0;
 
-        CORE_ASSERT(result == VK_SUCCESS, "Failed to create framebuffer!");
+        renderingInfo.colorAttachmentCount = 0;
+        renderingInfo.pColorAttachmentFormats = nullptr;
+
+        result = vkCreateGraphicsPipelines(m_VulkanContext.device.Get(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline);
+
+        CORE_ASSERT(result == VK_SUCCESS, "Failed to create depth pre-pass pipeline!");
+
+        m_VulkanContext.depthPrePassPipeline = m_VulkanContext.resources.AddPipeline(pipeline, m_VulkanContext.graphicsPipelineLayout, VK_PIPELINE_BIND_POINT_GRAPHICS);
+    };
+
+    vertexShaderModule.Destroy();
+    fragmentShaderModule.Destroy();
+
+    // FrameBuffer
+    if (!m_UseDynamicRendering)
+    {
+        CreateFrameBuffers();
     };
 
     // CommandPool
@@ -219,24 +344,159 @@ void RenderLayer::OnInit(const AppInstanceData &appInstanceData)
 
     CORE_ASSERT(result == VK_SUCCESS, "Failed to create command pool!");
 
-    // VertexBuffer and StagingBuffer (fast gpu access memory)
-    VkDeviceSize bufferSize = sizeof(m_Vertices[0]) * m_Vertices.size();
+    // Profiling (GPU scopes on the graphics queue, CPU zones drained from every thread's ring)
+    if (!m_Settings.tracePath.empty() && !m_TraceWriter.Open(m_Settings.tracePath))
+    {
+        CORE_LOG_ERROR("Failed to open trace file {0}", m_Settings.tracePath);
+    };
+
+    m_CpuProfiling = m_TraceWriter.IsOpen() || m_Settings.logCpuZones;
+
+    if (m_CpuProfiling)
+    {
+        m_CpuCollector.Create(Profiling::CollectorConfig{}, m_TraceWriter.IsOpen() ? &m_TraceWriter : nullptr);
+    };
+
+    if (m_Settings.gpuProfiling)
+    {
+        Renderer::GpuProfilerConfig profilerConfig;
+        profilerConfig.framesInFlight = m_MAX_FRAMES_IN_FLIGHT;
+        profilerConfig.pipelineStatistics = m_Settings.profilePipelineStatistics;
+
+        m_GpuProfiler.Create(profilerConfig, m_VulkanContext.device, m_VulkanContext.commandPool);
+
+        if (m_TraceWriter.IsOpen())
+        {
+            m_GpuProfiler.SetTraceWriter(&m_TraceWriter);
+        };
+    };
+
+    // Frame capture (readback ring of the final color image, written on worker threads)
+    if (!m_Settings.capturePath.empty())
+    {
+        if (m_Headless || (m_VulkanContext.swapChain.GetImageUsage() & VK_IMAGE_USAGE_TRANSFER_SRC_BIT))
+        {
+            Renderer::FrameCaptureConfig captureConfig;
+            captureConfig.extent = GetRenderExtent();
+            captureConfig.format = GetColorFormat();
+            captureConfig.framesInFlight = m_MAX_FRAMES_IN_FLIGHT;
+            captureConfig.directory = m_Settings.capturePath;
+            captureConfig.fileFormat = m_Settings.captureFormat;
+
+            m_FrameCapture.Create(captureConfig, m_VulkanContext.device);
+        }
+        else
+        {
+            CORE_LOG_WARN("Frame capture: swapchain images cannot be copied from, capture disabled.");
+        };
+    };
+
+    // Compute (own queue when the device has a dedicated compute family)
+    m_VulkanContext.computeScheduler.Create(m_VulkanContext.device, m_MAX_FRAMES_IN_FLIGHT);
+
+    // Particles (simulated on the compute queue, drawn in the color pass)
+    m_ParticlesEnabled = m_Settings.maxParticles > 0;
+
+    if (m_ParticlesEnabled)
+    {
+        Renderer::ParticleSystemConfig particleConfig;
+        particleConfig.maxParticles = m_Settings.maxParticles;
+        particleConfig.framesInFlight = m_MAX_FRAMES_IN_FLIGHT;
+        particleConfig.benchmark = m_Settings.particleBenchmark;
+
+        m_ParticleSystem.Create(particleConfig, m_VulkanContext.device, m_VulkanContext.descriptorPool, m_VulkanContext.commandPool);
+        m_ParticleSystem.CreateRenderPipeline(m_VulkanContext.renderPass, pipelineInfo.subpass, colorFormat, m_VulkanContext.depthFormat);
+    };
+
+    m_LastFrameTime = std::chrono::steady_clock::now();
+
+    // Textures (streamed against the device local heap's budget)
+    m_VulkanContext.memoryBudget.Create(m_VulkanContext.device);
+    m_VulkanContext.samplerCache.Create(m_VulkanContext.device);
+
+    VulkanCore::TextureStreamerConfig textureStreamerConfig;
+    textureStreamerConfig.framesInFlight = m_MAX_FRAMES_IN_FLIGHT;
+
+    m_VulkanContext.textureStreamer.Create(textureStreamerConfig, m_VulkanContext.device);
+
+    VulkanCore::TextureConfig meshTextureConfig;
+    meshTextureConfig.path = "assets/textures/checker.ktx2";
+    meshTextureConfig.streamed = true;
+
+    m_MeshTexture.Create(meshTextureConfig, m_VulkanContext.device, m_VulkanContext.commandPool);
+    m_VulkanContext.textureStreamer.Register(&m_MeshTexture);
+
+    m_MaterialSets.resize(m_MAX_FRAMES_IN_FLIGHT);
+    for (uint32_t i = 0; i < m_MAX_FRAMES_IN_FLIGHT; i++)
+    {
+        m_MaterialSets[i].set = m_VulkanContext.descriptorPool.Allocate(m_VulkanContext.materialSetLayout);
+        m_MaterialSets[i].textureVersion = m_MeshTexture.GetVersion() + 1;
+        UpdateMaterialSet(i);
+    };
+
+    // Occlusion Culling
+    if (m_OcclusionCulling)
+    {
+        Renderer::OcclusionCullerConfig cullerConfig;
+        cullerConfig.framesInFlight = m_MAX_FRAMES_IN_FLIGHT;
+
+        m_OcclusionCuller.Create(cullerConfig, m_VulkanContext.device, m_VulkanContext.descriptorPool);
+
+        CreateHiZPyramid();
+    };
+
+    // Every LOD level of the mesh, sharing the vertices
+    CreateMesh();
+    m_MeshLODs = Renderer::BuildLODChain(&m_Vertices[0].position.x, m_Vertices.size(), sizeof(Vertex), m_Indices, Renderer::LODChainConfig{});
+    CORE_LOG_INFO("Mesh: {0} triangles, {1} LOD levels", m_Indices.size() / 3, m_MeshLODs.levels.size());
+
+    if (m_VertexPulling)
+    {
+        // GeometryArena (vertices and indices of every mesh in one device address buffer)
+        m_GeometryArena.Create(Renderer::GeometryArenaConfig{}, m_VulkanContext.device, m_VulkanContext.commandPool);
+
+        bool added = m_GeometryArena.Add(Renderer::VertexFormat::PositionColorUV, m_Vertices.data(), static_cast<uint32_t>(m_Vertices.size()), m_MeshLODs.indices.data(), static_cast<uint32_t>(m_MeshLODs.indices.size()), m_PulledMesh);
+
+        CORE_ASSERT(added, "Failed to add the mesh to the geometry arena!");
+    }
+    else
+    {
+        // VertexBuffer and IndexBuffer (written in place on UMA and resizable BAR devices, staged into device local memory otherwise)
+        VkDeviceSize bufferSize = sizeof(m_Vertices[0]) * m_Vertices.size();
+        m_VertexBuffer = m_VulkanContext.resources.UploadBuffer("vertex buffer", m_Vertices.data(), bufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, m_VulkanContext.commandPool);
 
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
-    CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
+        bufferSize = sizeof(m_MeshLODs.indices[0]) * m_MeshLODs.indices.size();
+        m_IndexBuffer = m_VulkanContext.resources.UploadBuffer("index buffer", m_MeshLODs.indices.data(), bufferSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, m_VulkanContext.commandPool);
+    };
+
+    // Scene (the mesh as its only entity, at the root of the hierarchy)
+    Scene::HierarchyNode node = m_Hierarchy.Add(Scene::Transform{});
 
-    void *data;
-    vkMapMemory(m_VulkanContext.device.Get(), stagingBufferMemory, 0, bufferSize, 0, &data);
-    memcpy(data, m_Vertices.data(), (size_t)bufferSize);
-    vkUnmapMemory(m_VulkanContext.device.Get(), stagingBufferMemory);
+    Scene::MeshInstance meshInstance;
+    meshInstance.localBounds = glm::vec4(m_MeshLODs.center, m_MeshLODs.radius);
+    meshInstance.instance = m_Hierarchy.GetInstance(node);
+    m_Scene.Create(Scene::HierarchyTransform{node}, Scene::LocalToWorld{}, meshInstance, Scene::WorldBounds{});
+
+    if (m_VertexPulling)
+    {
+        // InstanceBuffers (written in place every frame, only rows whose world matrix changed since the slot's last frame)
+        m_InstanceBuffers.resize(m_MAX_FRAMES_IN_FLIGHT);
+        for (InstanceBuffer &instanceBuffer : m_InstanceBuffers)
+        {
+            VkDeviceSize size = sizeof(Scene::WorldRows) * m_MAX_INSTANCES;
+            instanceBuffer.buffer = m_VulkanContext.resources.CreateBuffer(size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
 
-    CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_VertexBuffer, m_VertexBufferMemory);
+            const VulkanCore::BufferResource *resource = m_VulkanContext.resources.GetBuffer(instanceBuffer.buffer);
+            vkMapMemory(m_VulkanContext.device.Get(), resource->memory, 0, size, 0, reinterpret_cast<void **>(&instanceBuffer.mapped));
 
-    CopyBuffer(stagingBuffer, m_VertexBuffer, bufferSize);
+            VkBufferDeviceAddressInfo addressInfo{};
+            addressInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+            addressInfo.buffer = resource->buffer;
+            instanceBuffer.address = m_VulkanContext.device.GetDispatch().vkGetBufferDeviceAddress(m_VulkanContext.device.Get(), &addressInfo);
+        };
+    };
 
-    vkDestroyBuffer(m_VulkanContext.device.Get(), stagingBuffer, nullptr);
-    vkFreeMemory(m_VulkanContext.device.Get(), stagingBufferMemory, nullptr);
+    m_Camera.viewportHeight = static_cast<float>(GetRenderExtent().height);
 
     // CommandBuffer
     m_VulkanContext.commandBuffers.resize(m_MAX_FRAMES_IN_FLIGHT);
@@ -272,14 +532,76 @@ void RenderLayer::OnInit(const AppInstanceData &appInstanceData)
             throw std::runtime_error("Failed to create synchronization objects for a frame!");
         };
     };
+
+    // Overdraw Queries (pre-pass occlusion, color pass occlusion, fragment shader invocations)
+    // Statistics queries cannot overlap, the profiler's per-pass statistics take over when enabled.
+    m_PipelineStatisticsEnabled = m_VulkanContext.device.GetEnabledFeatures().pipelineStatisticsQuery && !(m_Settings.gpuProfiling && m_Settings.profilePipelineStatistics);
+
+    if (!m_VulkanContext.device.GetEnabledFeatures().occlusionQueryPrecise)
+    {
+        CORE_LOG_INFO("Precise occlusion queries not supported, overdraw counters are approximate.");
+    };
+
+    m_VulkanContext.queryPools.resize(m_MAX_FRAMES_IN_FLIGHT * 2, VK_NULL_HANDLE);
+    m_QueriesPending.resize(m_MAX_FRAMES_IN_FLIGHT, false);
+    m_QueriedDrawCounts.resize(m_MAX_FRAMES_IN_FLIGHT, 0);
+    m_SubmitNs.resize(m_MAX_FRAMES_IN_FLIGHT, 0);
+
+    for (size_t i = 0; i < m_MAX_FRAMES_IN_FLIGHT; i++)
+    {
+        VkQueryPoolCreateInfo queryPoolInfo{};
+        queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryPoolInfo.queryType = VK_QUERY_TYPE_OCCLUSION;
+        queryPoolInfo.queryCount = 2;
+
+        result = vkCreateQueryPool(m_VulkanContext.device.Get(), &queryPoolInfo, nullptr, &(m_VulkanContext.queryPools[i * 2]));
+
+        CORE_ASSERT(result == VK_SUCCESS, "Failed to create occlusion query pool!");
+
+        if (m_PipelineStatisticsEnabled)
+        {
+            queryPoolInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+            queryPoolInfo.queryCount = 1;
+            queryPoolInfo.pipelineStatistics = VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+
+            result = vkCreateQueryPool(m_VulkanContext.device.Get(), &queryPoolInfo, nullptr, &(m_VulkanContext.queryPools[i * 2 + 1]));
+
+            CORE_ASSERT(result == VK_SUCCESS, "Failed to create pipeline statistics query pool!");
+        };
+    };
 };
 
 void RenderLayer::OnPrepareFrame()
 {
-    vkWaitForFences(m_VulkanContext.device.Get(), 1, &(m_VulkanContext.inFlightFences[m_CurrentFrame]), VK_TRUE, UINT64_MAX);
-    vkResetFences(m_VulkanContext.device.Get(), 1, &(m_VulkanContext.inFlightFences[m_CurrentFrame]));
+    VKS_PROFILE_ZONE("Prepare Frame");
+
+    const VulkanCore::DeviceDispatch &dispatch = m_VulkanContext.device.GetDispatch();
 
-    VkResult result = vkAcquireNextImageKHR(m_VulkanContext.device.Get(), m_VulkanContext.swapChain.Get(), UINT64_MAX, m_VulkanContext.imageAvailableSemaphores[m_CurrentFrame], VK_NULL_HANDLE, &m_CurrentBufferIndex);
+    dispatch.vkWaitForFences(m_VulkanContext.device.Get(), 1, &(m_VulkanContext.inFlightFences[m_CurrentFrame]), VK_TRUE, UINT64_MAX);
+    dispatch.vkResetFences(m_VulkanContext.device.Get(), 1, &(m_VulkanContext.inFlightFences[m_CurrentFrame]));
+
+    // The slot's previous frame has finished, its capture is ready to be written.
+    m_FrameCapture.Collect(m_CurrentFrame);
+
+    ReadFrameStats();
+    LogCpuZones();
+
+    m_VulkanContext.memoryBudget.Update();
+    m_VulkanContext.textureStreamer.SetHeapBudget(m_VulkanContext.memoryBudget.GetPrimaryHeap());
+
+    m_FrameStats.deviceMemoryUsage = m_VulkanContext.memoryBudget.GetPrimaryHeap().usage;
+    m_FrameStats.deviceMemoryBudget = m_VulkanContext.memoryBudget.GetPrimaryHeap().budget;
+
+    // Offscreen targets are per frame in flight, the fence above already guards them.
+    VkResult result = VK_SUCCESS;
+    if (m_Headless)
+    {
+        m_CurrentBufferIndex = m_CurrentFrame;
+    }
+    else
+    {
+        result = dispatch.vkAcquireNextImageKHR(m_VulkanContext.device.Get(), m_VulkanContext.swapChain.Get(), UINT64_MAX, m_VulkanContext.imageAvailableSemaphores[m_CurrentFrame], VK_NULL_HANDLE, &m_CurrentBufferIndex);
+    };
 
     if (result == VK_ERROR_OUT_OF_DATE_KHR)
     {
@@ -291,84 +613,277 @@ void RenderLayer::OnPrepareFrame()
         throw std::runtime_error("Failed to acquire swap chain image!");
     };
 
-    vkResetFences(m_VulkanContext.device.Get(), 1, &(m_VulkanContext.inFlightFences[m_CurrentFrame]));
+    dispatch.vkResetFences(m_VulkanContext.device.Get(), 1, &(m_VulkanContext.inFlightFences[m_CurrentFrame]));
+
+    auto frameTime = std::chrono::steady_clock::now();
+    float deltaTime = std::chrono::duration<float>(frameTime - m_LastFrameTime).count();
+    m_LastFrameTime = frameTime;
+
+    // Compute work of this frame, submitted ahead of the graphics work that consumes it
+    if (m_ParticlesEnabled)
+    {
+        VkCommandBuffer computeCommandBuffer = m_VulkanContext.computeScheduler.Begin(m_CurrentFrame);
+        m_ParticleSystem.Simulate(computeCommandBuffer, m_CurrentFrame, deltaTime);
+
+        const Renderer::ParticleStats &particleStats = m_ParticleSystem.GetStats();
+        m_FrameStats.particlesAlive = particleStats.aliveCount;
+        m_FrameStats.particleSimulationMs = particleStats.simulationMs;
+
+        m_StatsLogTimer += deltaTime;
+        if (m_Settings.particleBenchmark && m_StatsLogTimer >= 1.0f)
+        {
+            CORE_LOG_INFO("Particles: {0} alive, {1:.3f} ms simulation, {2:.0f} particles/ms", particleStats.aliveCount, particleStats.simulationMs, particleStats.particlesPerMs);
+            m_StatsLogTimer = 0.0f;
+        };
+    };
 
-    vkResetCommandBuffer(m_VulkanContext.commandBuffers[m_CurrentFrame], /*VkCommandBufferResetFlagBits*/ 0);
+    dispatch.vkResetCommandBuffer(m_VulkanContext.commandBuffers[m_CurrentFrame], /*VkCommandBufferResetFlagBits*/ 0);
 
     VkCommandBufferBeginInfo beginInfo{};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 
-    result = vkBeginCommandBuffer(m_VulkanContext.commandBuffers[m_CurrentFrame], &beginInfo);
+    result = dispatch.vkBeginCommandBuffer(m_VulkanContext.commandBuffers[m_CurrentFrame], &beginInfo);
 
     CORE_ASSERT(result == VK_SUCCESS, "Failed to begin recording command buffer!");
 
-    VkRenderPassBeginInfo renderPassInfo{};
-    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    renderPassInfo.renderPass = m_VulkanContext.renderPass;
-    renderPassInfo.framebuffer = m_VulkanContext.swapChainFrameBuffers[m_CurrentBufferIndex];
-    renderPassInfo.renderArea.offset = {0, 0};
-    renderPassInfo.renderArea.extent = m_VulkanContext.swapChain.GetExtent();
+    // GPU scopes of this slot's previous frame are resolved before its queries are reused
+    m_GpuProfiler.BeginFrame(m_VulkanContext.commandBuffers[m_CurrentFrame], m_CurrentFrame);
+
+    if (m_GpuProfiler.IsEnabled())
+    {
+        m_FrameStats.gpuFrameMs = m_GpuProfiler.GetFrameMs();
+
+        uint64_t gpuEndNs = 0;
+        for (const Renderer::GpuScopeResult &scope : m_GpuProfiler.GetResults())
+        {
+            gpuEndNs = (std::max)(gpuEndNs, scope.beginNs + scope.durationNs);
+        };
+
+        uint64_t submitNs = m_SubmitNs[m_CurrentFrame];
+        m_FrameStats.submitToPresentMs = submitNs != 0 && gpuEndNs > submitNs ? static_cast<float>(gpuEndNs - submitNs) / 1e6f : 0.0f;
+
+        const Renderer::GpuScopeResult *colorPass = m_GpuProfiler.FindResult("Color Pass");
+        if (colorPass != nullptr && colorPass->hasStatistics)
+        {
+            m_FrameStats.fragmentShaderInvocations = colorPass->statistics.fragmentShaderInvocations;
+        };
+    };
+
+    // Lights of this frame, binned into the cluster grid ahead of every pass that shades with it
+    if (m_Settings.lightCount > 0)
+    {
+        UpdateLightScene(deltaTime);
+    };
+
+    m_ClusteredLighting.Update(m_CurrentFrame, m_Lights, m_Camera, GetRenderExtent(), glm::vec3(m_Lights.empty() ? 1.0f : 0.1f));
+    m_GpuProfiler.BeginScope(m_VulkanContext.commandBuffers[m_CurrentFrame], "Light Culling");
+    m_ClusteredLighting.Build(m_VulkanContext.commandBuffers[m_CurrentFrame], m_CurrentFrame);
+    m_GpuProfiler.EndScope(m_VulkanContext.commandBuffers[m_CurrentFrame]);
+
+    VKS_PROFILE_ZONE("Record Commands");
 
-    VkClearValue clearColor = {{{0.0f, 0.0f, 0.0f, 1.0f}}};
-    renderPassInfo.clearValueCount = 1;
-    renderPassInfo.pClearValues = &clearColor;
+    // Opaque draws of this frame
+    m_SceneVersion = Scene::UpdateHierarchyTransforms(m_Scene, m_Hierarchy, m_SceneVersion);
 
-    vkCmdBeginRenderPass(m_VulkanContext.commandBuffers[m_CurrentFrame], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    if (m_VertexPulling)
+    {
+        CORE_ASSERT(m_Hierarchy.GetInstanceCapacity() <= m_MAX_INSTANCES, "Too many scene instances!");
+
+        InstanceBuffer &instanceBuffer = m_InstanceBuffers[m_CurrentFrame];
+        instanceBuffer.version = m_Hierarchy.WriteInstances(instanceBuffer.mapped, instanceBuffer.version);
+    };
+    BuildDrawList();
+
+    if (m_Settings.sortFrontToBack)
+    {
+        m_DrawList.SortFrontToBack();
+    };
+
+    VKS_PROFILE_COUNTER("Draws", m_DrawList.Size());
+
+    // Mip levels the draws above asked for, streamed in and out ahead of every pass that samples them
+    m_VulkanContext.textureStreamer.Update(m_VulkanContext.commandBuffers[m_CurrentFrame]);
+    UpdateMaterialSet(m_CurrentFrame);
+
+    VkCommandBuffer commandBuffer = m_VulkanContext.commandBuffers[m_CurrentFrame];
+
+    VkQueryPool occlusionQueryPool = m_VulkanContext.queryPools[m_CurrentFrame * 2];
+    VkQueryPool statisticsQueryPool = m_VulkanContext.queryPools[m_CurrentFrame * 2 + 1];
+
+    dispatch.vkCmdResetQueryPool(commandBuffer, occlusionQueryPool, 0, 2);
+    if (m_PipelineStatisticsEnabled)
+    {
+        dispatch.vkCmdResetQueryPool(commandBuffer, statisticsQueryPool, 0, 1);
+    };
+
+    VkQueryControlFlags occlusionFlags = m_VulkanContext.device.GetEnabledFeatures().occlusionQueryPrecise ? VK_QUERY_CONTROL_PRECISE_BIT : 0;
+
+    if (m_OcclusionCulling)
+    {
+        m_GpuProfiler.BeginScope(commandBuffer, "Occlusion Culling");
+        m_OcclusionCuller.Cull(commandBuffer, m_CurrentFrame, m_DrawList, m_Camera, m_HiZValid);
+        m_GpuProfiler.EndScope(commandBuffer);
+    };
 
-    vkCmdBindPipeline(m_VulkanContext.commandBuffers[m_CurrentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, m_VulkanContext.graphicsPipeline);
+    if (m_UseDynamicRendering)
+    {
+        TransitionAttachments(commandBuffer, true);
+    };
 
     VkViewport viewport{};
     viewport.x = 0.0f;
     viewport.y = 0.0f;
-    viewport.width = (float)m_VulkanContext.swapChain.GetExtent().width;
-    viewport.height = (float)m_VulkanContext.swapChain.GetExtent().height;
+    viewport.width = (float)GetRenderExtent().width;
+    viewport.height = (float)GetRenderExtent().height;
     viewport.minDepth = 0.0f;
     viewport.maxDepth = 1.0f;
-    vkCmdSetViewport(m_VulkanContext.commandBuffers[m_CurrentFrame], 0, 1, &viewport);
+    dispatch.vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
 
     VkRect2D scissor{};
     scissor.offset = {0, 0};
-    scissor.extent = m_VulkanContext.swapChain.GetExtent();
-    vkCmdSetScissor(m_VulkanContext.commandBuffers[m_CurrentFrame], 0, 1, &scissor);
+    scissor.extent = GetRenderExtent();
+    dispatch.vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+    std::array<VkDescriptorSet, 2> descriptorSets = {m_ClusteredLighting.GetDescriptorSet(m_CurrentFrame), m_MaterialSets[m_CurrentFrame].set};
+    dispatch.vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_VulkanContext.graphicsPipelineLayout, 0, static_cast<uint32_t>(descriptorSets.size()), descriptorSets.data(), 0, nullptr);
+
+    if (m_Settings.depthPrePass)
+    {
+        m_GpuProfiler.BeginScope(commandBuffer, "Depth Pre-Pass");
+        BeginPass(commandBuffer, true);
+
+        dispatch.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_VulkanContext.resources.GetPipeline(m_VulkanContext.depthPrePassPipeline)->pipeline);
+
+        dispatch.vkCmdBeginQuery(commandBuffer, occlusionQueryPool, 0, occlusionFlags);
+        RecordDraws(commandBuffer);
+        dispatch.vkCmdEndQuery(commandBuffer, occlusionQueryPool, 0);
+
+        EndPass(commandBuffer, true);
+        m_GpuProfiler.EndScope(commandBuffer);
+    };
+
+    m_GpuProfiler.BeginScope(commandBuffer, "Color Pass");
+    BeginPass(commandBuffer, false);
+
+    dispatch.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_VulkanContext.resources.GetPipeline(m_VulkanContext.graphicsPipeline)->pipeline);
+
+    dispatch.vkCmdBeginQuery(commandBuffer, occlusionQueryPool, 1, occlusionFlags);
+    if (m_PipelineStatisticsEnabled)
+    {
+        dispatch.vkCmdBeginQuery(commandBuffer, statisticsQueryPool, 0, 0);
+    };
+
+    RecordDraws(commandBuffer);
 
-    VkBuffer vertexBuffers[] = {m_VertexBuffer};
-    VkDeviceSize offsets[] = {0};
-    vkCmdBindVertexBuffers(m_VulkanContext.commandBuffers[m_CurrentFrame], 0, 1, vertexBuffers, offsets);
+    if (m_PipelineStatisticsEnabled)
+    {
+        dispatch.vkCmdEndQuery(commandBuffer, statisticsQueryPool, 0);
+    };
+    dispatch.vkCmdEndQuery(commandBuffer, occlusionQueryPool, 1);
+
+    if (m_ParticlesEnabled)
+    {
+        m_GpuProfiler.BeginScope(commandBuffer, "Particles");
+        m_ParticleSystem.Draw(commandBuffer, m_Camera);
+        m_GpuProfiler.EndScope(commandBuffer);
+    };
+
+    EndPass(commandBuffer, false);
+    m_GpuProfiler.EndScope(commandBuffer);
+
+    // Depth of this frame becomes the occluder set of the next one
+    if (m_OcclusionCulling)
+    {
+        m_GpuProfiler.BeginScope(commandBuffer, "Hi-Z Build");
+        m_HiZPyramid.Build(commandBuffer);
+        m_GpuProfiler.EndScope(commandBuffer);
+        m_HiZValid = true;
+    };
 
-    vkCmdDraw(m_VulkanContext.commandBuffers[m_CurrentFrame], static_cast<uint32_t>(m_Vertices.size()), 1, 0, 0);
+    if (m_UseDynamicRendering)
+    {
+        TransitionAttachments(commandBuffer, false);
+    };
 
-    vkCmdEndRenderPass(m_VulkanContext.commandBuffers[m_CurrentFrame]);
+    // The final image, copied out after everything that renders into it
+    m_FrameCapture.Capture(commandBuffer, m_CurrentFrame, m_FrameNumber, GetColorImage(m_CurrentBufferIndex), m_Headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+    m_FrameNumber++;
 
-    result = vkEndCommandBuffer(m_VulkanContext.commandBuffers[m_CurrentFrame]);
+    result = dispatch.vkEndCommandBuffer(commandBuffer);
 
     CORE_ASSERT(result == VK_SUCCESS, "Failed to record command buffer!");
+
+    m_QueriesPending[m_CurrentFrame] = true;
+    m_QueriedDrawCounts[m_CurrentFrame] = static_cast<uint32_t>(m_DrawList.Size());
 };
 
 void RenderLayer::OnRenderFrame()
 {
+    VKS_PROFILE_ZONE("Submit and Present");
+
+    const VulkanCore::DeviceDispatch &dispatch = m_VulkanContext.device.GetDispatch();
+
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-    VkSemaphore waitSemaphores[] = {m_VulkanContext.imageAvailableSemaphores[m_CurrentFrame]};
-    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-    submitInfo.waitSemaphoreCount = 1;
+    // Compute recorded this frame goes first, graphics only waits for it where its results are consumed.
+    VkSemaphore computeSemaphore = m_VulkanContext.computeScheduler.Submit(m_CurrentFrame);
+
+    VkSemaphore waitSemaphores[2];
+    VkPipelineStageFlags waitStages[2];
+    uint32_t waitCount = 0;
+
+    if (!m_Headless)
+    {
+        waitSemaphores[waitCount] = m_VulkanContext.imageAvailableSemaphores[m_CurrentFrame];
+        waitStages[waitCount++] = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    };
+
+    if (computeSemaphore != VK_NULL_HANDLE)
+    {
+        waitSemaphores[waitCount] = computeSemaphore;
+        waitStages[waitCount++] = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    };
+
+    submitInfo.waitSemaphoreCount = waitCount;
     submitInfo.pWaitSemaphores = waitSemaphores;
     submitInfo.pWaitDstStageMask = waitStages;
 
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &(m_VulkanContext.commandBuffers[m_CurrentFrame]);
 
-    VkSemaphore signalSemaphores[] = {m_VulkanContext.renderFinishedSemaphores[m_CurrentFrame]};
-    submitInfo.signalSemaphoreCount = 1;
+    // Once graphics is done reading them, compute may overwrite the shared resources next frame.
+    VkSemaphore signalSemaphores[2];
+    uint32_t signalCount = 0;
+
+    if (!m_Headless)
+    {
+        signalSemaphores[signalCount++] = m_VulkanContext.renderFinishedSemaphores[m_CurrentFrame];
+    };
+
+    if (computeSemaphore != VK_NULL_HANDLE)
+    {
+        signalSemaphores[signalCount++] = m_VulkanContext.computeScheduler.Release();
+    };
+
+    submitInfo.signalSemaphoreCount = signalCount;
     submitInfo.pSignalSemaphores = signalSemaphores;
 
-    VkResult result = vkQueueSubmit(m_VulkanContext.device.GetGraphicsQueue(), 1, &submitInfo, m_VulkanContext.inFlightFences[m_CurrentFrame]);
+    m_SubmitNs[m_CurrentFrame] = Profiling::NowNs();
+    VkResult result = dispatch.vkQueueSubmit(m_VulkanContext.device.GetGraphicsQueue(), 1, &submitInfo, m_VulkanContext.inFlightFences[m_CurrentFrame]);
 
     CORE_ASSERT(result == VK_SUCCESS, "Failed to submit draw command buffer!");
 
-    VkPresentInfoKHR presentInfo{};
-    presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-
+    // Nothing to present, the frame fence alone paces headless runs.
+    if (m_Headless)
+    {
+        m_CurrentFrame = (m_CurrentFrame + 1) % m_MAX_FRAMES_IN_FLIGHT;
+        return;
+    };
+
+    VkPresentInfoKHR presentInfo{};
+    presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+
     presentInfo.waitSemaphoreCount = 1;
     presentInfo.pWaitSemaphores = signalSemaphores;
 
@@ -378,7 +893,7 @@ void RenderLayer::OnRenderFrame()
 
     presentInfo.pImageIndices = &m_CurrentBufferIndex;
 
-    result = vkQueuePresentKHR(m_VulkanContext.device.GetPresentQueue(), &presentInfo);
+    result = dispatch.vkQueuePresentKHR(m_VulkanContext.device.GetPresentQueue(), &presentInfo);
 
     if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || m_FramebufferResized)
     {
@@ -397,6 +912,8 @@ void RenderLayer::OnCleanup()
 {
     vkDeviceWaitIdle(m_VulkanContext.device.Get());
 
+    m_FrameCapture.Destroy();
+
     for (size_t i = 0; i < m_MAX_FRAMES_IN_FLIGHT; i++)
     {
         vkDestroySemaphore(m_VulkanContext.device.Get(), m_VulkanContext.imageAvailableSemaphores[i], nullptr);
@@ -404,22 +921,75 @@ void RenderLayer::OnCleanup()
         vkDestroyFence(m_VulkanContext.device.Get(), m_VulkanContext.inFlightFences[i], nullptr);
     };
 
-    vkDestroyCommandPool(m_VulkanContext.device.Get(), m_VulkanContext.commandPool, nullptr);
+    if (m_OcclusionCulling)
+    {
+        m_HiZPyramid.Destroy();
+        m_OcclusionCuller.Destroy();
+    };
 
-    for (auto framebuffer : m_VulkanContext.swapChainFrameBuffers)
+    m_GeometryArena.Destroy();
+
+    m_Scene.Clear();
+    m_Hierarchy.Clear();
+    // Unmapped along with their memory when the resources are destroyed.
+    m_InstanceBuffers.clear();
+
+    m_GpuProfiler.Destroy();
+    if (m_CpuProfiling)
     {
-        vkDestroyFramebuffer(m_VulkanContext.device.Get(), framebuffer, nullptr);
+        m_CpuCollector.Destroy();
+    };
+    m_TraceWriter.Close();
+
+    m_VulkanContext.textureStreamer.Unregister(&m_MeshTexture);
+    m_MeshTexture.Destroy();
+    m_VulkanContext.textureStreamer.Destroy();
+    m_VulkanContext.samplerCache.Destroy();
+    m_VulkanContext.memoryBudget.Destroy();
+    if (m_ParticlesEnabled)
+    {
+        m_ParticleSystem.Destroy();
+    };
+
+    m_ClusteredLighting.Destroy();
+    m_VulkanContext.descriptorPool.Destroy();
+    m_VulkanContext.computeScheduler.Destroy();
+
+    for (auto queryPool : m_VulkanContext.queryPools)
+    {
+        if (queryPool != VK_NULL_HANDLE)
+        {
+            vkDestroyQueryPool(m_VulkanContext.device.Get(), queryPool, nullptr);
+        };
     };
 
-    vkDestroyPipeline(m_VulkanContext.device.Get(), m_VulkanContext.graphicsPipeline, nullptr);
+    vkDestroyCommandPool(m_VulkanContext.device.Get(), m_VulkanContext.commandPool, nullptr);
+
+    DestroyFrameBuffers();
+    m_VulkanContext.depthImage.Destroy();
+
+    // Vertex and index buffers and the graphics pipelines.
+    m_VulkanContext.resources.Destroy();
     vkDestroyPipelineLayout(m_VulkanContext.device.Get(), m_VulkanContext.graphicsPipelineLayout, nullptr);
-    vkDestroyRenderPass(m_VulkanContext.device.Get(), m_VulkanContext.renderPass, nullptr);
-    vkDestroyBuffer(m_VulkanContext.device.Get(), m_VertexBuffer, nullptr);
-    vkFreeMemory(m_VulkanContext.device.Get(), m_VertexBufferMemory, nullptr);
+    vkDestroyDescriptorSetLayout(m_VulkanContext.device.Get(), m_VulkanContext.materialSetLayout, nullptr);
+    if (m_VulkanContext.renderPass != VK_NULL_HANDLE)
+    {
+        vkDestroyRenderPass(m_VulkanContext.device.Get(), m_VulkanContext.renderPass, nullptr);
+    };
 
-    m_VulkanContext.swapChain.Destroy();
+    if (m_Headless)
+    {
+        DestroyOffscreenTargets();
+    }
+    else
+    {
+        m_VulkanContext.swapChain.Destroy();
+    };
     m_VulkanContext.device.Destroy();
-    m_VulkanContext.surface.Destroy();
+    if (!m_Headless)
+    {
+        m_VulkanContext.surface.Destroy();
+    };
     m_VulkanContext.instance.Destroy();
 };
 
@@ -436,11 +1006,9 @@ void RenderLayer::RecreateSwapChain()
 
     vkDeviceWaitIdle(m_VulkanContext.device.Get());
 
-    // Cleanup FrameBuffer
-    for (auto framebuffer : m_VulkanContext.swapChainFrameBuffers)
-    {
-        vkDestroyFramebuffer(m_VulkanContext.device.Get(), framebuffer, nullptr);
-    };
+    // Cleanup FrameBuffer and Depth
+    DestroyFrameBuffers();
+    m_VulkanContext.depthImage.Destroy();
 
     // Cleanup old SwapChain
     m_VulkanContext.swapChain.Destroy();
@@ -450,22 +1018,376 @@ void RenderLayer::RecreateSwapChain()
     swapChainConfig.format = VK_FORMAT_B8G8R8A8_SRGB;
     swapChainConfig.colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
     swapChainConfig.presentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+    swapChainConfig.imageUsage = m_Settings.capturePath.empty() ? 0 : VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
 
     m_VulkanContext.swapChain.Create(swapChainConfig, m_VulkanContext.device, m_VulkanContext.surface);
 
-    // Create New FrameBuffer
-    m_VulkanContext.swapChainFrameBuffers.resize(m_VulkanContext.swapChain.GetImageViews().size());
-    for (size_t i = 0; i < m_VulkanContext.swapChain.GetImageViews().size(); i++)
+    m_FrameCapture.Resize(GetRenderExtent());
+
+    m_Camera.viewportHeight = static_cast<float>(m_VulkanContext.swapChain.GetExtent().height);
+
+    if (m_Settings.lightCount > 0)
+    {
+        VkExtent2D extent = m_VulkanContext.swapChain.GetExtent();
+        m_Camera.SetPerspective(m_Camera.fovY, static_cast<float>(extent.width) / static_cast<float>(extent.height), m_Camera.nearPlane, m_Camera.farPlane);
+    };
+
+    // Create New Depth and FrameBuffer
+    CreateDepthResources();
+
+    if (m_OcclusionCulling)
+    {
+        m_HiZPyramid.Destroy();
+        CreateHiZPyramid();
+    };
+
+    if (!m_UseDynamicRendering)
+    {
+        CreateFrameBuffers();
+    };
+};
+
+void RenderLayer::CreateMesh()
+{
+    if (m_Settings.sphereRings == 0)
+    {
+        m_Vertices = {
+            {{0.0f, -0.5f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.5f, 0.0f}},
+            {{0.5f, 0.5f, 0.0f}, {0.0f, 1.0f, 0.0f}, {1.0f, 1.0f}},
+            {{-0.5f, 0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f}}};
+
+        m_Indices = {0, 1, 2};
+        return;
+    };
+
+    // UV sphere of the triangle's extent. The seam column and the poles are duplicated for their texture
+    // coordinates, the simplifier locks those open borders and collapses the rest of the surface.
+    const uint32_t rings = (std::max)(m_Settings.sphereRings, 2u);
+    const uint32_t segments = rings * 2;
+    const float radius = 0.5f;
+
+    m_Vertices.clear();
+    m_Vertices.reserve((rings + 1) * (segments + 1));
+    for (uint32_t ring = 0; ring <= rings; ring++)
+    {
+        float v = static_cast<float>(ring) / rings;
+        float polar = v * glm::radians(180.0f);
+
+        for (uint32_t segment = 0; segment <= segments; segment++)
+        {
+            float u = static_cast<float>(segment) / segments;
+            float azimuth = u * glm::radians(360.0f);
+
+            glm::vec3 direction(std::sin(polar) * std::cos(azimuth), -std::cos(polar), std::sin(polar) * std::sin(azimuth));
+            m_Vertices.push_back({direction * radius, direction * 0.5f + 0.5f, {u, v}});
+        };
+    };
+
+    m_Indices.clear();
+    m_Indices.reserve(rings * segments * 6);
+    for (uint32_t ring = 0; ring < rings; ring++)
+    {
+        for (uint32_t segment = 0; segment < segments; segment++)
+        {
+            uint32_t i0 = ring * (segments + 1) + segment;
+            uint32_t i1 = i0 + 1;
+            uint32_t i2 = i0 + segments + 1;
+            uint32_t i3 = i2 + 1;
+
+            // Wound like the triangle, facing outwards. The quads touching a pole degenerate to a single triangle.
+            if (ring != 0)
+            {
+                m_Indices.insert(m_Indices.end(), {i0, i2, i1});
+            };
+            if (ring != rings - 1)
+            {
+                m_Indices.insert(m_Indices.end(), {i1, i2, i3});
+            };
+        };
+    };
+};
+
+void RenderLayer::CreateLightScene()
+{
+    // Fixed seed, every run of the benchmark shades the same scene.
+    std::mt19937 generator(1337);
+    std::uniform_real_distribution<float> horizontal(-1.5f, 1.5f);
+    std::uniform_real_distribution<float> depth(-0.75f, 0.75f);
+    std::uniform_real_distribution<float> radius(0.15f, 0.4f);
+    std::uniform_real_distribution<float> channel(0.2f, 1.0f);
+
+    m_Lights.resize(m_Settings.lightCount);
+
+    for (Renderer::PointLight &light : m_Lights)
+    {
+        light.positionRadius = glm::vec4(horizontal(generator), horizontal(generator), depth(generator), radius(generator));
+        light.colorIntensity = glm::vec4(channel(generator), channel(generator), channel(generator), 1.0f);
+    };
+
+    // The vertices are authored in Vulkan clip space (y down), a y-up perspective camera keeps them upright.
+    VkExtent2D extent = GetRenderExtent();
+    m_Camera.SetPerspective(glm::radians(60.0f), static_cast<float>(extent.width) / static_cast<float>(extent.height), 0.1f, 100.0f);
+    m_Camera.LookAt(glm::vec3(0.0f, 0.0f, 2.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    CORE_LOG_INFO("Light benchmark: {0} point lights, {1} clusters", m_Lights.size(), m_ClusteredLighting.GetClusterCount());
+};
+
+void RenderLayer::UpdateLightScene(float deltaTime)
+{
+    VKS_PROFILE_FUNCTION();
+
+    // Orbit the lights about the view axis so the cluster assignment changes every frame.
+    float angle = deltaTime * 0.5f;
+    float cosAngle = std::cos(angle);
+    float sinAngle = std::sin(angle);
+
+    for (Renderer::PointLight &light : m_Lights)
+    {
+        float x = light.positionRadius.x;
+        float y = light.positionRadius.y;
+        light.positionRadius.x = x * cosAngle - y * sinAngle;
+        light.positionRadius.y = x * sinAngle + y * cosAngle;
+    };
+
+    // Assignments of this slot were written by its previous submission, which the frame fence has retired.
+    m_LightLogTimer += deltaTime;
+    if (m_LightLogTimer >= 1.0f)
+    {
+        float lightsPerCluster = static_cast<float>(m_ClusteredLighting.GetLightIndexCount(m_CurrentFrame)) / m_ClusteredLighting.GetClusterCount();
+        CORE_LOG_INFO("Lights: {0}, {1:.2f} per cluster, {2:.3f} ms frame", m_Lights.size(), lightsPerCluster, deltaTime * 1000.0f);
+        m_LightLogTimer = 0.0f;
+    };
+};
+
+void RenderLayer::CreateOffscreenTargets()
+{
+    // One color target per frame in flight, the fence of a frame makes its target reusable.
+    m_VulkanContext.offscreenImages.resize(m_MAX_FRAMES_IN_FLIGHT);
+    m_OffscreenImageViews.clear();
+
+    VulkanCore::ImageConfig colorConfig;
+    colorConfig.format = VK_FORMAT_R8G8B8A8_SRGB;
+    colorConfig.width = m_OffscreenExtent.width;
+    colorConfig.height = m_OffscreenExtent.height;
+    colorConfig.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    colorConfig.aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+
+    for (VulkanCore::Image &image : m_VulkanContext.offscreenImages)
+    {
+        image.Create(colorConfig, m_VulkanContext.device);
+        m_OffscreenImageViews.push_back(image.GetView());
+    };
+
+    CORE_LOG_INFO("Headless: rendering offscreen at {0}x{1}", m_OffscreenExtent.width, m_OffscreenExtent.height);
+};
+
+void RenderLayer::DestroyOffscreenTargets()
+{
+    for (VulkanCore::Image &image : m_VulkanContext.offscreenImages)
+    {
+        image.Destroy();
+    };
+
+    m_VulkanContext.offscreenImages.clear();
+    m_OffscreenImageViews.clear();
+};
+
+VkExtent2D RenderLayer::GetRenderExtent()
+{
+    return m_Headless ? m_OffscreenExtent : m_VulkanContext.swapChain.GetExtent();
+};
+
+VkFormat RenderLayer::GetColorFormat()
+{
+    return m_Headless ? m_VulkanContext.offscreenImages[0].GetFormat() : m_VulkanContext.swapChain.GetImageFormat();
+};
+
+VkImage RenderLayer::GetColorImage(uint32_t index)
+{
+    return m_Headless ? m_VulkanContext.offscreenImages[index].Get() : m_VulkanContext.swapChain.GetImage(index);
+};
+
+VkImageView RenderLayer::GetColorImageView(uint32_t index)
+{
+    return m_Headless ? m_OffscreenImageViews[index] : m_VulkanContext.swapChain.GetImageView(index);
+};
+
+const std::vector<VkImageView> &RenderLayer::GetColorImageViews()
+{
+    return m_Headless ? m_OffscreenImageViews : m_VulkanContext.swapChain.GetImageViews();
+};
+
+void RenderLayer::CreateRenderPass()
+{
+    VkAttachmentDescription colorAttachment{};
+    colorAttachment.format = GetColorFormat();
+    colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    colorAttachment.finalLayout = m_Headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+    VkAttachmentDescription depthAttachment{};
+    depthAttachment.format = m_VulkanContext.depthFormat;
+    depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.storeOp = m_TransientDepth ? VK_ATTACHMENT_STORE_OP_DONT_CARE : VK_ATTACHMENT_STORE_OP_STORE;
+    depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentReference colorAttachmentRef{};
+    colorAttachmentRef.attachment = 0;
+    colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentReference depthAttachmentRef{};
+    depthAttachmentRef.attachment = 1;
+    depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    // With a pre-pass, subpass 0 only writes depth and subpass 1 shades against it.
+    std::vector<VkSubpassDescription> subpasses;
+
+    if (m_Settings.depthPrePass)
+    {
+        VkSubpassDescription depthSubpass{};
+        depthSubpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        depthSubpass.colorAttachmentCount = 0;
+        depthSubpass.pDepthStencilAttachment = &depthAttachmentRef;
+        subpasses.push_back(depthSubpass);
+    };
+
+    VkSubpassDescription subpass{};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &colorAttachmentRef;
+    subpass.pDepthStencilAttachment = &depthAttachmentRef;
+    subpasses.push_back(subpass);
+
+    std::vector<VkSubpassDependency> dependencies;
+
+    VkSubpassDependency dependency{};
+    dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependency.dstSubpass = 0;
+    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies.push_back(dependency);
+
+    if (m_Settings.depthPrePass)
+    {
+        VkSubpassDependency prePassDependency{};
+        prePassDependency.srcSubpass = 0;
+        prePassDependency.dstSubpass = 1;
+        prePassDependency.srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        prePassDependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        prePassDependency.dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+        prePassDependency.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+        prePassDependency.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+        dependencies.push_back(prePassDependency);
+    };
+
+    std::array<VkAttachmentDescription, 2> attachments = {colorAttachment, depthAttachment};
+
+    VkRenderPassCreateInfo renderPassInfo{};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+    renderPassInfo.pAttachments = attachments.data();
+    renderPassInfo.subpassCount = static_cast<uint32_t>(subpasses.size());
+    renderPassInfo.pSubpasses = subpasses.data();
+    renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+    renderPassInfo.pDependencies = dependencies.data();
+
+    VkResult result = vkCreateRenderPass(m_VulkanContext.device.Get(), &renderPassInfo, nullptr, &(m_VulkanContext.renderPass));
+
+    CORE_ASSERT(result == VK_SUCCESS, "Failed to create render pass!");
+};
+
+void RenderLayer::CreateDepthResources()
+{
+    VulkanCore::ImageConfig depthConfig;
+    depthConfig.format = m_VulkanContext.depthFormat;
+    depthConfig.width = GetRenderExtent().width;
+    depthConfig.height = GetRenderExtent().height;
+    depthConfig.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+    if (m_OcclusionCulling)
+    {
+        depthConfig.usage |= VK_IMAGE_USAGE_SAMPLED_BIT;
+    };
+    depthConfig.aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+    depthConfig.memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+    // Tile based GPUs keep transient depth on chip and never back it with memory. Whether a lazily allocated type
+    // is one the depth image can use is only known from its memory requirements, the image falls back otherwise.
+    if (m_TransientDepth)
+    {
+        depthConfig.usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+        depthConfig.memoryProperties = VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+        depthConfig.fallbackMemoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    };
+
+    m_VulkanContext.depthImage.Create(depthConfig, m_VulkanContext.device);
+};
+
+void RenderLayer::CreateHiZPyramid()
+{
+    VulkanCore::SamplerConfig samplerConfig;
+    samplerConfig.magFilter = VK_FILTER_NEAREST;
+    samplerConfig.minFilter = VK_FILTER_NEAREST;
+    samplerConfig.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerConfig.addressMode = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+
+    VkSampler sampler = m_VulkanContext.samplerCache.Get(samplerConfig);
+
+    m_HiZPyramid.Create(m_VulkanContext.device, m_VulkanContext.depthImage.Get(), m_VulkanContext.depthImage.GetView(), m_VulkanContext.depthFormat, GetRenderExtent(), sampler);
+    m_OcclusionCuller.SetPyramid(m_HiZPyramid.GetView(), sampler, m_HiZPyramid.GetExtent(), m_HiZPyramid.GetLevelCount());
+    m_HiZValid = false;
+};
+
+void RenderLayer::UpdateMaterialSet(uint32_t frame)
+{
+    MaterialSet &materialSet = m_MaterialSets[frame];
+    if (materialSet.textureVersion == m_MeshTexture.GetVersion())
     {
-        VkImageView attachments[] = {m_VulkanContext.swapChain.GetImageViews()[i]};
+        return;
+    };
+
+    // Only this frame's set is rewritten, the other frames in flight may still be reading theirs.
+    VkDescriptorImageInfo imageInfo{};
+    imageInfo.sampler = m_VulkanContext.samplerCache.Get(VulkanCore::SamplerConfig{});
+    imageInfo.imageView = m_MeshTexture.GetView();
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkWriteDescriptorSet descriptorWrite{};
+    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrite.dstSet = materialSet.set;
+    descriptorWrite.dstBinding = 0;
+    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.pImageInfo = &imageInfo;
+
+    vkUpdateDescriptorSets(m_VulkanContext.device.Get(), 1, &descriptorWrite, 0, nullptr);
+
+    materialSet.textureVersion = m_MeshTexture.GetVersion();
+};
+
+void RenderLayer::CreateFrameBuffers()
+{
+    m_VulkanContext.swapChainFrameBuffers.resize(GetColorImageViews().size());
+    for (size_t i = 0; i < GetColorImageViews().size(); i++)
+    {
+        VkImageView attachments[] = {GetColorImageViews()[i], m_VulkanContext.depthImage.GetView()};
 
         VkFramebufferCreateInfo framebufferInfo{};
         framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
         framebufferInfo.renderPass = m_VulkanContext.renderPass;
-        framebufferInfo.attachmentCount = 1;
+        framebufferInfo.attachmentCount = 2;
         framebufferInfo.pAttachments = attachments;
-        framebufferInfo.width = m_VulkanContext.swapChain.GetExtent().width;
-        framebufferInfo.height = m_VulkanContext.swapChain.GetExtent().height;
+        framebufferInfo.width = GetRenderExtent().width;
+        framebufferInfo.height = GetRenderExtent().height;
         framebufferInfo.layers = 1;
 
         VkResult result = vkCreateFramebuffer(m_VulkanContext.device.Get(), &framebufferInfo, nullptr, &(m_VulkanContext.swapChainFrameBuffers[i]));
@@ -474,70 +1396,384 @@ void RenderLayer::RecreateSwapChain()
     };
 };
 
-void RenderLayer::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer &buffer, VkDeviceMemory &bufferMemory)
+void RenderLayer::DestroyFrameBuffers()
 {
+    for (auto framebuffer : m_VulkanContext.swapChainFrameBuffers)
+    {
+        vkDestroyFramebuffer(m_VulkanContext.device.Get(), framebuffer, nullptr);
+    };
 
-    VkBufferCreateInfo bufferInfo{};
-    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    bufferInfo.size = size;
-    bufferInfo.usage = usage;
-    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    m_VulkanContext.swapChainFrameBuffers.clear();
+};
 
-    VkResult result = vkCreateBuffer(m_VulkanContext.device.Get(), &bufferInfo, nullptr, &buffer);
+void RenderLayer::BeginPass(VkCommandBuffer commandBuffer, bool depthPrePass)
+{
+    const VulkanCore::DeviceDispatch &dispatch = m_VulkanContext.device.GetDispatch();
 
-    CORE_ASSERT(result == VK_SUCCESS, "Failed to create buffer!");
+    VkExtent2D extent = GetRenderExtent();
 
-    VkMemoryRequirements memRequirements;
-    vkGetBufferMemoryRequirements(m_VulkanContext.device.Get(), buffer, &memRequirements);
+    if (!m_UseDynamicRendering)
+    {
+        // The color pass is the second subpass of the same render pass when a pre-pass ran.
+        if (!depthPrePass && m_Settings.depthPrePass)
+        {
+            dispatch.vkCmdNextSubpass(commandBuffer, VK_SUBPASS_CONTENTS_INLINE);
+            return;
+        };
 
-    std::optional<uint32_t> memoryTypeIndex = VulkanCore::Utils::FindMemoryType(m_VulkanContext.device.GetPhysical(), memRequirements.memoryTypeBits, properties);
+        VkRenderPassBeginInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = m_VulkanContext.renderPass;
+        renderPassInfo.framebuffer = m_VulkanContext.swapChainFrameBuffers[m_CurrentBufferIndex];
+        renderPassInfo.renderArea.offset = {0, 0};
+        renderPassInfo.renderArea.extent = extent;
 
-    CORE_ASSERT(memoryTypeIndex.has_value(), "Failed to get memory type index!");
+        std::array<VkClearValue, 2> clearValues{};
+        clearValues[0].color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+        clearValues[1].depthStencil = {1.0f, 0};
+        renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+        renderPassInfo.pClearValues = clearValues.data();
 
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = memoryTypeIndex.value();
+        dispatch.vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        return;
+    };
 
-    result = vkAllocateMemory(m_VulkanContext.device.Get(), &allocInfo, nullptr, &bufferMemory);
+    VkRenderingAttachmentInfo colorAttachment{};
+    colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+    colorAttachment.imageView = GetColorImageView(m_CurrentBufferIndex);
+    colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.clearValue.color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+
+    // The color pass loads the depth laid down by the pre-pass.
+    bool loadDepth = !depthPrePass && m_Settings.depthPrePass;
+
+    VkRenderingAttachmentInfo depthAttachment{};
+    depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+    depthAttachment.imageView = m_VulkanContext.depthImage.GetView();
+    depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    depthAttachment.loadOp = loadDepth ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.storeOp = (depthPrePass || !m_TransientDepth) ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.clearValue.depthStencil = {1.0f, 0};
+
+    VkRenderingInfo renderingInfo{};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+    renderingInfo.renderArea.offset = {0, 0};
+    renderingInfo.renderArea.extent = extent;
+    renderingInfo.layerCount = 1;
+    renderingInfo.colorAttachmentCount = depthPrePass ? 0 : 1;
+    renderingInfo.pColorAttachments = depthPrePass ? nullptr : &colorAttachment;
+    renderingInfo.pDepthAttachment = &depthAttachment;
+
+    dispatch.vkCmdBeginRendering(commandBuffer, &renderingInfo);
+};
+
+void RenderLayer::EndPass(VkCommandBuffer commandBuffer, bool depthPrePass)
+{
+    const VulkanCore::DeviceDispatch &dispatch = m_VulkanContext.device.GetDispatch();
+
+    if (!m_UseDynamicRendering)
+    {
+        if (!depthPrePass)
+        {
+            dispatch.vkCmdEndRenderPass(commandBuffer);
+        };
+        return;
+    };
 
-    CORE_ASSERT(result == VK_SUCCESS, "Failed to allocate buffer memory!");
+    dispatch.vkCmdEndRendering(commandBuffer);
 
-    vkBindBufferMemory(m_VulkanContext.device.Get(), buffer, bufferMemory, 0);
+    if (depthPrePass)
+    {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = m_VulkanContext.depthImage.Get();
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, 1};
+        barrier.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+
+        dispatch.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    };
 };
 
-void RenderLayer::CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size)
+VkDrawIndexedIndirectCommand RenderLayer::BindColorPassState(VkCommandBuffer commandBuffer)
 {
-    VkCommandBufferAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandPool = m_VulkanContext.commandPool;
-    allocInfo.commandBufferCount = 1;
+    const VulkanCore::DeviceDispatch &dispatch = m_VulkanContext.device.GetDispatch();
 
-    VkCommandBuffer commandBuffer;
-    vkAllocateCommandBuffers(m_VulkanContext.device.Get(), &allocInfo, &commandBuffer);
+    VkViewport viewport{0.0f, 0.0f, static_cast<float>(GetRenderExtent().width), static_cast<float>(GetRenderExtent().height), 0.0f, 1.0f};
+    dispatch.vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
 
-    VkCommandBufferBeginInfo beginInfo{};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    VkRect2D scissor{{0, 0}, GetRenderExtent()};
+    dispatch.vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+    std::array<VkDescriptorSet, 2> descriptorSets = {m_ClusteredLighting.GetDescriptorSet(m_CurrentFrame), m_MaterialSets[m_CurrentFrame].set};
+    dispatch.vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_VulkanContext.graphicsPipelineLayout, 0, static_cast<uint32_t>(descriptorSets.size()), descriptorSets.data(), 0, nullptr);
 
-    vkBeginCommandBuffer(commandBuffer, &beginInfo);
+    VkDrawIndexedIndirectCommand draw{};
+    draw.indexCount = m_MeshLODs.levels[0].indexCount;
+    draw.instanceCount = 1;
+    draw.firstIndex = m_MeshLODs.levels[0].firstIndex;
 
-    VkBufferCopy copyRegion{};
-    copyRegion.size = size;
-    vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
+    if (m_VertexPulling)
+    {
+        dispatch.vkCmdBindIndexBuffer(commandBuffer, m_GeometryArena.GetBuffer(), 0, VK_INDEX_TYPE_UINT32);
+        draw.firstIndex += m_PulledMesh.firstIndex;
 
-    vkEndCommandBuffer(commandBuffer);
+        PullPushConstants pushConstants{};
+        pushConstants.viewProjection = m_Camera.GetViewProjection();
+        pushConstants.instances = m_InstanceBuffers[m_CurrentFrame].address;
+        pushConstants.vertices = m_PulledMesh.vertexAddress;
+        pushConstants.vertexFormat = static_cast<uint32_t>(m_PulledMesh.vertexFormat);
+        pushConstants.vertexStride = Renderer::GetVertexStride(m_PulledMesh.vertexFormat) / sizeof(uint32_t);
 
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffer;
+        dispatch.vkCmdPushConstants(commandBuffer, m_VulkanContext.graphicsPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PullPushConstants), &pushConstants);
+    }
+    else
+    {
+        VkBuffer vertexBuffer = m_VulkanContext.resources.GetBuffer(m_VertexBuffer)->buffer;
+        VkDeviceSize offset = 0;
+        dispatch.vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, &offset);
+        dispatch.vkCmdBindIndexBuffer(commandBuffer, m_VulkanContext.resources.GetBuffer(m_IndexBuffer)->buffer, 0, VK_INDEX_TYPE_UINT32);
+
+        PushConstants pushConstants{};
+        pushConstants.mvp = m_Camera.GetViewProjection();
+        pushConstants.model = glm::mat4(1.0f);
 
-    vkQueueSubmit(m_VulkanContext.device.GetGraphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(m_VulkanContext.device.GetGraphicsQueue());
+        dispatch.vkCmdPushConstants(commandBuffer, m_VulkanContext.graphicsPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstants), &pushConstants);
+    };
 
-    vkFreeCommandBuffers(m_VulkanContext.device.Get(), m_VulkanContext.commandPool, 1, &commandBuffer);
+    return draw;
+};
+
+void RenderLayer::TransitionAttachments(VkCommandBuffer commandBuffer, bool beginFrame)
+{
+    const VulkanCore::DeviceDispatch &dispatch = m_VulkanContext.device.GetDispatch();
+
+    // Without a render pass the layout transitions done by its attachment descriptions are explicit.
+    VkImageMemoryBarrier colorBarrier{};
+    colorBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    colorBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    colorBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    colorBarrier.image = GetColorImage(m_CurrentBufferIndex);
+    colorBarrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+
+    if (!beginFrame)
+    {
+        // Offscreen targets are left ready to be copied out.
+        colorBarrier.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        colorBarrier.newLayout = m_Headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        colorBarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        colorBarrier.dstAccessMask = m_Headless ? VK_ACCESS_TRANSFER_READ_BIT : 0;
+
+        dispatch.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, m_Headless ? VK_PIPELINE_STAGE_TRANSFER_BIT : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &colorBarrier);
+        return;
+    };
+
+    colorBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    colorBarrier.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorBarrier.srcAccessMask = 0;
+    colorBarrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+    VkImageMemoryBarrier depthBarrier{};
+    depthBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    depthBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    depthBarrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    depthBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    depthBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    depthBarrier.image = m_VulkanContext.depthImage.Get();
+    depthBarrier.subresourceRange = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, 1};
+    depthBarrier.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    depthBarrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    dispatch.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0, 0, nullptr, 0, nullptr, 1, &colorBarrier);
+    dispatch.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, 0, 0, nullptr, 0, nullptr, 1, &depthBarrier);
+};
+
+void RenderLayer::BuildDrawList()
+{
+    VKS_PROFILE_ZONE("Build Draw List");
+
+    m_DrawList.Clear();
+
+    // Levels are selected per entity, each keeping its own for the hysteresis. The texture streams in the levels
+    // the largest of the draws covers on screen.
+    auto addDraws = [this](const Scene::Entity *, uint32_t count, const Scene::LocalToWorld *localToWorld, const Scene::WorldBounds *bounds, Scene::MeshInstance *meshes)
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            meshes[i].lod = Renderer::SelectLOD(m_MeshLODs, glm::vec3(bounds[i].sphere), bounds[i].scale, m_Camera, meshes[i].lod, m_LODSelectionConfig);
+
+            float distance = glm::length(glm::vec3(bounds[i].sphere) - m_Camera.position) - bounds[i].sphere.w;
+            m_VulkanContext.textureStreamer.RequestMip(&m_MeshTexture, m_Camera.ProjectLength(2.0f * bounds[i].sphere.w, distance));
+
+            const Renderer::LODLevel &lod = m_MeshLODs.levels[meshes[i].lod];
+
+            Renderer::DrawCommand drawCommand{};
+            drawCommand.model = localToWorld[i].matrix;
+            drawCommand.instance = meshes[i].instance;
+            drawCommand.indexCount = lod.indexCount;
+            drawCommand.firstIndex = lod.firstIndex;
+            drawCommand.vertexBuffer = m_VertexBuffer;
+            drawCommand.indexBuffer = m_IndexBuffer;
+            if (m_VertexPulling)
+            {
+                drawCommand.firstIndex += m_PulledMesh.firstIndex;
+                drawCommand.vertexAddress = m_PulledMesh.vertexAddress;
+                drawCommand.vertexFormat = m_PulledMesh.vertexFormat;
+            };
+            drawCommand.boundingSphere = bounds[i].sphere;
+            drawCommand.viewDepth = -(m_Camera.view * glm::vec4(glm::vec3(bounds[i].sphere), 1.0f)).z;
+            m_DrawList.Add(drawCommand);
+        };
+    };
+
+    m_Scene.ForEachChunk<const Scene::LocalToWorld, const Scene::WorldBounds, Scene::MeshInstance>(addDraws);
+};
+
+void RenderLayer::RecordDraws(VkCommandBuffer commandBuffer)
+{
+    const VulkanCore::DeviceDispatch &dispatch = m_VulkanContext.device.GetDispatch();
+
+    glm::mat4 viewProjection = m_Camera.GetViewProjection();
+
+    const std::vector<Renderer::DrawCommand> &draws = m_DrawList.Get();
+    VulkanCore::BufferHandle boundVertexBuffer;
+    VulkanCore::BufferHandle boundIndexBuffer;
+    bool arenaBound = false;
+
+    for (size_t i = 0; i < draws.size(); i++)
+    {
+        // Pulled draws only push where their vertices are, the arena stays bound as the index buffer.
+        if (draws[i].vertexAddress != 0)
+        {
+            if (!arenaBound)
+            {
+                dispatch.vkCmdBindIndexBuffer(commandBuffer, m_GeometryArena.GetBuffer(), 0, VK_INDEX_TYPE_UINT32);
+                boundIndexBuffer = {};
+                arenaBound = true;
+            };
+
+            PullPushConstants pushConstants{};
+            pushConstants.viewProjection = viewProjection;
+            pushConstants.instances = m_InstanceBuffers[m_CurrentFrame].address;
+            pushConstants.vertices = draws[i].vertexAddress;
+            pushConstants.vertexFormat = static_cast<uint32_t>(draws[i].vertexFormat);
+            pushConstants.vertexStride = Renderer::GetVertexStride(draws[i].vertexFormat) / sizeof(uint32_t);
+            pushConstants.instance = draws[i].instance;
+
+            dispatch.vkCmdPushConstants(commandBuffer, m_VulkanContext.graphicsPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PullPushConstants), &pushConstants);
+        }
+        else
+        {
+            if (draws[i].vertexBuffer != boundVertexBuffer)
+            {
+                VkBuffer vertexBuffer = m_VulkanContext.resources.GetBuffer(draws[i].vertexBuffer)->buffer;
+                VkDeviceSize offset = 0;
+                dispatch.vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, &offset);
+                boundVertexBuffer = draws[i].vertexBuffer;
+            };
+
+            if (draws[i].indexBuffer != boundIndexBuffer)
+            {
+                dispatch.vkCmdBindIndexBuffer(commandBuffer, m_VulkanContext.resources.GetBuffer(draws[i].indexBuffer)->buffer, 0, VK_INDEX_TYPE_UINT32);
+                boundIndexBuffer = draws[i].indexBuffer;
+                arenaBound = false;
+            };
+
+            PushConstants pushConstants{};
+            pushConstants.mvp = viewProjection * draws[i].model;
+            pushConstants.model = draws[i].model;
+
+            dispatch.vkCmdPushConstants(commandBuffer, m_VulkanContext.graphicsPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstants), &pushConstants);
+        };
+
+        // Culled draws were given zero instances by the cull pass.
+        if (m_OcclusionCulling)
+        {
+            dispatch.vkCmdDrawIndexedIndirect(commandBuffer, m_OcclusionCuller.GetDrawBuffer(), i * sizeof(VkDrawIndexedIndirectCommand), 1, sizeof(VkDrawIndexedIndirectCommand));
+        }
+        else
+        {
+            dispatch.vkCmdDrawIndexed(commandBuffer, draws[i].indexCount, 1, draws[i].firstIndex, draws[i].vertexOffset, 0);
+        };
+    };
+};
+
+void RenderLayer::LogCpuZones()
+{
+    if (!m_Settings.logCpuZones)
+    {
+        return;
+    };
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - m_LastZoneLogTime < std::chrono::seconds(1))
+    {
+        return;
+    };
+    m_LastZoneLogTime = now;
+
+    // Slowest zones of the last frame the collector has finished.
+    std::vector<Profiling::ZoneStats> zones = m_CpuCollector.GetFrameZoneStats();
+    for (size_t i = 0; i < (std::min)(zones.size(), static_cast<size_t>(5)); i++)
+    {
+        CORE_LOG_INFO("CPU zone {0}: {1:.3f} ms over {2} calls", zones[i].name, zones[i].totalNs / 1e6, zones[i].calls);
+    };
+};
+
+void RenderLayer::ReadFrameStats()
+{
+    const VulkanCore::DeviceDispatch &dispatch = m_VulkanContext.device.GetDispatch();
+
+    Renderer::CullStats cullStats;
+    if (m_OcclusionCulling && m_OcclusionCuller.ReadStats(m_CurrentFrame, cullStats))
+    {
+        m_FrameStats.frustumCulled = cullStats.frustumCulled;
+        m_FrameStats.occlusionCulled = cullStats.occlusionCulled;
+    };
+
+    if (!m_QueriesPending[m_CurrentFrame])
+    {
+        return;
+    };
+
+    // The frame fence has signaled, so these never wait. Query 0 is only written with a pre-pass.
+    uint64_t occlusion[2] = {};
+    uint32_t firstQuery = m_Settings.depthPrePass ? 0 : 1;
+    VkResult result = dispatch.vkGetQueryPoolResults(m_VulkanContext.device.Get(), m_VulkanContext.queryPools[m_CurrentFrame * 2], firstQuery, 2 - firstQuery, sizeof(occlusion), &occlusion[firstQuery], sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+
+    if (result != VK_SUCCESS)
+    {
+        return;
+    };
+
+    m_FrameStats.drawCount = m_QueriedDrawCounts[m_CurrentFrame];
+    m_FrameStats.prePassSamples = m_Settings.depthPrePass ? occlusion[0] : 0;
+    m_FrameStats.colorPassSamples = occlusion[1];
+    m_FrameStats.overdrawEliminated = m_FrameStats.prePassSamples > m_FrameStats.colorPassSamples ? m_FrameStats.prePassSamples - m_FrameStats.colorPassSamples : 0;
+
+    if (m_PipelineStatisticsEnabled)
+    {
+        uint64_t invocations = 0;
+        result = dispatch.vkGetQueryPoolResults(m_VulkanContext.device.Get(), m_VulkanContext.queryPools[m_CurrentFrame * 2 + 1], 0, 1, sizeof(invocations), &invocations, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+
+        if (result == VK_SUCCESS)
+        {
+            m_FrameStats.fragmentShaderInvocations = invocations;
+        };
+    };
+
+    m_QueriesPending[m_CurrentFrame] = false;
+};
+
+void RenderLayer::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer &buffer, VkDeviceMemory &bufferMemory)
+{
+    VulkanCore::Utils::CreateBuffer(m_VulkanContext.device.Get(), m_VulkanContext.device.GetMemoryProperties(), size, usage, properties, buffer, bufferMemory);
 };
 
 void RenderLayer::OnResize(int width, int height)
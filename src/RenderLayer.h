@@ -3,22 +3,77 @@
 #include <vulkan/vulkan.h>
 #include <glm/glm.hpp>
 
+#include <chrono>
+#include <random>
+
 #include "Vulkan-Core/Types.h"
 #include "Vulkan-Core/Instance.h"
 #include "Vulkan-Core/Surface.h"
 #include "Vulkan-Core/Device.h"
 #include "Vulkan-Core/SwapChain.h"
 #include "Vulkan-Core/ShaderModule.h"
+#include "Vulkan-Core/SamplerCache.h"
+#include "Vulkan-Core/Texture.h"
+#include "Vulkan-Core/TextureStreamer.h"
+#include "Vulkan-Core/MemoryBudget.h"
+#include "Vulkan-Core/Image.h"
+#include "Vulkan-Core/ComputePipeline.h"
+#include "Vulkan-Core/ComputeScheduler.h"
+#include "Vulkan-Core/DescriptorPool.h"
+#include "Vulkan-Core/ResourcePool.h"
 #include "Vulkan-Core/Utils.h"
 
+#include "Renderer/Camera.h"
+#include "Renderer/MeshLOD.h"
+#include "Renderer/DrawList.h"
+#include "Renderer/FrameStats.h"
+#include "Renderer/ParticleSystem.h"
+#include "Renderer/HiZPyramid.h"
+#include "Renderer/OcclusionCuller.h"
+#include "Renderer/ClusteredLighting.h"
+#include "Renderer/GpuProfiler.h"
+#include "Renderer/FrameCapture.h"
+#include "Renderer/GeometryArena.h"
+
+#include "Scene/Registry.h"
+#include "Scene/Components.h"
+#include "Scene/TransformSystem.h"
+#include "Scene/TransformHierarchy.h"
+
+#include "Profiling/Clock.h"
+#include "Profiling/Profiler.h"
+#include "Profiling/TraceWriter.h"
+
 #include "Common.h"
 #include "Application.h"
 #include "Debug.h"
 
+struct PushConstants
+{
+    glm::mat4 mvp;
+    glm::mat4 model;
+};
+
+// Push constants of vertex_pull.vert, within the range of PushConstants so both paths share the pipeline layout.
+struct PullPushConstants
+{
+    glm::mat4 viewProjection;
+    // Scene::WorldRows of the frame, the model matrix is read from row instance.
+    VkDeviceAddress instances;
+    VkDeviceAddress vertices;
+    uint32_t vertexFormat;
+    // In 32-bit words.
+    uint32_t vertexStride;
+    uint32_t instance;
+};
+
+static_assert(sizeof(PullPushConstants) <= sizeof(PushConstants), "Vertex pulling push constants must fit the pipeline layout!");
+
 struct Vertex
 {
     glm::vec3 position;
     glm::vec3 color;
+    glm::vec2 uv;
 
     static VkVertexInputBindingDescription getBindingDescription()
     {
@@ -30,9 +85,9 @@ struct Vertex
         return bindingDescription;
     };
 
-    static std::array<VkVertexInputAttributeDescription, 2> getAttributeDescriptions()
+    static std::array<VkVertexInputAttributeDescription, 3> getAttributeDescriptions()
     {
-        std::array<VkVertexInputAttributeDescription, 2> attributeDescriptions{};
+        std::array<VkVertexInputAttributeDescription, 3> attributeDescriptions{};
 
         attributeDescriptions[0].binding = 0;
         attributeDescriptions[0].location = 0;
@@ -44,54 +99,227 @@ struct Vertex
         attributeDescriptions[1].format = VK_FORMAT_R32G32B32_SFLOAT;
         attributeDescriptions[1].offset = offsetof(Vertex, color);
 
+        attributeDescriptions[2].binding = 0;
+        attributeDescriptions[2].location = 2;
+        attributeDescriptions[2].format = VK_FORMAT_R32G32_SFLOAT;
+        attributeDescriptions[2].offset = offsetof(Vertex, uv);
+
         return attributeDescriptions;
     };
 };
 
+struct RenderSettings
+{
+    // Depth lives only on-chip (lazily allocated memory where available) and is never stored.
+    bool transientDepth = true;
+    // Lays down depth first so the color pass only shades visible fragments.
+    bool depthPrePass = false;
+    bool sortFrontToBack = true;
+    // Begin rendering against image views (Vulkan 1.3), no render pass or framebuffer objects.
+    bool dynamicRendering = false;
+    // Meshes live in a GeometryArena and the vertex shader fetches them through buffer device addresses, one
+    // pipeline for every vertex layout. Requires bufferDeviceAddress, falls back to vertex input.
+    bool vertexPulling = false;
+    // Draws are frustum and Hi-Z tested on the GPU against the previous frame's depth. Requires stored depth.
+    bool occlusionCulling = false;
+    // Capacity of the GPU particle system, 0 disables it.
+    uint32_t maxParticles = 0;
+    // Keeps the particle pool saturated and logs simulation throughput.
+    bool particleBenchmark = false;
+    // Latitude rings of a UV sphere drawn in place of the triangle, tessellated finely enough to build several
+    // LOD levels. 0 draws the triangle.
+    uint32_t sphereRings = 0;
+    // Point lights of the clustered lighting benchmark scene, 0 renders the scene unlit.
+    uint32_t lightCount = 0;
+    // Timestamp scopes around the passes, read back a few frames late.
+    bool gpuProfiling = false;
+    // Pipeline statistics per pass, replaces the color pass fragment invocation query.
+    bool profilePipelineStatistics = false;
+    // Chrome trace JSON of the GPU scopes and, with VKS_PROFILE, the CPU zones. Empty writes none.
+    std::string tracePath;
+    // Directory every rendered frame is written to, read back without stalling the frame loop. Empty captures none.
+    std::string capturePath;
+    Renderer::ImageFileFormat captureFormat = Renderer::ImageFileFormat::Png;
+    // Logs the slowest CPU zones of a frame once per second, requires VKS_PROFILE.
+    bool logCpuZones = false;
+    // Physical device index or name substring, empty picks the best scoring one. VKS_DEVICE takes precedence.
+    std::string preferredDevice;
+};
+
 struct VulkanContext
 {
     VulkanCore::Instance instance;
     VulkanCore::Surface surface;
     VulkanCore::Device device;
     VulkanCore::SwapChain swapChain;
+    // Stand-ins for the swapchain images in headless mode, one per frame in flight.
+    std::vector<VulkanCore::Image> offscreenImages;
     std::vector<VkFramebuffer> swapChainFrameBuffers;
-    VkRenderPass renderPass;
+    VulkanCore::Image depthImage;
+    VkFormat depthFormat;
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+    // Set 1 of the graphics pipeline, set 0 is the clustered lighting's.
+    VkDescriptorSetLayout materialSetLayout = VK_NULL_HANDLE;
     VkPipelineLayout graphicsPipelineLayout;
-    VkPipeline graphicsPipeline;
+    VulkanCore::PipelineHandle graphicsPipeline;
+    VulkanCore::PipelineHandle depthPrePassPipeline;
+    std::vector<VkQueryPool> queryPools;
     VkCommandPool commandPool;
     std::vector<VkCommandBuffer> commandBuffers;
     std::vector<VkSemaphore> imageAvailableSemaphores;
     std::vector<VkSemaphore> renderFinishedSemaphores;
     std::vector<VkFence> inFlightFences;
+    VulkanCore::SamplerCache samplerCache;
+    VulkanCore::TextureStreamer textureStreamer;
+    VulkanCore::MemoryBudget memoryBudget;
+    VulkanCore::ComputeScheduler computeScheduler;
+    VulkanCore::DescriptorPool descriptorPool;
+    VulkanCore::ResourcePool resources;
+};
+
+namespace Bench
+{
+    struct RenderLayerAccess;
 };
 
 class RenderLayer : public Layer
 {
 public:
+    RenderLayer() = default;
+    RenderLayer(const RenderSettings &settings) : m_Settings(settings){};
+
     virtual void OnInit(const AppInstanceData &appData) override;
     virtual void OnPrepareFrame() override;
     virtual void OnRenderFrame() override;
     virtual void OnCleanup() override;
     virtual void OnResize(int width, int height) override;
 
+    const Renderer::FrameStats &GetFrameStats() { return m_FrameStats; };
+    VulkanCore::Device &GetDevice() { return m_VulkanContext.device; };
+
 private:
-    void RecreateSwapChain();
+    // The microbenchmarks time buffer creation and draw recording outside of a frame.
+    friend struct Bench::RenderLayerAccess;
+
     void CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer &buffer, VkDeviceMemory &bufferMemory);
-    void CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
+    void BeginPass(VkCommandBuffer commandBuffer, bool depthPrePass);
+    void EndPass(VkCommandBuffer commandBuffer, bool depthPrePass);
+    // Binds the dynamic state, descriptor set, mesh buffers and push constants of the color pass, everything a
+    // draw of the mesh needs but the pipeline. Returns the draw of its full detail level.
+    VkDrawIndexedIndirectCommand BindColorPassState(VkCommandBuffer commandBuffer);
+
+    void RecreateSwapChain();
+    void CreateOffscreenTargets();
+    void DestroyOffscreenTargets();
+    VkExtent2D GetRenderExtent();
+    VkFormat GetColorFormat();
+    VkImage GetColorImage(uint32_t index);
+    VkImageView GetColorImageView(uint32_t index);
+    const std::vector<VkImageView> &GetColorImageViews();
+    void CreateRenderPass();
+    void CreateDepthResources();
+    void CreateHiZPyramid();
+    void CreateMesh();
+    void CreateLightScene();
+    void UpdateLightScene(float deltaTime);
+    void UpdateMaterialSet(uint32_t frame);
+    void CreateFrameBuffers();
+    void DestroyFrameBuffers();
+    void TransitionAttachments(VkCommandBuffer commandBuffer, bool beginFrame);
+    void RecordDraws(VkCommandBuffer commandBuffer);
+    void BuildDrawList();
+    void ReadFrameStats();
+    void LogCpuZones();
 
 private:
+    RenderSettings m_Settings;
     VulkanContext m_VulkanContext;
     void *m_Window = nullptr;
+    bool m_Headless = false;
+    VkExtent2D m_OffscreenExtent = {0, 0};
+    std::vector<VkImageView> m_OffscreenImageViews;
     const uint32_t m_MAX_FRAMES_IN_FLIGHT = 2;
     uint32_t m_CurrentFrame = 0;
     uint32_t m_CurrentBufferIndex;
     bool m_FramebufferResized = false;
 
-    const std::vector<Vertex> m_Vertices = {
-        {{0.0f, -0.5f, 0.0f}, {1.0f, 0.0f, 0.0f}},
-        {{0.5f, 0.5f, 0.0f}, {0.0f, 1.0f, 0.0f}},
-        {{-0.5f, 0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}}};
+    // The triangle, or the sphere of RenderSettings::sphereRings, written by CreateMesh.
+    std::vector<Vertex> m_Vertices;
+    std::vector<uint32_t> m_Indices;
+
+    // World matrices of the scene for vertex pulling, one host visible buffer per frame in flight.
+    struct InstanceBuffer
+    {
+        VulkanCore::BufferHandle buffer;
+        Scene::WorldRows *mapped = nullptr;
+        VkDeviceAddress address = 0;
+        // Hierarchy version the buffer's rows were last brought up to.
+        uint64_t version = 0;
+    };
+
+    VulkanCore::BufferHandle m_VertexBuffer;
+    VulkanCore::BufferHandle m_IndexBuffer;
+    // Streamed, its levels follow the on-screen size of the mesh's draws.
+    VulkanCore::Texture m_MeshTexture;
+
+    // The mesh texture and its sampler, one set per frame in flight. Streaming replaces the texture's image, a
+    // frame's set is rewritten before it is bound when its view is out of date.
+    struct MaterialSet
+    {
+        VkDescriptorSet set = VK_NULL_HANDLE;
+        // Texture version the set's image view belongs to.
+        uint32_t textureVersion = 0;
+    };
+
+    std::vector<MaterialSet> m_MaterialSets;
+    Renderer::GeometryArena m_GeometryArena;
+    Renderer::MeshAllocation m_PulledMesh;
+    bool m_VertexPulling = false;
+
+    Renderer::Camera m_Camera;
+    Renderer::LODChain m_MeshLODs;
+    Renderer::LODSelectionConfig m_LODSelectionConfig;
+
+    // Every drawn object is an entity placed on a hierarchy node, the triangle included.
+    Scene::Registry m_Scene;
+    Scene::TransformHierarchy m_Hierarchy;
+    // Hierarchy version the entities' world transforms were last brought up to, 0 until the first frame.
+    uint64_t m_SceneVersion = 0;
+    const uint32_t m_MAX_INSTANCES = 4096;
+    std::vector<InstanceBuffer> m_InstanceBuffers;
+
+    Renderer::DrawList m_DrawList;
+    Renderer::FrameStats m_FrameStats;
+    std::vector<bool> m_QueriesPending;
+    // Draws recorded in each frame slot, read back with that slot's queries.
+    std::vector<uint32_t> m_QueriedDrawCounts;
+    bool m_PipelineStatisticsEnabled = false;
+    bool m_UseDynamicRendering = false;
+    bool m_TransientDepth = true;
+
+    Renderer::HiZPyramid m_HiZPyramid;
+    Renderer::OcclusionCuller m_OcclusionCuller;
+    bool m_OcclusionCulling = false;
+    // The pyramid holds the depth of the previous frame, false until the first build after (re)creation.
+    bool m_HiZValid = false;
+
+    Renderer::ParticleSystem m_ParticleSystem;
+    bool m_ParticlesEnabled = false;
+    std::chrono::steady_clock::time_point m_LastFrameTime;
+    float m_StatsLogTimer = 0.0f;
+
+    Renderer::ClusteredLighting m_ClusteredLighting;
+    std::vector<Renderer::PointLight> m_Lights;
+    float m_LightLogTimer = 0.0f;
+
+    Renderer::GpuProfiler m_GpuProfiler;
+    // Host time of the last submit of each frame slot, matched against the slot's resolved GPU scopes.
+    std::vector<uint64_t> m_SubmitNs;
+    Profiling::TraceWriter m_TraceWriter;
+    Profiling::Collector m_CpuCollector;
+    bool m_CpuProfiling = false;
+    std::chrono::steady_clock::time_point m_LastZoneLogTime;
 
-    VkBuffer m_VertexBuffer;
-    VkDeviceMemory m_VertexBufferMemory;
+    Renderer::FrameCapture m_FrameCapture;
+    uint64_t m_FrameNumber = 0;
 };
\ No newline at end of file
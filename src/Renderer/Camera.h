@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cmath>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace Renderer
+{
+    struct Camera
+    {
+        glm::vec3 position = glm::vec3(0.0f);
+        glm::mat4 view = glm::mat4(1.0f);
+        glm::mat4 projection = glm::mat4(1.0f);
+        float fovY = glm::radians(60.0f);
+        float viewportHeight = 600.0f;
+        float nearPlane = 0.1f;
+        float farPlane = 100.0f;
+
+        glm::mat4 GetViewProjection() const { return projection * view; };
+
+        // Right handed with a [0, 1] depth range, as Vulkan clips.
+        void SetPerspective(float fov, float aspect, float zNear, float zFar)
+        {
+            fovY = fov;
+            nearPlane = zNear;
+            farPlane = zFar;
+            projection = glm::perspectiveRH_ZO(fov, aspect, zNear, zFar);
+        };
+
+        void LookAt(const glm::vec3 &eye, const glm::vec3 &target, const glm::vec3 &up)
+        {
+            position = eye;
+            view = glm::lookAt(eye, target, up);
+        };
+
+        // Size in pixels of a world-space length seen at the given distance.
+        float ProjectLength(float length, float distance) const
+        {
+            return length / ((std::max)(distance, 1e-4f) * std::tan(fovY * 0.5f)) * (viewportHeight * 0.5f);
+        };
+    };
+
+};
@@ -0,0 +1,176 @@
+#include "ClusteredLighting.h"
+#include "../Vulkan-Core/Utils.h"
+#include "../Log.h"
+
+#include <cmath>
+
+namespace Renderer
+{
+    namespace
+    {
+        // Mirrors ClusterUniforms (std140) of light_cluster.comp and shader.frag.
+        struct ClusterUniforms
+        {
+            glm::mat4 view;
+            glm::mat4 inverseProjection;
+            glm::uvec4 gridSize;
+            glm::vec4 screen;
+            glm::vec4 sliceParams;
+            glm::vec4 cameraPosition;
+            glm::vec4 ambient;
+        };
+
+        struct LightIndexCounter
+        {
+            uint32_t count;
+            uint32_t capacity;
+        };
+
+        const uint32_t CLUSTER_GROUP_SIZE = 64;
+    };
+
+    void ClusteredLighting::Create(const ClusteredLightingConfig &config, const VulkanCore::Device &device, VulkanCore::DescriptorPool &descriptorPool)
+    {
+        m_Config = config;
+        m_DeviceInst = &device;
+
+        VkDevice vkDevice = m_DeviceInst->Get();
+        const VkPhysicalDeviceMemoryProperties &memoryProperties = m_DeviceInst->GetMemoryProperties();
+
+        // Bindings 0-3 are also read by the fragment shader through the same set.
+        VkShaderStageFlags sharedStages = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+
+        VulkanCore::ComputePipelineConfig pipelineConfig;
+        pipelineConfig.shaderPath = "assets/shaders/spv/light_cluster.comp.spv";
+        pipelineConfig.localSizeX = CLUSTER_GROUP_SIZE;
+        pipelineConfig.bindings = {
+            {0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, sharedStages, nullptr},
+            {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, sharedStages, nullptr},
+            {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, sharedStages, nullptr},
+            {3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, sharedStages, nullptr},
+            {4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}};
+
+        m_ClusterPipeline.Create(pipelineConfig, *m_DeviceInst);
+
+        VulkanCore::Utils::CreateBuffer(vkDevice, memoryProperties, GetClusterCount() * 2 * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_LightGridBuffer, m_LightGridBufferMemory);
+        VulkanCore::Utils::CreateBuffer(vkDevice, memoryProperties, m_Config.maxLightIndices * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_LightIndexBuffer, m_LightIndexBufferMemory);
+
+        VkDeviceSize alignment = m_DeviceInst->GetProperties().limits.minStorageBufferOffsetAlignment;
+        m_CounterStride = (sizeof(LightIndexCounter) + alignment - 1) / alignment * alignment;
+
+        VulkanCore::Utils::CreateBuffer(vkDevice, memoryProperties, m_Config.framesInFlight * m_CounterStride, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_CounterBuffer, m_CounterBufferMemory);
+        vkMapMemory(vkDevice, m_CounterBufferMemory, 0, VK_WHOLE_SIZE, 0, &m_CounterData);
+
+        m_UniformBuffers.resize(m_Config.framesInFlight);
+        m_UniformBufferMemory.resize(m_Config.framesInFlight);
+        m_UniformData.resize(m_Config.framesInFlight);
+        m_LightBuffers.resize(m_Config.framesInFlight);
+        m_LightBufferMemory.resize(m_Config.framesInFlight);
+        m_LightData.resize(m_Config.framesInFlight);
+        m_LightCounts.resize(m_Config.framesInFlight, 0);
+        m_DescriptorSets.resize(m_Config.framesInFlight);
+
+        VkDeviceSize lightBufferSize = (std::max)(m_Config.maxLights, 1u) * sizeof(PointLight);
+
+        for (uint32_t i = 0; i < m_Config.framesInFlight; i++)
+        {
+            VulkanCore::Utils::CreateBuffer(vkDevice, memoryProperties, sizeof(ClusterUniforms), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_UniformBuffers[i], m_UniformBufferMemory[i]);
+            vkMapMemory(vkDevice, m_UniformBufferMemory[i], 0, sizeof(ClusterUniforms), 0, &m_UniformData[i]);
+
+            VulkanCore::Utils::CreateBuffer(vkDevice, memoryProperties, lightBufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_LightBuffers[i], m_LightBufferMemory[i]);
+            vkMapMemory(vkDevice, m_LightBufferMemory[i], 0, lightBufferSize, 0, &m_LightData[i]);
+
+            m_DescriptorSets[i] = descriptorPool.Allocate(m_ClusterPipeline.GetDescriptorSetLayout());
+
+            VulkanCore::Utils::WriteBufferDescriptor(vkDevice, m_DescriptorSets[i], 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, m_UniformBuffers[i]);
+            VulkanCore::Utils::WriteBufferDescriptor(vkDevice, m_DescriptorSets[i], 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, m_LightBuffers[i]);
+            VulkanCore::Utils::WriteBufferDescriptor(vkDevice, m_DescriptorSets[i], 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, m_LightGridBuffer);
+            VulkanCore::Utils::WriteBufferDescriptor(vkDevice, m_DescriptorSets[i], 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, m_LightIndexBuffer);
+
+            VkDescriptorBufferInfo counterInfo{m_CounterBuffer, i * m_CounterStride, sizeof(LightIndexCounter)};
+
+            VkWriteDescriptorSet descriptorWrite{};
+            descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptorWrite.dstSet = m_DescriptorSets[i];
+            descriptorWrite.dstBinding = 4;
+            descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            descriptorWrite.descriptorCount = 1;
+            descriptorWrite.pBufferInfo = &counterInfo;
+
+            vkUpdateDescriptorSets(vkDevice, 1, &descriptorWrite, 0, nullptr);
+        };
+    };
+
+    void ClusteredLighting::Destroy()
+    {
+        VkDevice vkDevice = m_DeviceInst->Get();
+
+        for (uint32_t i = 0; i < m_Config.framesInFlight; i++)
+        {
+            vkUnmapMemory(vkDevice, m_UniformBufferMemory[i]);
+            vkDestroyBuffer(vkDevice, m_UniformBuffers[i], nullptr);
+            vkFreeMemory(vkDevice, m_UniformBufferMemory[i], nullptr);
+            vkUnmapMemory(vkDevice, m_LightBufferMemory[i]);
+            vkDestroyBuffer(vkDevice, m_LightBuffers[i], nullptr);
+            vkFreeMemory(vkDevice, m_LightBufferMemory[i], nullptr);
+        };
+
+        vkUnmapMemory(vkDevice, m_CounterBufferMemory);
+        vkDestroyBuffer(vkDevice, m_CounterBuffer, nullptr);
+        vkFreeMemory(vkDevice, m_CounterBufferMemory, nullptr);
+        vkDestroyBuffer(vkDevice, m_LightIndexBuffer, nullptr);
+        vkFreeMemory(vkDevice, m_LightIndexBufferMemory, nullptr);
+        vkDestroyBuffer(vkDevice, m_LightGridBuffer, nullptr);
+        vkFreeMemory(vkDevice, m_LightGridBufferMemory, nullptr);
+
+        m_ClusterPipeline.Destroy();
+    };
+
+    void ClusteredLighting::Update(uint32_t frame, const std::vector<PointLight> &lights, const Camera &camera, VkExtent2D extent, const glm::vec3 &ambient)
+    {
+        uint32_t lightCount = static_cast<uint32_t>((std::min)(lights.size(), static_cast<size_t>(m_Config.maxLights)));
+        memcpy(m_LightData[frame], lights.data(), lightCount * sizeof(PointLight));
+        m_LightCounts[frame] = lightCount;
+
+        float sliceRange = std::log(camera.farPlane / camera.nearPlane);
+
+        ClusterUniforms uniforms{};
+        uniforms.view = camera.view;
+        uniforms.inverseProjection = glm::inverse(camera.projection);
+        uniforms.gridSize = glm::uvec4(m_Config.gridX, m_Config.gridY, m_Config.gridZ, lightCount);
+        uniforms.screen = glm::vec4(static_cast<float>(extent.width), static_cast<float>(extent.height), camera.nearPlane, camera.farPlane);
+        uniforms.sliceParams = glm::vec4(m_Config.gridZ / sliceRange, m_Config.gridZ * std::log(camera.nearPlane) / sliceRange,
+                                         static_cast<float>(extent.width) / m_Config.gridX, static_cast<float>(extent.height) / m_Config.gridY);
+        uniforms.cameraPosition = glm::vec4(camera.position, 1.0f);
+        uniforms.ambient = glm::vec4(ambient, 0.0f);
+
+        memcpy(m_UniformData[frame], &uniforms, sizeof(uniforms));
+    };
+
+    void ClusteredLighting::Build(VkCommandBuffer commandBuffer, uint32_t frame)
+    {
+        const VulkanCore::DeviceDispatch &dispatch = m_DeviceInst->GetDispatch();
+
+        // The grid and index list are shared by all frames, the previous frame's shading must be done with them.
+        VulkanCore::Utils::GlobalBarrier(dispatch, commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0);
+
+        LightIndexCounter counter{0, m_Config.maxLightIndices};
+        dispatch.vkCmdUpdateBuffer(commandBuffer, m_CounterBuffer, frame * m_CounterStride, sizeof(counter), &counter);
+
+        VulkanCore::Utils::GlobalBarrier(dispatch, commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+        m_ClusterPipeline.Bind(commandBuffer);
+        m_ClusterPipeline.BindDescriptorSet(commandBuffer, m_DescriptorSets[frame]);
+        m_ClusterPipeline.DispatchThreads(commandBuffer, GetClusterCount());
+
+        VulkanCore::Utils::GlobalBarrier(dispatch, commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_HOST_READ_BIT);
+    };
+
+    uint32_t ClusteredLighting::GetLightIndexCount(uint32_t frame)
+    {
+        const LightIndexCounter *counter = reinterpret_cast<const LightIndexCounter *>(static_cast<const char *>(m_CounterData) + frame * m_CounterStride);
+
+        return (std::min)(counter->count, m_Config.maxLightIndices);
+    };
+
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+
+#include "../Common.h"
+#include "../Vulkan-Core/Device.h"
+#include "../Vulkan-Core/ComputePipeline.h"
+#include "../Vulkan-Core/DescriptorPool.h"
+#include "Camera.h"
+
+namespace Renderer
+{
+    struct PointLight
+    {
+        // World-space position, w is the range.
+        glm::vec4 positionRadius;
+        // Linear color, w is the intensity.
+        glm::vec4 colorIntensity;
+    };
+
+    struct ClusteredLightingConfig
+    {
+        // Screen tiles by exponential depth slices.
+        uint32_t gridX = 16;
+        uint32_t gridY = 9;
+        uint32_t gridZ = 24;
+        uint32_t maxLights = 10000;
+        // Capacity of the compact index list shared by all clusters.
+        uint32_t maxLightIndices = 1 << 20;
+        uint32_t framesInFlight = 2;
+    };
+
+    // Clustered forward shading: a compute pass bins the lights into a froxel grid, building one run of light
+    // indices per cluster, and the fragment shader only walks the run of the cluster it falls in.
+    class ClusteredLighting
+    {
+    public:
+        ClusteredLighting() = default;
+        ~ClusteredLighting() = default;
+        ClusteredLighting(const ClusteredLighting &) = delete;
+        ClusteredLighting &operator=(const ClusteredLighting &) = delete;
+
+        void Create(const ClusteredLightingConfig &config, const VulkanCore::Device &device, VulkanCore::DescriptorPool &descriptorPool);
+        void Destroy();
+
+        // Writes the frame's camera and lights, the frame slot must not be in flight.
+        void Update(uint32_t frame, const std::vector<PointLight> &lights, const Camera &camera, VkExtent2D extent, const glm::vec3 &ambient);
+        // Records the light assignment, before any pass that shades with the grid.
+        void Build(VkCommandBuffer commandBuffer, uint32_t frame);
+
+        // Set 0 of the shading pipelines, shared with the compute pass.
+        VkDescriptorSetLayout GetDescriptorSetLayout() { return m_ClusterPipeline.GetDescriptorSetLayout(); };
+        VkDescriptorSet GetDescriptorSet(uint32_t frame) { return m_DescriptorSets[frame]; };
+        // Indices written by the last Build of the frame slot, read once it has finished executing.
+        uint32_t GetLightIndexCount(uint32_t frame);
+        uint32_t GetClusterCount() { return m_Config.gridX * m_Config.gridY * m_Config.gridZ; };
+
+    private:
+        ClusteredLightingConfig m_Config;
+        const VulkanCore::Device *m_DeviceInst = nullptr;
+        VulkanCore::ComputePipeline m_ClusterPipeline;
+        std::vector<VkDescriptorSet> m_DescriptorSets;
+
+        // Per frame, written by the CPU.
+        std::vector<VkBuffer> m_UniformBuffers;
+        std::vector<VkDeviceMemory> m_UniformBufferMemory;
+        std::vector<void *> m_UniformData;
+        std::vector<VkBuffer> m_LightBuffers;
+        std::vector<VkDeviceMemory> m_LightBufferMemory;
+        std::vector<void *> m_LightData;
+        std::vector<uint32_t> m_LightCounts;
+
+        // Per frame slots of the index list allocator, read back on the host.
+        VkBuffer m_CounterBuffer;
+        VkDeviceMemory m_CounterBufferMemory;
+        void *m_CounterData = nullptr;
+        VkDeviceSize m_CounterStride = 0;
+
+        VkBuffer m_LightGridBuffer;
+        VkDeviceMemory m_LightGridBufferMemory;
+        VkBuffer m_LightIndexBuffer;
+        VkDeviceMemory m_LightIndexBufferMemory;
+    };
+
+};
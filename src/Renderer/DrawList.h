@@ -0,0 +1,52 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "../Common.h"
+#include "../Vulkan-Core/Types.h"
+#include "GeometryArena.h"
+
+namespace Renderer
+{
+    struct DrawCommand
+    {
+        glm::mat4 model = glm::mat4(1.0f);
+        uint32_t indexCount;
+        uint32_t firstIndex;
+        int32_t vertexOffset = 0;
+        // Resolved through the ResourcePool at record time, rebound only when they change between draws.
+        VulkanCore::BufferHandle vertexBuffer;
+        VulkanCore::BufferHandle indexBuffer;
+        // Set for meshes in the GeometryArena, drawn by vertex pulling: the buffer handles are unused and firstIndex
+        // is relative to the arena.
+        VkDeviceAddress vertexAddress = 0;
+        VertexFormat vertexFormat = VertexFormat::PositionColorUV;
+        // Row of the model matrix in the frame's instance buffer, pulled draws read it there instead of model.
+        uint32_t instance = 0;
+        // World-space center and radius, used for culling.
+        glm::vec4 boundingSphere = glm::vec4(0.0f);
+        // Distance along the camera view direction, used for ordering.
+        float viewDepth = 0.0f;
+    };
+
+    class DrawList
+    {
+    public:
+        void Clear() { m_Commands.clear(); };
+        void Add(const DrawCommand &command) { m_Commands.push_back(command); };
+
+        // Nearest first, so early depth testing rejects the fragments of everything drawn behind.
+        void SortFrontToBack()
+        {
+            std::sort(m_Commands.begin(), m_Commands.end(), [](const DrawCommand &a, const DrawCommand &b)
+                      { return a.viewDepth < b.viewDepth; });
+        };
+
+        const std::vector<DrawCommand> &Get() const { return m_Commands; };
+        size_t Size() const { return m_Commands.size(); };
+
+    private:
+        std::vector<DrawCommand> m_Commands;
+    };
+
+};
@@ -0,0 +1,370 @@
+#include "FrameCapture.h"
+#include "../Vulkan-Core/Utils.h"
+#include "../Log.h"
+
+#include <cstdio>
+#include <filesystem>
+
+namespace Renderer
+{
+    void FrameCapture::Create(const FrameCaptureConfig &config, const VulkanCore::Device &device)
+    {
+        m_Config = config;
+        m_DeviceInst = &device;
+
+        switch (m_Config.format)
+        {
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_R8G8B8A8_SRGB:
+            m_SwapRedBlue = false;
+            break;
+        case VK_FORMAT_B8G8R8A8_UNORM:
+        case VK_FORMAT_B8G8R8A8_SRGB:
+            m_SwapRedBlue = true;
+            break;
+        default:
+            CORE_LOG_WARN("Frame capture: unsupported color format {0}, capture disabled.", static_cast<int>(m_Config.format));
+            return;
+        };
+
+        std::error_code error;
+        std::filesystem::create_directories(m_Config.directory, error);
+        if (error)
+        {
+            CORE_LOG_WARN("Frame capture: cannot create {0} ({1}), capture disabled.", m_Config.directory, error.message());
+            return;
+        };
+
+        // Reading back through cached memory is several times faster than through write-combined memory.
+        uint32_t memoryTypeBits = m_DeviceInst->GetBufferMemoryTypeBits(VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+        m_Coherent = !VulkanCore::Utils::HasMemoryProperty(m_DeviceInst->GetMemoryProperties(), memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+
+        uint32_t workerCount = m_Config.workerCount;
+        if (workerCount == 0)
+        {
+            workerCount = (std::max)(std::thread::hardware_concurrency() / 2, 1u);
+        };
+
+        // Enough for the frames in flight, one frame per busy writer and a little slack for encoding jitter.
+        if (m_Config.bufferCount == 0)
+        {
+            m_Config.bufferCount = m_Config.framesInFlight + workerCount + 2;
+        };
+
+        m_Config.bufferCount = (std::max)(m_Config.bufferCount, m_Config.framesInFlight + 1);
+        CreateBuffers();
+
+        SetPngCompressionLevel(m_Config.pngCompressionLevel);
+
+        m_Stopping = false;
+        for (uint32_t i = 0; i < workerCount; i++)
+        {
+            m_Workers.emplace_back(&FrameCapture::WorkerLoop, this);
+        };
+
+        m_Enabled = true;
+
+        CORE_LOG_INFO("Frame capture: {0}x{1} {2} to {3}, {4} readback buffers, {5} writers", m_Config.extent.width, m_Config.extent.height, GetImageFileExtension(m_Config.fileFormat), m_Config.directory, m_Config.bufferCount, workerCount);
+    };
+
+    void FrameCapture::Destroy()
+    {
+        if (!m_Enabled)
+        {
+            return;
+        };
+
+        // The device is idle, every copy still marked in flight has landed.
+        for (uint32_t frame = 0; frame < m_Config.framesInFlight; frame++)
+        {
+            Collect(frame);
+        };
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stopping = true;
+        };
+
+        m_QueueCondition.notify_all();
+        for (std::thread &worker : m_Workers)
+        {
+            worker.join();
+        };
+
+        m_Workers.clear();
+        DestroyBuffers();
+        m_Enabled = false;
+
+        FrameCaptureStats stats = GetStats();
+        CORE_LOG_INFO("Frame capture: {0} captured, {1} written, {2} dropped, {3} failed", stats.captured, stats.written, stats.dropped, stats.failed);
+    };
+
+    void FrameCapture::Resize(VkExtent2D extent)
+    {
+        if (!m_Enabled)
+        {
+            return;
+        };
+
+        for (uint32_t frame = 0; frame < m_Config.framesInFlight; frame++)
+        {
+            Collect(frame);
+        };
+
+        WaitForWriters();
+        DestroyBuffers();
+
+        m_Config.extent = extent;
+        CreateBuffers();
+    };
+
+    bool FrameCapture::Capture(VkCommandBuffer commandBuffer, uint32_t frame, uint64_t frameNumber, VkImage image, VkImageLayout layout)
+    {
+        const VulkanCore::DeviceDispatch &dispatch = m_DeviceInst->GetDispatch();
+
+        if (!m_Enabled)
+        {
+            return false;
+        };
+
+        Slot *slot = nullptr;
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            for (uint32_t i = 0; i < m_Slots.size(); i++)
+            {
+                uint32_t index = (m_NextSlot + i) % static_cast<uint32_t>(m_Slots.size());
+                if (m_Slots[index].state == SlotState::Free)
+                {
+                    slot = &m_Slots[index];
+                    m_NextSlot = (index + 1) % static_cast<uint32_t>(m_Slots.size());
+                    break;
+                };
+            };
+
+            if (slot == nullptr)
+            {
+                m_Stats.dropped++;
+                return false;
+            };
+
+            slot->state = SlotState::InFlight;
+            slot->frame = frame;
+            slot->frameNumber = frameNumber;
+            m_Stats.captured++;
+        };
+
+        VkImageMemoryBarrier imageBarrier{};
+        imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        imageBarrier.oldLayout = layout;
+        imageBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.image = image;
+        imageBarrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+        imageBarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        imageBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+        // All commands: the final layout transition of a render pass only chains with the implicit external
+        // dependency, whose second scope is the bottom of the pipe.
+        dispatch.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageBarrier);
+
+        VkBufferImageCopy region{};
+        region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+        region.imageExtent = {m_Config.extent.width, m_Config.extent.height, 1};
+
+        dispatch.vkCmdCopyImageToBuffer(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, slot->buffer, 1, &region);
+
+        VkBufferMemoryBarrier bufferBarrier{};
+        bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        bufferBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        bufferBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        bufferBarrier.buffer = slot->buffer;
+        bufferBarrier.size = VK_WHOLE_SIZE;
+
+        uint32_t imageBarrierCount = 0;
+        if (layout != VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL)
+        {
+            imageBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            imageBarrier.newLayout = layout;
+            imageBarrier.srcAccessMask = 0;
+            imageBarrier.dstAccessMask = 0;
+            imageBarrierCount = 1;
+        };
+
+        dispatch.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT | VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 1, &bufferBarrier, imageBarrierCount, &imageBarrier);
+
+        return true;
+    };
+
+    void FrameCapture::Collect(uint32_t frame)
+    {
+        if (!m_Enabled)
+        {
+            return;
+        };
+
+        bool queued = false;
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            for (uint32_t i = 0; i < m_Slots.size(); i++)
+            {
+                if (m_Slots[i].state == SlotState::InFlight && m_Slots[i].frame == frame)
+                {
+                    m_Slots[i].state = SlotState::Writing;
+                    m_Queue.push_back(i);
+                    queued = true;
+                };
+            };
+        };
+
+        if (queued)
+        {
+            m_QueueCondition.notify_all();
+        };
+    };
+
+    FrameCaptureStats FrameCapture::GetStats()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Stats;
+    };
+
+    void FrameCapture::CreateBuffers()
+    {
+        VkDeviceSize size = static_cast<VkDeviceSize>(m_Config.extent.width) * m_Config.extent.height * 4;
+        VkMemoryPropertyFlags properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | (m_Coherent ? VK_MEMORY_PROPERTY_HOST_COHERENT_BIT : VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+
+        m_Slots.resize(m_Config.bufferCount);
+        m_NextSlot = 0;
+
+        for (Slot &slot : m_Slots)
+        {
+            VulkanCore::Utils::CreateBuffer(m_DeviceInst->Get(), m_DeviceInst->GetMemoryProperties(), size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, properties, slot.buffer, slot.memory);
+
+            void *data;
+            vkMapMemory(m_DeviceInst->Get(), slot.memory, 0, VK_WHOLE_SIZE, 0, &data);
+            slot.data = static_cast<const uint8_t *>(data);
+            slot.state = SlotState::Free;
+        };
+    };
+
+    void FrameCapture::DestroyBuffers()
+    {
+        for (Slot &slot : m_Slots)
+        {
+            vkUnmapMemory(m_DeviceInst->Get(), slot.memory);
+            vkDestroyBuffer(m_DeviceInst->Get(), slot.buffer, nullptr);
+            vkFreeMemory(m_DeviceInst->Get(), slot.memory, nullptr);
+        };
+
+        m_Slots.clear();
+    };
+
+    void FrameCapture::WaitForWriters()
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_IdleCondition.wait(lock, [this]()
+                             { return m_Queue.empty() && m_Writing == 0; });
+    };
+
+    void FrameCapture::WorkerLoop()
+    {
+        while (true)
+        {
+            uint32_t slotIndex;
+
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_QueueCondition.wait(lock, [this]()
+                                      { return m_Stopping || !m_Queue.empty(); });
+
+                // Queued frames are still written when stopping.
+                if (m_Queue.empty())
+                {
+                    return;
+                };
+
+                slotIndex = m_Queue.front();
+                m_Queue.pop_front();
+                m_Writing++;
+            };
+
+            WriteSlot(slotIndex);
+
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Slots[slotIndex].state = SlotState::Free;
+                m_Writing--;
+            };
+
+            m_IdleCondition.notify_all();
+        };
+    };
+
+    void FrameCapture::WriteSlot(uint32_t slotIndex)
+    {
+        // The slot is owned by this writer until it is marked free, no lock is needed to read it.
+        const Slot &slot = m_Slots[slotIndex];
+        uint32_t width = m_Config.extent.width;
+        uint32_t height = m_Config.extent.height;
+
+        if (!m_Coherent)
+        {
+            VkMappedMemoryRange range{};
+            range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+            range.memory = slot.memory;
+            range.offset = 0;
+            range.size = VK_WHOLE_SIZE;
+            vkInvalidateMappedMemoryRanges(m_DeviceInst->Get(), 1, &range);
+        };
+
+        // The mapped buffer is never written from the host, dirty cache lines could land over the next copy.
+        const uint8_t *pixels = slot.data;
+        thread_local std::vector<uint8_t> swizzled;
+
+        if (m_SwapRedBlue)
+        {
+            size_t pixelCount = static_cast<size_t>(width) * height;
+            swizzled.resize(pixelCount * 4);
+
+            for (size_t i = 0; i < pixelCount; i++)
+            {
+                swizzled[i * 4 + 0] = slot.data[i * 4 + 2];
+                swizzled[i * 4 + 1] = slot.data[i * 4 + 1];
+                swizzled[i * 4 + 2] = slot.data[i * 4 + 0];
+                swizzled[i * 4 + 3] = slot.data[i * 4 + 3];
+            };
+
+            pixels = swizzled.data();
+        };
+
+        char name[64];
+        if (m_Config.fileFormat == ImageFileFormat::Raw)
+        {
+            std::snprintf(name, sizeof(name), "frame_%06llu_%ux%u.%s", static_cast<unsigned long long>(slot.frameNumber), width, height, GetImageFileExtension(m_Config.fileFormat));
+        }
+        else
+        {
+            std::snprintf(name, sizeof(name), "frame_%06llu.%s", static_cast<unsigned long long>(slot.frameNumber), GetImageFileExtension(m_Config.fileFormat));
+        };
+
+        bool written = WriteImage(m_Config.directory + "/" + name, m_Config.fileFormat, width, height, pixels);
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (written)
+        {
+            m_Stats.written++;
+        }
+        else
+        {
+            m_Stats.failed++;
+        };
+    };
+
+};
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "../Common.h"
+#include "../Vulkan-Core/Device.h"
+#include "ImageWriter.h"
+
+namespace Renderer
+{
+    struct FrameCaptureConfig
+    {
+        VkExtent2D extent;
+        // 8-bit RGBA or BGRA color formats, others disable the capture.
+        VkFormat format;
+        uint32_t framesInFlight = 2;
+        // Created if missing, frames are written as frame_<number>.<extension>.
+        std::string directory;
+        ImageFileFormat fileFormat = ImageFileFormat::Png;
+        // Readback buffers, 0 sizes the ring for the writer count. A frame is dropped, never waited for, when every
+        // buffer is still in flight or being written, so this bounds how far the writers may fall behind.
+        uint32_t bufferCount = 0;
+        // Writer threads, 0 uses half the hardware threads.
+        uint32_t workerCount = 0;
+        // Speed matters more than file size when every frame is written.
+        int pngCompressionLevel = 1;
+    };
+
+    struct FrameCaptureStats
+    {
+        uint64_t captured = 0;
+        uint64_t written = 0;
+        uint64_t dropped = 0;
+        uint64_t failed = 0;
+    };
+
+    // Copies rendered frames into a ring of host-cached readback buffers at the end of the frame's command
+    // buffer. A copy is handed to the writer threads once the frame's fence is known to have signaled, which the
+    // render loop already waits for before reusing the frame slot, so capturing never adds a wait.
+    class FrameCapture
+    {
+    public:
+        FrameCapture() = default;
+        ~FrameCapture() = default;
+        FrameCapture(const FrameCapture &) = delete;
+        FrameCapture &operator=(const FrameCapture &) = delete;
+
+        void Create(const FrameCaptureConfig &config, const VulkanCore::Device &device);
+        // Writes every captured frame before returning.
+        void Destroy();
+        // Reallocates the ring for a new extent, the device must be idle.
+        void Resize(VkExtent2D extent);
+
+        // Records the copy of image, left in layout, into a free readback buffer. False when the frame is dropped.
+        bool Capture(VkCommandBuffer commandBuffer, uint32_t frame, uint64_t frameNumber, VkImage image, VkImageLayout layout);
+        // The frame slot's fence has signaled: its copies are queued for writing.
+        void Collect(uint32_t frame);
+
+        bool IsEnabled() { return m_Enabled; };
+        FrameCaptureStats GetStats();
+
+    private:
+        void CreateBuffers();
+        void DestroyBuffers();
+        void WaitForWriters();
+        void WorkerLoop();
+        void WriteSlot(uint32_t slotIndex);
+
+    private:
+        enum class SlotState
+        {
+            Free,
+            // Copy recorded, the frame may still be executing.
+            InFlight,
+            Writing
+        };
+
+        struct Slot
+        {
+            VkBuffer buffer = VK_NULL_HANDLE;
+            VkDeviceMemory memory = VK_NULL_HANDLE;
+            const uint8_t *data = nullptr;
+            SlotState state = SlotState::Free;
+            uint32_t frame = 0;
+            uint64_t frameNumber = 0;
+        };
+
+        FrameCaptureConfig m_Config;
+        const VulkanCore::Device *m_DeviceInst = nullptr;
+        bool m_Enabled = false;
+        bool m_SwapRedBlue = false;
+        // Host-cached memory is fast to read but may not be coherent.
+        bool m_Coherent = true;
+
+        std::vector<Slot> m_Slots;
+        uint32_t m_NextSlot = 0;
+
+        // Guards the slot states, the queue and the stats, shared with the writers.
+        std::mutex m_Mutex;
+        std::condition_variable m_QueueCondition;
+        std::condition_variable m_IdleCondition;
+        std::deque<uint32_t> m_Queue;
+        uint32_t m_Writing = 0;
+        bool m_Stopping = false;
+        std::vector<std::thread> m_Workers;
+        FrameCaptureStats m_Stats;
+    };
+
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Renderer
+{
+    // GPU counters of a finished frame, read back a few frames late.
+    struct FrameStats
+    {
+        uint32_t drawCount = 0;
+        // Samples passing the depth test in the depth pre-pass, what a sorted single pass would have shaded.
+        uint64_t prePassSamples = 0;
+        // Samples passing the depth test in the color pass.
+        uint64_t colorPassSamples = 0;
+        // Requires pipelineStatisticsQuery, zero otherwise.
+        uint64_t fragmentShaderInvocations = 0;
+        // Fragments the pre-pass kept from being shaded.
+        uint64_t overdrawEliminated = 0;
+        // Draws rejected on the GPU, requires occlusion culling.
+        uint32_t frustumCulled = 0;
+        uint32_t occlusionCulled = 0;
+        uint32_t particlesAlive = 0;
+        // GPU time of the particle simulation, zero without compute timestamps.
+        float particleSimulationMs = 0.0f;
+        // GPU time of the profiled passes, requires GPU profiling.
+        float gpuFrameMs = 0.0f;
+        // Host time from queue submit to the end of the frame's last GPU scope. Present timing needs extensions
+        // the sandbox does not use, the GPU finishing the frame is the closest observable point. Requires GPU profiling.
+        float submitToPresentMs = 0.0f;
+        // Device local heap the textures stream into, usage is zero without VK_EXT_memory_budget.
+        uint64_t deviceMemoryUsage = 0;
+        uint64_t deviceMemoryBudget = 0;
+    };
+
+};
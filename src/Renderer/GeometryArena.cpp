@@ -0,0 +1,145 @@
+#include "GeometryArena.h"
+#include "../Vulkan-Core/Utils.h"
+#include "../Log.h"
+
+namespace Renderer
+{
+    namespace
+    {
+        // Every vertex format is made of 32-bit words, the shader reads them through a uint array.
+        constexpr VkDeviceSize AllocationAlignment = 16;
+
+        VkDeviceSize Align(VkDeviceSize value)
+        {
+            return (value + AllocationAlignment - 1) & ~(AllocationAlignment - 1);
+        };
+    };
+
+    uint32_t GetVertexStride(VertexFormat format)
+    {
+        switch (format)
+        {
+        case VertexFormat::PositionColorUVPacked:
+            return 5 * sizeof(uint32_t);
+        default:
+            return 8 * sizeof(uint32_t);
+        };
+    };
+
+    void GeometryArena::Create(const GeometryArenaConfig &config, const VulkanCore::Device &device, VkCommandPool commandPool)
+    {
+        m_Config = config;
+        m_DeviceInst = &device;
+        m_CommandPool = commandPool;
+        m_UsedBytes = 0;
+
+        VkBufferUsageFlags usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+        uint32_t memoryTypeBits = device.GetBufferMemoryTypeBits(usage);
+        m_UploadStrategy = VulkanCore::Utils::ChooseUploadStrategy(device.GetMemoryProperties(), memoryTypeBits, m_Config.capacity);
+
+        if (m_UploadStrategy == VulkanCore::UploadStrategy::DirectWrite)
+        {
+            VulkanCore::Utils::CreateBuffer(device.Get(), device.GetMemoryProperties(), m_Config.capacity, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_Buffer, m_Memory);
+            vkMapMemory(device.Get(), m_Memory, 0, m_Config.capacity, 0, reinterpret_cast<void **>(&m_Mapped));
+        }
+        else
+        {
+            VulkanCore::Utils::CreateBuffer(device.Get(), device.GetMemoryProperties(), m_Config.capacity, usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_Buffer, m_Memory);
+        };
+
+        VkBufferDeviceAddressInfo addressInfo{};
+        addressInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+        addressInfo.buffer = m_Buffer;
+        m_BaseAddress = device.GetDispatch().vkGetBufferDeviceAddress(device.Get(), &addressInfo);
+
+        CORE_LOG_INFO("Geometry arena: {0} MiB by {1}", m_Config.capacity >> 20, VulkanCore::Utils::GetUploadStrategyName(m_UploadStrategy));
+    };
+
+    void GeometryArena::Destroy()
+    {
+        if (m_Buffer == VK_NULL_HANDLE)
+        {
+            return;
+        };
+
+        if (m_Mapped != nullptr)
+        {
+            vkUnmapMemory(m_DeviceInst->Get(), m_Memory);
+            m_Mapped = nullptr;
+        };
+
+        vkDestroyBuffer(m_DeviceInst->Get(), m_Buffer, nullptr);
+        vkFreeMemory(m_DeviceInst->Get(), m_Memory, nullptr);
+
+        m_Buffer = VK_NULL_HANDLE;
+        m_Memory = VK_NULL_HANDLE;
+        m_BaseAddress = 0;
+        m_UsedBytes = 0;
+    };
+
+    bool GeometryArena::Add(VertexFormat format, const void *vertices, uint32_t vertexCount, const uint32_t *indices, uint32_t indexCount, MeshAllocation &mesh)
+    {
+        VkDeviceSize vertexSize = static_cast<VkDeviceSize>(vertexCount) * GetVertexStride(format);
+        VkDeviceSize indexSize = static_cast<VkDeviceSize>(indexCount) * sizeof(uint32_t);
+
+        VkDeviceSize vertexOffset = Align(m_UsedBytes);
+        VkDeviceSize indexOffset = Align(vertexOffset + vertexSize);
+
+        if (indexOffset + indexSize > m_Config.capacity)
+        {
+            CORE_LOG_WARN("Geometry arena full, {0} bytes requested with {1} of {2} used", vertexSize + indexSize, m_UsedBytes, m_Config.capacity);
+            return false;
+        };
+
+        Write(vertexOffset, vertices, vertexSize);
+        Write(indexOffset, indices, indexSize);
+
+        mesh.vertexAddress = m_BaseAddress + vertexOffset;
+        mesh.vertexFormat = format;
+        mesh.vertexCount = vertexCount;
+        mesh.firstIndex = static_cast<uint32_t>(indexOffset / sizeof(uint32_t));
+        mesh.indexCount = indexCount;
+
+        m_UsedBytes = indexOffset + indexSize;
+
+        return true;
+    };
+
+    void GeometryArena::Write(VkDeviceSize offset, const void *data, VkDeviceSize size)
+    {
+        if (size == 0)
+        {
+            return;
+        };
+
+        if (m_Mapped != nullptr)
+        {
+            memcpy(m_Mapped + offset, data, static_cast<size_t>(size));
+            return;
+        };
+
+        VkDevice vkDevice = m_DeviceInst->Get();
+
+        VkBuffer stagingBuffer;
+        VkDeviceMemory stagingBufferMemory;
+        VulkanCore::Utils::CreateBuffer(vkDevice, m_DeviceInst->GetMemoryProperties(), size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
+
+        void *mapped;
+        vkMapMemory(vkDevice, stagingBufferMemory, 0, size, 0, &mapped);
+        memcpy(mapped, data, static_cast<size_t>(size));
+        vkUnmapMemory(vkDevice, stagingBufferMemory);
+
+        VkCommandBuffer commandBuffer = VulkanCore::Utils::BeginSingleTimeCommands(vkDevice, m_CommandPool);
+
+        VkBufferCopy copyRegion{};
+        copyRegion.dstOffset = offset;
+        copyRegion.size = size;
+        m_DeviceInst->GetDispatch().vkCmdCopyBuffer(commandBuffer, stagingBuffer, m_Buffer, 1, &copyRegion);
+
+        VulkanCore::Utils::EndSingleTimeCommands(vkDevice, m_CommandPool, m_DeviceInst->GetGraphicsQueue(), commandBuffer);
+
+        vkDestroyBuffer(vkDevice, stagingBuffer, nullptr);
+        vkFreeMemory(vkDevice, stagingBufferMemory, nullptr);
+    };
+
+};
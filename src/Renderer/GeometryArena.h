@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "../Common.h"
+#include "../Vulkan-Core/Types.h"
+#include "../Vulkan-Core/Device.h"
+
+namespace Renderer
+{
+    // Vertex layouts vertex_pull.vert knows how to fetch and unpack, the values are shared with the shader.
+    enum class VertexFormat : uint32_t
+    {
+        // vec3 position, vec3 color, vec2 uv: the Vertex layout of the vertex input path.
+        PositionColorUV = 0,
+        // vec3 position, RGBA8 unorm color, half2 uv.
+        PositionColorUVPacked = 1
+    };
+
+    uint32_t GetVertexStride(VertexFormat format);
+
+    struct GeometryArenaConfig
+    {
+        // Vertices and indices of every mesh, allocated once and never grown.
+        VkDeviceSize capacity = 64ull * 1024 * 1024;
+    };
+
+    struct MeshAllocation
+    {
+        // Start of the mesh's vertices, pushed to the shader with every draw.
+        VkDeviceAddress vertexAddress = 0;
+        VertexFormat vertexFormat = VertexFormat::PositionColorUV;
+        uint32_t vertexCount = 0;
+        // In 32-bit indices from the start of the arena, bound once as the index buffer of every pulled draw.
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+    };
+
+    // One device address buffer holding the vertices and indices of meshes in any VertexFormat, for vertex pulling.
+    // Indices are mesh relative and vertices are fetched relative to the pushed address, so meshes of different
+    // layouts draw back to back with the same pipeline and index buffer binding. Meshes are appended, never freed.
+    class GeometryArena
+    {
+    public:
+        GeometryArena() = default;
+        ~GeometryArena() = default;
+        GeometryArena(const GeometryArena &) = delete;
+        GeometryArena &operator=(const GeometryArena &) = delete;
+
+        // Requires the bufferDeviceAddress feature. commandPool is only used when uploads are staged.
+        void Create(const GeometryArenaConfig &config, const VulkanCore::Device &device, VkCommandPool commandPool);
+        void Destroy();
+
+        // False when the arena is full, nothing is written then.
+        bool Add(VertexFormat format, const void *vertices, uint32_t vertexCount, const uint32_t *indices, uint32_t indexCount, MeshAllocation &mesh);
+
+        VkBuffer GetBuffer() const { return m_Buffer; };
+        VkDeviceSize GetUsedBytes() const { return m_UsedBytes; };
+        VulkanCore::UploadStrategy GetUploadStrategy() const { return m_UploadStrategy; };
+
+    private:
+        void Write(VkDeviceSize offset, const void *data, VkDeviceSize size);
+
+    private:
+        GeometryArenaConfig m_Config;
+        const VulkanCore::Device *m_DeviceInst = nullptr;
+        VkCommandPool m_CommandPool = VK_NULL_HANDLE;
+
+        VkBuffer m_Buffer = VK_NULL_HANDLE;
+        VkDeviceMemory m_Memory = VK_NULL_HANDLE;
+        VkDeviceAddress m_BaseAddress = 0;
+        VkDeviceSize m_UsedBytes = 0;
+
+        VulkanCore::UploadStrategy m_UploadStrategy = VulkanCore::UploadStrategy::None;
+        // Persistently mapped when meshes are written in place.
+        uint8_t *m_Mapped = nullptr;
+    };
+
+};
@@ -0,0 +1,406 @@
+#include "GpuProfiler.h"
+#include "../Vulkan-Core/Utils.h"
+#include "../Profiling/Clock.h"
+#include "../Log.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+namespace Renderer
+{
+    namespace
+    {
+        // Result order follows the bit order of the flags.
+        const VkQueryPipelineStatisticFlags PIPELINE_STATISTICS =
+            VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
+            VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+            VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+            VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+            VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT |
+            VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+
+        const uint32_t DROPPED_SCOPE = UINT32_MAX;
+
+#ifdef _WIN32
+        const VkTimeDomainEXT HOST_TIME_DOMAIN = VK_TIME_DOMAIN_QUERY_PERFORMANCE_COUNTER_EXT;
+#else
+        const VkTimeDomainEXT HOST_TIME_DOMAIN = VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT;
+#endif
+
+        uint64_t HostDomainToNs(uint64_t hostTimestamp)
+        {
+#ifdef _WIN32
+            LARGE_INTEGER frequency;
+            QueryPerformanceFrequency(&frequency);
+            return static_cast<uint64_t>(static_cast<double>(hostTimestamp) * 1e9 / static_cast<double>(frequency.QuadPart));
+#else
+            return hostTimestamp;
+#endif
+        };
+    };
+
+    void GpuProfiler::Create(const GpuProfilerConfig &config, const VulkanCore::Device &device, VkCommandPool commandPool)
+    {
+        m_Config = config;
+        m_DeviceInst = &device;
+        m_CommandPool = commandPool;
+
+        VkDevice vkDevice = m_DeviceInst->Get();
+        VkPhysicalDevice physicalDevice = m_DeviceInst->GetPhysical();
+
+        uint32_t queueFamilyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> queueFamilyProperties(queueFamilyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilyProperties.data());
+
+        uint32_t validBits = queueFamilyProperties[m_DeviceInst->GetQueueFamilies().graphicsFamily.value()].timestampValidBits;
+
+        if (validBits == 0)
+        {
+            CORE_LOG_INFO("Graphics queue has no timestamps, GPU profiler disabled.");
+            return;
+        };
+
+        m_Enabled = true;
+        m_TimestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+        m_TimestampPeriod = m_DeviceInst->GetProperties().limits.timestampPeriod;
+        m_Config.pipelineStatistics = m_Config.pipelineStatistics && m_DeviceInst->GetEnabledFeatures().pipelineStatisticsQuery;
+
+        // Calibrated timestamps sample both clocks together, otherwise a one-off submit gives an approximate offset.
+        if (m_DeviceInst->IsExtensionEnabled(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME))
+        {
+            auto getTimeDomains = (PFN_vkGetPhysicalDeviceCalibrateableTimeDomainsEXT)vkGetInstanceProcAddr(m_DeviceInst->GetInstance().Get(), "vkGetPhysicalDeviceCalibrateableTimeDomainsEXT");
+
+            uint32_t domainCount = 0;
+            std::vector<VkTimeDomainEXT> domains;
+            if (getTimeDomains != nullptr && getTimeDomains(physicalDevice, &domainCount, nullptr) == VK_SUCCESS)
+            {
+                domains.resize(domainCount);
+                getTimeDomains(physicalDevice, &domainCount, domains.data());
+            };
+
+            bool hasDevice = std::find(domains.begin(), domains.end(), VK_TIME_DOMAIN_DEVICE_EXT) != domains.end();
+            bool hasHost = std::find(domains.begin(), domains.end(), HOST_TIME_DOMAIN) != domains.end();
+
+            m_GetCalibratedTimestamps = (PFN_vkGetCalibratedTimestampsEXT)vkGetDeviceProcAddr(vkDevice, "vkGetCalibratedTimestampsEXT");
+            m_CalibratedTimestamps = hasDevice && hasHost && m_GetCalibratedTimestamps != nullptr;
+        };
+
+        if (!m_CalibratedTimestamps)
+        {
+            CORE_LOG_INFO("Calibrated timestamps not supported, GPU scopes are aligned to the host approximately.");
+        };
+
+        m_TimestampPools.resize(m_Config.framesInFlight, VK_NULL_HANDLE);
+        m_StatisticsPools.resize(m_Config.framesInFlight, VK_NULL_HANDLE);
+        m_FrameScopes.resize(m_Config.framesInFlight);
+
+        for (uint32_t i = 0; i < m_Config.framesInFlight; i++)
+        {
+            VkQueryPoolCreateInfo queryPoolInfo{};
+            queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+            queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+            queryPoolInfo.queryCount = m_Config.maxScopes * 2;
+
+            VkResult result = vkCreateQueryPool(vkDevice, &queryPoolInfo, nullptr, &m_TimestampPools[i]);
+
+            CORE_ASSERT(result == VK_SUCCESS, "Failed to create profiler timestamp query pool!");
+
+            if (m_Config.pipelineStatistics)
+            {
+                queryPoolInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+                queryPoolInfo.queryCount = m_Config.maxScopes;
+                queryPoolInfo.pipelineStatistics = PIPELINE_STATISTICS;
+
+                result = vkCreateQueryPool(vkDevice, &queryPoolInfo, nullptr, &m_StatisticsPools[i]);
+
+                CORE_ASSERT(result == VK_SUCCESS, "Failed to create profiler pipeline statistics query pool!");
+            };
+        };
+
+        Calibrate();
+    };
+
+    void GpuProfiler::Destroy()
+    {
+        for (uint32_t i = 0; i < m_TimestampPools.size(); i++)
+        {
+            vkDestroyQueryPool(m_DeviceInst->Get(), m_TimestampPools[i], nullptr);
+            if (m_StatisticsPools[i] != VK_NULL_HANDLE)
+            {
+                vkDestroyQueryPool(m_DeviceInst->Get(), m_StatisticsPools[i], nullptr);
+            };
+        };
+
+        m_TimestampPools.clear();
+        m_StatisticsPools.clear();
+        m_Enabled = false;
+    };
+
+    void GpuProfiler::SetTraceWriter(Profiling::TraceWriter *traceWriter)
+    {
+        m_TraceWriter = traceWriter;
+
+        if (m_TraceWriter != nullptr)
+        {
+            m_TraceWriter->SetTrackName(Profiling::GPU_TRACK, "GPU Graphics Queue");
+        };
+    };
+
+    void GpuProfiler::BeginFrame(VkCommandBuffer commandBuffer, uint32_t frame)
+    {
+        const VulkanCore::DeviceDispatch &dispatch = m_DeviceInst->GetDispatch();
+
+        if (!m_Enabled)
+        {
+            return;
+        };
+
+        if (!m_FrameScopes[frame].empty())
+        {
+            Resolve(frame);
+            m_FrameScopes[frame].clear();
+        };
+
+        // The clocks drift apart, recalibrate now and then when it is cheap to do so.
+        if (m_CalibratedTimestamps && ++m_FramesSinceCalibration >= m_Config.calibrationInterval)
+        {
+            Calibrate();
+        };
+
+        dispatch.vkCmdResetQueryPool(commandBuffer, m_TimestampPools[frame], 0, m_Config.maxScopes * 2);
+        if (m_Config.pipelineStatistics)
+        {
+            dispatch.vkCmdResetQueryPool(commandBuffer, m_StatisticsPools[frame], 0, m_Config.maxScopes);
+        };
+
+        m_CurrentFrame = frame;
+        m_OpenScopes.clear();
+    };
+
+    void GpuProfiler::BeginScope(VkCommandBuffer commandBuffer, const char *name)
+    {
+        const VulkanCore::DeviceDispatch &dispatch = m_DeviceInst->GetDispatch();
+
+        if (!m_Enabled)
+        {
+            return;
+        };
+
+        std::vector<PendingScope> &scopes = m_FrameScopes[m_CurrentFrame];
+        uint32_t index = static_cast<uint32_t>(scopes.size());
+
+        if (index >= m_Config.maxScopes)
+        {
+            m_OpenScopes.push_back(DROPPED_SCOPE);
+            return;
+        };
+
+        // Statistics queries of one type cannot nest, only the outermost scopes collect them.
+        uint32_t depth = static_cast<uint32_t>(m_OpenScopes.size());
+        bool hasStatistics = m_Config.pipelineStatistics && depth == 0;
+
+        scopes.push_back({name, depth, hasStatistics});
+        m_OpenScopes.push_back(index);
+
+        dispatch.vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_TimestampPools[m_CurrentFrame], index * 2);
+
+        if (hasStatistics)
+        {
+            dispatch.vkCmdBeginQuery(commandBuffer, m_StatisticsPools[m_CurrentFrame], index, 0);
+        };
+    };
+
+    void GpuProfiler::EndScope(VkCommandBuffer commandBuffer)
+    {
+        const VulkanCore::DeviceDispatch &dispatch = m_DeviceInst->GetDispatch();
+
+        if (!m_Enabled || m_OpenScopes.empty())
+        {
+            return;
+        };
+
+        uint32_t index = m_OpenScopes.back();
+        m_OpenScopes.pop_back();
+
+        if (index == DROPPED_SCOPE)
+        {
+            return;
+        };
+
+        if (m_FrameScopes[m_CurrentFrame][index].hasStatistics)
+        {
+            dispatch.vkCmdEndQuery(commandBuffer, m_StatisticsPools[m_CurrentFrame], index);
+        };
+
+        dispatch.vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_TimestampPools[m_CurrentFrame], index * 2 + 1);
+    };
+
+    const GpuScopeResult *GpuProfiler::FindResult(const char *name)
+    {
+        for (const GpuScopeResult &result : m_Results)
+        {
+            if (std::strcmp(result.name, name) == 0)
+            {
+                return &result;
+            };
+        };
+
+        return nullptr;
+    };
+
+    void GpuProfiler::Calibrate()
+    {
+        const VulkanCore::DeviceDispatch &dispatch = m_DeviceInst->GetDispatch();
+
+        m_FramesSinceCalibration = 0;
+
+        if (m_CalibratedTimestamps)
+        {
+            VkCalibratedTimestampInfoEXT timestampInfos[2]{};
+            timestampInfos[0].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT;
+            timestampInfos[0].timeDomain = VK_TIME_DOMAIN_DEVICE_EXT;
+            timestampInfos[1].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT;
+            timestampInfos[1].timeDomain = HOST_TIME_DOMAIN;
+
+            uint64_t timestamps[2] = {};
+            uint64_t maxDeviation = 0;
+            if (m_GetCalibratedTimestamps(m_DeviceInst->Get(), 2, timestampInfos, timestamps, &maxDeviation) == VK_SUCCESS)
+            {
+                m_DeviceReference = timestamps[0] & m_TimestampMask;
+                m_HostReference = HostDomainToNs(timestamps[1]);
+            };
+
+            return;
+        };
+
+        // Without the extension: a timestamp written by an otherwise idle queue, read as soon as the submit returns.
+        // The host reference lags by the submit latency, which is fine to line scopes up by eye.
+        VkQueryPoolCreateInfo queryPoolInfo{};
+        queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        queryPoolInfo.queryCount = 1;
+
+        VkQueryPool queryPool;
+        VkResult result = vkCreateQueryPool(m_DeviceInst->Get(), &queryPoolInfo, nullptr, &queryPool);
+
+        CORE_ASSERT(result == VK_SUCCESS, "Failed to create calibration query pool!");
+
+        VkCommandBuffer commandBuffer = VulkanCore::Utils::BeginSingleTimeCommands(m_DeviceInst->Get(), m_CommandPool);
+        dispatch.vkCmdResetQueryPool(commandBuffer, queryPool, 0, 1);
+        dispatch.vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, 0);
+        VulkanCore::Utils::EndSingleTimeCommands(m_DeviceInst->Get(), m_CommandPool, m_DeviceInst->GetGraphicsQueue(), commandBuffer);
+
+        uint64_t hostNs = Profiling::NowNs();
+
+        uint64_t timestamp = 0;
+        result = dispatch.vkGetQueryPoolResults(m_DeviceInst->Get(), queryPool, 0, 1, sizeof(timestamp), &timestamp, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+
+        if (result == VK_SUCCESS)
+        {
+            m_DeviceReference = timestamp & m_TimestampMask;
+            m_HostReference = hostNs;
+        };
+
+        vkDestroyQueryPool(m_DeviceInst->Get(), queryPool, nullptr);
+    };
+
+    uint64_t GpuProfiler::ToHostNs(uint64_t timestamp)
+    {
+        // Scopes may predate the reference after a recalibration, the masked difference is signed.
+        uint64_t forward = (timestamp - m_DeviceReference) & m_TimestampMask;
+
+        if (forward <= m_TimestampMask / 2)
+        {
+            return m_HostReference + static_cast<uint64_t>(forward * static_cast<double>(m_TimestampPeriod));
+        };
+
+        uint64_t backward = (m_DeviceReference - timestamp) & m_TimestampMask;
+
+        return m_HostReference - static_cast<uint64_t>(backward * static_cast<double>(m_TimestampPeriod));
+    };
+
+    void GpuProfiler::Resolve(uint32_t frame)
+    {
+        const VulkanCore::DeviceDispatch &dispatch = m_DeviceInst->GetDispatch();
+
+        const std::vector<PendingScope> &scopes = m_FrameScopes[frame];
+        uint32_t scopeCount = static_cast<uint32_t>(scopes.size());
+
+        // The frame fence has signaled, so these never wait. A scope left open is not ready and drops the frame.
+        std::vector<uint64_t> timestamps(scopeCount * 2);
+        VkResult result = dispatch.vkGetQueryPoolResults(m_DeviceInst->Get(), m_TimestampPools[frame], 0, scopeCount * 2, timestamps.size() * sizeof(uint64_t), timestamps.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+
+        if (result != VK_SUCCESS)
+        {
+            return;
+        };
+
+        std::vector<GpuPipelineStatistics> statistics(scopeCount);
+        bool statisticsReady = false;
+
+        if (m_Config.pipelineStatistics)
+        {
+            result = dispatch.vkGetQueryPoolResults(m_DeviceInst->Get(), m_StatisticsPools[frame], 0, scopeCount, statistics.size() * sizeof(GpuPipelineStatistics), statistics.data(), sizeof(GpuPipelineStatistics), VK_QUERY_RESULT_64_BIT);
+
+            // Scopes without statistics are never begun and report not ready, their slots stay untouched.
+            statisticsReady = result == VK_SUCCESS || result == VK_NOT_READY;
+        };
+
+        m_Results.clear();
+
+        uint64_t frameBegin = UINT64_MAX;
+        uint64_t frameEnd = 0;
+
+        for (uint32_t i = 0; i < scopeCount; i++)
+        {
+            GpuScopeResult scopeResult;
+            scopeResult.name = scopes[i].name;
+            scopeResult.depth = scopes[i].depth;
+            scopeResult.beginNs = ToHostNs(timestamps[i * 2] & m_TimestampMask);
+            scopeResult.durationNs = static_cast<uint64_t>(((timestamps[i * 2 + 1] - timestamps[i * 2]) & m_TimestampMask) * static_cast<double>(m_TimestampPeriod));
+            scopeResult.hasStatistics = scopes[i].hasStatistics && statisticsReady;
+
+            if (scopeResult.hasStatistics)
+            {
+                scopeResult.statistics = statistics[i];
+            };
+
+            if (scopeResult.depth == 0)
+            {
+                frameBegin = (std::min)(frameBegin, scopeResult.beginNs);
+                frameEnd = (std::max)(frameEnd, scopeResult.beginNs + scopeResult.durationNs);
+            };
+
+            m_Results.push_back(scopeResult);
+        };
+
+        m_FrameMs = frameEnd > frameBegin ? static_cast<float>(frameEnd - frameBegin) / 1e6f : 0.0f;
+
+        if (m_TraceWriter == nullptr)
+        {
+            return;
+        };
+
+        for (const GpuScopeResult &scopeResult : m_Results)
+        {
+            std::string args;
+            if (scopeResult.hasStatistics)
+            {
+                const GpuPipelineStatistics &stats = scopeResult.statistics;
+                args = "\"vertices\": " + std::to_string(stats.inputAssemblyVertices) +
+                       ", \"primitives\": " + std::to_string(stats.inputAssemblyPrimitives) +
+                       ", \"vertexInvocations\": " + std::to_string(stats.vertexShaderInvocations) +
+                       ", \"clippedPrimitives\": " + std::to_string(stats.clippingPrimitives) +
+                       ", \"fragmentInvocations\": " + std::to_string(stats.fragmentShaderInvocations) +
+                       ", \"computeInvocations\": " + std::to_string(stats.computeShaderInvocations);
+            };
+
+            m_TraceWriter->AddComplete(scopeResult.name, "gpu", Profiling::GPU_TRACK, scopeResult.beginNs, scopeResult.durationNs, args);
+        };
+    };
+
+};
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "../Common.h"
+#include "../Vulkan-Core/Device.h"
+#include "../Profiling/TraceWriter.h"
+
+namespace Renderer
+{
+    struct GpuProfilerConfig
+    {
+        // Timestamp scopes per frame, scopes past the limit are dropped.
+        uint32_t maxScopes = 64;
+        uint32_t framesInFlight = 2;
+        // Pipeline statistics of the outermost scopes, requires pipelineStatisticsQuery.
+        bool pipelineStatistics = false;
+        // Frames between two recalibrations of the GPU clock against the host clock.
+        uint32_t calibrationInterval = 120;
+    };
+
+    struct GpuPipelineStatistics
+    {
+        uint64_t inputAssemblyVertices = 0;
+        uint64_t inputAssemblyPrimitives = 0;
+        uint64_t vertexShaderInvocations = 0;
+        uint64_t clippingPrimitives = 0;
+        uint64_t fragmentShaderInvocations = 0;
+        uint64_t computeShaderInvocations = 0;
+    };
+
+    struct GpuScopeResult
+    {
+        const char *name = nullptr;
+        uint32_t depth = 0;
+        // Host time (Profiling::NowNs) of the scope, mapped through the calibration.
+        uint64_t beginNs = 0;
+        uint64_t durationNs = 0;
+        // Outermost scopes only, when pipeline statistics are enabled.
+        bool hasStatistics = false;
+        GpuPipelineStatistics statistics;
+    };
+
+    // Named GPU scopes bracketed with timestamps from per-frame query pools. Results of a frame slot are read
+    // when the slot comes around again, after its fence, so reading never stalls: they are framesInFlight late.
+    class GpuProfiler
+    {
+    public:
+        GpuProfiler() = default;
+        ~GpuProfiler() = default;
+        GpuProfiler(const GpuProfiler &) = delete;
+        GpuProfiler &operator=(const GpuProfiler &) = delete;
+
+        void Create(const GpuProfilerConfig &config, const VulkanCore::Device &device, VkCommandPool commandPool);
+        void Destroy();
+
+        // Resolves the previous use of the frame slot and resets its queries, outside any render pass.
+        void BeginFrame(VkCommandBuffer commandBuffer, uint32_t frame);
+        // Name must outlive the results (string literals).
+        void BeginScope(VkCommandBuffer commandBuffer, const char *name);
+        void EndScope(VkCommandBuffer commandBuffer);
+
+        // Scopes of the most recently resolved frame, empty until the first one resolves.
+        const std::vector<GpuScopeResult> &GetResults() { return m_Results; };
+        const GpuScopeResult *FindResult(const char *name);
+        // Span of the outermost scopes of the resolved frame.
+        float GetFrameMs() { return m_FrameMs; };
+        bool IsEnabled() { return m_Enabled; };
+        bool IsCalibrated() { return m_CalibratedTimestamps; };
+
+        // Resolved scopes are also streamed to the trace as complete events on the GPU track.
+        void SetTraceWriter(Profiling::TraceWriter *traceWriter);
+
+    private:
+        void Calibrate();
+        void Resolve(uint32_t frame);
+        uint64_t ToHostNs(uint64_t timestamp);
+
+    private:
+        struct PendingScope
+        {
+            const char *name;
+            uint32_t depth;
+            bool hasStatistics;
+        };
+
+        GpuProfilerConfig m_Config;
+        const VulkanCore::Device *m_DeviceInst = nullptr;
+        VkCommandPool m_CommandPool;
+        bool m_Enabled = false;
+
+        std::vector<VkQueryPool> m_TimestampPools;
+        std::vector<VkQueryPool> m_StatisticsPools;
+        std::vector<std::vector<PendingScope>> m_FrameScopes;
+        std::vector<uint32_t> m_OpenScopes;
+        uint32_t m_CurrentFrame = 0;
+
+        std::vector<GpuScopeResult> m_Results;
+        float m_FrameMs = 0.0f;
+
+        // GPU ticks to host nanoseconds: hostNs = m_HostReference + (ticks - m_DeviceReference) * m_TimestampPeriod.
+        float m_TimestampPeriod = 1.0f;
+        uint64_t m_TimestampMask = ~0ull;
+        uint64_t m_DeviceReference = 0;
+        uint64_t m_HostReference = 0;
+        bool m_CalibratedTimestamps = false;
+        VkTimeDomainEXT m_HostDomain = VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT;
+        PFN_vkGetCalibratedTimestampsEXT m_GetCalibratedTimestamps = nullptr;
+        uint32_t m_FramesSinceCalibration = 0;
+
+        Profiling::TraceWriter *m_TraceWriter = nullptr;
+    };
+
+};
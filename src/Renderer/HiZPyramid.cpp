@@ -0,0 +1,178 @@
+#include "HiZPyramid.h"
+#include "../Vulkan-Core/Utils.h"
+#include "../Log.h"
+
+#include <cmath>
+
+namespace Renderer
+{
+    namespace
+    {
+        struct BuildConstants
+        {
+            int32_t sourceSize[2];
+            int32_t destinationSize[2];
+        };
+
+        const uint32_t HIZ_GROUP_SIZE = 8;
+    };
+
+    void HiZPyramid::Create(const VulkanCore::Device &device, VkImage depthImage, VkImageView depthView, VkFormat depthFormat, VkExtent2D extent, VkSampler sampler)
+    {
+        m_DeviceInst = &device;
+        m_DepthImage = depthImage;
+        m_DepthAspect = VK_IMAGE_ASPECT_DEPTH_BIT | (VulkanCore::Utils::HasStencilComponent(depthFormat) ? VK_IMAGE_ASPECT_STENCIL_BIT : 0);
+        m_Initialized = false;
+
+        uint32_t levelCount = static_cast<uint32_t>(std::floor(std::log2((std::max)(extent.width, extent.height)))) + 1;
+
+        VulkanCore::ImageConfig imageConfig;
+        imageConfig.format = VK_FORMAT_R32_SFLOAT;
+        imageConfig.width = extent.width;
+        imageConfig.height = extent.height;
+        imageConfig.mipLevels = levelCount;
+        imageConfig.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+
+        m_Image.Create(imageConfig, *m_DeviceInst);
+
+        m_LevelViews.resize(levelCount);
+        for (uint32_t level = 0; level < levelCount; level++)
+        {
+            VkImageViewCreateInfo viewInfo{};
+            viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+            viewInfo.image = m_Image.Get();
+            viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            viewInfo.format = imageConfig.format;
+            viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, level, 1, 0, 1};
+
+            VkResult result = vkCreateImageView(m_DeviceInst->Get(), &viewInfo, nullptr, &m_LevelViews[level]);
+
+            CORE_ASSERT(result == VK_SUCCESS, "Failed to create Hi-Z level view!");
+        };
+
+        VulkanCore::ComputePipelineConfig pipelineConfig;
+        pipelineConfig.shaderPath = "assets/shaders/spv/hiz_build.comp.spv";
+        pipelineConfig.pushConstantSize = sizeof(BuildConstants);
+        pipelineConfig.localSizeX = HIZ_GROUP_SIZE;
+        pipelineConfig.localSizeY = HIZ_GROUP_SIZE;
+        pipelineConfig.bindings = {
+            {0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+            {1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}};
+
+        m_BuildPipeline.Create(pipelineConfig, *m_DeviceInst);
+
+        m_DescriptorPool.Create(*m_DeviceInst, levelCount, {{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, levelCount}, {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, levelCount}});
+
+        // Level 0 reads the depth buffer, every other level the one above it.
+        m_DescriptorSets.resize(levelCount);
+        for (uint32_t level = 0; level < levelCount; level++)
+        {
+            m_DescriptorSets[level] = m_DescriptorPool.Allocate(m_BuildPipeline.GetDescriptorSetLayout());
+
+            VkDescriptorImageInfo sourceInfo{};
+            sourceInfo.sampler = sampler;
+            sourceInfo.imageView = level == 0 ? depthView : m_LevelViews[level - 1];
+            sourceInfo.imageLayout = level == 0 ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_GENERAL;
+
+            VkDescriptorImageInfo destinationInfo{};
+            destinationInfo.imageView = m_LevelViews[level];
+            destinationInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+            std::array<VkWriteDescriptorSet, 2> descriptorWrites{};
+            descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptorWrites[0].dstSet = m_DescriptorSets[level];
+            descriptorWrites[0].dstBinding = 0;
+            descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            descriptorWrites[0].descriptorCount = 1;
+            descriptorWrites[0].pImageInfo = &sourceInfo;
+
+            descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptorWrites[1].dstSet = m_DescriptorSets[level];
+            descriptorWrites[1].dstBinding = 1;
+            descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+            descriptorWrites[1].descriptorCount = 1;
+            descriptorWrites[1].pImageInfo = &destinationInfo;
+
+            vkUpdateDescriptorSets(m_DeviceInst->Get(), static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+        };
+    };
+
+    void HiZPyramid::Destroy()
+    {
+        m_DescriptorPool.Destroy();
+        m_BuildPipeline.Destroy();
+
+        for (VkImageView view : m_LevelViews)
+        {
+            vkDestroyImageView(m_DeviceInst->Get(), view, nullptr);
+        };
+        m_LevelViews.clear();
+
+        m_Image.Destroy();
+    };
+
+    void HiZPyramid::Build(VkCommandBuffer commandBuffer)
+    {
+        const VulkanCore::DeviceDispatch &dispatch = m_DeviceInst->GetDispatch();
+
+        VkImageMemoryBarrier depthBarrier{};
+        depthBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        depthBarrier.oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        depthBarrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+        depthBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        depthBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        depthBarrier.image = m_DepthImage;
+        depthBarrier.subresourceRange = {m_DepthAspect, 0, 1, 0, 1};
+        depthBarrier.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        depthBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+        // The previous build's cull reads are covered by the queue order plus this dependency.
+        VkImageMemoryBarrier pyramidBarrier{};
+        pyramidBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        pyramidBarrier.oldLayout = m_Initialized ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_UNDEFINED;
+        pyramidBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+        pyramidBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        pyramidBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        pyramidBarrier.image = m_Image.Get();
+        pyramidBarrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, m_Image.GetMipLevels(), 0, 1};
+        pyramidBarrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        pyramidBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+        VkImageMemoryBarrier barriers[] = {depthBarrier, pyramidBarrier};
+        dispatch.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 2, barriers);
+
+        m_Initialized = true;
+
+        m_BuildPipeline.Bind(commandBuffer);
+
+        VkExtent2D extent = m_Image.GetExtent();
+        int32_t sourceWidth = static_cast<int32_t>(extent.width);
+        int32_t sourceHeight = static_cast<int32_t>(extent.height);
+
+        for (uint32_t level = 0; level < m_Image.GetMipLevels(); level++)
+        {
+            int32_t width = (std::max)(1, static_cast<int32_t>(extent.width >> level));
+            int32_t height = (std::max)(1, static_cast<int32_t>(extent.height >> level));
+
+            BuildConstants constants{{sourceWidth, sourceHeight}, {width, height}};
+
+            m_BuildPipeline.BindDescriptorSet(commandBuffer, m_DescriptorSets[level]);
+            m_BuildPipeline.PushConstants(commandBuffer, &constants, sizeof(constants));
+            m_BuildPipeline.DispatchThreads(commandBuffer, width, height);
+
+            VulkanCore::Utils::GlobalBarrier(dispatch, commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+
+            sourceWidth = width;
+            sourceHeight = height;
+        };
+
+        // Back to an attachment before the next frame clears it.
+        depthBarrier.oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+        depthBarrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        depthBarrier.srcAccessMask = 0;
+        depthBarrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+        dispatch.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, 0, 0, nullptr, 0, nullptr, 1, &depthBarrier);
+    };
+
+};
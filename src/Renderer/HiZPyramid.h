@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "../Common.h"
+#include "../Vulkan-Core/Device.h"
+#include "../Vulkan-Core/Image.h"
+#include "../Vulkan-Core/ComputePipeline.h"
+#include "../Vulkan-Core/DescriptorPool.h"
+
+namespace Renderer
+{
+    // Max-reduced depth mip chain (R32F, kept in GENERAL layout). Level 0 matches the depth buffer and every
+    // further level halves it, folding odd rows and columns into the last texel.
+    class HiZPyramid
+    {
+    public:
+        HiZPyramid() = default;
+        ~HiZPyramid() = default;
+        HiZPyramid(const HiZPyramid &) = delete;
+        HiZPyramid &operator=(const HiZPyramid &) = delete;
+
+        // depthView must only cover the depth aspect and its image must have sampled usage.
+        void Create(const VulkanCore::Device &device, VkImage depthImage, VkImageView depthView, VkFormat depthFormat, VkExtent2D extent, VkSampler sampler);
+        void Destroy();
+
+        // Reduces the depth written by the frame, which is left in DEPTH_STENCIL_ATTACHMENT_OPTIMAL again.
+        void Build(VkCommandBuffer commandBuffer);
+
+        VkImageView GetView() { return m_Image.GetView(); };
+        VkExtent2D GetExtent() { return m_Image.GetExtent(); };
+        uint32_t GetLevelCount() { return m_Image.GetMipLevels(); };
+
+    private:
+        const VulkanCore::Device *m_DeviceInst = nullptr;
+        VulkanCore::Image m_Image;
+        std::vector<VkImageView> m_LevelViews;
+        VulkanCore::ComputePipeline m_BuildPipeline;
+        VulkanCore::DescriptorPool m_DescriptorPool;
+        std::vector<VkDescriptorSet> m_DescriptorSets;
+
+        VkImage m_DepthImage = VK_NULL_HANDLE;
+        VkImageAspectFlags m_DepthAspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+        bool m_Initialized = false;
+    };
+
+};
@@ -0,0 +1,199 @@
+#include "ImageWriter.h"
+
+#include <cmath>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+namespace Renderer
+{
+    namespace
+    {
+        uint16_t FloatToHalf(float value)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+
+            uint32_t sign = (bits >> 16) & 0x8000u;
+            int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xffu) - 127 + 15;
+            uint32_t mantissa = bits & 0x7fffffu;
+
+            // Inputs are decoded 8-bit values in [0, 1]: no infinities or NaNs, only zero and small denormals.
+            if (exponent <= 0)
+            {
+                if (exponent < -10)
+                {
+                    return static_cast<uint16_t>(sign);
+                };
+
+                mantissa = (mantissa | 0x800000u) >> (1 - exponent);
+                return static_cast<uint16_t>(sign | ((mantissa + 0x1000u) >> 13));
+            };
+
+            // Round to nearest, a carry out of the mantissa correctly bumps the exponent.
+            return static_cast<uint16_t>((sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13)) + ((mantissa >> 12) & 1u));
+        };
+
+        // Half of every 8-bit value, sRGB decoded for color and linear for alpha.
+        struct HalfTables
+        {
+            uint16_t color[256];
+            uint16_t alpha[256];
+
+            HalfTables()
+            {
+                for (uint32_t i = 0; i < 256; i++)
+                {
+                    float encoded = static_cast<float>(i) / 255.0f;
+                    float linear = encoded <= 0.04045f ? encoded / 12.92f : std::pow((encoded + 0.055f) / 1.055f, 2.4f);
+                    color[i] = FloatToHalf(linear);
+                    alpha[i] = FloatToHalf(encoded);
+                };
+            };
+        };
+
+        template <typename T>
+        void Put(std::vector<uint8_t> &bytes, T value)
+        {
+            const uint8_t *data = reinterpret_cast<const uint8_t *>(&value);
+            bytes.insert(bytes.end(), data, data + sizeof(T));
+        };
+
+        void PutString(std::vector<uint8_t> &bytes, const char *value)
+        {
+            bytes.insert(bytes.end(), value, value + std::strlen(value) + 1);
+        };
+
+        void PutAttribute(std::vector<uint8_t> &bytes, const char *name, const char *type, uint32_t size)
+        {
+            PutString(bytes, name);
+            PutString(bytes, type);
+            Put<uint32_t>(bytes, size);
+        };
+
+        // OpenEXR is little endian, as is every platform the sandbox runs on.
+        bool WriteExr(const std::string &path, uint32_t width, uint32_t height, const uint8_t *pixels)
+        {
+            static const HalfTables tables;
+            // Channels are stored in alphabetical order.
+            const char *channels[] = {"A", "B", "G", "R"};
+            const uint32_t channelSource[] = {3, 2, 1, 0};
+
+            std::vector<uint8_t> header;
+            Put<uint32_t>(header, 20000630);
+            Put<uint32_t>(header, 2);
+
+            PutAttribute(header, "channels", "chlist", 4 * (2 + 16) + 1);
+            for (const char *channel : channels)
+            {
+                PutString(header, channel);
+                // HALF, not linear-perceptual, reserved, x and y sampling.
+                Put<uint32_t>(header, 1);
+                Put<uint32_t>(header, 0);
+                Put<int32_t>(header, 1);
+                Put<int32_t>(header, 1);
+            };
+            header.push_back(0);
+
+            PutAttribute(header, "compression", "compression", 1);
+            header.push_back(0);
+
+            for (const char *window : {"dataWindow", "displayWindow"})
+            {
+                PutAttribute(header, window, "box2i", 16);
+                Put<int32_t>(header, 0);
+                Put<int32_t>(header, 0);
+                Put<int32_t>(header, static_cast<int32_t>(width) - 1);
+                Put<int32_t>(header, static_cast<int32_t>(height) - 1);
+            };
+
+            PutAttribute(header, "lineOrder", "lineOrder", 1);
+            header.push_back(0);
+            PutAttribute(header, "pixelAspectRatio", "float", 4);
+            Put<float>(header, 1.0f);
+            PutAttribute(header, "screenWindowCenter", "v2f", 8);
+            Put<float>(header, 0.0f);
+            Put<float>(header, 0.0f);
+            PutAttribute(header, "screenWindowWidth", "float", 4);
+            Put<float>(header, 1.0f);
+            header.push_back(0);
+
+            // Without compression every chunk is one scanline: y, size and the channels one after another.
+            uint32_t lineSize = width * 4 * sizeof(uint16_t);
+            uint64_t chunkOffset = header.size() + static_cast<uint64_t>(height) * sizeof(uint64_t);
+            for (uint32_t y = 0; y < height; y++)
+            {
+                Put<uint64_t>(header, chunkOffset + static_cast<uint64_t>(y) * (8 + lineSize));
+            };
+
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+            {
+                return false;
+            };
+
+            file.write(reinterpret_cast<const char *>(header.data()), header.size());
+
+            std::vector<uint16_t> line(width * 4);
+            for (uint32_t y = 0; y < height; y++)
+            {
+                const uint8_t *row = pixels + static_cast<size_t>(y) * width * 4;
+
+                for (uint32_t c = 0; c < 4; c++)
+                {
+                    const uint16_t *table = channelSource[c] == 3 ? tables.alpha : tables.color;
+                    for (uint32_t x = 0; x < width; x++)
+                    {
+                        line[c * width + x] = table[row[x * 4 + channelSource[c]]];
+                    };
+                };
+
+                int32_t lineY = static_cast<int32_t>(y);
+                file.write(reinterpret_cast<const char *>(&lineY), sizeof(lineY));
+                file.write(reinterpret_cast<const char *>(&lineSize), sizeof(lineSize));
+                file.write(reinterpret_cast<const char *>(line.data()), lineSize);
+            };
+
+            return file.good();
+        };
+
+    };
+
+    const char *GetImageFileExtension(ImageFileFormat format)
+    {
+        switch (format)
+        {
+        case ImageFileFormat::Raw:
+            return "raw";
+        case ImageFileFormat::Exr:
+            return "exr";
+        default:
+            return "png";
+        };
+    };
+
+    bool WriteImage(const std::string &path, ImageFileFormat format, uint32_t width, uint32_t height, const uint8_t *pixels)
+    {
+        switch (format)
+        {
+        case ImageFileFormat::Png:
+            return stbi_write_png(path.c_str(), static_cast<int>(width), static_cast<int>(height), 4, pixels, static_cast<int>(width * 4)) != 0;
+        case ImageFileFormat::Exr:
+            return WriteExr(path, width, height, pixels);
+        case ImageFileFormat::Raw:
+        {
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char *>(pixels), static_cast<std::streamsize>(width) * height * 4);
+            return file.good();
+        };
+        };
+
+        return false;
+    };
+
+    void SetPngCompressionLevel(int level)
+    {
+        stbi_write_png_compression_level = level;
+    };
+
+};
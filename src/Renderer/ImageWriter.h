@@ -0,0 +1,24 @@
+#pragma once
+
+#include "../Common.h"
+
+namespace Renderer
+{
+    enum class ImageFileFormat
+    {
+        Png,
+        // Tightly packed RGBA8 rows, no header: the size is in the file name.
+        Raw,
+        // Uncompressed scanline OpenEXR with half RGBA channels, sRGB decoded to linear.
+        Exr
+    };
+
+    const char *GetImageFileExtension(ImageFileFormat format);
+
+    // pixels are tightly packed sRGB encoded RGBA8 rows, top row first. Safe to call from several threads at once.
+    bool WriteImage(const std::string &path, ImageFileFormat format, uint32_t width, uint32_t height, const uint8_t *pixels);
+
+    // zlib level of the PNG encoder, low levels trade file size for encoding speed.
+    void SetPngCompressionLevel(int level);
+
+};
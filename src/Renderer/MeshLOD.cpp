@@ -0,0 +1,191 @@
+#include "MeshLOD.h"
+#include "MeshSimplifier.h"
+#include "../Utils.h"
+#include "../Log.h"
+
+namespace Renderer
+{
+    namespace
+    {
+        const uint32_t LOD_CHAIN_MAGIC = 0x43444F4C; // "LODC"
+        const uint32_t LOD_CHAIN_VERSION = 1;
+
+        struct LODChainHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t levelCount;
+            uint32_t indexCount;
+            float center[3];
+            float radius;
+        };
+    };
+
+    LODChain BuildLODChain(const float *positions, size_t vertexCount, size_t vertexStride, const std::vector<uint32_t> &indices, const LODChainConfig &config)
+    {
+        LODChain chain;
+
+        // Bounding sphere around the box center, good enough for distance and error projection.
+        glm::vec3 minBounds(std::numeric_limits<float>::max());
+        glm::vec3 maxBounds(std::numeric_limits<float>::lowest());
+        for (size_t i = 0; i < vertexCount; i++)
+        {
+            const float *p = reinterpret_cast<const float *>(reinterpret_cast<const char *>(positions) + i * vertexStride);
+            minBounds = glm::min(minBounds, glm::vec3(p[0], p[1], p[2]));
+            maxBounds = glm::max(maxBounds, glm::vec3(p[0], p[1], p[2]));
+        };
+
+        chain.center = (minBounds + maxBounds) * 0.5f;
+        for (size_t i = 0; i < vertexCount; i++)
+        {
+            const float *p = reinterpret_cast<const float *>(reinterpret_cast<const char *>(positions) + i * vertexStride);
+            chain.radius = (std::max)(chain.radius, glm::length(glm::vec3(p[0], p[1], p[2]) - chain.center));
+        };
+
+        chain.indices = indices;
+        chain.levels.push_back({0, static_cast<uint32_t>(indices.size()), 0.0f});
+
+        size_t targetIndexCount = indices.size();
+
+        while (chain.levels.size() < config.maxLevels)
+        {
+            targetIndexCount = static_cast<size_t>(targetIndexCount * config.reduction) / 3 * 3;
+            if (targetIndexCount < config.minIndexCount)
+            {
+                break;
+            };
+
+            // Every level is simplified from the source mesh, so its error is measured against LOD 0.
+            SimplifyConfig simplifyConfig;
+            simplifyConfig.targetIndexCount = targetIndexCount;
+            simplifyConfig.targetError = config.maxError;
+
+            float error = 0.0f;
+            std::vector<uint32_t> levelIndices = MeshSimplifier::Simplify(positions, vertexCount, vertexStride, indices, simplifyConfig, &error);
+
+            const LODLevel &previous = chain.levels.back();
+
+            // No meaningful reduction left within the error bound.
+            if (levelIndices.size() > previous.indexCount * 0.95f)
+            {
+                break;
+            };
+
+            chain.levels.push_back({static_cast<uint32_t>(chain.indices.size()), static_cast<uint32_t>(levelIndices.size()), (std::max)(error, previous.error)});
+            chain.indices.insert(chain.indices.end(), levelIndices.begin(), levelIndices.end());
+        };
+
+        return chain;
+    };
+
+    void SaveLODChain(const std::string &path, const LODChain &chain)
+    {
+        std::ofstream file(path, std::ios::binary);
+
+        if (!file.is_open())
+        {
+            throw std::runtime_error("Failed to open file!");
+        };
+
+        LODChainHeader header{};
+        header.magic = LOD_CHAIN_MAGIC;
+        header.version = LOD_CHAIN_VERSION;
+        header.levelCount = static_cast<uint32_t>(chain.levels.size());
+        header.indexCount = static_cast<uint32_t>(chain.indices.size());
+        header.center[0] = chain.center.x;
+        header.center[1] = chain.center.y;
+        header.center[2] = chain.center.z;
+        header.radius = chain.radius;
+
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(chain.levels.data()), chain.levels.size() * sizeof(LODLevel));
+        file.write(reinterpret_cast<const char *>(chain.indices.data()), chain.indices.size() * sizeof(uint32_t));
+    };
+
+    LODChain LoadLODChain(const std::string &path)
+    {
+        std::vector<char> data = ReadFile(path);
+
+        LODChainHeader header;
+        if (data.size() < sizeof(header))
+        {
+            throw std::runtime_error("LOD chain file is truncated!");
+        };
+
+        memcpy(&header, data.data(), sizeof(header));
+
+        if (header.magic != LOD_CHAIN_MAGIC || header.version != LOD_CHAIN_VERSION)
+        {
+            throw std::runtime_error("Unsupported LOD chain file!");
+        };
+
+        if (header.levelCount == 0)
+        {
+            throw std::runtime_error("LOD chain file has no levels!");
+        };
+
+        size_t levelsSize = static_cast<size_t>(header.levelCount) * sizeof(LODLevel);
+        size_t indicesSize = static_cast<size_t>(header.indexCount) * sizeof(uint32_t);
+
+        if (data.size() < sizeof(header) + levelsSize + indicesSize)
+        {
+            throw std::runtime_error("LOD chain file is truncated!");
+        };
+
+        LODChain chain;
+        chain.center = glm::vec3(header.center[0], header.center[1], header.center[2]);
+        chain.radius = header.radius;
+        chain.levels.resize(header.levelCount);
+        chain.indices.resize(header.indexCount);
+
+        memcpy(chain.levels.data(), data.data() + sizeof(header), levelsSize);
+        memcpy(chain.indices.data(), data.data() + sizeof(header) + levelsSize, indicesSize);
+
+        // Levels are drawn straight from the index buffer, each must lie within it.
+        for (const LODLevel &level : chain.levels)
+        {
+            if (level.firstIndex > header.indexCount || level.indexCount > header.indexCount - level.firstIndex)
+            {
+                throw std::runtime_error("LOD chain level is out of bounds!");
+            };
+        };
+
+        return chain;
+    };
+
+    uint32_t SelectLOD(const LODChain &chain, const glm::vec3 &worldCenter, float scale, const Camera &camera, uint32_t currentLevel, const LODSelectionConfig &config)
+    {
+        uint32_t lastLevel = static_cast<uint32_t>(chain.levels.size()) - 1;
+        currentLevel = (std::min)(currentLevel, lastLevel);
+
+        float distance = glm::length(worldCenter - camera.position) - chain.radius * scale;
+
+        if (config.maxDistance > 0.0f && distance > config.maxDistance)
+        {
+            return lastLevel;
+        };
+
+        auto projectedError = [&](uint32_t level)
+        { return camera.ProjectLength(chain.levels[level].error * scale, distance); };
+
+        uint32_t level = 0;
+        for (uint32_t i = lastLevel; i > 0; i--)
+        {
+            if (projectedError(i) <= config.pixelError)
+            {
+                level = i;
+                break;
+            };
+        };
+
+        // Refining happens immediately, coarsening needs a margin below the threshold.
+        float coarsenThreshold = config.pixelError * (1.0f - config.hysteresis);
+        while (level > currentLevel && projectedError(level) > coarsenThreshold)
+        {
+            level--;
+        };
+
+        return level;
+    };
+
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "../Common.h"
+#include "Camera.h"
+
+namespace Renderer
+{
+    struct LODLevel
+    {
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        // Object-space geometric deviation from LOD 0.
+        float error;
+    };
+
+    // All levels live in one index buffer and share the source vertex buffer.
+    struct LODChain
+    {
+        std::vector<uint32_t> indices;
+        std::vector<LODLevel> levels;
+        glm::vec3 center = glm::vec3(0.0f);
+        float radius = 0.0f;
+    };
+
+    struct LODChainConfig
+    {
+        uint32_t maxLevels = 6;
+        // Index count ratio between consecutive levels.
+        float reduction = 0.5f;
+        // Largest error a level may introduce, relative to the mesh extent.
+        float maxError = 0.05f;
+        size_t minIndexCount = 96;
+    };
+
+    struct LODSelectionConfig
+    {
+        // Largest tolerated on-screen deviation.
+        float pixelError = 1.0f;
+        // A coarser level is only taken once its error is this fraction below the threshold, to avoid popping.
+        float hysteresis = 0.25f;
+        // Beyond this distance the coarsest level is used, 0 disables it.
+        float maxDistance = 0.0f;
+    };
+
+    LODChain BuildLODChain(const float *positions, size_t vertexCount, size_t vertexStride, const std::vector<uint32_t> &indices, const LODChainConfig &config);
+
+    // Offline baked chains, so large meshes do not pay for simplification at load time.
+    void SaveLODChain(const std::string &path, const LODChain &chain);
+    LODChain LoadLODChain(const std::string &path);
+
+    // Picks the coarsest level whose projected error stays under the pixel threshold. scale is the largest
+    // axis scale of the object transform.
+    uint32_t SelectLOD(const LODChain &chain, const glm::vec3 &worldCenter, float scale, const Camera &camera, uint32_t currentLevel, const LODSelectionConfig &config);
+
+};
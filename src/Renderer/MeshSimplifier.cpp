@@ -0,0 +1,346 @@
+#include "MeshSimplifier.h"
+
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <cmath>
+
+namespace Renderer
+{
+    namespace
+    {
+        // Symmetric 4x4 plane quadric, weighted by triangle area.
+        struct Quadric
+        {
+            double a00 = 0, a01 = 0, a02 = 0, a03 = 0;
+            double a11 = 0, a12 = 0, a13 = 0;
+            double a22 = 0, a23 = 0;
+            double a33 = 0;
+            double weight = 0;
+
+            void AddPlane(const glm::dvec3 &normal, double distance, double area)
+            {
+                a00 += area * normal.x * normal.x;
+                a01 += area * normal.x * normal.y;
+                a02 += area * normal.x * normal.z;
+                a03 += area * normal.x * distance;
+                a11 += area * normal.y * normal.y;
+                a12 += area * normal.y * normal.z;
+                a13 += area * normal.y * distance;
+                a22 += area * normal.z * normal.z;
+                a23 += area * normal.z * distance;
+                a33 += area * distance * distance;
+                weight += area;
+            };
+
+            void Add(const Quadric &other)
+            {
+                a00 += other.a00;
+                a01 += other.a01;
+                a02 += other.a02;
+                a03 += other.a03;
+                a11 += other.a11;
+                a12 += other.a12;
+                a13 += other.a13;
+                a22 += other.a22;
+                a23 += other.a23;
+                a33 += other.a33;
+                weight += other.weight;
+            };
+
+            double Evaluate(const glm::dvec3 &v) const
+            {
+                double error = a00 * v.x * v.x + 2 * a01 * v.x * v.y + 2 * a02 * v.x * v.z + 2 * a03 * v.x +
+                               a11 * v.y * v.y + 2 * a12 * v.y * v.z + 2 * a13 * v.y +
+                               a22 * v.z * v.z + 2 * a23 * v.z +
+                               a33;
+
+                return std::fabs(error);
+            };
+        };
+
+        struct Collapse
+        {
+            uint32_t source;
+            uint32_t target;
+            double cost;
+        };
+
+        glm::dvec3 LoadPosition(const float *positions, size_t vertexStride, uint32_t index)
+        {
+            const float *p = reinterpret_cast<const float *>(reinterpret_cast<const char *>(positions) + index * vertexStride);
+            return glm::dvec3(p[0], p[1], p[2]);
+        };
+
+        double CollapseCost(const std::vector<Quadric> &quadrics, const std::vector<glm::dvec3> &positions, uint32_t source, uint32_t target)
+        {
+            Quadric q = quadrics[source];
+            q.Add(quadrics[target]);
+
+            // Normalizing by area keeps the cost in squared distance units.
+            return q.weight > 0 ? q.Evaluate(positions[target]) / q.weight : 0.0;
+        };
+
+        bool FlipsTriangles(const std::vector<glm::dvec3> &positions, const std::vector<uint32_t> &indices, const std::vector<uint32_t> &vertexTriangles, uint32_t begin, uint32_t end, uint32_t source, uint32_t target)
+        {
+            for (uint32_t i = begin; i < end; i++)
+            {
+                uint32_t triangle = vertexTriangles[i];
+                uint32_t a = indices[triangle * 3 + 0];
+                uint32_t b = indices[triangle * 3 + 1];
+                uint32_t c = indices[triangle * 3 + 2];
+
+                // Triangles containing the edge collapse away.
+                if (a == target || b == target || c == target)
+                {
+                    continue;
+                };
+
+                glm::dvec3 before = glm::cross(positions[b] - positions[a], positions[c] - positions[a]);
+
+                glm::dvec3 pa = positions[a == source ? target : a];
+                glm::dvec3 pb = positions[b == source ? target : b];
+                glm::dvec3 pc = positions[c == source ? target : c];
+                glm::dvec3 after = glm::cross(pb - pa, pc - pa);
+
+                if (glm::dot(before, after) <= 0.0)
+                {
+                    return true;
+                };
+            };
+
+            return false;
+        };
+    };
+
+    namespace MeshSimplifier
+    {
+
+        float ComputeExtent(const float *positions, size_t vertexCount, size_t vertexStride)
+        {
+            if (vertexCount == 0)
+            {
+                return 0.0f;
+            };
+
+            glm::dvec3 minBounds = LoadPosition(positions, vertexStride, 0);
+            glm::dvec3 maxBounds = minBounds;
+
+            for (uint32_t i = 1; i < vertexCount; i++)
+            {
+                glm::dvec3 p = LoadPosition(positions, vertexStride, i);
+                minBounds = glm::min(minBounds, p);
+                maxBounds = glm::max(maxBounds, p);
+            };
+
+            glm::dvec3 size = maxBounds - minBounds;
+            return static_cast<float>((std::max)({size.x, size.y, size.z}));
+        };
+
+        std::vector<uint32_t> Simplify(const float *positions, size_t vertexCount, size_t vertexStride, const std::vector<uint32_t> &indices, const SimplifyConfig &config, float *resultError)
+        {
+            std::vector<uint32_t> result = indices;
+            double maxCost = 0.0;
+
+            std::vector<glm::dvec3> vertexPositions(vertexCount);
+            for (uint32_t i = 0; i < vertexCount; i++)
+            {
+                vertexPositions[i] = LoadPosition(positions, vertexStride, i);
+            };
+
+            double extent = ComputeExtent(positions, vertexCount, vertexStride);
+            double maxError = config.targetError * extent;
+            double maxErrorSquared = maxError * maxError;
+
+            // Quadrics are built once from the original surface and accumulated on every collapse.
+            std::vector<Quadric> quadrics(vertexCount);
+            for (size_t i = 0; i + 2 < result.size(); i += 3)
+            {
+                const glm::dvec3 &p0 = vertexPositions[result[i + 0]];
+                const glm::dvec3 &p1 = vertexPositions[result[i + 1]];
+                const glm::dvec3 &p2 = vertexPositions[result[i + 2]];
+
+                glm::dvec3 normal = glm::cross(p1 - p0, p2 - p0);
+                double length = glm::length(normal);
+                if (length == 0.0)
+                {
+                    continue;
+                };
+
+                normal /= length;
+                double distance = -glm::dot(normal, p0);
+                double area = length * 0.5;
+
+                for (int k = 0; k < 3; k++)
+                {
+                    quadrics[result[i + k]].AddPlane(normal, distance, area);
+                };
+            };
+
+            // Edges used by a single triangle are open borders or attribute seams, their vertices never move.
+            std::vector<bool> locked(vertexCount, false);
+            {
+                std::unordered_map<uint64_t, uint32_t> edgeUse;
+                for (size_t i = 0; i + 2 < result.size(); i += 3)
+                {
+                    for (int k = 0; k < 3; k++)
+                    {
+                        uint32_t a = result[i + k];
+                        uint32_t b = result[i + (k + 1) % 3];
+                        uint64_t key = (uint64_t((std::min)(a, b)) << 32) | (std::max)(a, b);
+                        edgeUse[key]++;
+                    };
+                };
+
+                for (const auto &[key, count] : edgeUse)
+                {
+                    if (count == 1)
+                    {
+                        locked[key >> 32] = true;
+                        locked[key & 0xffffffff] = true;
+                    };
+                };
+            };
+
+            std::vector<uint32_t> remap(vertexCount);
+            std::vector<bool> touched(vertexCount);
+            std::vector<uint32_t> triangleOffsets(vertexCount + 1);
+            std::vector<uint32_t> vertexTriangles;
+            std::vector<Collapse> collapses;
+
+            while (result.size() > config.targetIndexCount)
+            {
+                size_t triangleCount = result.size() / 3;
+
+                // Vertex -> triangle adjacency, rebuilt every pass.
+                std::fill(triangleOffsets.begin(), triangleOffsets.end(), 0);
+                for (uint32_t index : result)
+                {
+                    triangleOffsets[index + 1]++;
+                };
+                for (size_t i = 0; i < vertexCount; i++)
+                {
+                    triangleOffsets[i + 1] += triangleOffsets[i];
+                };
+
+                vertexTriangles.resize(result.size());
+                std::vector<uint32_t> fill(triangleOffsets.begin(), triangleOffsets.end() - 1);
+                for (uint32_t triangle = 0; triangle < triangleCount; triangle++)
+                {
+                    for (int k = 0; k < 3; k++)
+                    {
+                        vertexTriangles[fill[result[triangle * 3 + k]]++] = triangle;
+                    };
+                };
+
+                // Cheapest direction of every edge.
+                collapses.clear();
+                for (size_t i = 0; i < result.size(); i += 3)
+                {
+                    for (int k = 0; k < 3; k++)
+                    {
+                        uint32_t a = result[i + k];
+                        uint32_t b = result[i + (k + 1) % 3];
+
+                        // Each interior edge is seen twice, keep one.
+                        if (a > b)
+                        {
+                            continue;
+                        };
+
+                        double costAB = locked[a] ? HUGE_VAL : CollapseCost(quadrics, vertexPositions, a, b);
+                        double costBA = locked[b] ? HUGE_VAL : CollapseCost(quadrics, vertexPositions, b, a);
+
+                        if (costAB == HUGE_VAL && costBA == HUGE_VAL)
+                        {
+                            continue;
+                        };
+
+                        collapses.push_back(costAB <= costBA ? Collapse{a, b, costAB} : Collapse{b, a, costBA});
+                    };
+                };
+
+                std::sort(collapses.begin(), collapses.end(), [](const Collapse &x, const Collapse &y)
+                          { return x.cost < y.cost; });
+
+                for (uint32_t i = 0; i < vertexCount; i++)
+                {
+                    remap[i] = i;
+                };
+                std::fill(touched.begin(), touched.end(), false);
+
+                // Each collapse removes roughly two triangles.
+                size_t removableTriangles = (result.size() - config.targetIndexCount) / 3;
+                size_t collapseCount = 0;
+
+                for (const auto &collapse : collapses)
+                {
+                    if (collapse.cost > maxErrorSquared || collapseCount * 2 >= removableTriangles)
+                    {
+                        break;
+                    };
+
+                    if (touched[collapse.source] || touched[collapse.target])
+                    {
+                        continue;
+                    };
+
+                    uint32_t begin = triangleOffsets[collapse.source];
+                    uint32_t end = triangleOffsets[collapse.source + 1];
+
+                    if (FlipsTriangles(vertexPositions, result, vertexTriangles, begin, end, collapse.source, collapse.target))
+                    {
+                        continue;
+                    };
+
+                    remap[collapse.source] = collapse.target;
+                    quadrics[collapse.target].Add(quadrics[collapse.source]);
+                    maxCost = (std::max)(maxCost, collapse.cost);
+
+                    // Freeze the one-ring so flip checks of later collapses in this pass stay valid.
+                    for (uint32_t t = begin; t < end; t++)
+                    {
+                        uint32_t triangle = vertexTriangles[t];
+                        touched[result[triangle * 3 + 0]] = true;
+                        touched[result[triangle * 3 + 1]] = true;
+                        touched[result[triangle * 3 + 2]] = true;
+                    };
+
+                    collapseCount++;
+                };
+
+                if (collapseCount == 0)
+                {
+                    break;
+                };
+
+                size_t writeIndex = 0;
+                for (size_t i = 0; i < result.size(); i += 3)
+                {
+                    uint32_t a = remap[result[i + 0]];
+                    uint32_t b = remap[result[i + 1]];
+                    uint32_t c = remap[result[i + 2]];
+
+                    if (a == b || b == c || a == c)
+                    {
+                        continue;
+                    };
+
+                    result[writeIndex++] = a;
+                    result[writeIndex++] = b;
+                    result[writeIndex++] = c;
+                };
+
+                result.resize(writeIndex);
+            };
+
+            if (resultError != nullptr)
+            {
+                *resultError = static_cast<float>(std::sqrt(maxCost));
+            };
+
+            return result;
+        };
+
+    };
+
+};
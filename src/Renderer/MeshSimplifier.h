@@ -0,0 +1,25 @@
+#pragma once
+
+#include "../Common.h"
+
+namespace Renderer
+{
+    struct SimplifyConfig
+    {
+        // Stop once the index count drops to this value.
+        size_t targetIndexCount = 0;
+        // Largest allowed geometric error, relative to the mesh extent (0.01 = 1% of the bounding box).
+        float targetError = 0.01f;
+    };
+
+    namespace MeshSimplifier
+    {
+        // Quadric error metric edge collapse. The output indexes into the original vertex buffer, so every LOD
+        // shares the same vertices. Vertices on open borders and attribute seams are locked to avoid cracks.
+        // resultError receives the absolute object-space error of the simplified mesh.
+        std::vector<uint32_t> Simplify(const float *positions, size_t vertexCount, size_t vertexStride, const std::vector<uint32_t> &indices, const SimplifyConfig &config, float *resultError = nullptr);
+
+        float ComputeExtent(const float *positions, size_t vertexCount, size_t vertexStride);
+    };
+
+};
@@ -0,0 +1,203 @@
+#include "OcclusionCuller.h"
+#include "../Vulkan-Core/Utils.h"
+#include "../Log.h"
+
+namespace Renderer
+{
+    namespace
+    {
+        // Mirrors the CullInput block of cull.comp.
+        struct CullInputHeader
+        {
+            glm::mat4 viewProjection;
+            glm::mat4 previousViewProjection;
+            glm::vec4 pyramidSize;
+            uint32_t drawCount;
+            uint32_t padding[3];
+        };
+
+        struct CullDraw
+        {
+            glm::vec4 boundingSphere;
+            uint32_t indexCount;
+            uint32_t firstIndex;
+            int32_t vertexOffset;
+            uint32_t padding;
+        };
+
+        struct CullCounters
+        {
+            uint32_t visible;
+            uint32_t frustumCulled;
+            uint32_t occlusionCulled;
+            uint32_t padding;
+        };
+
+        const uint32_t CULL_GROUP_SIZE = 64;
+    };
+
+    void OcclusionCuller::Create(const OcclusionCullerConfig &config, const VulkanCore::Device &device, VulkanCore::DescriptorPool &descriptorPool)
+    {
+        m_Config = config;
+        m_DeviceInst = &device;
+
+        VkDevice vkDevice = m_DeviceInst->Get();
+        const VkPhysicalDeviceMemoryProperties &memoryProperties = m_DeviceInst->GetMemoryProperties();
+
+        VulkanCore::ComputePipelineConfig pipelineConfig;
+        pipelineConfig.shaderPath = "assets/shaders/spv/cull.comp.spv";
+        pipelineConfig.localSizeX = CULL_GROUP_SIZE;
+        pipelineConfig.bindings = {
+            {0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+            {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+            {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+            {3, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}};
+
+        m_CullPipeline.Create(pipelineConfig, *m_DeviceInst);
+
+        VkDeviceSize drawBufferSize = m_Config.maxDraws * sizeof(VkDrawIndexedIndirectCommand);
+        VulkanCore::Utils::CreateBuffer(vkDevice, memoryProperties, drawBufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_DrawBuffer, m_DrawBufferMemory);
+
+        // Each frame binds its own counters, so the slots respect the storage buffer offset alignment.
+        VkDeviceSize alignment = m_DeviceInst->GetProperties().limits.minStorageBufferOffsetAlignment;
+        m_StatsStride = (sizeof(CullCounters) + alignment - 1) / alignment * alignment;
+
+        VulkanCore::Utils::CreateBuffer(vkDevice, memoryProperties, m_Config.framesInFlight * m_StatsStride, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_StatsBuffer, m_StatsBufferMemory);
+        vkMapMemory(vkDevice, m_StatsBufferMemory, 0, VK_WHOLE_SIZE, 0, &m_StatsData);
+
+        VkDeviceSize inputBufferSize = sizeof(CullInputHeader) + m_Config.maxDraws * sizeof(CullDraw);
+
+        m_InputBuffers.resize(m_Config.framesInFlight);
+        m_InputBufferMemory.resize(m_Config.framesInFlight);
+        m_InputData.resize(m_Config.framesInFlight);
+        m_DescriptorSets.resize(m_Config.framesInFlight);
+        m_StatsPending.resize(m_Config.framesInFlight, false);
+
+        for (uint32_t i = 0; i < m_Config.framesInFlight; i++)
+        {
+            VulkanCore::Utils::CreateBuffer(vkDevice, memoryProperties, inputBufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_InputBuffers[i], m_InputBufferMemory[i]);
+            vkMapMemory(vkDevice, m_InputBufferMemory[i], 0, inputBufferSize, 0, &m_InputData[i]);
+
+            m_DescriptorSets[i] = descriptorPool.Allocate(m_CullPipeline.GetDescriptorSetLayout());
+
+            VulkanCore::Utils::WriteBufferDescriptor(vkDevice, m_DescriptorSets[i], 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, m_InputBuffers[i]);
+            VulkanCore::Utils::WriteBufferDescriptor(vkDevice, m_DescriptorSets[i], 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, m_DrawBuffer);
+
+            VkDescriptorBufferInfo statsInfo{m_StatsBuffer, i * m_StatsStride, sizeof(CullCounters)};
+
+            VkWriteDescriptorSet descriptorWrite{};
+            descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptorWrite.dstSet = m_DescriptorSets[i];
+            descriptorWrite.dstBinding = 2;
+            descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            descriptorWrite.descriptorCount = 1;
+            descriptorWrite.pBufferInfo = &statsInfo;
+
+            vkUpdateDescriptorSets(vkDevice, 1, &descriptorWrite, 0, nullptr);
+        };
+    };
+
+    void OcclusionCuller::Destroy()
+    {
+        VkDevice vkDevice = m_DeviceInst->Get();
+
+        for (uint32_t i = 0; i < m_Config.framesInFlight; i++)
+        {
+            vkUnmapMemory(vkDevice, m_InputBufferMemory[i]);
+            vkDestroyBuffer(vkDevice, m_InputBuffers[i], nullptr);
+            vkFreeMemory(vkDevice, m_InputBufferMemory[i], nullptr);
+        };
+
+        vkUnmapMemory(vkDevice, m_StatsBufferMemory);
+        vkDestroyBuffer(vkDevice, m_StatsBuffer, nullptr);
+        vkFreeMemory(vkDevice, m_StatsBufferMemory, nullptr);
+        vkDestroyBuffer(vkDevice, m_DrawBuffer, nullptr);
+        vkFreeMemory(vkDevice, m_DrawBufferMemory, nullptr);
+
+        m_CullPipeline.Destroy();
+    };
+
+    void OcclusionCuller::SetPyramid(VkImageView pyramidView, VkSampler sampler, VkExtent2D extent, uint32_t levelCount)
+    {
+        m_PyramidExtent = extent;
+        m_PyramidLevels = levelCount;
+
+        VkDescriptorImageInfo imageInfo{};
+        imageInfo.sampler = sampler;
+        imageInfo.imageView = pyramidView;
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        for (VkDescriptorSet descriptorSet : m_DescriptorSets)
+        {
+            VkWriteDescriptorSet descriptorWrite{};
+            descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptorWrite.dstSet = descriptorSet;
+            descriptorWrite.dstBinding = 3;
+            descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            descriptorWrite.descriptorCount = 1;
+            descriptorWrite.pImageInfo = &imageInfo;
+
+            vkUpdateDescriptorSets(m_DeviceInst->Get(), 1, &descriptorWrite, 0, nullptr);
+        };
+    };
+
+    void OcclusionCuller::Cull(VkCommandBuffer commandBuffer, uint32_t frame, const DrawList &drawList, const Camera &camera, bool pyramidValid)
+    {
+        const VulkanCore::DeviceDispatch &dispatch = m_DeviceInst->GetDispatch();
+
+        const std::vector<DrawCommand> &draws = drawList.Get();
+        uint32_t drawCount = static_cast<uint32_t>((std::min)(draws.size(), static_cast<size_t>(m_Config.maxDraws)));
+
+        CORE_ASSERT(draws.size() <= m_Config.maxDraws, "Draw list exceeds the occlusion culler capacity!");
+
+        glm::mat4 viewProjection = camera.GetViewProjection();
+
+        CullInputHeader *header = static_cast<CullInputHeader *>(m_InputData[frame]);
+        header->viewProjection = viewProjection;
+        header->previousViewProjection = m_PreviousViewProjection;
+        header->pyramidSize = glm::vec4(static_cast<float>(m_PyramidExtent.width), static_cast<float>(m_PyramidExtent.height), static_cast<float>(m_PyramidLevels), pyramidValid && m_PyramidLevels > 0 ? 1.0f : 0.0f);
+        header->drawCount = drawCount;
+
+        CullDraw *cullDraws = reinterpret_cast<CullDraw *>(header + 1);
+        for (uint32_t i = 0; i < drawCount; i++)
+        {
+            cullDraws[i].boundingSphere = draws[i].boundingSphere;
+            cullDraws[i].indexCount = draws[i].indexCount;
+            cullDraws[i].firstIndex = draws[i].firstIndex;
+            cullDraws[i].vertexOffset = draws[i].vertexOffset;
+        };
+
+        // The previous frame's indirect reads of the draw buffer finish before it is rewritten.
+        VulkanCore::Utils::GlobalBarrier(dispatch, commandBuffer, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0, VK_PIPELINE_STAGE_TRANSFER_BIT, 0);
+
+        dispatch.vkCmdFillBuffer(commandBuffer, m_StatsBuffer, frame * m_StatsStride, sizeof(CullCounters), 0);
+
+        VulkanCore::Utils::GlobalBarrier(dispatch, commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+        m_CullPipeline.Bind(commandBuffer);
+        m_CullPipeline.BindDescriptorSet(commandBuffer, m_DescriptorSets[frame]);
+        m_CullPipeline.DispatchThreads(commandBuffer, drawCount);
+
+        VulkanCore::Utils::GlobalBarrier(dispatch, commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_HOST_READ_BIT);
+
+        m_PreviousViewProjection = viewProjection;
+        m_StatsPending[frame] = true;
+    };
+
+    bool OcclusionCuller::ReadStats(uint32_t frame, CullStats &stats)
+    {
+        if (!m_StatsPending[frame])
+        {
+            return false;
+        };
+
+        const CullCounters *counters = reinterpret_cast<const CullCounters *>(static_cast<const char *>(m_StatsData) + frame * m_StatsStride);
+        stats.visible = counters->visible;
+        stats.frustumCulled = counters->frustumCulled;
+        stats.occlusionCulled = counters->occlusionCulled;
+
+        m_StatsPending[frame] = false;
+        return true;
+    };
+
+};
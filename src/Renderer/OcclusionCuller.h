@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+
+#include "../Common.h"
+#include "../Vulkan-Core/Device.h"
+#include "../Vulkan-Core/ComputePipeline.h"
+#include "../Vulkan-Core/DescriptorPool.h"
+#include "Camera.h"
+#include "DrawList.h"
+
+namespace Renderer
+{
+    struct OcclusionCullerConfig
+    {
+        uint32_t maxDraws = 4096;
+        uint32_t framesInFlight = 2;
+    };
+
+    struct CullStats
+    {
+        uint32_t visible = 0;
+        uint32_t frustumCulled = 0;
+        uint32_t occlusionCulled = 0;
+    };
+
+    // Frustum and Hi-Z tests on the GPU. Occlusion uses the previous frame's pyramid reprojected with the
+    // camera it was rendered with, so anything newly disoccluded shows up one frame late.
+    class OcclusionCuller
+    {
+    public:
+        OcclusionCuller() = default;
+        ~OcclusionCuller() = default;
+        OcclusionCuller(const OcclusionCuller &) = delete;
+        OcclusionCuller &operator=(const OcclusionCuller &) = delete;
+
+        void Create(const OcclusionCullerConfig &config, const VulkanCore::Device &device, VulkanCore::DescriptorPool &descriptorPool);
+        void Destroy();
+
+        // Must not be called while frames are in flight.
+        void SetPyramid(VkImageView pyramidView, VkSampler sampler, VkExtent2D extent, uint32_t levelCount);
+
+        // Writes one VkDrawIndexedIndirectCommand per draw, hidden draws get zero instances. pyramidValid
+        // tells whether the pyramid holds the depth of the previous frame.
+        void Cull(VkCommandBuffer commandBuffer, uint32_t frame, const DrawList &drawList, const Camera &camera, bool pyramidValid);
+
+        // Counters of the last Cull in this frame slot, false while none are pending.
+        bool ReadStats(uint32_t frame, CullStats &stats);
+
+        VkBuffer GetDrawBuffer() { return m_DrawBuffer; };
+
+    private:
+        OcclusionCullerConfig m_Config;
+        const VulkanCore::Device *m_DeviceInst = nullptr;
+        VulkanCore::ComputePipeline m_CullPipeline;
+        std::vector<VkDescriptorSet> m_DescriptorSets;
+
+        // Per frame: camera, pyramid info and draw bounds written by the CPU.
+        std::vector<VkBuffer> m_InputBuffers;
+        std::vector<VkDeviceMemory> m_InputBufferMemory;
+        std::vector<void *> m_InputData;
+
+        // Per frame counters written by the shader and read on the host.
+        VkBuffer m_StatsBuffer;
+        VkDeviceMemory m_StatsBufferMemory;
+        void *m_StatsData = nullptr;
+        VkDeviceSize m_StatsStride = 0;
+        std::vector<bool> m_StatsPending;
+
+        VkBuffer m_DrawBuffer;
+        VkDeviceMemory m_DrawBufferMemory;
+
+        VkExtent2D m_PyramidExtent = {0, 0};
+        uint32_t m_PyramidLevels = 0;
+        glm::mat4 m_PreviousViewProjection = glm::mat4(1.0f);
+    };
+
+};
@@ -0,0 +1,466 @@
+#include "ParticleSystem.h"
+#include "../Vulkan-Core/ShaderModule.h"
+#include "../Vulkan-Core/Utils.h"
+#include "../Log.h"
+
+#include <cstddef>
+#include <numeric>
+
+namespace Renderer
+{
+    namespace
+    {
+        struct Particle
+        {
+            glm::vec4 positionLife;
+            glm::vec4 velocityMaxLife;
+            glm::vec4 color;
+        };
+
+        // Mirrors the Counters block of the particle shaders.
+        struct ParticleCounters
+        {
+            int32_t aliveCount[2];
+            int32_t deadCount;
+            uint32_t renderCount;
+            VkDispatchIndirectCommand dispatchArgs;
+            uint32_t dispatchPadding;
+            VkDrawIndirectCommand drawArgs;
+        };
+
+        struct SimulationConstants
+        {
+            glm::vec4 emitterPosition;
+            glm::vec4 emitterVelocity;
+            glm::vec4 gravity;
+            glm::vec2 lifetime;
+            uint32_t emitCount;
+            uint32_t seed;
+            uint32_t current;
+            uint32_t capacity;
+            uint32_t mode;
+        };
+
+        struct RenderConstants
+        {
+            glm::mat4 viewProjection;
+            glm::vec4 cameraRight;
+            glm::vec4 cameraUp;
+            uint32_t renderList;
+            uint32_t capacity;
+        };
+
+        const uint32_t PARTICLE_GROUP_SIZE = 64;
+
+        const VkPipelineStageFlags COMPUTE_STAGE = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        const VkAccessFlags COMPUTE_ACCESS = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    };
+
+    void ParticleSystem::Create(const ParticleSystemConfig &config, const VulkanCore::Device &device, VulkanCore::DescriptorPool &descriptorPool, VkCommandPool commandPool)
+    {
+        m_Config = config;
+        m_DeviceInst = &device;
+
+        const VulkanCore::DeviceDispatch &dispatch = m_DeviceInst->GetDispatch();
+
+        VkDevice vkDevice = m_DeviceInst->Get();
+        VkPhysicalDevice physicalDevice = m_DeviceInst->GetPhysical();
+        const VkPhysicalDeviceMemoryProperties &memoryProperties = m_DeviceInst->GetMemoryProperties();
+        const VulkanCore::QueueFamilyIndices &queueFamilies = m_DeviceInst->GetQueueFamilies();
+
+        // Written on the compute queue and read by graphics, shared instead of transferred every frame.
+        std::vector<uint32_t> sharedFamilies = {queueFamilies.graphicsFamily.value(), queueFamilies.computeFamily.value()};
+        VkBufferUsageFlags storageUsage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        VkDeviceSize capacity = m_Config.maxParticles;
+
+        VulkanCore::Utils::CreateBuffer(vkDevice, memoryProperties, capacity * sizeof(Particle), storageUsage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_ParticleBuffer, m_ParticleBufferMemory, sharedFamilies);
+        VulkanCore::Utils::CreateBuffer(vkDevice, memoryProperties, capacity * 2 * sizeof(uint32_t), storageUsage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_AliveBuffer, m_AliveBufferMemory, sharedFamilies);
+        VulkanCore::Utils::CreateBuffer(vkDevice, memoryProperties, capacity * sizeof(uint32_t), storageUsage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_DeadBuffer, m_DeadBufferMemory, sharedFamilies);
+        VulkanCore::Utils::CreateBuffer(vkDevice, memoryProperties, sizeof(ParticleCounters), storageUsage | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_CounterBuffer, m_CounterBufferMemory, sharedFamilies);
+
+        VulkanCore::Utils::CreateBuffer(vkDevice, memoryProperties, m_Config.framesInFlight * sizeof(ParticleCounters), VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_ReadbackBuffer, m_ReadbackBufferMemory, sharedFamilies);
+        vkMapMemory(vkDevice, m_ReadbackBufferMemory, 0, VK_WHOLE_SIZE, 0, &m_ReadbackData);
+
+        // Initial state: every slot free, nothing alive.
+        ParticleCounters counters{};
+        counters.deadCount = static_cast<int32_t>(m_Config.maxParticles);
+        counters.dispatchArgs = {0, 1, 1};
+        counters.drawArgs = {6, 0, 0, 0};
+
+        VkDeviceSize deadListSize = capacity * sizeof(uint32_t);
+        VkDeviceSize stagingSize = deadListSize + sizeof(ParticleCounters);
+
+        VkBuffer stagingBuffer;
+        VkDeviceMemory stagingBufferMemory;
+        VulkanCore::Utils::CreateBuffer(vkDevice, memoryProperties, stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
+
+        void *data;
+        vkMapMemory(vkDevice, stagingBufferMemory, 0, stagingSize, 0, &data);
+        uint32_t *deadList = static_cast<uint32_t *>(data);
+        std::iota(deadList, deadList + m_Config.maxParticles, 0u);
+        memcpy(static_cast<char *>(data) + deadListSize, &counters, sizeof(counters));
+        vkUnmapMemory(vkDevice, stagingBufferMemory);
+
+        VkCommandBuffer commandBuffer = VulkanCore::Utils::BeginSingleTimeCommands(vkDevice, commandPool);
+
+        VkBufferCopy deadListCopy{0, 0, deadListSize};
+        dispatch.vkCmdCopyBuffer(commandBuffer, stagingBuffer, m_DeadBuffer, 1, &deadListCopy);
+
+        VkBufferCopy counterCopy{deadListSize, 0, sizeof(ParticleCounters)};
+        dispatch.vkCmdCopyBuffer(commandBuffer, stagingBuffer, m_CounterBuffer, 1, &counterCopy);
+
+        VulkanCore::Utils::EndSingleTimeCommands(vkDevice, commandPool, m_DeviceInst->GetGraphicsQueue(), commandBuffer);
+
+        vkDestroyBuffer(vkDevice, stagingBuffer, nullptr);
+        vkFreeMemory(vkDevice, stagingBufferMemory, nullptr);
+
+        // Compute pipelines, all four share one set layout definition so a single descriptor set serves them.
+        VulkanCore::ComputePipelineConfig pipelineConfig;
+        pipelineConfig.pushConstantSize = sizeof(SimulationConstants);
+        pipelineConfig.localSizeX = PARTICLE_GROUP_SIZE;
+
+        for (uint32_t binding = 0; binding < 4; binding++)
+        {
+            VkDescriptorSetLayoutBinding layoutBinding{};
+            layoutBinding.binding = binding;
+            layoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            layoutBinding.descriptorCount = 1;
+            // The render pipeline reads particles and the alive list through the same set.
+            layoutBinding.stageFlags = binding < 2 ? VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT : VK_SHADER_STAGE_COMPUTE_BIT;
+            pipelineConfig.bindings.push_back(layoutBinding);
+        };
+
+        pipelineConfig.shaderPath = "assets/shaders/spv/particle_emit.comp.spv";
+        m_EmitPipeline.Create(pipelineConfig, *m_DeviceInst);
+
+        pipelineConfig.shaderPath = "assets/shaders/spv/particle_update.comp.spv";
+        m_UpdatePipeline.Create(pipelineConfig, *m_DeviceInst);
+
+        pipelineConfig.shaderPath = "assets/shaders/spv/particle_compact.comp.spv";
+        m_CompactPipeline.Create(pipelineConfig, *m_DeviceInst);
+
+        pipelineConfig.shaderPath = "assets/shaders/spv/particle_args.comp.spv";
+        pipelineConfig.localSizeX = 1;
+        m_ArgsPipeline.Create(pipelineConfig, *m_DeviceInst);
+
+        m_DescriptorSet = descriptorPool.Allocate(m_EmitPipeline.GetDescriptorSetLayout());
+
+        VulkanCore::Utils::WriteBufferDescriptor(vkDevice, m_DescriptorSet, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, m_ParticleBuffer);
+        VulkanCore::Utils::WriteBufferDescriptor(vkDevice, m_DescriptorSet, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, m_AliveBuffer);
+        VulkanCore::Utils::WriteBufferDescriptor(vkDevice, m_DescriptorSet, 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, m_DeadBuffer);
+        VulkanCore::Utils::WriteBufferDescriptor(vkDevice, m_DescriptorSet, 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, m_CounterBuffer);
+
+        // Timestamps around the simulation, when the compute family supports them.
+        uint32_t queueFamilyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> queueFamilyProperties(queueFamilyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilyProperties.data());
+
+        m_StatsPending.resize(m_Config.framesInFlight, false);
+
+        if (queueFamilyProperties[queueFamilies.computeFamily.value()].timestampValidBits > 0)
+        {
+            m_TimestampPeriod = m_DeviceInst->GetProperties().limits.timestampPeriod;
+
+            VkQueryPoolCreateInfo queryPoolInfo{};
+            queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+            queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+            queryPoolInfo.queryCount = m_Config.framesInFlight * 2;
+
+            VkResult result = vkCreateQueryPool(vkDevice, &queryPoolInfo, nullptr, &m_TimestampPool);
+
+            CORE_ASSERT(result == VK_SUCCESS, "Failed to create particle timestamp query pool!");
+        }
+        else if (m_Config.benchmark)
+        {
+            CORE_LOG_INFO("Compute queue has no timestamps, particle benchmark reports counts only.");
+        };
+    };
+
+    void ParticleSystem::Destroy()
+    {
+        VkDevice vkDevice = m_DeviceInst->Get();
+
+        if (m_TimestampPool != VK_NULL_HANDLE)
+        {
+            vkDestroyQueryPool(vkDevice, m_TimestampPool, nullptr);
+        };
+
+        if (m_RenderPipeline != VK_NULL_HANDLE)
+        {
+            vkDestroyPipeline(vkDevice, m_RenderPipeline, nullptr);
+            vkDestroyPipelineLayout(vkDevice, m_RenderPipelineLayout, nullptr);
+        };
+
+        m_EmitPipeline.Destroy();
+        m_UpdatePipeline.Destroy();
+        m_CompactPipeline.Destroy();
+        m_ArgsPipeline.Destroy();
+
+        vkUnmapMemory(vkDevice, m_ReadbackBufferMemory);
+        vkDestroyBuffer(vkDevice, m_ReadbackBuffer, nullptr);
+        vkFreeMemory(vkDevice, m_ReadbackBufferMemory, nullptr);
+        vkDestroyBuffer(vkDevice, m_CounterBuffer, nullptr);
+        vkFreeMemory(vkDevice, m_CounterBufferMemory, nullptr);
+        vkDestroyBuffer(vkDevice, m_DeadBuffer, nullptr);
+        vkFreeMemory(vkDevice, m_DeadBufferMemory, nullptr);
+        vkDestroyBuffer(vkDevice, m_AliveBuffer, nullptr);
+        vkFreeMemory(vkDevice, m_AliveBufferMemory, nullptr);
+        vkDestroyBuffer(vkDevice, m_ParticleBuffer, nullptr);
+        vkFreeMemory(vkDevice, m_ParticleBufferMemory, nullptr);
+    };
+
+    void ParticleSystem::CreateRenderPipeline(VkRenderPass renderPass, uint32_t subpass, VkFormat colorFormat, VkFormat depthFormat)
+    {
+        VulkanCore::ShaderModule vertexShaderModule;
+        vertexShaderModule.Create(*m_DeviceInst, "assets/shaders/spv/particle.vert.spv");
+
+        VulkanCore::ShaderModule fragmentShaderModule;
+        fragmentShaderModule.Create(*m_DeviceInst, "assets/shaders/spv/particle.frag.spv");
+
+        VkPipelineShaderStageCreateInfo shaderStages[2]{};
+        shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+        shaderStages[0].module = vertexShaderModule.Get();
+        shaderStages[0].pName = "main";
+        shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        shaderStages[1].module = fragmentShaderModule.Get();
+        shaderStages[1].pName = "main";
+
+        // Quads are expanded from the particle buffer, there is no vertex input.
+        VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+        vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+        VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+        inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+        inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+        VkPipelineViewportStateCreateInfo viewportState{};
+        viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+        viewportState.viewportCount = 1;
+        viewportState.scissorCount = 1;
+
+        VkPipelineRasterizationStateCreateInfo rasterizer{};
+        rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+        rasterizer.lineWidth = 1.0f;
+        rasterizer.cullMode = VK_CULL_MODE_NONE;
+        rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
+
+        VkPipelineMultisampleStateCreateInfo multisampling{};
+        multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+        multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+        // Tested against the opaque depth but never written, additive blending needs no sorting.
+        VkPipelineDepthStencilStateCreateInfo depthStencil{};
+        depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+        depthStencil.depthTestEnable = VK_TRUE;
+        depthStencil.depthWriteEnable = VK_FALSE;
+        depthStencil.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+
+        VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+        colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        colorBlendAttachment.blendEnable = VK_TRUE;
+        colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+        colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
+        colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+        colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+        colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+
+        VkPipelineColorBlendStateCreateInfo colorBlending{};
+        colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        colorBlending.attachmentCount = 1;
+        colorBlending.pAttachments = &colorBlendAttachment;
+
+        std::vector<VkDynamicState> dynamicStates = {
+            VK_DYNAMIC_STATE_VIEWPORT,
+            VK_DYNAMIC_STATE_SCISSOR};
+
+        VkPipelineDynamicStateCreateInfo dynamicState{};
+        dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+        dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+        dynamicState.pDynamicStates = dynamicStates.data();
+
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof(RenderConstants);
+
+        VkDescriptorSetLayout descriptorSetLayout = m_EmitPipeline.GetDescriptorSetLayout();
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+        VkResult result = vkCreatePipelineLayout(m_DeviceInst->Get(), &pipelineLayoutInfo, nullptr, &m_RenderPipelineLayout);
+
+        CORE_ASSERT(result == VK_SUCCESS, "Failed to create particle pipeline layout!");
+
+        VkPipelineRenderingCreateInfo renderingInfo{};
+        renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+        renderingInfo.colorAttachmentCount = 1;
+        renderingInfo.pColorAttachmentFormats = &colorFormat;
+        renderingInfo.depthAttachmentFormat = depthFormat;
+
+        VkGraphicsPipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pipelineInfo.pNext = renderPass == VK_NULL_HANDLE ? &renderingInfo : nullptr;
+        pipelineInfo.stageCount = 2;
+        pipelineInfo.pStages = shaderStages;
+        pipelineInfo.pVertexInputState = &vertexInputInfo;
+        pipelineInfo.pInputAssemblyState = &inputAssembly;
+        pipelineInfo.pViewportState = &viewportState;
+        pipelineInfo.pRasterizationState = &rasterizer;
+        pipelineInfo.pMultisampleState = &multisampling;
+        pipelineInfo.pDepthStencilState = &depthStencil;
+        pipelineInfo.pColorBlendState = &colorBlending;
+        pipelineInfo.pDynamicState = &dynamicState;
+        pipelineInfo.layout = m_RenderPipelineLayout;
+        pipelineInfo.renderPass = renderPass;
+        pipelineInfo.subpass = subpass;
+
+        result = vkCreateGraphicsPipelines(m_DeviceInst->Get(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_RenderPipeline);
+
+        CORE_ASSERT(result == VK_SUCCESS, "Failed to create particle pipeline!");
+
+        vertexShaderModule.Destroy();
+        fragmentShaderModule.Destroy();
+    };
+
+    void ParticleSystem::Simulate(VkCommandBuffer commandBuffer, uint32_t frame, float deltaTime)
+    {
+        const VulkanCore::DeviceDispatch &dispatch = m_DeviceInst->GetDispatch();
+
+        ReadStats(frame);
+
+        uint32_t emitCount;
+        if (m_Config.benchmark)
+        {
+            // Refill whatever died, based on counters a few frames old; the GPU clamps the excess.
+            emitCount = m_Config.maxParticles - (std::min)(m_Stats.aliveCount, m_Config.maxParticles);
+        }
+        else
+        {
+            m_EmitAccumulator += m_Config.emitRate * deltaTime;
+            emitCount = static_cast<uint32_t>((std::min)(m_EmitAccumulator, static_cast<float>(m_Config.maxParticles)));
+            m_EmitAccumulator -= static_cast<float>(emitCount);
+        };
+
+        SimulationConstants constants{};
+        constants.emitterPosition = glm::vec4(m_Config.emitterPosition, m_Config.emitterRadius);
+        constants.emitterVelocity = glm::vec4(m_Config.emitterVelocity, m_Config.velocityJitter);
+        constants.gravity = glm::vec4(m_Config.gravity, deltaTime);
+        constants.lifetime = glm::vec2(m_Config.minLifetime, m_Config.maxLifetime);
+        constants.emitCount = emitCount;
+        constants.seed = m_Seed++;
+        constants.current = m_Current;
+        constants.capacity = m_Config.maxParticles;
+
+        if (m_TimestampPool != VK_NULL_HANDLE)
+        {
+            dispatch.vkCmdResetQueryPool(commandBuffer, m_TimestampPool, frame * 2, 2);
+            dispatch.vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_TimestampPool, frame * 2);
+        };
+
+        m_EmitPipeline.BindDescriptorSet(commandBuffer, m_DescriptorSet);
+
+        // Emit into the current alive list
+        if (emitCount > 0)
+        {
+            m_EmitPipeline.Bind(commandBuffer);
+            m_EmitPipeline.PushConstants(commandBuffer, &constants, sizeof(constants));
+            m_EmitPipeline.DispatchThreads(commandBuffer, emitCount);
+
+            VulkanCore::Utils::GlobalBarrier(dispatch, commandBuffer, COMPUTE_STAGE, COMPUTE_ACCESS, COMPUTE_STAGE, COMPUTE_ACCESS);
+        };
+
+        // Size update and compaction from the GPU alive count
+        constants.mode = 0;
+        m_ArgsPipeline.Bind(commandBuffer);
+        m_ArgsPipeline.PushConstants(commandBuffer, &constants, sizeof(constants));
+        m_ArgsPipeline.Dispatch(commandBuffer, 1);
+
+        VulkanCore::Utils::GlobalBarrier(dispatch, commandBuffer, COMPUTE_STAGE, COMPUTE_ACCESS, COMPUTE_STAGE | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, COMPUTE_ACCESS | VK_ACCESS_INDIRECT_COMMAND_READ_BIT);
+
+        m_UpdatePipeline.Bind(commandBuffer);
+        m_UpdatePipeline.PushConstants(commandBuffer, &constants, sizeof(constants));
+        m_UpdatePipeline.DispatchIndirect(commandBuffer, m_CounterBuffer, offsetof(ParticleCounters, dispatchArgs));
+
+        VulkanCore::Utils::GlobalBarrier(dispatch, commandBuffer, COMPUTE_STAGE, COMPUTE_ACCESS, COMPUTE_STAGE, COMPUTE_ACCESS);
+
+        m_CompactPipeline.Bind(commandBuffer);
+        m_CompactPipeline.PushConstants(commandBuffer, &constants, sizeof(constants));
+        m_CompactPipeline.DispatchIndirect(commandBuffer, m_CounterBuffer, offsetof(ParticleCounters, dispatchArgs));
+
+        VulkanCore::Utils::GlobalBarrier(dispatch, commandBuffer, COMPUTE_STAGE, COMPUTE_ACCESS, COMPUTE_STAGE, COMPUTE_ACCESS);
+
+        // Draw arguments from the compacted list
+        constants.mode = 1;
+        m_ArgsPipeline.Bind(commandBuffer);
+        m_ArgsPipeline.PushConstants(commandBuffer, &constants, sizeof(constants));
+        m_ArgsPipeline.Dispatch(commandBuffer, 1);
+
+        if (m_TimestampPool != VK_NULL_HANDLE)
+        {
+            dispatch.vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_TimestampPool, frame * 2 + 1);
+        };
+
+        VulkanCore::Utils::GlobalBarrier(dispatch, commandBuffer, COMPUTE_STAGE, VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+
+        VkBufferCopy readbackCopy{0, frame * sizeof(ParticleCounters), sizeof(ParticleCounters)};
+        dispatch.vkCmdCopyBuffer(commandBuffer, m_CounterBuffer, m_ReadbackBuffer, 1, &readbackCopy);
+
+        m_StatsPending[frame] = true;
+        m_Current = 1 - m_Current;
+    };
+
+    void ParticleSystem::Draw(VkCommandBuffer commandBuffer, const Camera &camera)
+    {
+        const VulkanCore::DeviceDispatch &dispatch = m_DeviceInst->GetDispatch();
+
+        RenderConstants constants{};
+        constants.viewProjection = camera.GetViewProjection();
+        constants.cameraRight = glm::vec4(camera.view[0][0], camera.view[1][0], camera.view[2][0], m_Config.particleSize);
+        constants.cameraUp = glm::vec4(camera.view[0][1], camera.view[1][1], camera.view[2][1], 0.0f);
+        constants.renderList = m_Current;
+        constants.capacity = m_Config.maxParticles;
+
+        dispatch.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_RenderPipeline);
+        dispatch.vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_RenderPipelineLayout, 0, 1, &m_DescriptorSet, 0, nullptr);
+        dispatch.vkCmdPushConstants(commandBuffer, m_RenderPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(constants), &constants);
+
+        dispatch.vkCmdDrawIndirect(commandBuffer, m_CounterBuffer, offsetof(ParticleCounters, drawArgs), 1, sizeof(VkDrawIndirectCommand));
+    };
+
+    void ParticleSystem::ReadStats(uint32_t frame)
+    {
+        if (!m_StatsPending[frame])
+        {
+            return;
+        };
+
+        // The frame slot finished executing, so neither of these waits.
+        const ParticleCounters *counters = static_cast<const ParticleCounters *>(m_ReadbackData) + frame;
+        m_Stats.aliveCount = counters->renderCount;
+
+        if (m_TimestampPool != VK_NULL_HANDLE)
+        {
+            uint64_t timestamps[2] = {};
+            VkResult result = m_DeviceInst->GetDispatch().vkGetQueryPoolResults(m_DeviceInst->Get(), m_TimestampPool, frame * 2, 2, sizeof(timestamps), timestamps, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+
+            if (result == VK_SUCCESS && timestamps[1] > timestamps[0])
+            {
+                m_Stats.simulationMs = static_cast<float>(static_cast<double>(timestamps[1] - timestamps[0]) * m_TimestampPeriod * 1e-6);
+                m_Stats.particlesPerMs = m_Stats.simulationMs > 0.0f ? static_cast<float>(m_Stats.aliveCount) / m_Stats.simulationMs : 0.0f;
+            };
+        };
+
+        m_StatsPending[frame] = false;
+    };
+
+};
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+
+#include "../Common.h"
+#include "../Vulkan-Core/Device.h"
+#include "../Vulkan-Core/ComputePipeline.h"
+#include "../Vulkan-Core/DescriptorPool.h"
+#include "Camera.h"
+
+namespace Renderer
+{
+    struct ParticleSystemConfig
+    {
+        uint32_t maxParticles = 1 << 20;
+        // Particles spawned per second, the GPU drops whatever does not fit in the free slots.
+        float emitRate = 200000.0f;
+        glm::vec3 emitterPosition = glm::vec3(0.0f);
+        float emitterRadius = 0.05f;
+        glm::vec3 emitterVelocity = glm::vec3(0.0f, -1.5f, 0.0f);
+        float velocityJitter = 0.75f;
+        glm::vec3 gravity = glm::vec3(0.0f, 2.0f, 0.0f);
+        float minLifetime = 1.0f;
+        float maxLifetime = 3.0f;
+        float particleSize = 0.004f;
+        uint32_t framesInFlight = 2;
+        // Keeps the pool saturated and times the simulation with GPU timestamps.
+        bool benchmark = false;
+    };
+
+    struct ParticleStats
+    {
+        uint32_t aliveCount = 0;
+        // GPU time of emit, update and compaction, zero if the compute queue has no timestamps.
+        float simulationMs = 0.0f;
+        float particlesPerMs = 0.0f;
+    };
+
+    // Particles live only in GPU memory: emit, update and compaction run as compute dispatches sized by
+    // GPU-written indirect arguments, and rendering is a single indirect instanced draw.
+    class ParticleSystem
+    {
+    public:
+        ParticleSystem() = default;
+        ~ParticleSystem() = default;
+        ParticleSystem(const ParticleSystem &) = delete;
+        ParticleSystem &operator=(const ParticleSystem &) = delete;
+
+        void Create(const ParticleSystemConfig &config, const VulkanCore::Device &device, VulkanCore::DescriptorPool &descriptorPool, VkCommandPool commandPool);
+        void Destroy();
+
+        // A VK_NULL_HANDLE render pass builds the pipeline for dynamic rendering with the given formats.
+        void CreateRenderPipeline(VkRenderPass renderPass, uint32_t subpass, VkFormat colorFormat, VkFormat depthFormat);
+
+        // Records one simulation step into a compute command buffer. The slot of frame must have finished executing.
+        void Simulate(VkCommandBuffer commandBuffer, uint32_t frame, float deltaTime);
+        // Draws what the last Simulate produced, the submission must wait for that compute work.
+        void Draw(VkCommandBuffer commandBuffer, const Camera &camera);
+
+        const ParticleStats &GetStats() { return m_Stats; };
+        uint32_t GetCapacity() { return m_Config.maxParticles; };
+
+    private:
+        void ReadStats(uint32_t frame);
+
+    private:
+        ParticleSystemConfig m_Config;
+        const VulkanCore::Device *m_DeviceInst = nullptr;
+
+        VulkanCore::ComputePipeline m_EmitPipeline;
+        VulkanCore::ComputePipeline m_UpdatePipeline;
+        VulkanCore::ComputePipeline m_CompactPipeline;
+        VulkanCore::ComputePipeline m_ArgsPipeline;
+        VkPipelineLayout m_RenderPipelineLayout = VK_NULL_HANDLE;
+        VkPipeline m_RenderPipeline = VK_NULL_HANDLE;
+        VkDescriptorSet m_DescriptorSet = VK_NULL_HANDLE;
+
+        VkBuffer m_ParticleBuffer;
+        VkDeviceMemory m_ParticleBufferMemory;
+        VkBuffer m_AliveBuffer;
+        VkDeviceMemory m_AliveBufferMemory;
+        VkBuffer m_DeadBuffer;
+        VkDeviceMemory m_DeadBufferMemory;
+        VkBuffer m_CounterBuffer;
+        VkDeviceMemory m_CounterBufferMemory;
+
+        // Per frame copies of the counters, read once the frame slot comes around again.
+        VkBuffer m_ReadbackBuffer;
+        VkDeviceMemory m_ReadbackBufferMemory;
+        void *m_ReadbackData = nullptr;
+
+        VkQueryPool m_TimestampPool = VK_NULL_HANDLE;
+        float m_TimestampPeriod = 0.0f;
+        std::vector<bool> m_StatsPending;
+
+        uint32_t m_Current = 0;
+        uint32_t m_Seed = 0;
+        float m_EmitAccumulator = 0.0f;
+        ParticleStats m_Stats;
+    };
+
+};
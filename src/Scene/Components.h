@@ -0,0 +1,44 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "../Common.h"
+
+namespace Scene
+{
+    // Local placement of an entity, the only transform component systems write to.
+    struct Transform
+    {
+        glm::vec3 position = glm::vec3(0.0f);
+        glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        glm::vec3 scale = glm::vec3(1.0f);
+    };
+
+    // Derived from Transform by UpdateWorldTransforms, read by the renderer.
+    struct LocalToWorld
+    {
+        glm::mat4 matrix = glm::mat4(1.0f);
+    };
+
+    // An entity drawn with the renderer's mesh.
+    struct MeshInstance
+    {
+        // Object-space center and radius of the mesh.
+        glm::vec4 localBounds = glm::vec4(0.0f);
+        // Level selected last frame, kept for the selection hysteresis.
+        uint32_t lod = 0;
+        // Row of the world matrix in the renderer's instance buffer, see TransformHierarchy::GetInstance().
+        uint32_t instance = 0;
+    };
+
+    // Derived from Transform and MeshInstance by UpdateWorldTransforms.
+    struct WorldBounds
+    {
+        // World-space center and radius.
+        glm::vec4 sphere = glm::vec4(0.0f);
+        // Largest axis scale of the transform.
+        float scale = 1.0f;
+    };
+
+};
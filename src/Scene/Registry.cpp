@@ -0,0 +1,199 @@
+#include "Registry.h"
+#include "../Log.h"
+
+#include <mutex>
+
+namespace Scene
+{
+    namespace
+    {
+        std::mutex s_ComponentMutex;
+        std::vector<ComponentInfo> s_Components;
+    };
+
+    uint32_t RegisterComponent(uint32_t size, uint32_t alignment)
+    {
+        std::lock_guard<std::mutex> lock(s_ComponentMutex);
+
+        CORE_ASSERT(s_Components.size() < MAX_COMPONENT_TYPES, "Too many component types!");
+
+        s_Components.push_back(ComponentInfo{size, alignment});
+        return static_cast<uint32_t>(s_Components.size() - 1);
+    };
+
+    ComponentInfo GetComponentInfo(uint32_t id)
+    {
+        std::lock_guard<std::mutex> lock(s_ComponentMutex);
+        return s_Components[id];
+    };
+
+    void Registry::Destroy(Entity entity)
+    {
+        EntityLocation location;
+        if (m_Entities.Remove(entity, &location))
+        {
+            RemoveRow(location);
+        };
+    };
+
+    void Registry::Clear()
+    {
+        m_Entities.Clear();
+        m_Archetypes.clear();
+        m_ArchetypeIndices.clear();
+        m_ChunkRefs.clear();
+    };
+
+    size_t Registry::GetChunkCount() const
+    {
+        size_t count = 0;
+        for (const Archetype &archetype : m_Archetypes)
+        {
+            count += archetype.chunks.size();
+        };
+
+        return count;
+    };
+
+    Entity Registry::CreateEntity(ComponentMask mask)
+    {
+        uint32_t archetypeIndex = GetOrCreateArchetype(mask);
+        EntityLocation location = AllocateRow(archetypeIndex);
+        Entity entity = m_Entities.Add(location);
+
+        Chunk &chunk = m_Archetypes[archetypeIndex].chunks[location.chunk];
+        GetEntities(chunk)[location.row] = entity;
+
+        uint64_t version = ++m_Version;
+        for (uint32_t component : m_Archetypes[archetypeIndex].components)
+        {
+            chunk.versions[component] = version;
+        };
+
+        return entity;
+    };
+
+    uint32_t Registry::GetOrCreateArchetype(ComponentMask mask)
+    {
+        auto it = m_ArchetypeIndices.find(mask);
+        if (it != m_ArchetypeIndices.end())
+        {
+            return it->second;
+        };
+
+        Archetype archetype;
+        archetype.mask = mask;
+
+        uint32_t rowSize = sizeof(Entity);
+        uint32_t padding = 0;
+        for (uint32_t id = 0; id < MAX_COMPONENT_TYPES; id++)
+        {
+            if (mask & (ComponentMask(1) << id))
+            {
+                ComponentInfo info = GetComponentInfo(id);
+                archetype.components.push_back(id);
+                archetype.sizes.push_back(info.size);
+                rowSize += info.size;
+                padding += info.alignment;
+            };
+        };
+
+        // Every column may need up to its alignment in padding ahead of it.
+        archetype.capacity = (CHUNK_SIZE - padding) / rowSize;
+
+        CORE_ASSERT(archetype.capacity > 0, "Archetype rows do not fit in a chunk!");
+
+        uint32_t offset = archetype.capacity * sizeof(Entity);
+        for (size_t i = 0; i < archetype.components.size(); i++)
+        {
+            uint32_t alignment = GetComponentInfo(archetype.components[i]).alignment;
+            offset = (offset + alignment - 1) / alignment * alignment;
+            archetype.columnOffsets[archetype.components[i]] = offset;
+            offset += archetype.capacity * archetype.sizes[i];
+        };
+
+        uint32_t index = static_cast<uint32_t>(m_Archetypes.size());
+        m_Archetypes.push_back(std::move(archetype));
+        m_ArchetypeIndices[mask] = index;
+
+        return index;
+    };
+
+    Registry::EntityLocation Registry::AllocateRow(uint32_t archetypeIndex)
+    {
+        Archetype &archetype = m_Archetypes[archetypeIndex];
+
+        if (archetype.chunks.empty() || archetype.chunks.back().count == archetype.capacity)
+        {
+            Chunk chunk;
+            chunk.storage = std::make_unique<ChunkStorage>();
+            archetype.chunks.push_back(std::move(chunk));
+        };
+
+        uint32_t chunkIndex = static_cast<uint32_t>(archetype.chunks.size() - 1);
+        return EntityLocation{archetypeIndex, chunkIndex, archetype.chunks[chunkIndex].count++};
+    };
+
+    void Registry::RemoveRow(const EntityLocation &location)
+    {
+        Archetype &archetype = m_Archetypes[location.archetype];
+        Chunk &chunk = archetype.chunks[location.chunk];
+        Chunk &lastChunk = archetype.chunks.back();
+        uint32_t lastRow = lastChunk.count - 1;
+
+        if (&chunk != &lastChunk || location.row != lastRow)
+        {
+            Entity moved = GetEntities(lastChunk)[lastRow];
+            GetEntities(chunk)[location.row] = moved;
+
+            uint64_t version = ++m_Version;
+            for (size_t i = 0; i < archetype.components.size(); i++)
+            {
+                uint32_t id = archetype.components[i];
+                uint32_t size = archetype.sizes[i];
+                uint32_t offset = archetype.columnOffsets[id];
+                memcpy(chunk.storage->bytes + offset + location.row * size, lastChunk.storage->bytes + offset + lastRow * size, size);
+                chunk.versions[id] = version;
+            };
+
+            *m_Entities.Get(moved) = location;
+        };
+
+        if (--lastChunk.count == 0)
+        {
+            archetype.chunks.pop_back();
+        };
+    };
+
+    void Registry::MoveEntity(Entity entity, ComponentMask mask)
+    {
+        EntityLocation source = *m_Entities.Get(entity);
+        uint32_t archetypeIndex = GetOrCreateArchetype(mask);
+        EntityLocation destination = AllocateRow(archetypeIndex);
+
+        // Looked up after the archetype was created, which may have moved the archetypes.
+        Archetype &sourceArchetype = m_Archetypes[source.archetype];
+        Archetype &archetype = m_Archetypes[archetypeIndex];
+        Chunk &sourceChunk = sourceArchetype.chunks[source.chunk];
+        Chunk &chunk = archetype.chunks[destination.chunk];
+
+        GetEntities(chunk)[destination.row] = entity;
+
+        uint64_t version = ++m_Version;
+        for (size_t i = 0; i < archetype.components.size(); i++)
+        {
+            uint32_t id = archetype.components[i];
+            if (sourceArchetype.mask & (ComponentMask(1) << id))
+            {
+                uint32_t size = archetype.sizes[i];
+                memcpy(chunk.storage->bytes + archetype.columnOffsets[id] + destination.row * size, sourceChunk.storage->bytes + sourceArchetype.columnOffsets[id] + source.row * size, size);
+            };
+
+            chunk.versions[id] = version;
+        };
+
+        RemoveRow(source);
+        *m_Entities.Get(entity) = destination;
+    };
+
+};
@@ -0,0 +1,323 @@
+#pragma once
+
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+
+#include "../Common.h"
+#include "../Vulkan-Core/HandlePool.h"
+#include "WorkerPool.h"
+
+namespace Scene
+{
+    struct EntityTag
+    {
+    };
+
+    // Stays valid while the entity moves between archetypes, stops resolving once it is destroyed.
+    using Entity = VulkanCore::Handle<EntityTag>;
+    using ComponentMask = uint64_t;
+
+    static constexpr uint32_t MAX_COMPONENT_TYPES = 64;
+    // Every chunk is one allocation of this size, split into one column per component of its archetype.
+    static constexpr uint32_t CHUNK_SIZE = 16 * 1024;
+
+    struct ComponentInfo
+    {
+        uint32_t size;
+        uint32_t alignment;
+    };
+
+    // Ids are handed out in order of first use.
+    uint32_t RegisterComponent(uint32_t size, uint32_t alignment);
+    ComponentInfo GetComponentInfo(uint32_t id);
+
+    // Rows move between chunks with memcpy, components must be trivially copyable.
+    template <typename Component>
+    uint32_t RegisterComponentType()
+    {
+        static_assert(std::is_trivially_copyable_v<Component>, "Components must be trivially copyable!");
+
+        static const uint32_t id = RegisterComponent(sizeof(Component), alignof(Component));
+        return id;
+    };
+
+    // T and const T share one id, queries use const to mark read-only access.
+    template <typename T>
+    uint32_t GetComponentId()
+    {
+        return RegisterComponentType<std::remove_cv_t<T>>();
+    };
+
+    template <typename... Ts>
+    ComponentMask GetComponentMask()
+    {
+        return (ComponentMask(0) | ... | (ComponentMask(1) << GetComponentId<Ts>()));
+    };
+
+    struct alignas(64) ChunkStorage
+    {
+        uint8_t bytes[CHUNK_SIZE];
+    };
+
+    struct Chunk
+    {
+        std::unique_ptr<ChunkStorage> storage;
+        uint32_t count = 0;
+        // Registry version of the last write to each column, indexed by component id.
+        std::array<uint64_t, MAX_COMPONENT_TYPES> versions{};
+    };
+
+    // Entities sharing one set of components. Their components are stored structure-of-arrays in fixed size
+    // chunks, so systems stream through contiguous columns of only the components they touch.
+    struct Archetype
+    {
+        ComponentMask mask = 0;
+        std::vector<uint32_t> components;
+        // Size of each component, in the order of components.
+        std::vector<uint32_t> sizes;
+        // Byte offset of each component's column in a chunk, indexed by component id. The entity column is first.
+        std::array<uint32_t, MAX_COMPONENT_TYPES> columnOffsets{};
+        uint32_t capacity = 0;
+        // Packed: every chunk but the last is full.
+        std::vector<Chunk> chunks;
+    };
+
+    // Entity-component store. Queries visit the chunks of every archetype holding the requested components;
+    // components requested non-const are stamped with a new version in each visited chunk, which is what
+    // ForEachChangedChunk filters on. Structural changes (Create, Destroy, Add, Remove) must not happen
+    // while iterating, and the registry itself is not thread safe: only the chunk callbacks of the parallel
+    // queries run concurrently.
+    class Registry
+    {
+    public:
+        Registry() = default;
+        ~Registry() = default;
+        Registry(const Registry &) = delete;
+        Registry &operator=(const Registry &) = delete;
+
+        template <typename... Ts>
+        Entity Create(const Ts &...components)
+        {
+            Entity entity = CreateEntity(GetComponentMask<Ts...>());
+            (WriteComponent(entity, components), ...);
+            return entity;
+        };
+
+        void Destroy(Entity entity);
+        void Clear();
+        bool IsAlive(Entity entity) const { return m_Entities.IsValid(entity); };
+
+        template <typename T>
+        bool Has(Entity entity) const
+        {
+            const EntityLocation *location = m_Entities.Get(entity);
+            return location != nullptr && (m_Archetypes[location->archetype].mask & GetComponentMask<T>()) != 0;
+        };
+
+        // Null for stale entities or missing components. Reads are not tracked.
+        template <typename T>
+        const T *Get(Entity entity) const
+        {
+            return Has<T>(entity) ? GetComponent<T>(*m_Entities.Get(entity)) : nullptr;
+        };
+
+        // The entity must have T.
+        template <typename T>
+        void Set(Entity entity, const T &value)
+        {
+            CORE_ASSERT(Has<T>(entity), "Entity has no such component!");
+
+            const EntityLocation &location = *m_Entities.Get(entity);
+            *GetComponent<T>(location) = value;
+            m_Archetypes[location.archetype].chunks[location.chunk].versions[GetComponentId<T>()] = ++m_Version;
+        };
+
+        // Moves the entity to the archetype with T, or overwrites T when the entity already has it.
+        template <typename T>
+        void Add(Entity entity, const T &value)
+        {
+            if (Has<T>(entity))
+            {
+                Set(entity, value);
+                return;
+            };
+
+            const EntityLocation *location = m_Entities.Get(entity);
+            CORE_ASSERT(location != nullptr, "Stale entity!");
+
+            MoveEntity(entity, m_Archetypes[location->archetype].mask | GetComponentMask<T>());
+            WriteComponent(entity, value);
+        };
+
+        template <typename T>
+        void Remove(Entity entity)
+        {
+            if (Has<T>(entity))
+            {
+                MoveEntity(entity, m_Archetypes[m_Entities.Get(entity)->archetype].mask & ~GetComponentMask<T>());
+            };
+        };
+
+        // fn(Entity, Ts &...) for every entity holding all of Ts.
+        template <typename... Ts, typename Fn>
+        void ForEach(Fn &&fn)
+        {
+            ForEachChunk<Ts...>([&fn](const Entity *entities, uint32_t count, Ts *...columns)
+                                {
+                                    for (uint32_t i = 0; i < count; i++)
+                                    {
+                                        fn(entities[i], columns[i]...);
+                                    };
+                                });
+        };
+
+        // fn(const Entity *, uint32_t count, Ts *...) once per chunk, every column holds count elements.
+        template <typename... Ts, typename Fn>
+        void ForEachChunk(Fn &&fn)
+        {
+            VisitChunks<Ts...>(GetComponentMask<Ts...>(), INVALID_COMPONENT, 0, [this, &fn](Archetype &archetype, Chunk &chunk)
+                               { fn(GetEntities(chunk), chunk.count, GetColumn<Ts>(archetype, chunk)...); });
+        };
+
+        // ForEachChunk restricted to chunks where Changed was written after version, a value of GetVersion().
+        template <typename Changed, typename... Ts, typename Fn>
+        void ForEachChangedChunk(uint64_t version, Fn &&fn)
+        {
+            VisitChunks<Ts...>(GetComponentMask<Changed, Ts...>(), GetComponentId<Changed>(), version, [this, &fn](Archetype &archetype, Chunk &chunk)
+                               { fn(GetEntities(chunk), chunk.count, GetColumn<Ts>(archetype, chunk)...); });
+        };
+
+        // ForEachChunk with the chunks spread across the pool's threads, fn must be safe to call concurrently.
+        template <typename... Ts, typename Fn>
+        void ParallelForEachChunk(WorkerPool &pool, Fn &&fn)
+        {
+            ParallelVisit<Ts...>(pool, GetComponentMask<Ts...>(), INVALID_COMPONENT, 0, fn);
+        };
+
+        // ForEachChangedChunk with the chunks spread across the pool's threads.
+        template <typename Changed, typename... Ts, typename Fn>
+        void ParallelForEachChangedChunk(WorkerPool &pool, uint64_t version, Fn &&fn)
+        {
+            ParallelVisit<Ts...>(pool, GetComponentMask<Changed, Ts...>(), GetComponentId<Changed>(), version, fn);
+        };
+
+        template <typename... Ts, typename Fn>
+        void ParallelForEach(WorkerPool &pool, Fn &&fn)
+        {
+            ParallelForEachChunk<Ts...>(pool, [&fn](const Entity *entities, uint32_t count, Ts *...columns)
+                                        {
+                                            for (uint32_t i = 0; i < count; i++)
+                                            {
+                                                fn(entities[i], columns[i]...);
+                                            };
+                                        });
+        };
+
+        // Bumped by every tracked write, keep it to find what changed since.
+        uint64_t GetVersion() const { return m_Version; };
+        size_t GetEntityCount() const { return m_Entities.Size(); };
+        size_t GetArchetypeCount() const { return m_Archetypes.size(); };
+        size_t GetChunkCount() const;
+
+    private:
+        static constexpr uint32_t INVALID_COMPONENT = ~0u;
+
+        struct EntityLocation
+        {
+            uint32_t archetype;
+            uint32_t chunk;
+            uint32_t row;
+        };
+
+        struct ChunkRef
+        {
+            Archetype *archetype;
+            Chunk *chunk;
+        };
+
+        Entity CreateEntity(ComponentMask mask);
+        uint32_t GetOrCreateArchetype(ComponentMask mask);
+        EntityLocation AllocateRow(uint32_t archetypeIndex);
+        // Fills the hole with the archetype's last row, keeping the chunks packed.
+        void RemoveRow(const EntityLocation &location);
+        void MoveEntity(Entity entity, ComponentMask mask);
+
+        static Entity *GetEntities(Chunk &chunk) { return reinterpret_cast<Entity *>(chunk.storage->bytes); };
+
+        template <typename T>
+        static T *GetColumn(Archetype &archetype, Chunk &chunk)
+        {
+            return reinterpret_cast<T *>(chunk.storage->bytes + archetype.columnOffsets[GetComponentId<T>()]);
+        };
+
+        template <typename T>
+        T *GetComponent(const EntityLocation &location) const
+        {
+            Archetype &archetype = const_cast<Archetype &>(m_Archetypes[location.archetype]);
+            return GetColumn<T>(archetype, archetype.chunks[location.chunk]) + location.row;
+        };
+
+        // Untracked, the caller stamps the chunk.
+        template <typename T>
+        void WriteComponent(Entity entity, const T &value)
+        {
+            *GetComponent<T>(*m_Entities.Get(entity)) = value;
+        };
+
+        // Gathers the chunks first, the tasks then only index into the scratch list.
+        template <typename... Ts, typename Fn>
+        void ParallelVisit(WorkerPool &pool, ComponentMask mask, uint32_t changedComponent, uint64_t changedSince, Fn &fn)
+        {
+            m_ChunkRefs.clear();
+            VisitChunks<Ts...>(mask, changedComponent, changedSince, [this](Archetype &archetype, Chunk &chunk)
+                               { m_ChunkRefs.push_back({&archetype, &chunk}); });
+
+            pool.Run(static_cast<uint32_t>(m_ChunkRefs.size()), [this, &fn](uint32_t index)
+                     {
+                         Archetype &archetype = *m_ChunkRefs[index].archetype;
+                         Chunk &chunk = *m_ChunkRefs[index].chunk;
+                         fn(GetEntities(chunk), chunk.count, GetColumn<Ts>(archetype, chunk)...);
+                     });
+        };
+
+        template <typename... Ts, typename Visitor>
+        void VisitChunks(ComponentMask mask, uint32_t changedComponent, uint64_t changedSince, Visitor &&visitor)
+        {
+            constexpr bool writes = (false || ... || !std::is_const_v<Ts>);
+            uint64_t version = writes ? ++m_Version : 0;
+
+            for (Archetype &archetype : m_Archetypes)
+            {
+                if ((archetype.mask & mask) != mask)
+                {
+                    continue;
+                };
+
+                for (Chunk &chunk : archetype.chunks)
+                {
+                    if (changedComponent != INVALID_COMPONENT && chunk.versions[changedComponent] <= changedSince)
+                    {
+                        continue;
+                    };
+
+                    if constexpr (writes)
+                    {
+                        ((std::is_const_v<Ts> ? void() : void(chunk.versions[GetComponentId<Ts>()] = version)), ...);
+                    };
+
+                    visitor(archetype, chunk);
+                };
+            };
+        };
+
+    private:
+        VulkanCore::HandlePool<EntityTag, EntityLocation> m_Entities;
+        std::vector<Archetype> m_Archetypes;
+        std::unordered_map<ComponentMask, uint32_t> m_ArchetypeIndices;
+        uint64_t m_Version = 1;
+        // Scratch list of the parallel queries, kept to avoid allocating every frame.
+        std::vector<ChunkRef> m_ChunkRefs;
+    };
+
+};
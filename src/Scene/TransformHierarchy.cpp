@@ -0,0 +1,432 @@
+#include "TransformHierarchy.h"
+#include "../Profiling/Profiler.h"
+
+#include <numeric>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VKS_SCENE_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace Scene
+{
+    namespace
+    {
+        struct LocalChannels
+        {
+            const float *position[3];
+            // x, y, z, w.
+            const float *rotation[4];
+            const float *scale[3];
+        };
+
+        // Rows of T * R * S for one node.
+        void ComposeLocal(const LocalChannels &channels, uint32_t index, WorldRows &local)
+        {
+            float x = channels.rotation[0][index], y = channels.rotation[1][index], z = channels.rotation[2][index], w = channels.rotation[3][index];
+            glm::vec3 scale(channels.scale[0][index], channels.scale[1][index], channels.scale[2][index]);
+
+            local.rows[0] = glm::vec4((1.0f - 2.0f * (y * y + z * z)) * scale.x, 2.0f * (x * y - w * z) * scale.y, 2.0f * (x * z + w * y) * scale.z, channels.position[0][index]);
+            local.rows[1] = glm::vec4(2.0f * (x * y + w * z) * scale.x, (1.0f - 2.0f * (x * x + z * z)) * scale.y, 2.0f * (y * z - w * x) * scale.z, channels.position[1][index]);
+            local.rows[2] = glm::vec4(2.0f * (x * z - w * y) * scale.x, 2.0f * (y * z + w * x) * scale.y, (1.0f - 2.0f * (x * x + y * y)) * scale.z, channels.position[2][index]);
+        };
+
+        // parent * local, both affine with an implicit (0, 0, 0, 1) last row.
+        void MultiplyScalar(const WorldRows &parent, const WorldRows &local, WorldRows &world)
+        {
+            for (int i = 0; i < 3; i++)
+            {
+                const glm::vec4 &p = parent.rows[i];
+                world.rows[i] = p.x * local.rows[0] + p.y * local.rows[1] + p.z * local.rows[2] + glm::vec4(0.0f, 0.0f, 0.0f, p.w);
+            };
+        };
+
+#if VKS_SCENE_SSE
+        // MultiplyScalar with a whole row per register.
+        void Multiply(const WorldRows &parent, const WorldRows &local, WorldRows &world)
+        {
+            __m128 l0 = _mm_load_ps(&local.rows[0].x);
+            __m128 l1 = _mm_load_ps(&local.rows[1].x);
+            __m128 l2 = _mm_load_ps(&local.rows[2].x);
+            __m128 l3 = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+
+            for (int i = 0; i < 3; i++)
+            {
+                __m128 p = _mm_load_ps(&parent.rows[i].x);
+                __m128 row = _mm_mul_ps(_mm_shuffle_ps(p, p, 0x00), l0);
+                row = _mm_add_ps(row, _mm_mul_ps(_mm_shuffle_ps(p, p, 0x55), l1));
+                row = _mm_add_ps(row, _mm_mul_ps(_mm_shuffle_ps(p, p, 0xAA), l2));
+                row = _mm_add_ps(row, _mm_mul_ps(_mm_shuffle_ps(p, p, 0xFF), l3));
+                _mm_store_ps(&world.rows[i].x, row);
+            };
+        };
+
+        // ComposeLocal for the four nodes from index on, one node per SIMD lane: the SoA channels load directly and
+        // the matrix elements are transposed into rows at the end.
+        void ComposeLocal4(const LocalChannels &channels, uint32_t index, WorldRows local[4])
+        {
+            __m128 x = _mm_loadu_ps(channels.rotation[0] + index);
+            __m128 y = _mm_loadu_ps(channels.rotation[1] + index);
+            __m128 z = _mm_loadu_ps(channels.rotation[2] + index);
+            __m128 w = _mm_loadu_ps(channels.rotation[3] + index);
+            __m128 sx = _mm_loadu_ps(channels.scale[0] + index);
+            __m128 sy = _mm_loadu_ps(channels.scale[1] + index);
+            __m128 sz = _mm_loadu_ps(channels.scale[2] + index);
+
+            __m128 one = _mm_set1_ps(1.0f);
+            __m128 two = _mm_set1_ps(2.0f);
+
+            __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+            __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+            __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+            __m128 rows[3][4] = {
+                {_mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx), _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy), _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz), _mm_loadu_ps(channels.position[0] + index)},
+                {_mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx), _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy), _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz), _mm_loadu_ps(channels.position[1] + index)},
+                {_mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx), _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy), _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz), _mm_loadu_ps(channels.position[2] + index)}};
+
+            for (int r = 0; r < 3; r++)
+            {
+                _MM_TRANSPOSE4_PS(rows[r][0], rows[r][1], rows[r][2], rows[r][3]);
+                for (int lane = 0; lane < 4; lane++)
+                {
+                    _mm_store_ps(&local[lane].rows[r].x, rows[r][lane]);
+                };
+            };
+        };
+#endif
+
+    };
+
+    HierarchyNode TransformHierarchy::Add(const Transform &local, HierarchyNode parent)
+    {
+        uint32_t parentIndex = INVALID_INDEX;
+        if (!parent.IsNull())
+        {
+            CORE_ASSERT(m_Nodes.IsValid(parent), "Stale parent node!");
+            parentIndex = *m_Nodes.Get(parent);
+        };
+
+        uint32_t index = static_cast<uint32_t>(m_Parents.size());
+        for (std::vector<float> &channel : m_Local)
+        {
+            channel.push_back(0.0f);
+        };
+        SetChannels(index, local);
+
+        m_Parents.push_back(parentIndex);
+        m_Depths.push_back(parentIndex == INVALID_INDEX ? 0 : m_Depths[parentIndex] + 1);
+        m_World.push_back(WorldRows{});
+        m_WorldVersions.push_back(0);
+        m_Dirty.push_back(1);
+
+        HierarchyNode node = m_Nodes.Add(index);
+        m_Handles.push_back(node);
+        m_InstanceCapacity = (std::max)(m_InstanceCapacity, node.GetIndex() + 1);
+
+        m_Sorted = false;
+        m_AnyDirty = true;
+
+        return node;
+    };
+
+    void TransformHierarchy::Remove(HierarchyNode node)
+    {
+        if (!m_Nodes.IsValid(node))
+        {
+            return;
+        };
+
+        // Descendants follow their ancestors once sorted, one pass finds the whole subtree.
+        Sort();
+
+        uint32_t index = *m_Nodes.Get(node);
+        std::vector<uint8_t> removed(m_Parents.size(), 0);
+        removed[index] = 1;
+
+        std::vector<uint32_t> order;
+        order.reserve(m_Parents.size());
+        for (uint32_t i = 0; i < m_Parents.size(); i++)
+        {
+            if (i > index && m_Parents[i] != INVALID_INDEX && removed[m_Parents[i]])
+            {
+                removed[i] = 1;
+            };
+
+            if (removed[i])
+            {
+                m_Nodes.Remove(m_Handles[i]);
+            }
+            else
+            {
+                order.push_back(i);
+            };
+        };
+
+        // Dropping nodes keeps the others in depth order.
+        Permute(order);
+        BuildLevels();
+    };
+
+    void TransformHierarchy::Clear()
+    {
+        m_Nodes.Clear();
+
+        for (std::vector<float> &channel : m_Local)
+        {
+            channel.clear();
+        };
+
+        m_Parents.clear();
+        m_Depths.clear();
+        m_Handles.clear();
+        m_World.clear();
+        m_WorldVersions.clear();
+        m_Dirty.clear();
+        m_Levels = {0};
+        m_Sorted = true;
+        m_AnyDirty = false;
+    };
+
+    void TransformHierarchy::SetLocal(HierarchyNode node, const Transform &local)
+    {
+        CORE_ASSERT(m_Nodes.IsValid(node), "Stale node!");
+
+        uint32_t index = *m_Nodes.Get(node);
+        SetChannels(index, local);
+        m_Dirty[index] = 1;
+        m_AnyDirty = true;
+    };
+
+    Transform TransformHierarchy::GetLocal(HierarchyNode node) const
+    {
+        CORE_ASSERT(m_Nodes.IsValid(node), "Stale node!");
+
+        uint32_t index = *m_Nodes.Get(node);
+
+        Transform local;
+        local.position = glm::vec3(m_Local[PositionX][index], m_Local[PositionY][index], m_Local[PositionZ][index]);
+        local.rotation = glm::quat(m_Local[RotationW][index], m_Local[RotationX][index], m_Local[RotationY][index], m_Local[RotationZ][index]);
+        local.scale = glm::vec3(m_Local[ScaleX][index], m_Local[ScaleY][index], m_Local[ScaleZ][index]);
+
+        return local;
+    };
+
+    const WorldRows &TransformHierarchy::GetWorld(HierarchyNode node) const
+    {
+        CORE_ASSERT(m_Nodes.IsValid(node), "Stale node!");
+
+        return m_World[*m_Nodes.Get(node)];
+    };
+
+    uint64_t TransformHierarchy::GetWorldVersion(HierarchyNode node) const
+    {
+        CORE_ASSERT(m_Nodes.IsValid(node), "Stale node!");
+
+        return m_WorldVersions[*m_Nodes.Get(node)];
+    };
+
+    uint32_t TransformHierarchy::Propagate()
+    {
+        VKS_PROFILE_ZONE("Propagate Transforms");
+
+        Sort();
+
+        if (!m_AnyDirty)
+        {
+            return 0;
+        };
+
+        m_Version++;
+
+        LocalChannels channels = {
+            {m_Local[PositionX].data(), m_Local[PositionY].data(), m_Local[PositionZ].data()},
+            {m_Local[RotationX].data(), m_Local[RotationY].data(), m_Local[RotationZ].data(), m_Local[RotationW].data()},
+            {m_Local[ScaleX].data(), m_Local[ScaleY].data(), m_Local[ScaleZ].data()}};
+
+        uint32_t computed = 0;
+        for (uint32_t level = 0; level + 1 < m_Levels.size(); level++)
+        {
+            uint32_t end = m_Levels[level + 1];
+
+            // Batches of four stay within the level, their parents are all final.
+            for (uint32_t first = m_Levels[level]; first < end; first += 4)
+            {
+                uint32_t lanes = (std::min)(end - first, 4u);
+
+                uint32_t needed = 0;
+                for (uint32_t lane = 0; lane < lanes; lane++)
+                {
+                    uint32_t parent = m_Parents[first + lane];
+                    if (m_Dirty[first + lane] || (parent != INVALID_INDEX && m_Dirty[parent]))
+                    {
+                        needed |= 1u << lane;
+                    };
+                };
+
+                if (needed == 0)
+                {
+                    continue;
+                };
+
+                WorldRows local[4];
+#if VKS_SCENE_SSE
+                if (lanes == 4 && m_SimdEnabled)
+                {
+                    ComposeLocal4(channels, first, local);
+                }
+                else
+#endif
+                {
+                    for (uint32_t lane = 0; lane < lanes; lane++)
+                    {
+                        ComposeLocal(channels, first + lane, local[lane]);
+                    };
+                };
+
+                for (uint32_t lane = 0; lane < lanes; lane++)
+                {
+                    if ((needed & (1u << lane)) == 0)
+                    {
+                        continue;
+                    };
+
+                    uint32_t index = first + lane;
+                    if (m_Parents[index] == INVALID_INDEX)
+                    {
+                        m_World[index] = local[lane];
+                    }
+                    else
+                    {
+#if VKS_SCENE_SSE
+                        if (m_SimdEnabled)
+                        {
+                            Multiply(m_World[m_Parents[index]], local[lane], m_World[index]);
+                        }
+                        else
+#endif
+                        {
+                            MultiplyScalar(m_World[m_Parents[index]], local[lane], m_World[index]);
+                        };
+                    };
+
+                    m_WorldVersions[index] = m_Version;
+                    m_Dirty[index] = 1;
+                    computed++;
+                };
+            };
+        };
+
+        std::fill(m_Dirty.begin(), m_Dirty.end(), 0);
+        m_AnyDirty = false;
+
+        return computed;
+    };
+
+    uint64_t TransformHierarchy::WriteInstances(WorldRows *instances, uint64_t version) const
+    {
+        VKS_PROFILE_ZONE("Write Instances");
+
+        for (size_t i = 0; i < m_Handles.size(); i++)
+        {
+            if (m_WorldVersions[i] > version)
+            {
+                instances[m_Handles[i].GetIndex()] = m_World[i];
+            };
+        };
+
+        return m_Version;
+    };
+
+    void TransformHierarchy::SetChannels(uint32_t index, const Transform &local)
+    {
+        m_Local[PositionX][index] = local.position.x;
+        m_Local[PositionY][index] = local.position.y;
+        m_Local[PositionZ][index] = local.position.z;
+        m_Local[RotationX][index] = local.rotation.x;
+        m_Local[RotationY][index] = local.rotation.y;
+        m_Local[RotationZ][index] = local.rotation.z;
+        m_Local[RotationW][index] = local.rotation.w;
+        m_Local[ScaleX][index] = local.scale.x;
+        m_Local[ScaleY][index] = local.scale.y;
+        m_Local[ScaleZ][index] = local.scale.z;
+    };
+
+    void TransformHierarchy::Permute(const std::vector<uint32_t> &order)
+    {
+        std::vector<uint32_t> newIndices(m_Parents.size(), INVALID_INDEX);
+        for (uint32_t i = 0; i < order.size(); i++)
+        {
+            newIndices[order[i]] = i;
+        };
+
+        auto reorder = [&order](auto &values)
+        {
+            std::remove_reference_t<decltype(values)> reordered;
+            reordered.reserve(order.size());
+            for (uint32_t index : order)
+            {
+                reordered.push_back(values[index]);
+            };
+            values.swap(reordered);
+        };
+
+        for (std::vector<float> &channel : m_Local)
+        {
+            reorder(channel);
+        };
+
+        reorder(m_Parents);
+        reorder(m_Depths);
+        reorder(m_Handles);
+        reorder(m_World);
+        reorder(m_WorldVersions);
+        reorder(m_Dirty);
+
+        for (uint32_t i = 0; i < order.size(); i++)
+        {
+            if (m_Parents[i] != INVALID_INDEX)
+            {
+                m_Parents[i] = newIndices[m_Parents[i]];
+            };
+
+            *m_Nodes.Get(m_Handles[i]) = i;
+        };
+    };
+
+    void TransformHierarchy::Sort()
+    {
+        if (m_Sorted)
+        {
+            return;
+        };
+
+        // Nodes are mostly added below existing ones, which leaves the arrays sorted already.
+        if (!std::is_sorted(m_Depths.begin(), m_Depths.end()))
+        {
+            std::vector<uint32_t> order(m_Depths.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b)
+                             { return m_Depths[a] < m_Depths[b]; });
+
+            Permute(order);
+        };
+
+        BuildLevels();
+        m_Sorted = true;
+    };
+
+    void TransformHierarchy::BuildLevels()
+    {
+        m_Levels.clear();
+        for (uint32_t i = 0; i < m_Depths.size(); i++)
+        {
+            while (m_Levels.size() <= m_Depths[i])
+            {
+                m_Levels.push_back(i);
+            };
+        };
+        m_Levels.push_back(static_cast<uint32_t>(m_Depths.size()));
+    };
+
+};
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "../Common.h"
+#include "../Vulkan-Core/HandlePool.h"
+#include "Components.h"
+
+namespace Scene
+{
+    struct HierarchyNodeTag
+    {
+    };
+
+    using HierarchyNode = VulkanCore::Handle<HierarchyNodeTag>;
+
+    // World matrix as the rows of its affine part, the layout of the renderer's instance buffer.
+    struct alignas(16) WorldRows
+    {
+        glm::vec4 rows[3];
+    };
+
+    // Places an entity at a node of a TransformHierarchy instead of giving it a Transform of its own.
+    struct HierarchyTransform
+    {
+        HierarchyNode node;
+    };
+
+    // Parent-child transforms. Local TRS are stored structure-of-arrays and kept sorted by depth, so world matrices
+    // are computed level by level, every parent ahead of its children, four nodes at a time with SSE where the
+    // target has it. Only nodes whose local transform changed and their descendants are recomputed.
+    class TransformHierarchy
+    {
+    public:
+        TransformHierarchy() = default;
+        ~TransformHierarchy() = default;
+        TransformHierarchy(const TransformHierarchy &) = delete;
+        TransformHierarchy &operator=(const TransformHierarchy &) = delete;
+
+        // A null parent adds a root.
+        HierarchyNode Add(const Transform &local, HierarchyNode parent = {});
+        // Removes the node along with its whole subtree.
+        void Remove(HierarchyNode node);
+        void Clear();
+        bool IsValid(HierarchyNode node) const { return m_Nodes.IsValid(node); };
+
+        void SetLocal(HierarchyNode node, const Transform &local);
+        Transform GetLocal(HierarchyNode node) const;
+        // Current as of the last Propagate().
+        const WorldRows &GetWorld(HierarchyNode node) const;
+        // Propagate() version the node's world matrix was last computed in, compare against GetVersion().
+        uint64_t GetWorldVersion(HierarchyNode node) const;
+        uint64_t GetVersion() const { return m_Version; };
+
+        // Row of the node in the instance buffer, stable for its lifetime and below GetInstanceCapacity().
+        uint32_t GetInstance(HierarchyNode node) const { return node.GetIndex(); };
+        uint32_t GetInstanceCapacity() const { return m_InstanceCapacity; };
+
+        // Recomputes the world matrices of the dirty nodes and their subtrees, returns how many were computed.
+        uint32_t Propagate();
+        // Writes the world rows computed after version into instances, indexed by GetInstance(). Returns the
+        // version to pass next time, 0 writes every node.
+        uint64_t WriteInstances(WorldRows *instances, uint64_t version) const;
+
+        // Off computes every node with the scalar kernels, to check the SSE ones against. No effect without SSE.
+        void SetSimdEnabled(bool enabled) { m_SimdEnabled = enabled; };
+
+        size_t Size() const { return m_Nodes.Size(); };
+        uint32_t GetLevelCount() const { return static_cast<uint32_t>(m_Levels.size()) - 1; };
+
+    private:
+        static constexpr uint32_t INVALID_INDEX = ~0u;
+
+        enum Channel
+        {
+            PositionX,
+            PositionY,
+            PositionZ,
+            RotationX,
+            RotationY,
+            RotationZ,
+            RotationW,
+            ScaleX,
+            ScaleY,
+            ScaleZ,
+            CHANNEL_COUNT
+        };
+
+        void SetChannels(uint32_t index, const Transform &local);
+        // Reorders every node array so node i becomes the node at order[i], nodes missing from order are dropped.
+        void Permute(const std::vector<uint32_t> &order);
+        void Sort();
+        void BuildLevels();
+
+    private:
+        // Handles resolve to the node's position in the sorted arrays.
+        VulkanCore::HandlePool<HierarchyNodeTag, uint32_t> m_Nodes;
+        uint32_t m_InstanceCapacity = 0;
+
+        // Node arrays, in depth order once sorted.
+        std::array<std::vector<float>, CHANNEL_COUNT> m_Local;
+        std::vector<uint32_t> m_Parents;
+        std::vector<uint32_t> m_Depths;
+        std::vector<HierarchyNode> m_Handles;
+        std::vector<WorldRows> m_World;
+        // Propagate() version each world matrix was last computed in.
+        std::vector<uint64_t> m_WorldVersions;
+        // Set for changed nodes, and during Propagate() for every node computed, so their children follow.
+        std::vector<uint8_t> m_Dirty;
+
+        // First node of every depth, plus the node count.
+        std::vector<uint32_t> m_Levels = {0};
+        bool m_Sorted = true;
+        bool m_AnyDirty = false;
+        bool m_SimdEnabled = true;
+        uint64_t m_Version = 0;
+    };
+
+};
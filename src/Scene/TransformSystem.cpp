@@ -0,0 +1,92 @@
+#include "TransformSystem.h"
+#include "../Profiling/Profiler.h"
+
+namespace Scene
+{
+    namespace
+    {
+        glm::mat4 ComposeMatrix(const Transform &transform)
+        {
+            glm::mat3 rotation = glm::mat3_cast(transform.rotation);
+
+            glm::mat4 matrix(1.0f);
+            matrix[0] = glm::vec4(rotation[0] * transform.scale.x, 0.0f);
+            matrix[1] = glm::vec4(rotation[1] * transform.scale.y, 0.0f);
+            matrix[2] = glm::vec4(rotation[2] * transform.scale.z, 0.0f);
+            matrix[3] = glm::vec4(transform.position, 1.0f);
+
+            return matrix;
+        };
+
+    };
+
+    uint64_t UpdateWorldTransforms(Registry &registry, WorkerPool &pool, uint64_t version)
+    {
+        VKS_PROFILE_ZONE("Update World Transforms");
+
+        auto updateMatrices = [](const Entity *, uint32_t count, const Transform *transforms, LocalToWorld *localToWorld)
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                localToWorld[i].matrix = ComposeMatrix(transforms[i]);
+            };
+        };
+
+        auto updateBounds = [](const Entity *, uint32_t count, const Transform *transforms, const LocalToWorld *localToWorld, const MeshInstance *meshes, WorldBounds *bounds)
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                glm::vec3 scale = glm::abs(transforms[i].scale);
+                float maxScale = (std::max)((std::max)(scale.x, scale.y), scale.z);
+                glm::vec3 center = glm::vec3(localToWorld[i].matrix * glm::vec4(glm::vec3(meshes[i].localBounds), 1.0f));
+
+                bounds[i].sphere = glm::vec4(center, meshes[i].localBounds.w * maxScale);
+                bounds[i].scale = maxScale;
+            };
+        };
+
+        registry.ParallelForEachChangedChunk<Transform, const Transform, LocalToWorld>(pool, version, updateMatrices);
+        registry.ParallelForEachChangedChunk<Transform, const Transform, const LocalToWorld, const MeshInstance, WorldBounds>(pool, version, updateBounds);
+
+        // Both passes stamped only derived components, later Transform writes are newer than this.
+        return registry.GetVersion();
+    };
+
+    uint64_t UpdateHierarchyTransforms(Registry &registry, TransformHierarchy &hierarchy, uint64_t version)
+    {
+        if (hierarchy.Propagate() == 0 && version != 0)
+        {
+            return hierarchy.GetVersion();
+        };
+
+        VKS_PROFILE_ZONE("Update Hierarchy Entities");
+
+        auto copyWorld = [&hierarchy, version](const Entity *, uint32_t count, const HierarchyTransform *transforms, const MeshInstance *meshes, LocalToWorld *localToWorld, WorldBounds *bounds)
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                if (hierarchy.GetWorldVersion(transforms[i].node) <= version)
+                {
+                    continue;
+                };
+
+                const WorldRows &world = hierarchy.GetWorld(transforms[i].node);
+                localToWorld[i].matrix = glm::transpose(glm::mat4(world.rows[0], world.rows[1], world.rows[2], glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)));
+
+                // Largest axis scale, the length of the longest basis column.
+                glm::mat3 basis(localToWorld[i].matrix);
+                float scale = glm::sqrt((std::max)((std::max)(glm::dot(basis[0], basis[0]), glm::dot(basis[1], basis[1])), glm::dot(basis[2], basis[2])));
+                glm::vec3 center = glm::vec3(localToWorld[i].matrix * glm::vec4(glm::vec3(meshes[i].localBounds), 1.0f));
+
+                bounds[i].sphere = glm::vec4(center, meshes[i].localBounds.w * scale);
+                bounds[i].scale = scale;
+            };
+        };
+
+        // Only runs in frames where some node moved, the chunks it stamps are those of placed entities.
+        registry.ForEachChunk<const HierarchyTransform, const MeshInstance, LocalToWorld, WorldBounds>(copyWorld);
+
+        return hierarchy.GetVersion();
+    };
+
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Registry.h"
+#include "Components.h"
+#include "TransformHierarchy.h"
+
+namespace Scene
+{
+    // Recomputes LocalToWorld and, for meshes, WorldBounds in the chunks whose Transform was written after
+    // version. Returns the version to pass next time, 0 updates every entity.
+    uint64_t UpdateWorldTransforms(Registry &registry, WorkerPool &pool, uint64_t version);
+
+    // Propagates the hierarchy, then copies the world matrices computed after version into the LocalToWorld and
+    // WorldBounds of the entities placed on them. Returns the hierarchy version to pass next time.
+    uint64_t UpdateHierarchyTransforms(Registry &registry, TransformHierarchy &hierarchy, uint64_t version);
+
+};
@@ -0,0 +1,117 @@
+#include "WorkerPool.h"
+#include "../Profiling/Profiler.h"
+
+namespace Scene
+{
+
+    void WorkerPool::Create(uint32_t workerCount)
+    {
+        if (workerCount == 0)
+        {
+            workerCount = (std::max)(std::thread::hardware_concurrency(), 1u) - 1;
+        };
+
+        m_Stopping = false;
+        for (uint32_t i = 0; i < workerCount; i++)
+        {
+            m_Workers.emplace_back(&WorkerPool::WorkerLoop, this);
+        };
+    };
+
+    void WorkerPool::Destroy()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stopping = true;
+        };
+
+        m_WorkCondition.notify_all();
+
+        for (std::thread &worker : m_Workers)
+        {
+            worker.join();
+        };
+
+        m_Workers.clear();
+    };
+
+    void WorkerPool::RunTasks(uint32_t taskCount, TaskFunction function, const void *context)
+    {
+        // Waking the workers costs more than a single task.
+        if (m_Workers.empty() || taskCount <= 1)
+        {
+            for (uint32_t i = 0; i < taskCount; i++)
+            {
+                function(context, i);
+            };
+
+            return;
+        };
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Function = function;
+            m_Context = context;
+            m_TaskCount = taskCount;
+            m_NextTask.store(0, std::memory_order_relaxed);
+            m_Active = static_cast<uint32_t>(m_Workers.size());
+            m_Generation++;
+        };
+
+        m_WorkCondition.notify_all();
+
+        Execute();
+
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_DoneCondition.wait(lock, [this]()
+                             { return m_Active == 0; });
+    };
+
+    void WorkerPool::WorkerLoop()
+    {
+        VKS_PROFILE_THREAD("Scene Worker");
+
+        uint64_t generation = 0;
+
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_WorkCondition.wait(lock, [this, generation]()
+                                     { return m_Stopping || m_Generation != generation; });
+
+                if (m_Stopping)
+                {
+                    return;
+                };
+
+                generation = m_Generation;
+            };
+
+            Execute();
+
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Active--;
+            };
+
+            m_DoneCondition.notify_one();
+        };
+    };
+
+    void WorkerPool::Execute()
+    {
+        // Tasks are claimed one at a time, uneven chunks balance out across the threads.
+        while (true)
+        {
+            uint32_t index = m_NextTask.fetch_add(1, std::memory_order_relaxed);
+            if (index >= m_TaskCount)
+            {
+                return;
+            };
+
+            m_Function(m_Context, index);
+        };
+    };
+
+};
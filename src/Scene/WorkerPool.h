@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "../Common.h"
+
+namespace Scene
+{
+    // Persistent threads for data parallel loops over scene chunks. The calling thread works alongside the
+    // workers and Run() returns once every task has finished, so callers need no synchronization of their own.
+    // A pool that was never created, or has no workers, runs every task on the calling thread.
+    class WorkerPool
+    {
+    public:
+        WorkerPool() = default;
+        ~WorkerPool() = default;
+        WorkerPool(const WorkerPool &) = delete;
+        WorkerPool &operator=(const WorkerPool &) = delete;
+
+        // 0 uses one worker per hardware thread besides the caller's.
+        void Create(uint32_t workerCount = 0);
+        void Destroy();
+
+        // Calls task(index) once for every index below taskCount. Not reentrant, tasks must not call Run().
+        template <typename Task>
+        void Run(uint32_t taskCount, const Task &task)
+        {
+            RunTasks(taskCount, [](const void *context, uint32_t index)
+                     { (*static_cast<const Task *>(context))(index); },
+                     &task);
+        };
+
+        uint32_t GetThreadCount() const { return static_cast<uint32_t>(m_Workers.size()) + 1; };
+
+    private:
+        // Type erased so running a loop never allocates.
+        using TaskFunction = void (*)(const void *context, uint32_t index);
+
+        void RunTasks(uint32_t taskCount, TaskFunction function, const void *context);
+        void WorkerLoop();
+        void Execute();
+
+    private:
+        std::vector<std::thread> m_Workers;
+
+        // Guards everything below but the task counter.
+        std::mutex m_Mutex;
+        std::condition_variable m_WorkCondition;
+        std::condition_variable m_DoneCondition;
+        bool m_Stopping = false;
+        // Bumped for every Run(), workers take part in each one exactly once.
+        uint64_t m_Generation = 0;
+        uint32_t m_Active = 0;
+
+        TaskFunction m_Function = nullptr;
+        const void *m_Context = nullptr;
+        uint32_t m_TaskCount = 0;
+        std::atomic<uint32_t> m_NextTask{0};
+    };
+
+};
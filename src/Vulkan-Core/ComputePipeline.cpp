@@ -0,0 +1,111 @@
+#include "ComputePipeline.h"
+#include "ShaderModule.h"
+#include "../Log.h"
+
+namespace VulkanCore
+{
+
+    void ComputePipeline::Create(const ComputePipelineConfig &config, const Device &device)
+    {
+        m_Config = config;
+        m_DeviceInst = &device;
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.bindingCount = static_cast<uint32_t>(m_Config.bindings.size());
+        layoutInfo.pBindings = m_Config.bindings.data();
+
+        VkResult result = vkCreateDescriptorSetLayout(m_DeviceInst->Get(), &layoutInfo, nullptr, &m_DescriptorSetLayout);
+
+        CORE_ASSERT(result == VK_SUCCESS, "Failed to create compute descriptor set layout!");
+
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = m_Config.pushConstantSize;
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &m_DescriptorSetLayout;
+        pipelineLayoutInfo.pushConstantRangeCount = m_Config.pushConstantSize > 0 ? 1 : 0;
+        pipelineLayoutInfo.pPushConstantRanges = m_Config.pushConstantSize > 0 ? &pushConstantRange : nullptr;
+
+        result = vkCreatePipelineLayout(m_DeviceInst->Get(), &pipelineLayoutInfo, nullptr, &m_PipelineLayout);
+
+        CORE_ASSERT(result == VK_SUCCESS, "Failed to create compute pipeline layout!");
+
+        ShaderModule computeShaderModule;
+        computeShaderModule.Create(*m_DeviceInst, m_Config.shaderPath);
+
+        VkPipelineShaderStageCreateInfo computeShaderStageInfo{};
+        computeShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        computeShaderStageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        computeShaderStageInfo.module = computeShaderModule.Get();
+        computeShaderStageInfo.pName = "main";
+
+        VkComputePipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineInfo.stage = computeShaderStageInfo;
+        pipelineInfo.layout = m_PipelineLayout;
+
+        result = vkCreateComputePipelines(m_DeviceInst->Get(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_Pipeline);
+
+        CORE_ASSERT(result == VK_SUCCESS, "Failed to create compute pipeline!");
+
+        computeShaderModule.Destroy();
+    };
+
+    void ComputePipeline::Destroy()
+    {
+        if (m_PipelineLayout == VK_NULL_HANDLE)
+        {
+            return;
+        };
+
+        vkDestroyPipeline(m_DeviceInst->Get(), m_Pipeline, nullptr);
+        vkDestroyPipelineLayout(m_DeviceInst->Get(), m_PipelineLayout, nullptr);
+        vkDestroyDescriptorSetLayout(m_DeviceInst->Get(), m_DescriptorSetLayout, nullptr);
+
+        m_Pipeline = VK_NULL_HANDLE;
+        m_PipelineLayout = VK_NULL_HANDLE;
+        m_DescriptorSetLayout = VK_NULL_HANDLE;
+    };
+
+    void ComputePipeline::Bind(VkCommandBuffer commandBuffer)
+    {
+        m_DeviceInst->GetDispatch().vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_Pipeline);
+    };
+
+    void ComputePipeline::BindDescriptorSet(VkCommandBuffer commandBuffer, VkDescriptorSet descriptorSet)
+    {
+        m_DeviceInst->GetDispatch().vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_PipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+    };
+
+    void ComputePipeline::PushConstants(VkCommandBuffer commandBuffer, const void *data, uint32_t size)
+    {
+        CORE_ASSERT(size <= m_Config.pushConstantSize, "Push constant data exceeds the compute pipeline range!");
+
+        m_DeviceInst->GetDispatch().vkCmdPushConstants(commandBuffer, m_PipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, size, data);
+    };
+
+    void ComputePipeline::Dispatch(VkCommandBuffer commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
+    {
+        m_DeviceInst->GetDispatch().vkCmdDispatch(commandBuffer, groupCountX, groupCountY, groupCountZ);
+    };
+
+    void ComputePipeline::DispatchThreads(VkCommandBuffer commandBuffer, uint32_t threadCountX, uint32_t threadCountY, uint32_t threadCountZ)
+    {
+        uint32_t groupCountX = (threadCountX + m_Config.localSizeX - 1) / m_Config.localSizeX;
+        uint32_t groupCountY = (threadCountY + m_Config.localSizeY - 1) / m_Config.localSizeY;
+        uint32_t groupCountZ = (threadCountZ + m_Config.localSizeZ - 1) / m_Config.localSizeZ;
+
+        m_DeviceInst->GetDispatch().vkCmdDispatch(commandBuffer, groupCountX, groupCountY, groupCountZ);
+    };
+
+    void ComputePipeline::DispatchIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset)
+    {
+        m_DeviceInst->GetDispatch().vkCmdDispatchIndirect(commandBuffer, buffer, offset);
+    };
+
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "../Common.h"
+#include "Types.h"
+#include "Device.h"
+
+namespace VulkanCore
+{
+    // A compute shader with its own descriptor set layout (set 0) and optional push constant block.
+    class ComputePipeline
+    {
+    public:
+        ComputePipeline() = default;
+        ~ComputePipeline() { Destroy(); };
+        ComputePipeline(const ComputePipeline &) = delete;
+        ComputePipeline &operator=(const ComputePipeline &) = delete;
+
+        void Create(const ComputePipelineConfig &config, const Device &device);
+        void Destroy();
+
+        void Bind(VkCommandBuffer commandBuffer);
+        void BindDescriptorSet(VkCommandBuffer commandBuffer, VkDescriptorSet descriptorSet);
+        void PushConstants(VkCommandBuffer commandBuffer, const void *data, uint32_t size);
+
+        void Dispatch(VkCommandBuffer commandBuffer, uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1);
+        // Rounds a thread count up to whole workgroups of the configured local size.
+        void DispatchThreads(VkCommandBuffer commandBuffer, uint32_t threadCountX, uint32_t threadCountY = 1, uint32_t threadCountZ = 1);
+        // Group counts are read from a VkDispatchIndirectCommand in the buffer, so the GPU can size its own work.
+        void DispatchIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset = 0);
+
+        VkPipeline Get() { return m_Pipeline; };
+        VkPipelineLayout GetLayout() { return m_PipelineLayout; };
+        VkDescriptorSetLayout GetDescriptorSetLayout() { return m_DescriptorSetLayout; };
+
+    private:
+        ComputePipelineConfig m_Config;
+        const Device *m_DeviceInst = nullptr;
+
+        VkDescriptorSetLayout m_DescriptorSetLayout = VK_NULL_HANDLE;
+        VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE;
+        VkPipeline m_Pipeline = VK_NULL_HANDLE;
+    };
+
+};
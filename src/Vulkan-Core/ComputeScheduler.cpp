@@ -0,0 +1,155 @@
+#include "ComputeScheduler.h"
+#include "../Log.h"
+
+namespace VulkanCore
+{
+
+    void ComputeScheduler::Create(const Device &device, uint32_t framesInFlight)
+    {
+        m_DeviceInst = &device;
+
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        poolInfo.queueFamilyIndex = GetQueueFamily();
+
+        VkResult result = vkCreateCommandPool(m_DeviceInst->Get(), &poolInfo, nullptr, &m_CommandPool);
+
+        CORE_ASSERT(result == VK_SUCCESS, "Failed to create compute command pool!");
+
+        m_CommandBuffers.resize(framesInFlight);
+
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = m_CommandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = framesInFlight;
+
+        result = vkAllocateCommandBuffers(m_DeviceInst->Get(), &allocInfo, m_CommandBuffers.data());
+
+        CORE_ASSERT(result == VK_SUCCESS, "Failed to allocate compute command buffers!");
+
+        m_FinishedSemaphores.resize(framesInFlight);
+        m_InFlightFences.resize(framesInFlight);
+        m_Recording.resize(framesInFlight, false);
+
+        VkSemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+        VkFenceCreateInfo fenceInfo{};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+        for (uint32_t i = 0; i < framesInFlight; i++)
+        {
+            if (vkCreateSemaphore(m_DeviceInst->Get(), &semaphoreInfo, nullptr, &m_FinishedSemaphores[i]) != VK_SUCCESS ||
+                vkCreateFence(m_DeviceInst->Get(), &fenceInfo, nullptr, &m_InFlightFences[i]) != VK_SUCCESS)
+            {
+                throw std::runtime_error("Failed to create synchronization objects for compute!");
+            };
+        };
+
+        result = vkCreateSemaphore(m_DeviceInst->Get(), &semaphoreInfo, nullptr, &m_ReleaseSemaphore);
+
+        CORE_ASSERT(result == VK_SUCCESS, "Failed to create compute release semaphore!");
+    };
+
+    void ComputeScheduler::Destroy()
+    {
+        if (m_CommandPool == VK_NULL_HANDLE)
+        {
+            return;
+        };
+
+        for (size_t i = 0; i < m_InFlightFences.size(); i++)
+        {
+            vkDestroySemaphore(m_DeviceInst->Get(), m_FinishedSemaphores[i], nullptr);
+            vkDestroyFence(m_DeviceInst->Get(), m_InFlightFences[i], nullptr);
+        };
+
+        vkDestroySemaphore(m_DeviceInst->Get(), m_ReleaseSemaphore, nullptr);
+        m_ReleaseSemaphore = VK_NULL_HANDLE;
+
+        m_FinishedSemaphores.clear();
+        m_InFlightFences.clear();
+
+        vkDestroyCommandPool(m_DeviceInst->Get(), m_CommandPool, nullptr);
+        m_CommandPool = VK_NULL_HANDLE;
+    };
+
+    VkCommandBuffer ComputeScheduler::Begin(uint32_t frame)
+    {
+        const DeviceDispatch &dispatch = m_DeviceInst->GetDispatch();
+
+        VkCommandBuffer commandBuffer = m_CommandBuffers[frame];
+
+        if (m_Recording[frame])
+        {
+            return commandBuffer;
+        };
+
+        dispatch.vkWaitForFences(m_DeviceInst->Get(), 1, &m_InFlightFences[frame], VK_TRUE, UINT64_MAX);
+        dispatch.vkResetFences(m_DeviceInst->Get(), 1, &m_InFlightFences[frame]);
+
+        dispatch.vkResetCommandBuffer(commandBuffer, 0);
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        VkResult result = dispatch.vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+        CORE_ASSERT(result == VK_SUCCESS, "Failed to begin recording compute command buffer!");
+
+        m_Recording[frame] = true;
+
+        return commandBuffer;
+    };
+
+    VkSemaphore ComputeScheduler::Submit(uint32_t frame)
+    {
+        const DeviceDispatch &dispatch = m_DeviceInst->GetDispatch();
+
+        if (!m_Recording[frame])
+        {
+            return VK_NULL_HANDLE;
+        };
+
+        m_Recording[frame] = false;
+
+        VkResult result = dispatch.vkEndCommandBuffer(m_CommandBuffers[frame]);
+
+        CORE_ASSERT(result == VK_SUCCESS, "Failed to record compute command buffer!");
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &m_CommandBuffers[frame];
+
+        VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        if (m_ReleasePending)
+        {
+            submitInfo.waitSemaphoreCount = 1;
+            submitInfo.pWaitSemaphores = &m_ReleaseSemaphore;
+            submitInfo.pWaitDstStageMask = &waitStage;
+            m_ReleasePending = false;
+        };
+
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &m_FinishedSemaphores[frame];
+
+        result = dispatch.vkQueueSubmit(m_DeviceInst->GetComputeQueue(), 1, &submitInfo, m_InFlightFences[frame]);
+
+        CORE_ASSERT(result == VK_SUCCESS, "Failed to submit compute command buffer!");
+
+        return m_FinishedSemaphores[frame];
+    };
+
+    VkSemaphore ComputeScheduler::Release()
+    {
+        m_ReleasePending = true;
+
+        return m_ReleaseSemaphore;
+    };
+
+};
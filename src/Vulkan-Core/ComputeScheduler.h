@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "../Common.h"
+#include "Device.h"
+
+namespace VulkanCore
+{
+    // Records compute work per frame and submits it to the compute queue. On devices with a dedicated
+    // compute family that queue runs alongside graphics; the returned semaphore orders the consumer.
+    class ComputeScheduler
+    {
+    public:
+        ComputeScheduler() = default;
+        ~ComputeScheduler() { Destroy(); };
+        ComputeScheduler(const ComputeScheduler &) = delete;
+        ComputeScheduler &operator=(const ComputeScheduler &) = delete;
+
+        void Create(const Device &device, uint32_t framesInFlight);
+        void Destroy();
+
+        // Command buffer of the frame, begun on first use. Blocks only if the same frame slot is still executing.
+        VkCommandBuffer Begin(uint32_t frame);
+        // Submits the recorded work and returns the semaphore it signals, VK_NULL_HANDLE if nothing was recorded.
+        // The returned semaphore must be waited on by exactly one later submission.
+        VkSemaphore Submit(uint32_t frame);
+        // Semaphore the consumer signals once it is done with resources the next compute submission overwrites.
+        // The next Submit waits on it, so it must be signaled by exactly one submission before that.
+        VkSemaphore Release();
+
+        bool IsAsync() { return m_DeviceInst->HasAsyncCompute(); };
+        uint32_t GetQueueFamily() { return m_DeviceInst->GetQueueFamilies().computeFamily.value(); };
+        VkCommandPool GetCommandPool() { return m_CommandPool; };
+
+    private:
+        const Device *m_DeviceInst = nullptr;
+
+        VkCommandPool m_CommandPool = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> m_CommandBuffers;
+        std::vector<VkSemaphore> m_FinishedSemaphores;
+        std::vector<VkFence> m_InFlightFences;
+        std::vector<bool> m_Recording;
+        VkSemaphore m_ReleaseSemaphore = VK_NULL_HANDLE;
+        bool m_ReleasePending = false;
+    };
+
+};
@@ -0,0 +1,52 @@
+#include "DescriptorPool.h"
+#include "../Log.h"
+
+namespace VulkanCore
+{
+
+    void DescriptorPool::Create(const Device &device, uint32_t maxSets, const std::vector<VkDescriptorPoolSize> &poolSizes)
+    {
+        m_DeviceInst = &device;
+
+        VkDescriptorPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.maxSets = maxSets;
+        poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+        poolInfo.pPoolSizes = poolSizes.data();
+
+        VkResult result = vkCreateDescriptorPool(m_DeviceInst->Get(), &poolInfo, nullptr, &m_DescriptorPool);
+
+        CORE_ASSERT(result == VK_SUCCESS, "Failed to create descriptor pool!");
+    };
+
+    void DescriptorPool::Destroy()
+    {
+        if (m_DescriptorPool != VK_NULL_HANDLE)
+        {
+            vkDestroyDescriptorPool(m_DeviceInst->Get(), m_DescriptorPool, nullptr);
+            m_DescriptorPool = VK_NULL_HANDLE;
+        };
+    };
+
+    VkDescriptorSet DescriptorPool::Allocate(VkDescriptorSetLayout layout)
+    {
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = m_DescriptorPool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &layout;
+
+        VkDescriptorSet descriptorSet;
+        VkResult result = vkAllocateDescriptorSets(m_DeviceInst->Get(), &allocInfo, &descriptorSet);
+
+        CORE_ASSERT(result == VK_SUCCESS, "Failed to allocate descriptor set!");
+
+        return descriptorSet;
+    };
+
+    void DescriptorPool::Reset()
+    {
+        vkResetDescriptorPool(m_DeviceInst->Get(), m_DescriptorPool, 0);
+    };
+
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "../Common.h"
+#include "Device.h"
+
+namespace VulkanCore
+{
+    class DescriptorPool
+    {
+    public:
+        DescriptorPool() = default;
+        ~DescriptorPool() { Destroy(); };
+        DescriptorPool(const DescriptorPool &) = delete;
+        DescriptorPool &operator=(const DescriptorPool &) = delete;
+
+        void Create(const Device &device, uint32_t maxSets, const std::vector<VkDescriptorPoolSize> &poolSizes);
+        void Destroy();
+
+        VkDescriptorSet Allocate(VkDescriptorSetLayout layout);
+        // Frees every set allocated from the pool at once.
+        void Reset();
+
+        VkDescriptorPool Get() { return m_DescriptorPool; };
+
+    private:
+        VkDescriptorPool m_DescriptorPool = VK_NULL_HANDLE;
+        const Device *m_DeviceInst = nullptr;
+    };
+
+};
@@ -2,45 +2,146 @@
 #include "Utils.h"
 #include "../Log.h"
 
+#include <cctype>
+#include <cstdlib>
+
 namespace VulkanCore
 {
+	namespace
+	{
+		const char *GetDeviceTypeName(VkPhysicalDeviceType type)
+		{
+			switch (type)
+			{
+			case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+				return "discrete";
+			case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+				return "integrated";
+			case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+				return "virtual";
+			case VK_PHYSICAL_DEVICE_TYPE_CPU:
+				return "cpu";
+			default:
+				return "other";
+			};
+		};
+	};
 
 	void Device::PickPhysical()
 	{
 		uint32_t deviceCount = 0;
-		vkEnumeratePhysicalDevices(m_Instance.Get(), &deviceCount, nullptr);
+		vkEnumeratePhysicalDevices(m_Instance->Get(), &deviceCount, nullptr);
 
 		CORE_ASSERT(deviceCount != 0, "Failed to find GPUs with Vulkan support!");
 
 		std::vector<VkPhysicalDevice> devices(deviceCount);
-		vkEnumeratePhysicalDevices(m_Instance.Get(), &deviceCount, devices.data());
+		vkEnumeratePhysicalDevices(m_Instance->Get(), &deviceCount, devices.data());
 
-		for (const auto &device : devices)
+		std::vector<PhysicalDeviceCandidate> candidates;
+		for (uint32_t i = 0; i < deviceCount; i++)
 		{
-			if (IsSuitable(device))
+			candidates.push_back(EvaluateDevice(devices[i], i));
+		};
+
+		// Suitable devices first, best score first; ties keep the enumeration order.
+		std::stable_sort(candidates.begin(), candidates.end(), [](const PhysicalDeviceCandidate &a, const PhysicalDeviceCandidate &b)
+						 { return a.suitable != b.suitable ? a.suitable : a.score > b.score; });
+
+		CORE_LOG_INFO("Physical devices:");
+		for (const PhysicalDeviceCandidate &candidate : candidates)
+		{
+			if (candidate.suitable)
+			{
+				CORE_LOG_INFO("  [{0}] {1} ({2}, {3} MiB device local): score {4}", candidate.index, candidate.name, GetDeviceTypeName(candidate.type), candidate.deviceLocalBytes >> 20, candidate.score);
+			}
+			else
+			{
+				CORE_LOG_INFO("  [{0}] {1} ({2}): rejected, {3}", candidate.index, candidate.name, GetDeviceTypeName(candidate.type), candidate.rejection);
+			};
+		};
+
+		const PhysicalDeviceCandidate *selected = FindPreferredDevice(candidates);
+		if (selected == nullptr && !candidates.empty() && candidates[0].suitable)
+		{
+			selected = &candidates[0];
+		};
+
+		CORE_ASSERT(selected != nullptr, "Failed to find a suitable GPU!");
+
+		m_PhysicalDevice = selected->device;
+		m_QueueFamilies = selected->queueFamilies;
+		m_Extensions = selected->extensions;
+		m_SelectedDeviceName = selected->name;
+
+		CORE_LOG_INFO("Selected device: {0}", m_SelectedDeviceName);
+	};
+
+	const PhysicalDeviceCandidate *Device::FindPreferredDevice(const std::vector<PhysicalDeviceCandidate> &candidates)
+	{
+		const char *environmentOverride = std::getenv("VKS_DEVICE");
+		std::string preferred = environmentOverride != nullptr ? environmentOverride : m_DeviceConfig.preferredDevice;
+
+		if (preferred.empty())
+		{
+			return nullptr;
+		};
+
+		auto toLower = [](std::string text)
+		{
+			std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c)
+						   { return static_cast<char>(std::tolower(c)); });
+			return text;
+		};
+
+		bool isIndex = std::all_of(preferred.begin(), preferred.end(), [](unsigned char c)
+								   { return std::isdigit(c) != 0; });
+		std::string preferredName = toLower(preferred);
+		unsigned long preferredIndex = isIndex ? std::strtoul(preferred.c_str(), nullptr, 10) : 0;
+
+		for (const PhysicalDeviceCandidate &candidate : candidates)
+		{
+			bool matches = isIndex ? candidate.index == preferredIndex : toLower(candidate.name).find(preferredName) != std::string::npos;
+			if (!matches)
+			{
+				continue;
+			};
+
+			if (candidate.suitable)
 			{
-				m_PhysicalDevice = device;
-				break;
+				CORE_LOG_INFO("Device override \"{0}\" matched {1}", preferred, candidate.name);
+				return &candidate;
 			};
+
+			CORE_LOG_WARN("Device override \"{0}\" matched {1}, which is unsuitable ({2})", preferred, candidate.name, candidate.rejection);
 		};
 
-		CORE_ASSERT(m_PhysicalDevice != VK_NULL_HANDLE, "Failed to find a suitable GPU!");
+		CORE_LOG_WARN("Device override \"{0}\" matched no suitable device, using the ranking.", preferred);
+		return nullptr;
 	};
 
 	void Device::Create(const DeviceConfig &config, const Instance &instance, const Surface &surface)
 	{
 		m_DeviceConfig = config;
-		m_Instance = instance;
-		m_Surface = surface;
+		m_Instance = &instance;
+		m_Surface = &surface;
 
 		PickPhysical();
 
+		// Fixed for the lifetime of the physical device, only the budgets change.
+		vkGetPhysicalDeviceMemoryProperties(m_PhysicalDevice, &m_MemoryProperties);
+
 		VkDeviceQueueCreateInfo queueCreateInfo{};
 		std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
 
 		std::set<uint32_t> uniqueQueueFamilies = {
 			m_QueueFamilies.graphicsFamily.value(),
-			m_QueueFamilies.presentFamily.value()};
+			m_QueueFamilies.computeFamily.value()};
+
+		// Headless devices have no surface to present to.
+		if (m_QueueFamilies.presentFamily.has_value())
+		{
+			uniqueQueueFamilies.insert(m_QueueFamilies.presentFamily.value());
+		};
 
 		float queuePriority = 1.0f;
 		for (uint32_t queueFamily : uniqueQueueFamilies)
@@ -53,13 +154,58 @@ namespace VulkanCore
 			queueCreateInfos.push_back(queueCreateInfo);
 		};
 
-		VkPhysicalDeviceFeatures deviceFeatures{};
+		m_Properties = GetDeviceProperties(m_PhysicalDevice);
+		m_ApiVersion = (std::min)(m_Instance->GetApiVersion(), m_Properties.apiVersion);
+
+		FeatureChain supportedFeatures(m_ApiVersion);
+		supportedFeatures.Query(m_PhysicalDevice);
+
+		// Required features were checked when the device was picked.
+		m_EnabledFeatures = FeatureChain(m_ApiVersion);
+		for (DeviceFeature feature : m_DeviceConfig.requiredFeatures)
+		{
+			m_EnabledFeatures.Set(feature, true);
+		};
+
+		for (DeviceFeature feature : m_DeviceConfig.optionalFeatures)
+		{
+			if (supportedFeatures.Get(feature))
+			{
+				m_EnabledFeatures.Set(feature, true);
+			}
+			else
+			{
+				CORE_LOG_INFO("Optional feature {0} not supported.", FeatureChain::GetName(feature));
+			};
+		};
 
 		VkDeviceCreateInfo createInfo{};
 		createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
 		createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
 		createInfo.pQueueCreateInfos = queueCreateInfos.data();
-		createInfo.pEnabledFeatures = &deviceFeatures;
+
+		// Features2 in the chain replaces pEnabledFeatures, it needs 1.1.
+		if (m_ApiVersion >= VK_API_VERSION_1_1)
+		{
+			createInfo.pNext = m_EnabledFeatures.Link();
+		}
+		else
+		{
+			createInfo.pEnabledFeatures = &m_EnabledFeatures.GetCore();
+		};
+
+		std::vector<VkExtensionProperties> optionalExtensions = GetRequiredExtensions(m_PhysicalDevice, m_DeviceConfig.optionalExtensions);
+		for (const char *extension : m_DeviceConfig.optionalExtensions)
+		{
+			for (const auto &optionalExtension : optionalExtensions)
+			{
+				if (std::string_view(optionalExtension.extensionName) == std::string_view(extension))
+				{
+					m_Extensions.push_back(extension);
+					break;
+				};
+			};
+		};
 
 		createInfo.enabledExtensionCount = static_cast<uint32_t>(m_Extensions.size());
 		createInfo.ppEnabledExtensionNames = m_Extensions.data();
@@ -68,68 +214,232 @@ namespace VulkanCore
 
 		CORE_ASSERT(result == VK_SUCCESS, "Failed to create logical device!");
 
+		m_Dispatch.Load(m_Device);
+
 		vkGetDeviceQueue(m_Device, m_QueueFamilies.graphicsFamily.value(), 0, &m_GraphicsQueue);
-		vkGetDeviceQueue(m_Device, m_QueueFamilies.presentFamily.value(), 0, &m_PresentQueue);
+		if (m_QueueFamilies.presentFamily.has_value())
+		{
+			vkGetDeviceQueue(m_Device, m_QueueFamilies.presentFamily.value(), 0, &m_PresentQueue);
+		};
+		vkGetDeviceQueue(m_Device, m_QueueFamilies.computeFamily.value(), 0, &m_ComputeQueue);
+
+		if (HasAsyncCompute())
+		{
+			CORE_LOG_INFO("Async compute queue family: {0}", m_QueueFamilies.computeFamily.value());
+		};
+
+		CORE_LOG_INFO("Device API version {0}.{1}.{2}", VK_API_VERSION_MAJOR(m_ApiVersion), VK_API_VERSION_MINOR(m_ApiVersion), VK_API_VERSION_PATCH(m_ApiVersion));
+		for (uint32_t i = 0; i < static_cast<uint32_t>(DeviceFeature::Count); i++)
+		{
+			if (m_EnabledFeatures.Get(static_cast<DeviceFeature>(i)))
+			{
+				CORE_LOG_INFO("  Enabled feature: {0}", FeatureChain::GetName(static_cast<DeviceFeature>(i)));
+			};
+		};
 	};
 
 	void Device::Destroy()
 	{
+		if (m_Device == VK_NULL_HANDLE)
+		{
+			return;
+		};
+
 		vkDestroyDevice(m_Device, nullptr);
+		m_Device = VK_NULL_HANDLE;
+		m_BufferMemoryTypeBits.clear();
 	};
 
-	bool Device::IsSuitable(VkPhysicalDevice device)
+	uint32_t Device::GetBufferMemoryTypeBits(VkBufferUsageFlags usage) const
+	{
+		std::lock_guard<std::mutex> lock(m_BufferMemoryTypeBitsMutex);
+
+		auto cached = m_BufferMemoryTypeBits.find(usage);
+		if (cached != m_BufferMemoryTypeBits.end())
+		{
+			return cached->second;
+		};
+
+		// The spec makes memoryTypeBits identical for every buffer created with the same usage and flags.
+		VkBufferCreateInfo bufferInfo{};
+		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		bufferInfo.size = 1;
+		bufferInfo.usage = usage;
+		bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		VkBuffer buffer;
+		VkResult result = vkCreateBuffer(m_Device, &bufferInfo, nullptr, &buffer);
+
+		CORE_ASSERT(result == VK_SUCCESS, "Failed to create buffer!");
+
+		VkMemoryRequirements memRequirements;
+		vkGetBufferMemoryRequirements(m_Device, buffer, &memRequirements);
+		vkDestroyBuffer(m_Device, buffer, nullptr);
+
+		m_BufferMemoryTypeBits.emplace(usage, memRequirements.memoryTypeBits);
+
+		return memRequirements.memoryTypeBits;
+	};
+
+	bool Device::IsExtensionEnabled(const char *extensionName) const
+	{
+		for (const char *extension : m_Extensions)
+		{
+			if (std::string_view(extension) == std::string_view(extensionName))
+			{
+				return true;
+			};
+		};
+
+		return false;
+	};
+
+	PhysicalDeviceCandidate Device::EvaluateDevice(VkPhysicalDevice device, uint32_t index)
 	{
 		VkPhysicalDeviceProperties deviceProperties = GetDeviceProperties(device);
 		VkPhysicalDeviceFeatures deviceFeatures = GetDeviceFeatures(device);
 		std::vector<VkQueueFamilyProperties> queueFamilies = GetQueueFamilies(device);
 
-		if (m_DeviceConfig.isDiscrete && deviceProperties.deviceType != VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU)
+		VkPhysicalDeviceMemoryProperties memoryProperties;
+		vkGetPhysicalDeviceMemoryProperties(device, &memoryProperties);
+
+		PhysicalDeviceCandidate candidate;
+		candidate.device = device;
+		candidate.index = index;
+		candidate.name = deviceProperties.deviceName;
+		candidate.type = deviceProperties.deviceType;
+
+		for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++)
+		{
+			if (memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+			{
+				candidate.deviceLocalBytes += memoryProperties.memoryHeaps[i].size;
+			};
+		};
+
+		if (m_DeviceConfig.requireDiscrete && deviceProperties.deviceType != VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU)
 		{
-			return false;
+			candidate.rejection = "not a discrete GPU";
+			return candidate;
 		};
 
+		if (!m_DeviceConfig.allowSoftware && deviceProperties.deviceType == VK_PHYSICAL_DEVICE_TYPE_CPU)
+		{
+			candidate.rejection = "software implementation";
+			return candidate;
+		};
+
+		std::optional<uint32_t> graphicsIndex = GetQueueIndex(queueFamilies, VK_QUEUE_GRAPHICS_BIT);
 		if (m_DeviceConfig.requireGraphicsQueue)
 		{
-			std::optional<uint32_t> graphicsIndex = GetQueueIndex(queueFamilies, VK_QUEUE_GRAPHICS_BIT);
 			if (!graphicsIndex.has_value())
 			{
-				return false;
-			}
+				candidate.rejection = "no graphics queue";
+				return candidate;
+			};
+
+			candidate.queueFamilies.graphicsFamily = graphicsIndex.value();
 
-			m_QueueFamilies.graphicsFamily = graphicsIndex.value();
+			// Work on a compute-only family runs alongside graphics instead of being serialized with it.
+			std::optional<uint32_t> computeIndex = GetDedicatedQueueIndex(queueFamilies, VK_QUEUE_COMPUTE_BIT, VK_QUEUE_GRAPHICS_BIT);
+			candidate.queueFamilies.computeFamily = computeIndex.value_or(graphicsIndex.value());
 		};
 
+		candidate.extensions = m_DeviceConfig.requiredExtensions;
+
 		if (m_DeviceConfig.requirePresentQueue)
 		{
-			std::optional<uint32_t> presentIndex = GetPresentQueueIndex(queueFamilies, device, m_Surface.Get());
+			std::optional<uint32_t> presentIndex = GetPresentQueueIndex(queueFamilies, device, m_Surface->Get());
 			if (!presentIndex.has_value())
 			{
-				return false;
+				candidate.rejection = "cannot present to the surface";
+				return candidate;
 			};
 
-			m_QueueFamilies.presentFamily = presentIndex.value();
+			candidate.queueFamilies.presentFamily = presentIndex.value();
+			candidate.extensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+		};
+
+		std::vector<VkExtensionProperties> extensions = GetRequiredExtensions(device, candidate.extensions);
+		if (extensions.size() != candidate.extensions.size())
+		{
+			candidate.rejection = "missing required extensions";
+			return candidate;
+		};
 
-			// check swapchain support
-			std::vector<const char *> requiredExtensions{VK_KHR_SWAPCHAIN_EXTENSION_NAME};
-			std::vector<VkExtensionProperties> extensions = GetRequiredExtensions(device, requiredExtensions);
-			if (requiredExtensions.size() != extensions.size())
+		FeatureChain supportedFeatures((std::min)(m_Instance->GetApiVersion(), deviceProperties.apiVersion));
+		supportedFeatures.Query(device);
+		for (DeviceFeature feature : m_DeviceConfig.requiredFeatures)
+		{
+			if (!supportedFeatures.Get(feature))
 			{
-				return false;
+				candidate.rejection = std::string("missing feature ") + FeatureChain::GetName(feature);
+				return candidate;
 			};
+		};
 
-			m_Extensions = requiredExtensions;
-
-			SwapChainSupportDetails swapChainDetails = Utils::GetSwapChainDetails(device, m_Surface.Get());
+		if (m_DeviceConfig.requirePresentQueue)
+		{
+			SwapChainSupportDetails swapChainDetails = Utils::GetSwapChainDetails(device, m_Surface->Get());
 			if (swapChainDetails.formats.empty() || swapChainDetails.presentModes.empty())
 			{
-				return false;
+				candidate.rejection = "no swapchain formats or present modes";
+				return candidate;
 			};
 		};
 
-		m_SelectedDeviceName = deviceProperties.deviceName;
+		candidate.suitable = true;
+
+		// Device type dominates: any hardware GPU beats a CPU implementation, a discrete one beats shared memory.
+		switch (deviceProperties.deviceType)
+		{
+		case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+			candidate.score += 10000;
+			break;
+		case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+			candidate.score += 5000;
+			break;
+		case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+			candidate.score += 2000;
+			break;
+		case VK_PHYSICAL_DEVICE_TYPE_CPU:
+			candidate.score += 0;
+			break;
+		default:
+			candidate.score += 1000;
+			break;
+		};
+
+		// Then memory, 100 per GiB, which orders discrete GPUs of one machine roughly by class.
+		candidate.score += static_cast<int64_t>((std::min)(candidate.deviceLocalBytes >> 30, uint64_t(40))) * 100;
+
+		if (deviceProperties.apiVersion >= VK_API_VERSION_1_3)
+		{
+			candidate.score += 200;
+		}
+		else if (deviceProperties.apiVersion >= VK_API_VERSION_1_2)
+		{
+			candidate.score += 100;
+		};
+
+		// Features the renderer enables when present.
+		candidate.score += deviceFeatures.samplerAnisotropy ? 50 : 0;
+		candidate.score += (deviceFeatures.textureCompressionBC || deviceFeatures.textureCompressionASTC_LDR) ? 50 : 0;
+		candidate.score += deviceFeatures.pipelineStatisticsQuery ? 25 : 0;
+		candidate.score += deviceFeatures.occlusionQueryPrecise ? 25 : 0;
+		candidate.score += static_cast<int64_t>(GetRequiredExtensions(device, m_DeviceConfig.optionalExtensions).size()) * 50;
+		for (DeviceFeature feature : m_DeviceConfig.optionalFeatures)
+		{
+			candidate.score += supportedFeatures.Get(feature) ? 50 : 0;
+		};
 
-		return true;
-	}
+		// Queue topology: async compute, and graphics presenting without a cross-family hand-off.
+		candidate.score += candidate.queueFamilies.computeFamily != candidate.queueFamilies.graphicsFamily ? 300 : 0;
+		candidate.score += candidate.queueFamilies.presentFamily.has_value() && candidate.queueFamilies.presentFamily == candidate.queueFamilies.graphicsFamily ? 100 : 0;
+		candidate.score += GetDedicatedQueueIndex(queueFamilies, VK_QUEUE_TRANSFER_BIT, VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT).has_value() ? 100 : 0;
+
+		return candidate;
+	};
 
 	VkPhysicalDeviceProperties Device::GetDeviceProperties(VkPhysicalDevice device)
 	{
@@ -217,4 +527,19 @@ namespace VulkanCore
 		return extensions;
 	};
 
+	std::optional<uint32_t> Device::GetDedicatedQueueIndex(const std::vector<VkQueueFamilyProperties> &queueFamilies, VkQueueFlagBits queueFlag, VkQueueFlags excludedFlags)
+	{
+		int index = 0;
+		for (const auto &queueFamily : queueFamilies)
+		{
+			if ((queueFamily.queueFlags & queueFlag) && !(queueFamily.queueFlags & excludedFlags))
+			{
+				return index;
+			};
+
+			index++;
+		};
+		return {};
+	};
+
 };
\ No newline at end of file
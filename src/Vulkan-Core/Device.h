@@ -2,50 +2,87 @@
 
 #include <vulkan/vulkan.h>
 
+#include <mutex>
+#include <unordered_map>
+
 #include "../Common.h"
 #include "Types.h"
+#include "FeatureChain.h"
+#include "DeviceDispatch.h"
 #include "Instance.h"
 #include "Surface.h"
 
 namespace VulkanCore
 {
+    // Owned by the VulkanContext. Every other VulkanCore object keeps a non-owning pointer to it, so they are
+    // destroyed first, in reverse creation order, and the device must not move once created.
     class Device
     {
     public:
         Device() = default;
-        ~Device() = default;
+        ~Device() { Destroy(); };
+        Device(const Device &) = delete;
+        Device &operator=(const Device &) = delete;
 
 	    void Create(const DeviceConfig &config, const Instance &instance, const Surface &surface);
         void Destroy();
 
-        VkPhysicalDevice GetPhysical() { return m_PhysicalDevice; };
-        VkDevice Get() { return m_Device; };
-        QueueFamilyIndices GetQueueFamilies() { return m_QueueFamilies; };
-        VkQueue GetGraphicsQueue() { return m_GraphicsQueue; };
-        VkQueue GetPresentQueue() { return m_PresentQueue; };
-        const std::string& GetDeviceName() { return m_SelectedDeviceName; };
+        VkPhysicalDevice GetPhysical() const { return m_PhysicalDevice; };
+        VkDevice Get() const { return m_Device; };
+        const QueueFamilyIndices &GetQueueFamilies() const { return m_QueueFamilies; };
+        VkQueue GetGraphicsQueue() const { return m_GraphicsQueue; };
+        VkQueue GetPresentQueue() const { return m_PresentQueue; };
+        VkQueue GetComputeQueue() const { return m_ComputeQueue; };
+        bool HasAsyncCompute() const { return m_QueueFamilies.computeFamily != m_QueueFamilies.graphicsFamily; };
+        const std::string& GetDeviceName() const { return m_SelectedDeviceName; };
+        const VkPhysicalDeviceProperties &GetProperties() const { return m_Properties; };
+        const VkPhysicalDeviceMemoryProperties &GetMemoryProperties() const { return m_MemoryProperties; };
+        const VkPhysicalDeviceFeatures &GetEnabledFeatures() const { return m_EnabledFeatures.GetCore(); };
+        const FeatureChain &GetEnabledFeatureChain() const { return m_EnabledFeatures; };
+        bool IsFeatureEnabled(DeviceFeature feature) const { return m_EnabledFeatures.Get(feature); };
+        // The instance version clamped to the device's, what the device was created against.
+        uint32_t GetApiVersion() const { return m_ApiVersion; };
+        // Direct entry points for the recording and submission paths, bypassing the loader.
+        const DeviceDispatch &GetDispatch() const { return m_Dispatch; };
+        bool IsExtensionEnabled(const char *extensionName) const;
+        // Memory types a buffer of this usage can be bound to, known before the buffer is created. Probed once per
+        // usage with a throwaway buffer, the types do not depend on the buffer's size.
+        uint32_t GetBufferMemoryTypeBits(VkBufferUsageFlags usage) const;
+        const Instance &GetInstance() const { return *m_Instance; };
 
     private:
         void PickPhysical();
-        bool IsSuitable(VkPhysicalDevice device);
+        // Checks the requirements and scores the device, without touching the selection state.
+        PhysicalDeviceCandidate EvaluateDevice(VkPhysicalDevice device, uint32_t index);
+        const PhysicalDeviceCandidate *FindPreferredDevice(const std::vector<PhysicalDeviceCandidate> &candidates);
         VkPhysicalDeviceProperties GetDeviceProperties(VkPhysicalDevice device);
         VkPhysicalDeviceFeatures GetDeviceFeatures(VkPhysicalDevice device);
         std::vector<VkQueueFamilyProperties> GetQueueFamilies(VkPhysicalDevice device);
         std::optional<uint32_t> GetPresentQueueIndex(const std::vector<VkQueueFamilyProperties> &queueFamilies, VkPhysicalDevice device, VkSurfaceKHR surface);
         std::optional<uint32_t> GetQueueIndex(const std::vector<VkQueueFamilyProperties> &queueFamilies, VkQueueFlagBits queueFlag);
+        std::optional<uint32_t> GetDedicatedQueueIndex(const std::vector<VkQueueFamilyProperties> &queueFamilies, VkQueueFlagBits queueFlag, VkQueueFlags excludedFlags);
         std::vector<VkExtensionProperties> GetRequiredExtensions(VkPhysicalDevice device, const std::vector<const char*> &requiredExtensions);
 
     private:
         DeviceConfig m_DeviceConfig;
         VkPhysicalDevice m_PhysicalDevice = VK_NULL_HANDLE;
-        VkDevice m_Device;
+        VkDevice m_Device = VK_NULL_HANDLE;
         VkQueue m_GraphicsQueue;
-        VkQueue m_PresentQueue;
+        VkQueue m_PresentQueue = VK_NULL_HANDLE;
+        VkQueue m_ComputeQueue;
         QueueFamilyIndices m_QueueFamilies;
         std::vector<const char *> m_Extensions;
-        Instance m_Instance;
-        Surface m_Surface;
+        const Instance *m_Instance = nullptr;
+        // Never created when headless.
+        const Surface *m_Surface = nullptr;
         std::string m_SelectedDeviceName;
+        VkPhysicalDeviceProperties m_Properties{};
+        VkPhysicalDeviceMemoryProperties m_MemoryProperties{};
+        uint32_t m_ApiVersion = VK_API_VERSION_1_0;
+        FeatureChain m_EnabledFeatures;
+        DeviceDispatch m_Dispatch;
+        mutable std::mutex m_BufferMemoryTypeBitsMutex;
+        mutable std::unordered_map<VkBufferUsageFlags, uint32_t> m_BufferMemoryTypeBits;
     };
 
 };
\ No newline at end of file
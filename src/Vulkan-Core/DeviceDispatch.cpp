@@ -0,0 +1,23 @@
+#include "DeviceDispatch.h"
+#include "../Log.h"
+
+namespace VulkanCore
+{
+
+    void DeviceDispatch::Load(VkDevice device)
+    {
+#define VKS_LOAD_FUNCTION(name) name = reinterpret_cast<PFN_##name>(vkGetDeviceProcAddr(device, #name));
+#define VKS_LOAD_REQUIRED_FUNCTION(name)                                           \
+    name = reinterpret_cast<PFN_##name>(vkGetDeviceProcAddr(device, #name)); \
+    CORE_ASSERT(name != nullptr, "Failed to load " #name "!");
+
+        VKS_DEVICE_FUNCTIONS(VKS_LOAD_REQUIRED_FUNCTION)
+        VKS_DEVICE_FUNCTIONS_1_2(VKS_LOAD_FUNCTION)
+        VKS_DEVICE_FUNCTIONS_1_3(VKS_LOAD_FUNCTION)
+        VKS_DEVICE_FUNCTIONS_SWAPCHAIN(VKS_LOAD_FUNCTION)
+
+#undef VKS_LOAD_REQUIRED_FUNCTION
+#undef VKS_LOAD_FUNCTION
+    };
+
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "../Common.h"
+
+// Device-level entry points called while recording and submitting frames. The exported loader functions
+// go through a trampoline that looks up the device's dispatch table on every call, pointers fetched with
+// vkGetDeviceProcAddr call straight into the driver (or the first enabled layer).
+#define VKS_DEVICE_FUNCTIONS(X)               \
+    X(vkQueueSubmit)                          \
+    X(vkQueueWaitIdle)                        \
+    X(vkDeviceWaitIdle)                       \
+    X(vkWaitForFences)                        \
+    X(vkResetFences)                          \
+    X(vkGetFenceStatus)                       \
+    X(vkMapMemory)                            \
+    X(vkUnmapMemory)                          \
+    X(vkFlushMappedMemoryRanges)              \
+    X(vkInvalidateMappedMemoryRanges)         \
+    X(vkUpdateDescriptorSets)                 \
+    X(vkGetQueryPoolResults)                  \
+    X(vkBeginCommandBuffer)                   \
+    X(vkEndCommandBuffer)                     \
+    X(vkResetCommandBuffer)                   \
+    X(vkCmdBindPipeline)                      \
+    X(vkCmdSetViewport)                       \
+    X(vkCmdSetScissor)                        \
+    X(vkCmdBindDescriptorSets)                \
+    X(vkCmdBindIndexBuffer)                   \
+    X(vkCmdBindVertexBuffers)                 \
+    X(vkCmdDraw)                              \
+    X(vkCmdDrawIndexed)                       \
+    X(vkCmdDrawIndirect)                      \
+    X(vkCmdDrawIndexedIndirect)               \
+    X(vkCmdDispatch)                          \
+    X(vkCmdDispatchIndirect)                  \
+    X(vkCmdCopyBuffer)                        \
+    X(vkCmdCopyImage)                         \
+    X(vkCmdBlitImage)                         \
+    X(vkCmdCopyBufferToImage)                 \
+    X(vkCmdCopyImageToBuffer)                 \
+    X(vkCmdUpdateBuffer)                      \
+    X(vkCmdFillBuffer)                        \
+    X(vkCmdPipelineBarrier)                   \
+    X(vkCmdBeginQuery)                        \
+    X(vkCmdEndQuery)                          \
+    X(vkCmdResetQueryPool)                    \
+    X(vkCmdWriteTimestamp)                    \
+    X(vkCmdPushConstants)                     \
+    X(vkCmdBeginRenderPass)                   \
+    X(vkCmdNextSubpass)                       \
+    X(vkCmdEndRenderPass)
+
+// Core in 1.2 and 1.3, null when the device was created against an older version.
+#define VKS_DEVICE_FUNCTIONS_1_2(X)           \
+    X(vkCmdDrawIndexedIndirectCount)          \
+    X(vkWaitSemaphores)                       \
+    X(vkSignalSemaphore)                      \
+    X(vkGetSemaphoreCounterValue)             \
+    X(vkGetBufferDeviceAddress)
+
+#define VKS_DEVICE_FUNCTIONS_1_3(X)           \
+    X(vkCmdBeginRendering)                    \
+    X(vkCmdEndRendering)                      \
+    X(vkCmdPipelineBarrier2)                  \
+    X(vkQueueSubmit2)
+
+// Null unless VK_KHR_swapchain is enabled.
+#define VKS_DEVICE_FUNCTIONS_SWAPCHAIN(X)     \
+    X(vkAcquireNextImageKHR)                  \
+    X(vkQueuePresentKHR)
+
+namespace VulkanCore
+{
+    // Per-device function table in the spirit of volk, members are named after the functions they replace.
+    struct DeviceDispatch
+    {
+#define VKS_DECLARE_FUNCTION(name) PFN_##name name = nullptr;
+        VKS_DEVICE_FUNCTIONS(VKS_DECLARE_FUNCTION)
+        VKS_DEVICE_FUNCTIONS_1_2(VKS_DECLARE_FUNCTION)
+        VKS_DEVICE_FUNCTIONS_1_3(VKS_DECLARE_FUNCTION)
+        VKS_DEVICE_FUNCTIONS_SWAPCHAIN(VKS_DECLARE_FUNCTION)
+#undef VKS_DECLARE_FUNCTION
+
+        void Load(VkDevice device);
+    };
+
+};
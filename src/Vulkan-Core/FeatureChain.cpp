@@ -0,0 +1,167 @@
+#include "FeatureChain.h"
+
+#include <cstddef>
+
+namespace VulkanCore
+{
+    namespace
+    {
+        enum class FeatureStruct
+        {
+            Core,
+            Vulkan11,
+            Vulkan12,
+            Vulkan13
+        };
+
+        struct FeatureInfo
+        {
+            DeviceFeature feature;
+            const char *name;
+            FeatureStruct featureStruct;
+            size_t offset;
+        };
+
+#define VKS_FEATURE(feature, featureStruct, type, member) {DeviceFeature::feature, #member, FeatureStruct::featureStruct, offsetof(type, member)}
+
+        // In DeviceFeature order.
+        const FeatureInfo FeatureTable[] = {
+            VKS_FEATURE(TextureCompressionBC, Core, VkPhysicalDeviceFeatures, textureCompressionBC),
+            VKS_FEATURE(TextureCompressionASTC, Core, VkPhysicalDeviceFeatures, textureCompressionASTC_LDR),
+            VKS_FEATURE(SamplerAnisotropy, Core, VkPhysicalDeviceFeatures, samplerAnisotropy),
+            VKS_FEATURE(OcclusionQueryPrecise, Core, VkPhysicalDeviceFeatures, occlusionQueryPrecise),
+            VKS_FEATURE(PipelineStatisticsQuery, Core, VkPhysicalDeviceFeatures, pipelineStatisticsQuery),
+            VKS_FEATURE(MultiDrawIndirect, Core, VkPhysicalDeviceFeatures, multiDrawIndirect),
+            VKS_FEATURE(DrawIndirectFirstInstance, Core, VkPhysicalDeviceFeatures, drawIndirectFirstInstance),
+            VKS_FEATURE(ShaderInt64, Core, VkPhysicalDeviceFeatures, shaderInt64),
+            VKS_FEATURE(ShaderDrawParameters, Vulkan11, VkPhysicalDeviceVulkan11Features, shaderDrawParameters),
+            VKS_FEATURE(DrawIndirectCount, Vulkan12, VkPhysicalDeviceVulkan12Features, drawIndirectCount),
+            VKS_FEATURE(DescriptorIndexing, Vulkan12, VkPhysicalDeviceVulkan12Features, descriptorIndexing),
+            VKS_FEATURE(ShaderSampledImageArrayNonUniformIndexing, Vulkan12, VkPhysicalDeviceVulkan12Features, shaderSampledImageArrayNonUniformIndexing),
+            VKS_FEATURE(DescriptorBindingPartiallyBound, Vulkan12, VkPhysicalDeviceVulkan12Features, descriptorBindingPartiallyBound),
+            VKS_FEATURE(DescriptorBindingVariableDescriptorCount, Vulkan12, VkPhysicalDeviceVulkan12Features, descriptorBindingVariableDescriptorCount),
+            VKS_FEATURE(RuntimeDescriptorArray, Vulkan12, VkPhysicalDeviceVulkan12Features, runtimeDescriptorArray),
+            VKS_FEATURE(ScalarBlockLayout, Vulkan12, VkPhysicalDeviceVulkan12Features, scalarBlockLayout),
+            VKS_FEATURE(HostQueryReset, Vulkan12, VkPhysicalDeviceVulkan12Features, hostQueryReset),
+            VKS_FEATURE(TimelineSemaphore, Vulkan12, VkPhysicalDeviceVulkan12Features, timelineSemaphore),
+            VKS_FEATURE(BufferDeviceAddress, Vulkan12, VkPhysicalDeviceVulkan12Features, bufferDeviceAddress),
+            VKS_FEATURE(Synchronization2, Vulkan13, VkPhysicalDeviceVulkan13Features, synchronization2),
+            VKS_FEATURE(DynamicRendering, Vulkan13, VkPhysicalDeviceVulkan13Features, dynamicRendering),
+            VKS_FEATURE(Maintenance4, Vulkan13, VkPhysicalDeviceVulkan13Features, maintenance4),
+        };
+
+#undef VKS_FEATURE
+
+        static_assert(sizeof(FeatureTable) / sizeof(FeatureTable[0]) == static_cast<size_t>(DeviceFeature::Count), "FeatureTable is missing a DeviceFeature!");
+
+        const FeatureInfo &GetInfo(DeviceFeature feature)
+        {
+            return FeatureTable[static_cast<size_t>(feature)];
+        };
+
+        uint32_t GetRequiredVersion(FeatureStruct featureStruct)
+        {
+            switch (featureStruct)
+            {
+            case FeatureStruct::Vulkan11:
+            case FeatureStruct::Vulkan12:
+                return VK_API_VERSION_1_2;
+            case FeatureStruct::Vulkan13:
+                return VK_API_VERSION_1_3;
+            default:
+                return VK_API_VERSION_1_0;
+            };
+        };
+
+    };
+
+    FeatureChain::FeatureChain(uint32_t apiVersion)
+        : m_ApiVersion(apiVersion)
+    {
+        m_Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        m_Vulkan11Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES;
+        m_Vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        m_Vulkan13Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+    };
+
+    void FeatureChain::Query(VkPhysicalDevice device)
+    {
+        // vkGetPhysicalDeviceFeatures2 is core in 1.1, a 1.0 device only reports the core features.
+        if (m_ApiVersion < VK_API_VERSION_1_1)
+        {
+            vkGetPhysicalDeviceFeatures(device, &m_Features.features);
+            return;
+        };
+
+        vkGetPhysicalDeviceFeatures2(device, const_cast<VkPhysicalDeviceFeatures2 *>(Link()));
+    };
+
+    const VkPhysicalDeviceFeatures2 *FeatureChain::Link()
+    {
+        m_Features.pNext = nullptr;
+        m_Vulkan11Features.pNext = nullptr;
+        m_Vulkan12Features.pNext = nullptr;
+        m_Vulkan13Features.pNext = nullptr;
+
+        if (m_ApiVersion >= VK_API_VERSION_1_2)
+        {
+            m_Features.pNext = &m_Vulkan11Features;
+            m_Vulkan11Features.pNext = &m_Vulkan12Features;
+        };
+
+        if (m_ApiVersion >= VK_API_VERSION_1_3)
+        {
+            m_Vulkan12Features.pNext = &m_Vulkan13Features;
+        };
+
+        return &m_Features;
+    };
+
+    bool FeatureChain::Get(DeviceFeature feature) const
+    {
+        return IsAvailable(feature) && *Find(feature) == VK_TRUE;
+    };
+
+    void FeatureChain::Set(DeviceFeature feature, bool enabled)
+    {
+        if (IsAvailable(feature))
+        {
+            *const_cast<VkBool32 *>(Find(feature)) = enabled ? VK_TRUE : VK_FALSE;
+        };
+    };
+
+    bool FeatureChain::IsAvailable(DeviceFeature feature) const
+    {
+        return m_ApiVersion >= GetRequiredVersion(GetInfo(feature).featureStruct);
+    };
+
+    const char *FeatureChain::GetName(DeviceFeature feature)
+    {
+        return GetInfo(feature).name;
+    };
+
+    const VkBool32 *FeatureChain::Find(DeviceFeature feature) const
+    {
+        const FeatureInfo &info = GetInfo(feature);
+
+        const uint8_t *base = nullptr;
+        switch (info.featureStruct)
+        {
+        case FeatureStruct::Core:
+            base = reinterpret_cast<const uint8_t *>(&m_Features.features);
+            break;
+        case FeatureStruct::Vulkan11:
+            base = reinterpret_cast<const uint8_t *>(&m_Vulkan11Features);
+            break;
+        case FeatureStruct::Vulkan12:
+            base = reinterpret_cast<const uint8_t *>(&m_Vulkan12Features);
+            break;
+        case FeatureStruct::Vulkan13:
+            base = reinterpret_cast<const uint8_t *>(&m_Vulkan13Features);
+            break;
+        };
+
+        return reinterpret_cast<const VkBool32 *>(base + info.offset);
+    };
+
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "../Common.h"
+#include "Types.h"
+
+namespace VulkanCore
+{
+    // VkPhysicalDeviceFeatures2 with the Vulkan 1.1, 1.2 and 1.3 feature structs behind it. Only the structs the API
+    // version knows are chained: 1.1 and 1.2 features need 1.2, dynamic rendering and synchronization2 need 1.3.
+    class FeatureChain
+    {
+    public:
+        explicit FeatureChain(uint32_t apiVersion = VK_API_VERSION_1_0);
+
+        // Fills the chain with what the device supports.
+        void Query(VkPhysicalDevice device);
+        // Chain head for VkDeviceCreateInfo::pNext. Relinked on every call, the chain may have been copied.
+        const VkPhysicalDeviceFeatures2 *Link();
+
+        // False for features the API version cannot express.
+        bool Get(DeviceFeature feature) const;
+        void Set(DeviceFeature feature, bool enabled);
+        bool IsAvailable(DeviceFeature feature) const;
+
+        uint32_t GetApiVersion() const { return m_ApiVersion; };
+        const VkPhysicalDeviceFeatures &GetCore() const { return m_Features.features; };
+
+        static const char *GetName(DeviceFeature feature);
+
+    private:
+        const VkBool32 *Find(DeviceFeature feature) const;
+
+    private:
+        uint32_t m_ApiVersion;
+        VkPhysicalDeviceFeatures2 m_Features{};
+        VkPhysicalDeviceVulkan11Features m_Vulkan11Features{};
+        VkPhysicalDeviceVulkan12Features m_Vulkan12Features{};
+        VkPhysicalDeviceVulkan13Features m_Vulkan13Features{};
+    };
+
+};
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "../Common.h"
+#include "../Log.h"
+
+namespace VulkanCore
+{
+    // 32-bit typed handle: the low bits index a slot, the high bits hold the slot's generation when the handle
+    // was issued. Removing an entry bumps its slot's generation, so handles to it stop resolving instead of
+    // silently aliasing whatever reuses the slot. The zero handle is never issued.
+    template <typename Tag>
+    struct Handle
+    {
+        static constexpr uint32_t INDEX_BITS = 20;
+        static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+        static constexpr uint32_t GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+
+        uint32_t value = 0;
+
+        uint32_t GetIndex() const { return value & INDEX_MASK; };
+        uint32_t GetGeneration() const { return value >> INDEX_BITS; };
+        bool IsNull() const { return value == 0; };
+
+        static Handle Make(uint32_t index, uint32_t generation) { return Handle{(generation << INDEX_BITS) | index}; };
+
+        bool operator==(const Handle &other) const { return value == other.value; };
+        bool operator!=(const Handle &other) const { return value != other.value; };
+    };
+
+    // Slot map: entries are packed densely in insertion order (reordered by removals), slots map handles to
+    // their dense position. Lookup is two array reads, iteration walks only live entries back to back.
+    template <typename Tag, typename T>
+    class HandlePool
+    {
+    public:
+        using HandleType = Handle<Tag>;
+
+        HandleType Add(T value)
+        {
+            uint32_t slotIndex;
+            if (!m_FreeSlots.empty())
+            {
+                slotIndex = m_FreeSlots.back();
+                m_FreeSlots.pop_back();
+            }
+            else
+            {
+                CORE_ASSERT(m_Slots.size() <= HandleType::INDEX_MASK, "Handle pool is full!");
+                slotIndex = static_cast<uint32_t>(m_Slots.size());
+                // Generation 0 is reserved, it would make the first handle of slot 0 the null handle.
+                m_Slots.push_back(Slot{INVALID_INDEX, 1});
+            };
+
+            Slot &slot = m_Slots[slotIndex];
+            slot.denseIndex = static_cast<uint32_t>(m_Dense.size());
+            m_Dense.push_back(std::move(value));
+            m_DenseToSlot.push_back(slotIndex);
+
+            return HandleType::Make(slotIndex, slot.generation);
+        };
+
+        // Moves the entry out and invalidates every handle to it. False for stale or null handles.
+        bool Remove(HandleType handle, T *removed = nullptr)
+        {
+            if (!IsValid(handle))
+            {
+                return false;
+            };
+
+            Slot &slot = m_Slots[handle.GetIndex()];
+            uint32_t denseIndex = slot.denseIndex;
+            uint32_t lastIndex = static_cast<uint32_t>(m_Dense.size() - 1);
+
+            T entry = std::move(m_Dense[denseIndex]);
+            if (removed != nullptr)
+            {
+                *removed = std::move(entry);
+            };
+
+            // The last entry fills the hole so the dense array stays packed.
+            if (denseIndex != lastIndex)
+            {
+                m_Dense[denseIndex] = std::move(m_Dense[lastIndex]);
+                m_DenseToSlot[denseIndex] = m_DenseToSlot[lastIndex];
+                m_Slots[m_DenseToSlot[denseIndex]].denseIndex = denseIndex;
+            };
+
+            m_Dense.pop_back();
+            m_DenseToSlot.pop_back();
+            Retire(handle.GetIndex());
+
+            return true;
+        };
+
+        bool IsValid(HandleType handle) const
+        {
+            uint32_t index = handle.GetIndex();
+            return !handle.IsNull() && index < m_Slots.size() && m_Slots[index].generation == handle.GetGeneration() && m_Slots[index].denseIndex != INVALID_INDEX;
+        };
+
+        // Null for stale handles. The pointer is invalidated by the next Add or Remove.
+        T *Get(HandleType handle) { return IsValid(handle) ? &m_Dense[m_Slots[handle.GetIndex()].denseIndex] : nullptr; };
+        const T *Get(HandleType handle) const { return IsValid(handle) ? &m_Dense[m_Slots[handle.GetIndex()].denseIndex] : nullptr; };
+
+        // Invalidates every handle, the slots are kept for reuse.
+        void Clear()
+        {
+            for (uint32_t slotIndex : m_DenseToSlot)
+            {
+                Retire(slotIndex);
+            };
+
+            m_Dense.clear();
+            m_DenseToSlot.clear();
+        };
+
+        size_t Size() const { return m_Dense.size(); };
+        bool Empty() const { return m_Dense.empty(); };
+
+        // Live entries, densely packed and in no particular order.
+        std::vector<T> &GetEntries() { return m_Dense; };
+        const std::vector<T> &GetEntries() const { return m_Dense; };
+
+    private:
+        static constexpr uint32_t INVALID_INDEX = ~0u;
+
+        struct Slot
+        {
+            uint32_t denseIndex;
+            uint32_t generation;
+        };
+
+        void Retire(uint32_t slotIndex)
+        {
+            Slot &slot = m_Slots[slotIndex];
+            slot.denseIndex = INVALID_INDEX;
+            // Wraps after 4095 reuses of one slot, skipping the reserved generation 0.
+            slot.generation = (slot.generation + 1) & HandleType::GENERATION_MASK;
+            if (slot.generation == 0)
+            {
+                slot.generation = 1;
+            };
+
+            m_FreeSlots.push_back(slotIndex);
+        };
+
+        std::vector<T> m_Dense;
+        std::vector<uint32_t> m_DenseToSlot;
+        std::vector<Slot> m_Slots;
+        std::vector<uint32_t> m_FreeSlots;
+    };
+
+};
@@ -0,0 +1,183 @@
+#include "Image.h"
+#include "Utils.h"
+#include "../Log.h"
+
+#include <utility>
+
+namespace VulkanCore
+{
+
+    void Image::Create(const ImageConfig &config, const Device &device)
+    {
+        m_Config = config;
+        m_DeviceInst = &device;
+
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.extent.width = m_Config.width;
+        imageInfo.extent.height = m_Config.height;
+        imageInfo.extent.depth = 1;
+        imageInfo.mipLevels = m_Config.mipLevels;
+        imageInfo.arrayLayers = 1;
+        imageInfo.format = m_Config.format;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageInfo.usage = m_Config.usage;
+        imageInfo.samples = m_Config.samples;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        VkResult result = vkCreateImage(m_DeviceInst->Get(), &imageInfo, nullptr, &m_Image);
+
+        CORE_ASSERT(result == VK_SUCCESS, "Failed to create image!");
+
+        VkMemoryRequirements memRequirements;
+        vkGetImageMemoryRequirements(m_DeviceInst->Get(), m_Image, &memRequirements);
+
+        std::optional<uint32_t> memoryTypeIndex = Utils::FindMemoryType(m_DeviceInst->GetMemoryProperties(), memRequirements.memoryTypeBits, m_Config.memoryProperties);
+        if (!memoryTypeIndex.has_value() && m_Config.fallbackMemoryProperties != 0)
+        {
+            memoryTypeIndex = Utils::FindMemoryType(m_DeviceInst->GetMemoryProperties(), memRequirements.memoryTypeBits, m_Config.fallbackMemoryProperties);
+        };
+
+        CORE_ASSERT(memoryTypeIndex.has_value(), "Failed to get memory type index!");
+
+        VkMemoryAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = memRequirements.size;
+        allocInfo.memoryTypeIndex = memoryTypeIndex.value();
+
+        result = vkAllocateMemory(m_DeviceInst->Get(), &allocInfo, nullptr, &m_ImageMemory);
+
+        CORE_ASSERT(result == VK_SUCCESS, "Failed to allocate image memory!");
+
+        vkBindImageMemory(m_DeviceInst->Get(), m_Image, m_ImageMemory, 0);
+        m_MemorySize = memRequirements.size;
+
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = m_Image;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = m_Config.format;
+        viewInfo.subresourceRange.aspectMask = m_Config.aspect;
+        viewInfo.subresourceRange.baseMipLevel = 0;
+        viewInfo.subresourceRange.levelCount = m_Config.mipLevels;
+        viewInfo.subresourceRange.baseArrayLayer = 0;
+        viewInfo.subresourceRange.layerCount = 1;
+
+        result = vkCreateImageView(m_DeviceInst->Get(), &viewInfo, nullptr, &m_ImageView);
+
+        CORE_ASSERT(result == VK_SUCCESS, "Failed to create image view!");
+    };
+
+    Image::Image(Image &&other) noexcept
+        : m_Config(other.m_Config),
+          m_DeviceInst(other.m_DeviceInst),
+          m_Image(std::exchange(other.m_Image, VK_NULL_HANDLE)),
+          m_ImageView(std::exchange(other.m_ImageView, VK_NULL_HANDLE)),
+          m_ImageMemory(std::exchange(other.m_ImageMemory, VK_NULL_HANDLE)),
+          m_MemorySize(std::exchange(other.m_MemorySize, 0))
+    {
+    };
+
+    Image &Image::operator=(Image &&other) noexcept
+    {
+        if (this != &other)
+        {
+            // The image being replaced is released first, as the destructor would.
+            Destroy();
+
+            m_Config = other.m_Config;
+            m_DeviceInst = other.m_DeviceInst;
+            m_Image = std::exchange(other.m_Image, VK_NULL_HANDLE);
+            m_ImageView = std::exchange(other.m_ImageView, VK_NULL_HANDLE);
+            m_ImageMemory = std::exchange(other.m_ImageMemory, VK_NULL_HANDLE);
+            m_MemorySize = std::exchange(other.m_MemorySize, 0);
+        };
+
+        return *this;
+    };
+
+    void Image::Destroy()
+    {
+        if (m_Image == VK_NULL_HANDLE)
+        {
+            return;
+        };
+
+        vkDestroyImageView(m_DeviceInst->Get(), m_ImageView, nullptr);
+        vkDestroyImage(m_DeviceInst->Get(), m_Image, nullptr);
+        vkFreeMemory(m_DeviceInst->Get(), m_ImageMemory, nullptr);
+
+        m_ImageView = VK_NULL_HANDLE;
+        m_Image = VK_NULL_HANDLE;
+        m_ImageMemory = VK_NULL_HANDLE;
+    };
+
+    void Image::TransitionLayout(VkCommandBuffer commandBuffer, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t baseMipLevel, uint32_t levelCount)
+    {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = m_Image;
+        barrier.subresourceRange.aspectMask = m_Config.aspect;
+        barrier.subresourceRange.baseMipLevel = baseMipLevel;
+        barrier.subresourceRange.levelCount = levelCount;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = 1;
+
+        VkPipelineStageFlags srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        VkPipelineStageFlags dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+        switch (oldLayout)
+        {
+        case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+            break;
+
+        case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+            break;
+
+        case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+            barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            srcStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+            break;
+
+        default:
+            barrier.srcAccessMask = 0;
+            break;
+        };
+
+        switch (newLayout)
+        {
+        case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+            break;
+
+        case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+            break;
+
+        case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+            break;
+
+        default:
+            barrier.dstAccessMask = 0;
+            dstStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+            break;
+        };
+
+        m_DeviceInst->GetDispatch().vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    };
+
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "../Common.h"
+#include "Types.h"
+#include "Device.h"
+
+namespace VulkanCore
+{
+    class Image
+    {
+    public:
+        Image() = default;
+        ~Image() { Destroy(); };
+        // Moving transfers ownership, the source is left empty.
+        Image(const Image &) = delete;
+        Image &operator=(const Image &) = delete;
+        Image(Image &&other) noexcept;
+        Image &operator=(Image &&other) noexcept;
+
+        void Create(const ImageConfig &config, const Device &device);
+        void Destroy();
+
+        void TransitionLayout(VkCommandBuffer commandBuffer, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t baseMipLevel, uint32_t levelCount);
+
+        VkImage Get() const { return m_Image; };
+        VkImageView GetView() const { return m_ImageView; };
+        VkDeviceMemory GetMemory() const { return m_ImageMemory; };
+        VkFormat GetFormat() const { return m_Config.format; };
+        VkExtent2D GetExtent() const { return {m_Config.width, m_Config.height}; };
+        uint32_t GetMipLevels() const { return m_Config.mipLevels; };
+        VkDeviceSize GetSize() const { return m_MemorySize; };
+
+    private:
+        ImageConfig m_Config;
+        const Device *m_DeviceInst = nullptr;
+
+        VkImage m_Image = VK_NULL_HANDLE;
+        VkImageView m_ImageView = VK_NULL_HANDLE;
+        VkDeviceMemory m_ImageMemory = VK_NULL_HANDLE;
+        VkDeviceSize m_MemorySize = 0;
+    };
+
+};
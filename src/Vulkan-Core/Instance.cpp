@@ -17,13 +17,23 @@ namespace VulkanCore
             m_ValidationLayerEnabled = true;
         };
 
+        // Requesting more than the loader supports fails on 1.0 loaders, the device version is clamped again later.
+        uint32_t loaderVersion = VK_API_VERSION_1_0;
+        vkEnumerateInstanceVersion(&loaderVersion);
+        m_ApiVersion = (std::min)(m_InstanceConfigData.apiVersion, loaderVersion);
+
+        if (m_ApiVersion < m_InstanceConfigData.apiVersion)
+        {
+            CORE_LOG_WARN("Vulkan {0}.{1} requested, the loader supports {2}.{3}.", VK_API_VERSION_MAJOR(m_InstanceConfigData.apiVersion), VK_API_VERSION_MINOR(m_InstanceConfigData.apiVersion), VK_API_VERSION_MAJOR(m_ApiVersion), VK_API_VERSION_MINOR(m_ApiVersion));
+        };
+
         VkApplicationInfo appInfo{};
         appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
         appInfo.pApplicationName = m_InstanceConfigData.appName;
         appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
         appInfo.pEngineName = "No Engine";
         appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-        appInfo.apiVersion = VK_API_VERSION_1_0;
+        appInfo.apiVersion = m_ApiVersion;
 
         VkInstanceCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -68,20 +78,32 @@ namespace VulkanCore
 
     void Instance::Destroy()
     {
+        if (m_Instance == VK_NULL_HANDLE)
+        {
+            return;
+        };
+
         if (m_ValidationLayerEnabled && m_DebugMessenger)
         {
             DestroyDebugUtilsMessengerEXT(m_Instance, m_DebugMessenger, nullptr);
+            m_DebugMessenger = VK_NULL_HANDLE;
         };
         vkDestroyInstance(m_Instance, nullptr);
+        m_Instance = VK_NULL_HANDLE;
     };
 
     std::vector<const char *> Instance::GetRequiredExtensions()
     {
-        uint32_t glfwExtensionCount = 0;
-        const char **glfwExtensions;
-        glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+        std::vector<const char *> extensions;
 
-        std::vector<const char *> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        if (!m_InstanceConfigData.headless)
+        {
+            uint32_t glfwExtensionCount = 0;
+            const char **glfwExtensions;
+            glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+
+            extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        };
 
         if (m_InstanceConfigData.enableValidation)
         {
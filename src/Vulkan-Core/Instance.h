@@ -12,12 +12,16 @@ namespace VulkanCore
     {
     public:
         Instance() = default;
-        ~Instance() = default;
+        ~Instance() { Destroy(); };
+        Instance(const Instance &) = delete;
+        Instance &operator=(const Instance &) = delete;
 
         void Create(const InstanceConfig &config);
         void Destroy();
 
-        VkInstance Get() { return m_Instance; };
+        VkInstance Get() const { return m_Instance; };
+        // The requested version clamped to what the loader supports.
+        uint32_t GetApiVersion() const { return m_ApiVersion; };
 
     private:
         bool CheckValidationLayerSupport();
@@ -27,9 +31,10 @@ namespace VulkanCore
         void DestroyDebugUtilsMessengerEXT(VkInstance instance, VkDebugUtilsMessengerEXT debugMessenger, const VkAllocationCallbacks *pAllocator);
 
     private:
-        VkInstance m_Instance;
-        VkDebugUtilsMessengerEXT m_DebugMessenger;
+        VkInstance m_Instance = VK_NULL_HANDLE;
+        VkDebugUtilsMessengerEXT m_DebugMessenger = VK_NULL_HANDLE;
         InstanceConfig m_InstanceConfigData;
+        uint32_t m_ApiVersion = VK_API_VERSION_1_0;
         bool m_ValidationLayerEnabled = false;
         std::vector<const char *> validationLayers = {"VK_LAYER_KHRONOS_validation"};
     };
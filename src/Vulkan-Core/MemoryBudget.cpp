@@ -0,0 +1,93 @@
+#include "MemoryBudget.h"
+#include "Utils.h"
+#include "../Log.h"
+
+namespace VulkanCore
+{
+
+    void MemoryBudget::Create(const Device &device)
+    {
+        m_DeviceInst = &device;
+
+        // The budget query goes through vkGetPhysicalDeviceMemoryProperties2, core since 1.1.
+        m_Tracked = device.IsExtensionEnabled(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) && device.GetApiVersion() >= VK_API_VERSION_1_1;
+
+        const VkPhysicalDeviceMemoryProperties &memoryProperties = device.GetMemoryProperties();
+
+        m_Heaps.resize(memoryProperties.memoryHeapCount);
+        m_OverBudget.assign(memoryProperties.memoryHeapCount, false);
+
+        for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++)
+        {
+            m_Heaps[i].size = memoryProperties.memoryHeaps[i].size;
+            m_Heaps[i].budget = memoryProperties.memoryHeaps[i].size / 5 * 4;
+            m_Heaps[i].deviceLocal = (memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+        };
+
+        std::optional<uint32_t> memoryType = Utils::FindMemoryType(memoryProperties, ~0u, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        m_PrimaryHeap = memoryType.has_value() ? memoryProperties.memoryTypes[memoryType.value()].heapIndex : 0;
+
+        if (!m_Tracked)
+        {
+            CORE_LOG_INFO("VK_EXT_memory_budget not available, memory usage is not tracked.");
+        };
+
+        Update();
+        LogHeaps();
+    };
+
+    void MemoryBudget::Destroy()
+    {
+        m_Heaps.clear();
+        m_OverBudget.clear();
+        m_Tracked = false;
+    };
+
+    void MemoryBudget::Update()
+    {
+        if (!m_Tracked)
+        {
+            return;
+        };
+
+        VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties{};
+        budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+        VkPhysicalDeviceMemoryProperties2 memoryProperties{};
+        memoryProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+        memoryProperties.pNext = &budgetProperties;
+
+        vkGetPhysicalDeviceMemoryProperties2(m_DeviceInst->GetPhysical(), &memoryProperties);
+
+        for (uint32_t i = 0; i < static_cast<uint32_t>(m_Heaps.size()); i++)
+        {
+            HeapBudget &heap = m_Heaps[i];
+            heap.budget = budgetProperties.heapBudget[i];
+            heap.usage = budgetProperties.heapUsage[i];
+
+            bool overBudget = heap.usage > heap.budget;
+            if (overBudget && !m_OverBudget[i])
+            {
+                CORE_LOG_WARN("Memory heap {0} over budget: {1} MiB used of {2} MiB", i, heap.usage >> 20, heap.budget >> 20);
+            };
+
+            m_OverBudget[i] = overBudget;
+        };
+    };
+
+    float MemoryBudget::GetPressure() const
+    {
+        const HeapBudget &heap = GetPrimaryHeap();
+        return heap.budget > 0 ? static_cast<float>(static_cast<double>(heap.usage) / static_cast<double>(heap.budget)) : 0.0f;
+    };
+
+    void MemoryBudget::LogHeaps() const
+    {
+        for (uint32_t i = 0; i < static_cast<uint32_t>(m_Heaps.size()); i++)
+        {
+            const HeapBudget &heap = m_Heaps[i];
+            CORE_LOG_INFO("Memory heap {0}{1}: {2} MiB, budget {3} MiB, used {4} MiB", i, heap.deviceLocal ? " (device local)" : "", heap.size >> 20, heap.budget >> 20, heap.usage >> 20);
+        };
+    };
+
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "../Common.h"
+#include "Types.h"
+#include "Device.h"
+
+namespace VulkanCore
+{
+    // Per-heap usage against budget, polled from VK_EXT_memory_budget once per frame. Without the extension only the
+    // heap sizes are known, usage stays zero and nothing downstream throttles.
+    class MemoryBudget
+    {
+    public:
+        MemoryBudget() = default;
+        ~MemoryBudget() { Destroy(); };
+        MemoryBudget(const MemoryBudget &) = delete;
+        MemoryBudget &operator=(const MemoryBudget &) = delete;
+
+        void Create(const Device &device);
+        void Destroy();
+
+        // Drivers refresh the numbers at most once per frame, polling more often only costs time.
+        void Update();
+
+        bool IsTracked() const { return m_Tracked; };
+        const std::vector<HeapBudget> &GetHeaps() const { return m_Heaps; };
+        // The heap backing the first device local memory type, where images and device local buffers are placed.
+        const HeapBudget &GetPrimaryHeap() const { return m_Heaps[m_PrimaryHeap]; };
+        // Usage over budget of the primary heap, zero when not tracked.
+        float GetPressure() const;
+        void LogHeaps() const;
+
+    private:
+        const Device *m_DeviceInst = nullptr;
+        bool m_Tracked = false;
+        std::vector<HeapBudget> m_Heaps;
+        uint32_t m_PrimaryHeap = 0;
+        // Heaps that were over budget at the last update, warnings are only logged when a heap crosses it.
+        std::vector<bool> m_OverBudget;
+    };
+
+};
@@ -0,0 +1,157 @@
+#include "ResourcePool.h"
+#include "Utils.h"
+#include "../Log.h"
+
+namespace VulkanCore
+{
+
+    void ResourcePool::Create(const Device &device)
+    {
+        m_DeviceInst = &device;
+    };
+
+    void ResourcePool::Destroy()
+    {
+        for (BufferResource &buffer : m_Buffers.GetEntries())
+        {
+            vkDestroyBuffer(m_DeviceInst->Get(), buffer.buffer, nullptr);
+            vkFreeMemory(m_DeviceInst->Get(), buffer.memory, nullptr);
+        };
+
+        for (Image &image : m_Images.GetEntries())
+        {
+            image.Destroy();
+        };
+
+        for (PipelineResource &pipeline : m_Pipelines.GetEntries())
+        {
+            vkDestroyPipeline(m_DeviceInst->Get(), pipeline.pipeline, nullptr);
+        };
+
+        m_Buffers.Clear();
+        m_Images.Clear();
+        m_Pipelines.Clear();
+        m_Samplers.Clear();
+    };
+
+    BufferHandle ResourcePool::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties)
+    {
+        BufferResource buffer;
+        buffer.size = size;
+        buffer.usage = usage;
+        buffer.properties = properties;
+
+        Utils::CreateBuffer(m_DeviceInst->Get(), m_DeviceInst->GetMemoryProperties(), size, usage, properties, buffer.buffer, buffer.memory);
+
+        return m_Buffers.Add(buffer);
+    };
+
+    BufferHandle ResourcePool::UploadBuffer(const char *name, const void *data, VkDeviceSize size, VkBufferUsageFlags usage, VkCommandPool commandPool)
+    {
+        uint32_t memoryTypeBits = m_DeviceInst->GetBufferMemoryTypeBits(usage);
+        UploadStrategy strategy = Utils::ChooseUploadStrategy(m_DeviceInst->GetMemoryProperties(), memoryTypeBits, size);
+
+        BufferHandle handle;
+        void *mapped = nullptr;
+
+        if (strategy == UploadStrategy::DirectWrite)
+        {
+            handle = CreateBuffer(size, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+            const BufferResource *buffer = m_Buffers.Get(handle);
+            vkMapMemory(m_DeviceInst->Get(), buffer->memory, 0, size, 0, &mapped);
+            memcpy(mapped, data, static_cast<size_t>(size));
+            vkUnmapMemory(m_DeviceInst->Get(), buffer->memory);
+        }
+        else
+        {
+            VkBuffer stagingBuffer;
+            VkDeviceMemory stagingBufferMemory;
+            Utils::CreateBuffer(m_DeviceInst->Get(), m_DeviceInst->GetMemoryProperties(), size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
+
+            vkMapMemory(m_DeviceInst->Get(), stagingBufferMemory, 0, size, 0, &mapped);
+            memcpy(mapped, data, static_cast<size_t>(size));
+            vkUnmapMemory(m_DeviceInst->Get(), stagingBufferMemory);
+
+            handle = CreateBuffer(size, usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+            VkCommandBuffer commandBuffer = Utils::BeginSingleTimeCommands(m_DeviceInst->Get(), commandPool);
+
+            VkBufferCopy copyRegion{};
+            copyRegion.size = size;
+            m_DeviceInst->GetDispatch().vkCmdCopyBuffer(commandBuffer, stagingBuffer, m_Buffers.Get(handle)->buffer, 1, &copyRegion);
+
+            Utils::EndSingleTimeCommands(m_DeviceInst->Get(), commandPool, m_DeviceInst->GetGraphicsQueue(), commandBuffer);
+
+            vkDestroyBuffer(m_DeviceInst->Get(), stagingBuffer, nullptr);
+            vkFreeMemory(m_DeviceInst->Get(), stagingBufferMemory, nullptr);
+        };
+
+        m_Buffers.Get(handle)->upload = strategy;
+
+        CORE_LOG_INFO("Uploaded {} ({} bytes) by {}", name, size, Utils::GetUploadStrategyName(strategy));
+
+        return handle;
+    };
+
+    void ResourcePool::DestroyBuffer(BufferHandle handle)
+    {
+        BufferResource buffer;
+        if (m_Buffers.Remove(handle, &buffer))
+        {
+            vkDestroyBuffer(m_DeviceInst->Get(), buffer.buffer, nullptr);
+            vkFreeMemory(m_DeviceInst->Get(), buffer.memory, nullptr);
+        };
+    };
+
+    ImageHandle ResourcePool::AddImage(Image &&image)
+    {
+        return m_Images.Add(std::move(image));
+    };
+
+    void ResourcePool::DestroyImage(ImageHandle handle)
+    {
+        Image image;
+        if (m_Images.Remove(handle, &image))
+        {
+            image.Destroy();
+        };
+    };
+
+    PipelineHandle ResourcePool::AddPipeline(VkPipeline pipeline, VkPipelineLayout layout, VkPipelineBindPoint bindPoint)
+    {
+        return m_Pipelines.Add(PipelineResource{pipeline, layout, bindPoint});
+    };
+
+    void ResourcePool::DestroyPipeline(PipelineHandle handle)
+    {
+        PipelineResource pipeline;
+        if (m_Pipelines.Remove(handle, &pipeline))
+        {
+            vkDestroyPipeline(m_DeviceInst->Get(), pipeline.pipeline, nullptr);
+        };
+    };
+
+    SamplerHandle ResourcePool::AddSampler(VkSampler sampler)
+    {
+        return m_Samplers.Add(SamplerResource{sampler});
+    };
+
+    VkSampler ResourcePool::GetSampler(SamplerHandle handle) const
+    {
+        const SamplerResource *sampler = m_Samplers.Get(handle);
+        return sampler != nullptr ? sampler->sampler : VK_NULL_HANDLE;
+    };
+
+    VkDeviceSize ResourcePool::GetBufferMemorySize() const
+    {
+        VkDeviceSize size = 0;
+        for (const BufferResource &buffer : m_Buffers.GetEntries())
+        {
+            size += buffer.size;
+        };
+
+        return size;
+    };
+
+};
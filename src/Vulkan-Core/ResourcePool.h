@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "../Common.h"
+#include "Types.h"
+#include "Device.h"
+#include "Image.h"
+#include "HandlePool.h"
+
+namespace VulkanCore
+{
+    // Owns buffers, images and pipelines behind generational handles, so draw packets and passes can carry 32-bit
+    // handles instead of raw Vulkan objects. A stale handle resolves to null rather than to a recycled object.
+    // Samplers stay owned by the SamplerCache, the pool only hands out handles to them.
+    class ResourcePool
+    {
+    public:
+        ResourcePool() = default;
+        ~ResourcePool() { Destroy(); };
+        ResourcePool(const ResourcePool &) = delete;
+        ResourcePool &operator=(const ResourcePool &) = delete;
+
+        void Create(const Device &device);
+        // Destroys every resource still in the pool, the device must be idle.
+        void Destroy();
+
+        BufferHandle CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties);
+        // Device local buffer holding data, written in place when Utils::ChooseUploadStrategy allows it and through a
+        // staging copy on the graphics queue otherwise. The strategy is logged under name and kept on the resource.
+        BufferHandle UploadBuffer(const char *name, const void *data, VkDeviceSize size, VkBufferUsageFlags usage, VkCommandPool commandPool);
+        void DestroyBuffer(BufferHandle handle);
+        const BufferResource *GetBuffer(BufferHandle handle) const { return m_Buffers.Get(handle); };
+
+        ImageHandle AddImage(Image &&image);
+        void DestroyImage(ImageHandle handle);
+        Image *GetImage(ImageHandle handle) { return m_Images.Get(handle); };
+
+        // Takes ownership of the pipeline, not of its layout.
+        PipelineHandle AddPipeline(VkPipeline pipeline, VkPipelineLayout layout, VkPipelineBindPoint bindPoint);
+        void DestroyPipeline(PipelineHandle handle);
+        const PipelineResource *GetPipeline(PipelineHandle handle) const { return m_Pipelines.Get(handle); };
+
+        SamplerHandle AddSampler(VkSampler sampler);
+        VkSampler GetSampler(SamplerHandle handle) const;
+
+        // Walks the packed buffer records only.
+        VkDeviceSize GetBufferMemorySize() const;
+        size_t GetBufferCount() const { return m_Buffers.Size(); };
+        size_t GetImageCount() const { return m_Images.Size(); };
+        size_t GetPipelineCount() const { return m_Pipelines.Size(); };
+
+    private:
+        const Device *m_DeviceInst = nullptr;
+
+        HandlePool<BufferResource, BufferResource> m_Buffers;
+        HandlePool<Image, Image> m_Images;
+        HandlePool<PipelineResource, PipelineResource> m_Pipelines;
+        HandlePool<SamplerResource, SamplerResource> m_Samplers;
+    };
+
+};
@@ -0,0 +1,76 @@
+#include "SamplerCache.h"
+#include "../Log.h"
+
+namespace VulkanCore
+{
+
+    size_t SamplerConfigHash::operator()(const SamplerConfig &config) const
+    {
+        size_t seed = 0;
+        auto combine = [&seed](size_t value)
+        { seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2); };
+
+        combine(std::hash<int>()(config.magFilter));
+        combine(std::hash<int>()(config.minFilter));
+        combine(std::hash<int>()(config.mipmapMode));
+        combine(std::hash<int>()(config.addressMode));
+        combine(std::hash<float>()(config.maxAnisotropy));
+        combine(std::hash<float>()(config.minLod));
+        combine(std::hash<float>()(config.maxLod));
+
+        return seed;
+    };
+
+    void SamplerCache::Create(const Device &device)
+    {
+        m_DeviceInst = &device;
+    };
+
+    void SamplerCache::Destroy()
+    {
+        for (auto &[config, sampler] : m_Samplers)
+        {
+            vkDestroySampler(m_DeviceInst->Get(), sampler, nullptr);
+        };
+
+        m_Samplers.clear();
+    };
+
+    VkSampler SamplerCache::Get(const SamplerConfig &config)
+    {
+        auto it = m_Samplers.find(config);
+        if (it != m_Samplers.end())
+        {
+            return it->second;
+        };
+
+        bool anisotropyEnabled = m_DeviceInst->GetEnabledFeatures().samplerAnisotropy && config.maxAnisotropy > 1.0f;
+
+        VkSamplerCreateInfo samplerInfo{};
+        samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        samplerInfo.magFilter = config.magFilter;
+        samplerInfo.minFilter = config.minFilter;
+        samplerInfo.mipmapMode = config.mipmapMode;
+        samplerInfo.addressModeU = config.addressMode;
+        samplerInfo.addressModeV = config.addressMode;
+        samplerInfo.addressModeW = config.addressMode;
+        samplerInfo.anisotropyEnable = anisotropyEnabled ? VK_TRUE : VK_FALSE;
+        samplerInfo.maxAnisotropy = anisotropyEnabled ? (std::min)(config.maxAnisotropy, m_DeviceInst->GetProperties().limits.maxSamplerAnisotropy) : 1.0f;
+        samplerInfo.compareEnable = VK_FALSE;
+        samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+        samplerInfo.minLod = config.minLod;
+        samplerInfo.maxLod = config.maxLod;
+        samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+        samplerInfo.unnormalizedCoordinates = VK_FALSE;
+
+        VkSampler sampler;
+        VkResult result = vkCreateSampler(m_DeviceInst->Get(), &samplerInfo, nullptr, &sampler);
+
+        CORE_ASSERT(result == VK_SUCCESS, "Failed to create sampler!");
+
+        m_Samplers.emplace(config, sampler);
+
+        return sampler;
+    };
+
+};
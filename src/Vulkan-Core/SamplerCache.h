@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <unordered_map>
+
+#include "../Common.h"
+#include "Types.h"
+#include "Device.h"
+
+namespace VulkanCore
+{
+    struct SamplerConfigHash
+    {
+        size_t operator()(const SamplerConfig &config) const;
+    };
+
+    // Samplers are few and immutable, so identical configs share a single VkSampler.
+    class SamplerCache
+    {
+    public:
+        SamplerCache() = default;
+        ~SamplerCache() { Destroy(); };
+        SamplerCache(const SamplerCache &) = delete;
+        SamplerCache &operator=(const SamplerCache &) = delete;
+
+        void Create(const Device &device);
+        void Destroy();
+
+        VkSampler Get(const SamplerConfig &config);
+        size_t GetCount() { return m_Samplers.size(); };
+
+    private:
+        const Device *m_DeviceInst = nullptr;
+        std::unordered_map<SamplerConfig, VkSampler, SamplerConfigHash> m_Samplers;
+    };
+
+};
@@ -6,7 +6,7 @@ namespace VulkanCore
 {
     void ShaderModule::Create(const Device &device, const std::string &path)
     {
-        m_DeviceInst = device;
+        m_DeviceInst = &device;
 
         auto code = ReadFile(path);
 
@@ -15,13 +15,17 @@ namespace VulkanCore
         createInfo.codeSize = code.size();
         createInfo.pCode = reinterpret_cast<const uint32_t *>(code.data());
 
-        VkResult result = vkCreateShaderModule(m_DeviceInst.Get(), &createInfo, nullptr, &m_ShaderModule);
+        VkResult result = vkCreateShaderModule(m_DeviceInst->Get(), &createInfo, nullptr, &m_ShaderModule);
 
         CORE_ASSERT(result == VK_SUCCESS, "Failed to create shader module!");
     };
 
     void ShaderModule::Destroy()
     {
-        vkDestroyShaderModule(m_DeviceInst.Get(), m_ShaderModule, nullptr);
+        if (m_ShaderModule != VK_NULL_HANDLE)
+        {
+            vkDestroyShaderModule(m_DeviceInst->Get(), m_ShaderModule, nullptr);
+            m_ShaderModule = VK_NULL_HANDLE;
+        };
     };
 };
\ No newline at end of file
@@ -11,7 +11,9 @@ namespace VulkanCore
     {
     public:
         ShaderModule() = default;
-        ~ShaderModule() = default;
+        ~ShaderModule() { Destroy(); };
+        ShaderModule(const ShaderModule &) = delete;
+        ShaderModule &operator=(const ShaderModule &) = delete;
 
         void Create(const Device &device, const std::string &path);
         void Destroy();
@@ -19,8 +21,8 @@ namespace VulkanCore
         VkShaderModule Get() { return m_ShaderModule; };
 
     private:
-        VkShaderModule m_ShaderModule;
-        Device m_DeviceInst;
+        VkShaderModule m_ShaderModule = VK_NULL_HANDLE;
+        const Device *m_DeviceInst = nullptr;
     };
 
 };
\ No newline at end of file
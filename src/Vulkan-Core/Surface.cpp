@@ -8,18 +8,24 @@ namespace VulkanCore
 
     void Surface::Create(const Instance &instance, void *window)
     {
-        m_Instance = instance;
+        m_Instance = &instance;
         m_WindowHandle = window;
         GLFWwindow *win = static_cast<GLFWwindow *>(m_WindowHandle);
 
-        VkResult result = glfwCreateWindowSurface(m_Instance.Get(), win, nullptr, &m_Surface);
+        VkResult result = glfwCreateWindowSurface(m_Instance->Get(), win, nullptr, &m_Surface);
 
         CORE_ASSERT(result == VK_SUCCESS, "Failed to create window surface!");
     };
 
     void Surface::Destroy()
     {
-        vkDestroySurfaceKHR(m_Instance.Get(), m_Surface, nullptr);
+        if (m_Surface == VK_NULL_HANDLE)
+        {
+            return;
+        };
+
+        vkDestroySurfaceKHR(m_Instance->Get(), m_Surface, nullptr);
+        m_Surface = VK_NULL_HANDLE;
     };
 
 }
\ No newline at end of file
@@ -13,18 +13,20 @@ namespace VulkanCore
     {
     public:
         Surface() = default;
-        ~Surface() = default;
+        ~Surface() { Destroy(); };
+        Surface(const Surface &) = delete;
+        Surface &operator=(const Surface &) = delete;
 
         void Create(const Instance &instance, void *window);
         void Destroy();
 
-        VkSurfaceKHR Get() { return m_Surface; };
-        void *GetWindow() { return m_WindowHandle; };
+        VkSurfaceKHR Get() const { return m_Surface; };
+        void *GetWindow() const { return m_WindowHandle; };
 
     private:
-        VkSurfaceKHR m_Surface;
-        Instance m_Instance;
-        void *m_WindowHandle;
+        VkSurfaceKHR m_Surface = VK_NULL_HANDLE;
+        const Instance *m_Instance = nullptr;
+        void *m_WindowHandle = nullptr;
     };
 
 };
\ No newline at end of file
@@ -10,10 +10,10 @@ namespace VulkanCore
     void SwapChain::Create(const SwapChainConfig &config, const Device &device, const Surface &surface)
     {
         m_Config = config;
-        m_DeviceInst = device;
-        m_SurfaceInst = surface;
+        m_DeviceInst = &device;
+        m_SurfaceInst = &surface;
 
-        SwapChainSupportDetails swapChainSupport = Utils::GetSwapChainDetails(m_DeviceInst.GetPhysical(), m_SurfaceInst.Get());
+        SwapChainSupportDetails swapChainSupport = Utils::GetSwapChainDetails(m_DeviceInst->GetPhysical(), m_SurfaceInst->Get());
 
         VkSurfaceFormatKHR surfaceFormat = ChooseSwapSurfaceFormat(swapChainSupport.formats);
         VkPresentModeKHR presentMode = ChooseSwapPresentMode(swapChainSupport.presentModes);
@@ -27,16 +27,17 @@ namespace VulkanCore
 
         VkSwapchainCreateInfoKHR createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
-        createInfo.surface = m_SurfaceInst.Get();
+        createInfo.surface = m_SurfaceInst->Get();
 
         createInfo.minImageCount = imageCount;
         createInfo.imageFormat = surfaceFormat.format;
         createInfo.imageColorSpace = surfaceFormat.colorSpace;
         createInfo.imageExtent = extent;
         createInfo.imageArrayLayers = 1;
-        createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        m_ImageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | (m_Config.imageUsage & swapChainSupport.capabilities.supportedUsageFlags);
+        createInfo.imageUsage = m_ImageUsage;
 
-        QueueFamilyIndices indices = m_DeviceInst.GetQueueFamilies();
+        const QueueFamilyIndices &indices = m_DeviceInst->GetQueueFamilies();
         uint32_t queueFamilyIndices[] = {indices.graphicsFamily.value(), indices.presentFamily.value()};
 
         if (indices.graphicsFamily != indices.presentFamily)
@@ -57,13 +58,13 @@ namespace VulkanCore
 
         createInfo.oldSwapchain = VK_NULL_HANDLE;
 
-        VkResult result = vkCreateSwapchainKHR(m_DeviceInst.Get(), &createInfo, nullptr, &m_SwapChain);
+        VkResult result = vkCreateSwapchainKHR(m_DeviceInst->Get(), &createInfo, nullptr, &m_SwapChain);
 
         CORE_ASSERT(result == VK_SUCCESS, "Failed to create swap chain!");
 
-        vkGetSwapchainImagesKHR(m_DeviceInst.Get(), m_SwapChain, &imageCount, nullptr);
+        vkGetSwapchainImagesKHR(m_DeviceInst->Get(), m_SwapChain, &imageCount, nullptr);
         m_SwapChainImages.resize(imageCount);
-        vkGetSwapchainImagesKHR(m_DeviceInst.Get(), m_SwapChain, &imageCount, m_SwapChainImages.data());
+        vkGetSwapchainImagesKHR(m_DeviceInst->Get(), m_SwapChain, &imageCount, m_SwapChainImages.data());
 
         m_SwapChainImageFormat = surfaceFormat.format;
         m_SwapChainExtent = extent;
@@ -73,8 +74,14 @@ namespace VulkanCore
 
     void SwapChain::Destroy()
     {
+        if (m_SwapChain == VK_NULL_HANDLE)
+        {
+            return;
+        };
+
         DestroyImageViews();
-        vkDestroySwapchainKHR(m_DeviceInst.Get(), m_SwapChain, nullptr);
+        vkDestroySwapchainKHR(m_DeviceInst->Get(), m_SwapChain, nullptr);
+        m_SwapChain = VK_NULL_HANDLE;
     };
 
     void SwapChain::CreateImageViews()
@@ -98,7 +105,7 @@ namespace VulkanCore
             createInfo.subresourceRange.baseArrayLayer = 0;
             createInfo.subresourceRange.layerCount = 1;
 
-            VkResult result = vkCreateImageView(m_DeviceInst.Get(), &createInfo, nullptr, &m_SwapChainImageViews[i]);
+            VkResult result = vkCreateImageView(m_DeviceInst->Get(), &createInfo, nullptr, &m_SwapChainImageViews[i]);
 
             CORE_ASSERT(result == VK_SUCCESS, "Failed to create image views!");
         };
@@ -108,8 +115,9 @@ namespace VulkanCore
     {
         for (auto imageView : m_SwapChainImageViews)
         {
-            vkDestroyImageView(m_DeviceInst.Get(), imageView, nullptr);
+            vkDestroyImageView(m_DeviceInst->Get(), imageView, nullptr);
         };
+        m_SwapChainImageViews.clear();
     };
 
     VkSurfaceFormatKHR SwapChain::ChooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR> &availableFormats)
@@ -148,7 +156,7 @@ namespace VulkanCore
         else
         {
             int width, height;
-            GLFWwindow *win = static_cast<GLFWwindow *>(m_SurfaceInst.GetWindow());
+            GLFWwindow *win = static_cast<GLFWwindow *>(m_SurfaceInst->GetWindow());
             glfwGetFramebufferSize(win, &width, &height);
 
             VkExtent2D actualExtent = {
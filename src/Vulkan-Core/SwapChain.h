@@ -14,15 +14,20 @@ namespace VulkanCore
     {
     public:
         SwapChain() = default;
-        ~SwapChain() = default;
+        ~SwapChain() { Destroy(); };
+        SwapChain(const SwapChain &) = delete;
+        SwapChain &operator=(const SwapChain &) = delete;
 
         void Create(const SwapChainConfig &config, const Device &device, const Surface &surface);
         void Destroy();
 
-        VkSwapchainKHR Get() { return m_SwapChain; };
-        VkFormat GetImageFormat() { return m_SwapChainImageFormat; };
-        VkExtent2D GetExtent() { return m_SwapChainExtent; };
-        std::vector<VkImageView> GetImageViews() { return m_SwapChainImageViews; };
+        VkSwapchainKHR Get() const { return m_SwapChain; };
+        VkFormat GetImageFormat() const { return m_SwapChainImageFormat; };
+        VkExtent2D GetExtent() const { return m_SwapChainExtent; };
+        VkImageUsageFlags GetImageUsage() const { return m_ImageUsage; };
+        const std::vector<VkImageView> &GetImageViews() const { return m_SwapChainImageViews; };
+        VkImage GetImage(uint32_t index) const { return m_SwapChainImages[index]; };
+        VkImageView GetImageView(uint32_t index) const { return m_SwapChainImageViews[index]; };
 
     private:
         void CreateImageViews();
@@ -34,12 +39,13 @@ namespace VulkanCore
 
     private:
         SwapChainConfig m_Config;
-        Device m_DeviceInst;
-        Surface m_SurfaceInst;
+        const Device *m_DeviceInst = nullptr;
+        const Surface *m_SurfaceInst = nullptr;
 
-        VkSwapchainKHR m_SwapChain;
+        VkSwapchainKHR m_SwapChain = VK_NULL_HANDLE;
         VkFormat m_SwapChainImageFormat;
         VkExtent2D m_SwapChainExtent;
+        VkImageUsageFlags m_ImageUsage = 0;
         std::vector<VkImage> m_SwapChainImages;
         std::vector<VkImageView> m_SwapChainImageViews;
     };
@@ -0,0 +1,316 @@
+#include "Texture.h"
+#include "Utils.h"
+#include "../Log.h"
+
+#include <cmath>
+#include <utility>
+
+namespace VulkanCore
+{
+
+    void Texture::Create(const TextureConfig &config, const Device &device, VkCommandPool commandPool)
+    {
+        m_Config = config;
+        m_DeviceInst = &device;
+        m_CommandPool = commandPool;
+
+        m_Data = TextureLoader::LoadKTX2(m_Config.path);
+
+        if (TextureLoader::IsBCFormat(m_Data.format) && !m_DeviceInst->GetEnabledFeatures().textureCompressionBC)
+        {
+            throw std::runtime_error("BCn compressed textures are not supported by the device!");
+        };
+
+        if (TextureLoader::IsASTCFormat(m_Data.format) && !m_DeviceInst->GetEnabledFeatures().textureCompressionASTC_LDR)
+        {
+            throw std::runtime_error("ASTC compressed textures are not supported by the device!");
+        };
+
+        VkFormatProperties formatProperties;
+        vkGetPhysicalDeviceFormatProperties(m_DeviceInst->GetPhysical(), m_Data.format, &formatProperties);
+
+        CORE_ASSERT(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT, "Texture format can not be sampled!");
+
+        m_LevelCount = static_cast<uint32_t>(m_Data.levels.size());
+
+        // Files without a mip chain get one generated on the GPU. Block compressed formats can not be blit targets.
+        if (m_LevelCount == 1 && m_Config.generateMips && !TextureLoader::IsCompressedFormat(m_Data.format))
+        {
+            VkFormatFeatureFlags blitFeatures = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT;
+
+            if ((formatProperties.optimalTilingFeatures & blitFeatures) == blitFeatures)
+            {
+                m_GenerateMips = true;
+                m_LevelCount = static_cast<uint32_t>(std::floor(std::log2((std::max)(m_Data.width, m_Data.height)))) + 1;
+                m_BlitFilter = (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT) ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+            }
+            else
+            {
+                CORE_LOG_INFO("Texture {0}: format does not support blits, mip generation skipped.", m_Config.path);
+            };
+        };
+
+        // Only authored mip chains can be streamed, generated levels need the full resolution base level.
+        m_Streamed = m_Config.streamed && !m_GenerateMips && m_LevelCount > 1;
+        m_ResidentMip = m_Streamed ? m_LevelCount - 1 : 0;
+
+        m_UploadCommandBuffer = Utils::BeginSingleTimeCommands(m_DeviceInst->Get(), m_CommandPool);
+        Upload(m_UploadCommandBuffer, m_ResidentMip, nullptr, 0, m_UploadStagingBuffer, m_UploadStagingBufferMemory);
+        m_UploadFence = Utils::SubmitSingleTimeCommands(m_DeviceInst->GetDispatch(), m_DeviceInst->Get(), m_DeviceInst->GetGraphicsQueue(), m_UploadCommandBuffer);
+    };
+
+    void Texture::Destroy()
+    {
+        ReleaseUpload(true);
+        m_Image.Destroy();
+        m_Data.payload.clear();
+    };
+
+    bool Texture::ReleaseUpload(bool wait)
+    {
+        if (m_UploadFence == VK_NULL_HANDLE)
+        {
+            return true;
+        };
+
+        const DeviceDispatch &dispatch = m_DeviceInst->GetDispatch();
+        VkDevice device = m_DeviceInst->Get();
+
+        if (wait)
+        {
+            dispatch.vkWaitForFences(device, 1, &m_UploadFence, VK_TRUE, UINT64_MAX);
+        }
+        else if (dispatch.vkGetFenceStatus(device, m_UploadFence) != VK_SUCCESS)
+        {
+            return false;
+        };
+
+        vkDestroyFence(device, m_UploadFence, nullptr);
+        vkFreeCommandBuffers(device, m_CommandPool, 1, &m_UploadCommandBuffer);
+
+        if (m_UploadStagingBuffer != VK_NULL_HANDLE)
+        {
+            vkDestroyBuffer(device, m_UploadStagingBuffer, nullptr);
+            vkFreeMemory(device, m_UploadStagingBufferMemory, nullptr);
+        };
+
+        m_UploadFence = VK_NULL_HANDLE;
+        m_UploadCommandBuffer = VK_NULL_HANDLE;
+        m_UploadStagingBuffer = VK_NULL_HANDLE;
+        m_UploadStagingBufferMemory = VK_NULL_HANDLE;
+
+        return true;
+    };
+
+    Texture::Texture(Texture &&other) noexcept
+        : m_Config(std::move(other.m_Config)),
+          m_DeviceInst(std::exchange(other.m_DeviceInst, nullptr)),
+          m_CommandPool(std::exchange(other.m_CommandPool, VK_NULL_HANDLE)),
+          m_Data(std::move(other.m_Data)),
+          m_Image(std::move(other.m_Image)),
+          m_LevelCount(std::exchange(other.m_LevelCount, 1)),
+          m_ResidentMip(std::exchange(other.m_ResidentMip, 0)),
+          m_Version(std::exchange(other.m_Version, 0)),
+          m_GenerateMips(std::exchange(other.m_GenerateMips, false)),
+          m_Streamed(std::exchange(other.m_Streamed, false)),
+          m_BlitFilter(other.m_BlitFilter),
+          m_UploadCommandBuffer(std::exchange(other.m_UploadCommandBuffer, VK_NULL_HANDLE)),
+          m_UploadFence(std::exchange(other.m_UploadFence, VK_NULL_HANDLE)),
+          m_UploadStagingBuffer(std::exchange(other.m_UploadStagingBuffer, VK_NULL_HANDLE)),
+          m_UploadStagingBufferMemory(std::exchange(other.m_UploadStagingBufferMemory, VK_NULL_HANDLE))
+    {
+    };
+
+    Texture &Texture::operator=(Texture &&other) noexcept
+    {
+        if (this != &other)
+        {
+            // The texture being replaced is released first, as the destructor would.
+            Destroy();
+
+            m_Config = std::move(other.m_Config);
+            m_DeviceInst = std::exchange(other.m_DeviceInst, nullptr);
+            m_CommandPool = std::exchange(other.m_CommandPool, VK_NULL_HANDLE);
+            m_Data = std::move(other.m_Data);
+            m_Image = std::move(other.m_Image);
+            m_LevelCount = std::exchange(other.m_LevelCount, 1);
+            m_ResidentMip = std::exchange(other.m_ResidentMip, 0);
+            m_Version = std::exchange(other.m_Version, 0);
+            m_GenerateMips = std::exchange(other.m_GenerateMips, false);
+            m_Streamed = std::exchange(other.m_Streamed, false);
+            m_BlitFilter = other.m_BlitFilter;
+            m_UploadCommandBuffer = std::exchange(other.m_UploadCommandBuffer, VK_NULL_HANDLE);
+            m_UploadFence = std::exchange(other.m_UploadFence, VK_NULL_HANDLE);
+            m_UploadStagingBuffer = std::exchange(other.m_UploadStagingBuffer, VK_NULL_HANDLE);
+            m_UploadStagingBufferMemory = std::exchange(other.m_UploadStagingBufferMemory, VK_NULL_HANDLE);
+        };
+
+        return *this;
+    };
+
+    RetiredTexture Texture::SetResidentMip(VkCommandBuffer commandBuffer, uint32_t baseMip)
+    {
+        baseMip = (std::min)(baseMip, m_LevelCount - 1);
+
+        RetiredTexture retired;
+        retired.image = std::move(m_Image);
+        uint32_t previousBaseMip = m_ResidentMip;
+
+        Upload(commandBuffer, baseMip, &retired.image, previousBaseMip, retired.stagingBuffer, retired.stagingBufferMemory);
+
+        m_ResidentMip = baseMip;
+        m_Version++;
+
+        return retired;
+    };
+
+    VkDeviceSize Texture::GetLevelSize(uint32_t level)
+    {
+        if (level < m_Data.levels.size())
+        {
+            return m_Data.levels[level].size;
+        };
+
+        return (std::max)(m_Data.levels[0].size >> (2 * level), VkDeviceSize(1));
+    };
+
+    VkDeviceSize Texture::GetResidentSize(uint32_t baseMip)
+    {
+        VkDeviceSize size = 0;
+        for (uint32_t level = baseMip; level < m_LevelCount; level++)
+        {
+            size += GetLevelSize(level);
+        };
+
+        return size;
+    };
+
+    void Texture::Upload(VkCommandBuffer commandBuffer, uint32_t baseMip, Image *previous, uint32_t previousBaseMip, VkBuffer &stagingBuffer, VkDeviceMemory &stagingBufferMemory)
+    {
+        const DeviceDispatch &dispatch = m_DeviceInst->GetDispatch();
+
+        uint32_t levelCount = m_LevelCount - baseMip;
+
+        ImageConfig imageConfig;
+        imageConfig.format = m_Data.format;
+        imageConfig.width = (std::max)(m_Data.width >> baseMip, 1u);
+        imageConfig.height = (std::max)(m_Data.height >> baseMip, 1u);
+        imageConfig.mipLevels = levelCount;
+        imageConfig.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+
+        Image image;
+        image.Create(imageConfig, *m_DeviceInst);
+
+        // Levels [baseMip, firstCopiedMip) come from the cpu, the rest are already resident in the previous image.
+        uint32_t firstCopiedMip = previous != nullptr ? (std::max)(previousBaseMip, baseMip) : m_LevelCount;
+        uint32_t lastUploadedMip = m_GenerateMips ? (std::min)(firstCopiedMip, baseMip + 1) : firstCopiedMip;
+
+        VkDeviceSize stagingSize = 0;
+        for (uint32_t level = baseMip; level < lastUploadedMip; level++)
+        {
+            stagingSize += m_Data.levels[level].size;
+        };
+
+        stagingBuffer = VK_NULL_HANDLE;
+        stagingBufferMemory = VK_NULL_HANDLE;
+        std::vector<VkBufferImageCopy> uploadRegions;
+
+        if (stagingSize > 0)
+        {
+            Utils::CreateBuffer(m_DeviceInst->Get(), m_DeviceInst->GetMemoryProperties(), stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
+
+            char *data;
+            vkMapMemory(m_DeviceInst->Get(), stagingBufferMemory, 0, stagingSize, 0, reinterpret_cast<void **>(&data));
+
+            VkDeviceSize offset = 0;
+            for (uint32_t level = baseMip; level < lastUploadedMip; level++)
+            {
+                const TextureLevel &textureLevel = m_Data.levels[level];
+                memcpy(data + offset, m_Data.payload.data() + textureLevel.offset, (size_t)textureLevel.size);
+
+                VkBufferImageCopy region{};
+                region.bufferOffset = offset;
+                region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                region.imageSubresource.mipLevel = level - baseMip;
+                region.imageSubresource.baseArrayLayer = 0;
+                region.imageSubresource.layerCount = 1;
+                region.imageExtent = {textureLevel.width, textureLevel.height, 1};
+                uploadRegions.push_back(region);
+
+                offset += textureLevel.size;
+            };
+
+            vkUnmapMemory(m_DeviceInst->Get(), stagingBufferMemory);
+        };
+
+        image.TransitionLayout(commandBuffer, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 0, levelCount);
+
+        if (!uploadRegions.empty())
+        {
+            dispatch.vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, image.Get(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(uploadRegions.size()), uploadRegions.data());
+        };
+
+        if (firstCopiedMip < m_LevelCount)
+        {
+            uint32_t previousLevelCount = m_LevelCount - previousBaseMip;
+            previous->TransitionLayout(commandBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, 0, previousLevelCount);
+
+            std::vector<VkImageCopy> copyRegions;
+            for (uint32_t level = firstCopiedMip; level < m_LevelCount; level++)
+            {
+                VkImageCopy region{};
+                region.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level - previousBaseMip, 0, 1};
+                region.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level - baseMip, 0, 1};
+                region.extent = {(std::max)(m_Data.width >> level, 1u), (std::max)(m_Data.height >> level, 1u), 1};
+                copyRegions.push_back(region);
+            };
+
+            dispatch.vkCmdCopyImage(commandBuffer, previous->Get(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image.Get(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(copyRegions.size()), copyRegions.data());
+
+            previous->TransitionLayout(commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 0, previousLevelCount);
+        };
+
+        if (m_GenerateMips && previous == nullptr)
+        {
+            GenerateMips(commandBuffer, image);
+        }
+        else
+        {
+            image.TransitionLayout(commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 0, levelCount);
+        };
+
+        m_Image = std::move(image);
+    };
+
+    void Texture::GenerateMips(VkCommandBuffer commandBuffer, Image &image)
+    {
+        int32_t mipWidth = static_cast<int32_t>(m_Data.width);
+        int32_t mipHeight = static_cast<int32_t>(m_Data.height);
+
+        for (uint32_t level = 1; level < m_LevelCount; level++)
+        {
+            image.TransitionLayout(commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, level - 1, 1);
+
+            int32_t nextWidth = mipWidth > 1 ? mipWidth / 2 : 1;
+            int32_t nextHeight = mipHeight > 1 ? mipHeight / 2 : 1;
+
+            VkImageBlit blit{};
+            blit.srcOffsets[0] = {0, 0, 0};
+            blit.srcOffsets[1] = {mipWidth, mipHeight, 1};
+            blit.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level - 1, 0, 1};
+            blit.dstOffsets[0] = {0, 0, 0};
+            blit.dstOffsets[1] = {nextWidth, nextHeight, 1};
+            blit.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1};
+
+            m_DeviceInst->GetDispatch().vkCmdBlitImage(commandBuffer, image.Get(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image.Get(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, m_BlitFilter);
+
+            image.TransitionLayout(commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, level - 1, 1);
+
+            mipWidth = nextWidth;
+            mipHeight = nextHeight;
+        };
+
+        image.TransitionLayout(commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, m_LevelCount - 1, 1);
+    };
+
+};
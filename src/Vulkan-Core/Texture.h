@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "../Common.h"
+#include "Types.h"
+#include "Device.h"
+#include "Image.h"
+#include "TextureLoader.h"
+
+namespace VulkanCore
+{
+    // Left behind by a residency change: the image it replaced and the staging buffer of its upload, both in use
+    // until the command buffer the change was recorded into has executed.
+    struct RetiredTexture
+    {
+        Image image;
+        VkBuffer stagingBuffer = VK_NULL_HANDLE;
+        VkDeviceMemory stagingBufferMemory = VK_NULL_HANDLE;
+    };
+
+    class Texture
+    {
+    public:
+        Texture() = default;
+        ~Texture() { Destroy(); };
+        Texture(const Texture &) = delete;
+        Texture &operator=(const Texture &) = delete;
+        // A texture registered with a TextureStreamer is tracked by address and must not be moved.
+        Texture(Texture &&other) noexcept;
+        Texture &operator=(Texture &&other) noexcept;
+
+        // The first upload is submitted without waiting on it, later submissions to the graphics queue see the
+        // texture's levels. Nothing blocks, see ReleaseUpload().
+        void Create(const TextureConfig &config, const Device &device, VkCommandPool commandPool);
+        void Destroy();
+
+        // Frees the staging buffer and command buffer of the first upload once it has executed, or waits for it to.
+        // True when nothing is left pending. Textures registered with a TextureStreamer are polled by its Update().
+        bool ReleaseUpload(bool wait = false);
+
+        // Rebuilds the image so it holds levels [baseMip, levelCount), recorded into commandBuffer ahead of the draws
+        // sampling it. Levels already resident are copied on the GPU, only missing ones are uploaded. What is returned
+        // must outlive the command buffer and the frames still reading the previous image.
+        RetiredTexture SetResidentMip(VkCommandBuffer commandBuffer, uint32_t baseMip);
+
+        VkImageView GetView() { return m_Image.GetView(); };
+        VkFormat GetFormat() { return m_Data.format; };
+        uint32_t GetWidth() { return m_Data.width; };
+        uint32_t GetHeight() { return m_Data.height; };
+        uint32_t GetLevelCount() { return m_LevelCount; };
+        uint32_t GetResidentMip() { return m_ResidentMip; };
+        uint32_t GetVersion() { return m_Version; };
+        bool IsStreamed() { return m_Streamed; };
+        VkDeviceSize GetLevelSize(uint32_t level);
+        VkDeviceSize GetResidentSize(uint32_t baseMip);
+
+    private:
+        // Records the upload, the staging buffer is returned for the caller to release once it has executed.
+        void Upload(VkCommandBuffer commandBuffer, uint32_t baseMip, Image *previous, uint32_t previousBaseMip, VkBuffer &stagingBuffer, VkDeviceMemory &stagingBufferMemory);
+        void GenerateMips(VkCommandBuffer commandBuffer, Image &image);
+
+    private:
+        TextureConfig m_Config;
+        const Device *m_DeviceInst = nullptr;
+        VkCommandPool m_CommandPool = VK_NULL_HANDLE;
+
+        TextureData m_Data;
+        Image m_Image;
+        uint32_t m_LevelCount = 1;
+        uint32_t m_ResidentMip = 0;
+        uint32_t m_Version = 0;
+        bool m_GenerateMips = false;
+        bool m_Streamed = false;
+        VkFilter m_BlitFilter = VK_FILTER_LINEAR;
+
+        // The first upload, in flight until m_UploadFence signals.
+        VkCommandBuffer m_UploadCommandBuffer = VK_NULL_HANDLE;
+        VkFence m_UploadFence = VK_NULL_HANDLE;
+        VkBuffer m_UploadStagingBuffer = VK_NULL_HANDLE;
+        VkDeviceMemory m_UploadStagingBufferMemory = VK_NULL_HANDLE;
+    };
+
+};
@@ -0,0 +1,152 @@
+#include "TextureLoader.h"
+#include "../Utils.h"
+#include "../Log.h"
+
+#include <cmath>
+
+namespace VulkanCore
+{
+    namespace
+    {
+        const uint8_t KTX2_IDENTIFIER[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+        struct KTX2Header
+        {
+            uint8_t identifier[12];
+            uint32_t vkFormat;
+            uint32_t typeSize;
+            uint32_t pixelWidth;
+            uint32_t pixelHeight;
+            uint32_t pixelDepth;
+            uint32_t layerCount;
+            uint32_t faceCount;
+            uint32_t levelCount;
+            uint32_t supercompressionScheme;
+            uint32_t dfdByteOffset;
+            uint32_t dfdByteLength;
+            uint32_t kvdByteOffset;
+            uint32_t kvdByteLength;
+            uint64_t sgdByteOffset;
+            uint64_t sgdByteLength;
+        };
+
+        struct KTX2LevelIndex
+        {
+            uint64_t byteOffset;
+            uint64_t byteLength;
+            uint64_t uncompressedByteLength;
+        };
+
+        static_assert(sizeof(KTX2Header) == 80, "KTX2 header must be 80 bytes!");
+        static_assert(sizeof(KTX2LevelIndex) == 24, "KTX2 level index entry must be 24 bytes!");
+    };
+
+    namespace TextureLoader
+    {
+
+        TextureData LoadKTX2(const std::string &path)
+        {
+            std::vector<char> file = ReadFile(path);
+
+            if (file.size() < sizeof(KTX2Header))
+            {
+                throw std::runtime_error("KTX2 file is truncated!");
+            };
+
+            KTX2Header header;
+            memcpy(&header, file.data(), sizeof(KTX2Header));
+
+            if (memcmp(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0)
+            {
+                throw std::runtime_error("File is not a KTX2 container!");
+            };
+
+            if (header.vkFormat == VK_FORMAT_UNDEFINED || header.supercompressionScheme != 0)
+            {
+                throw std::runtime_error("Supercompressed (Basis/Zstd) KTX2 files are not supported!");
+            };
+
+            if (header.pixelDepth > 1 || header.layerCount > 1 || header.faceCount != 1)
+            {
+                throw std::runtime_error("Only 2D KTX2 textures are supported!");
+            };
+
+            if (header.pixelWidth == 0)
+            {
+                throw std::runtime_error("KTX2 texture has no width!");
+            };
+
+            // levelCount == 0 asks the loader to generate the mip chain, only the base level is stored.
+            uint32_t levelCount = (std::max)(header.levelCount, 1u);
+
+            // The count comes from the file, it is bounded before it sizes the level index or any allocation.
+            uint32_t maxLevelCount = static_cast<uint32_t>(std::floor(std::log2((std::max)(header.pixelWidth, header.pixelHeight)))) + 1;
+            if (levelCount > maxLevelCount)
+            {
+                throw std::runtime_error("KTX2 level count exceeds the mip chain of the texture!");
+            };
+
+            if (levelCount > (file.size() - sizeof(KTX2Header)) / sizeof(KTX2LevelIndex))
+            {
+                throw std::runtime_error("KTX2 level index is truncated!");
+            };
+
+            std::vector<KTX2LevelIndex> levelIndex(levelCount);
+            memcpy(levelIndex.data(), file.data() + sizeof(KTX2Header), levelCount * sizeof(KTX2LevelIndex));
+
+            TextureData data;
+            data.format = static_cast<VkFormat>(header.vkFormat);
+            data.width = header.pixelWidth;
+            data.height = (std::max)(header.pixelHeight, 1u);
+
+            VkDeviceSize payloadSize = 0;
+            for (const auto &level : levelIndex)
+            {
+                // Compared without adding, a crafted offset and length could wrap the sum back into range.
+                if (level.byteOffset > file.size() || level.byteLength > file.size() - level.byteOffset)
+                {
+                    throw std::runtime_error("KTX2 level data is out of bounds!");
+                };
+                payloadSize += level.byteLength;
+            };
+
+            data.payload.resize(payloadSize);
+            data.levels.resize(levelCount);
+
+            VkDeviceSize offset = 0;
+            for (uint32_t i = 0; i < levelCount; i++)
+            {
+                memcpy(data.payload.data() + offset, file.data() + levelIndex[i].byteOffset, levelIndex[i].byteLength);
+
+                data.levels[i].offset = offset;
+                data.levels[i].size = levelIndex[i].byteLength;
+                data.levels[i].width = (std::max)(data.width >> i, 1u);
+                data.levels[i].height = (std::max)(data.height >> i, 1u);
+
+                offset += levelIndex[i].byteLength;
+            };
+
+            CORE_LOG_INFO("Loaded KTX2 texture {0} ({1}x{2}, {3} levels, format {4})", path, data.width, data.height, levelCount, header.vkFormat);
+
+            return data;
+        };
+
+        bool IsBCFormat(VkFormat format)
+        {
+            return format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK && format <= VK_FORMAT_BC7_SRGB_BLOCK;
+        };
+
+        bool IsASTCFormat(VkFormat format)
+        {
+            return format >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK && format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK;
+        };
+
+        bool IsCompressedFormat(VkFormat format)
+        {
+            return IsBCFormat(format) || IsASTCFormat(format) ||
+                   (format >= VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK && format <= VK_FORMAT_EAC_R11G11_SNORM_BLOCK);
+        };
+
+    };
+
+};
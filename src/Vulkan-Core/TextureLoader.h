@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "../Common.h"
+
+namespace VulkanCore
+{
+    struct TextureLevel
+    {
+        VkDeviceSize offset;
+        VkDeviceSize size;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    struct TextureData
+    {
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        // Level 0 is the full resolution image. A single level means the file carried no mip chain.
+        std::vector<TextureLevel> levels;
+        std::vector<char> payload;
+    };
+
+    namespace TextureLoader
+    {
+        // Loads a 2D KTX2 container without supercompression (raw BCn, ASTC or uncompressed payloads).
+        TextureData LoadKTX2(const std::string &path);
+
+        bool IsCompressedFormat(VkFormat format);
+        bool IsBCFormat(VkFormat format);
+        bool IsASTCFormat(VkFormat format);
+    };
+
+};
@@ -0,0 +1,196 @@
+#include "TextureStreamer.h"
+#include "../Log.h"
+
+#include <cmath>
+
+namespace VulkanCore
+{
+
+    void TextureStreamer::Create(const TextureStreamerConfig &config, const Device &device)
+    {
+        m_Config = config;
+        m_DeviceInst = &device;
+    };
+
+    void TextureStreamer::Destroy()
+    {
+        for (auto &retired : m_Retired)
+        {
+            Release(retired);
+        };
+
+        m_Retired.clear();
+        m_Textures.clear();
+    };
+
+    void TextureStreamer::Release(RetiredResources &retired)
+    {
+        retired.texture.image.Destroy();
+
+        if (retired.texture.stagingBuffer != VK_NULL_HANDLE)
+        {
+            vkDestroyBuffer(m_DeviceInst->Get(), retired.texture.stagingBuffer, nullptr);
+            vkFreeMemory(m_DeviceInst->Get(), retired.texture.stagingBufferMemory, nullptr);
+            retired.texture.stagingBuffer = VK_NULL_HANDLE;
+            retired.texture.stagingBufferMemory = VK_NULL_HANDLE;
+        };
+    };
+
+    void TextureStreamer::Register(Texture *texture)
+    {
+        if (!texture->IsStreamed())
+        {
+            return;
+        };
+
+        StreamedTexture streamed{};
+        streamed.texture = texture;
+        streamed.requestedMip = texture->GetLevelCount() - 1;
+        streamed.targetMip = texture->GetResidentMip();
+        streamed.priority = 0.0f;
+
+        m_Textures.push_back(streamed);
+    };
+
+    void TextureStreamer::Unregister(Texture *texture)
+    {
+        m_Textures.erase(std::remove_if(m_Textures.begin(), m_Textures.end(), [texture](const StreamedTexture &streamed)
+                                        { return streamed.texture == texture; }),
+                         m_Textures.end());
+    };
+
+    void TextureStreamer::RequestMip(Texture *texture, float projectedSize)
+    {
+        for (auto &streamed : m_Textures)
+        {
+            if (streamed.texture != texture)
+            {
+                continue;
+            };
+
+            // One texel per pixel: every halving of the on-screen size drops one mip.
+            float textureSize = static_cast<float>((std::max)(texture->GetWidth(), texture->GetHeight()));
+            float lod = std::log2(textureSize / (std::max)(projectedSize, 1.0f));
+            uint32_t mip = static_cast<uint32_t>(std::clamp(std::floor(lod), 0.0f, static_cast<float>(texture->GetLevelCount() - 1)));
+
+            streamed.requestedMip = (std::min)(streamed.requestedMip, mip);
+            streamed.priority = (std::max)(streamed.priority, projectedSize / textureSize);
+            return;
+        };
+    };
+
+    void TextureStreamer::Update(VkCommandBuffer commandBuffer)
+    {
+        // Retired images and staging buffers may still be referenced by frames in flight.
+        for (auto it = m_Retired.begin(); it != m_Retired.end();)
+        {
+            if (it->framesLeft-- == 0)
+            {
+                Release(*it);
+                it = m_Retired.erase(it);
+            }
+            else
+            {
+                it++;
+            };
+        };
+
+        if (m_Textures.empty())
+        {
+            return;
+        };
+
+        VkDeviceSize memoryBudget = m_Config.memoryBudget;
+        VkDeviceSize uploadBudget = m_Config.uploadBudgetPerFrame;
+
+        if (m_HeapBudget.usage > 0)
+        {
+            // Everything else on the heap stays put, textures get what is left below the hard limit.
+            VkDeviceSize hardLimit = static_cast<VkDeviceSize>(static_cast<double>(m_HeapBudget.budget) * m_Config.heapHardLimit);
+            VkDeviceSize softLimit = static_cast<VkDeviceSize>(static_cast<double>(m_HeapBudget.budget) * m_Config.heapSoftLimit);
+            VkDeviceSize otherUsage = m_HeapBudget.usage - (std::min)(m_HeapBudget.usage, m_ResidentBytes);
+
+            memoryBudget = (std::min)(memoryBudget, hardLimit - (std::min)(hardLimit, otherUsage));
+
+            if (m_HeapBudget.usage >= hardLimit)
+            {
+                uploadBudget = 0;
+            }
+            else if (m_HeapBudget.usage > softLimit)
+            {
+                uploadBudget = static_cast<VkDeviceSize>(static_cast<double>(uploadBudget) * static_cast<double>(hardLimit - m_HeapBudget.usage) / static_cast<double>(hardLimit - softLimit));
+            };
+        };
+
+        m_EffectiveBudget = memoryBudget;
+
+        // Least important textures give up their most detailed levels first.
+        std::sort(m_Textures.begin(), m_Textures.end(), [](const StreamedTexture &a, const StreamedTexture &b)
+                  { return a.priority > b.priority; });
+
+        VkDeviceSize requiredBytes = 0;
+        for (auto &streamed : m_Textures)
+        {
+            uint32_t tailMip = streamed.texture->GetLevelCount() - (std::min)(m_Config.minResidentLevels, streamed.texture->GetLevelCount());
+            streamed.targetMip = (std::min)(streamed.requestedMip, tailMip);
+            requiredBytes += streamed.texture->GetResidentSize(streamed.targetMip);
+        };
+
+        bool reduced = true;
+        while (requiredBytes > memoryBudget && reduced)
+        {
+            reduced = false;
+            for (auto it = m_Textures.rbegin(); it != m_Textures.rend() && requiredBytes > memoryBudget; it++)
+            {
+                uint32_t tailMip = it->texture->GetLevelCount() - (std::min)(m_Config.minResidentLevels, it->texture->GetLevelCount());
+                if (it->targetMip < tailMip)
+                {
+                    requiredBytes -= it->texture->GetLevelSize(it->targetMip);
+                    it->targetMip++;
+                    reduced = true;
+                };
+            };
+        };
+
+        // Evictions are free, uploads are limited per frame and go to the most important textures first.
+        VkDeviceSize uploadedBytes = 0;
+        m_ResidentBytes = 0;
+
+        for (auto &streamed : m_Textures)
+        {
+            Texture *texture = streamed.texture;
+            uint32_t residentMip = texture->GetResidentMip();
+
+            texture->ReleaseUpload();
+
+            if (streamed.targetMip > residentMip)
+            {
+                m_Retired.push_back({texture->SetResidentMip(commandBuffer, streamed.targetMip), m_Config.framesInFlight});
+            }
+            else if (streamed.targetMip < residentMip)
+            {
+                uint32_t targetMip = residentMip;
+                VkDeviceSize uploadSize = 0;
+
+                while (targetMip > streamed.targetMip && uploadedBytes + uploadSize + texture->GetLevelSize(targetMip - 1) <= uploadBudget)
+                {
+                    targetMip--;
+                    uploadSize += texture->GetLevelSize(targetMip);
+                };
+
+                if (targetMip != residentMip)
+                {
+                    m_Retired.push_back({texture->SetResidentMip(commandBuffer, targetMip), m_Config.framesInFlight});
+                    uploadedBytes += uploadSize;
+                };
+            };
+
+            m_ResidentBytes += texture->GetResidentSize(texture->GetResidentMip());
+
+            // Demand is rebuilt every frame.
+            streamed.requestedMip = texture->GetLevelCount() - 1;
+            streamed.priority = 0.0f;
+        };
+    };
+
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "../Common.h"
+#include "Types.h"
+#include "Device.h"
+#include "Texture.h"
+
+namespace VulkanCore
+{
+    // Decides which mip levels of streamed textures are resident. Renderers report the on-screen size of every
+    // textured draw, Update() turns that demand into target levels that fit the memory budget and records the
+    // changes into the frame's command buffer. Nothing waits on the GPU, replaced images and staging buffers are
+    // released once the frames that used them have retired.
+    class TextureStreamer
+    {
+    public:
+        TextureStreamer() = default;
+        ~TextureStreamer() { Destroy(); };
+        TextureStreamer(const TextureStreamer &) = delete;
+        TextureStreamer &operator=(const TextureStreamer &) = delete;
+
+        void Create(const TextureStreamerConfig &config, const Device &device);
+        void Destroy();
+
+        void Register(Texture *texture);
+        void Unregister(Texture *texture);
+
+        // projectedSize is the largest screen-space extent, in pixels, the texture covers this frame.
+        void RequestMip(Texture *texture, float projectedSize);
+        // commandBuffer is the frame's, recording and outside of any render pass.
+        void Update(VkCommandBuffer commandBuffer);
+
+        void SetMemoryBudget(VkDeviceSize budget) { m_Config.memoryBudget = budget; };
+        // The heap textures are allocated from, as of this frame. Tightens the memory budget and throttles uploads
+        // as the heap nears its budget, see TextureStreamerConfig.
+        void SetHeapBudget(const HeapBudget &heap) { m_HeapBudget = heap; };
+        VkDeviceSize GetResidentBytes() { return m_ResidentBytes; };
+        // The budget Update() last fit the textures into.
+        VkDeviceSize GetEffectiveBudget() { return m_EffectiveBudget; };
+
+    private:
+        struct StreamedTexture
+        {
+            Texture *texture;
+            uint32_t requestedMip;
+            uint32_t targetMip;
+            float priority;
+        };
+
+        struct RetiredResources
+        {
+            RetiredTexture texture;
+            uint32_t framesLeft;
+        };
+
+        void Release(RetiredResources &retired);
+
+    private:
+        TextureStreamerConfig m_Config;
+        const Device *m_DeviceInst = nullptr;
+        HeapBudget m_HeapBudget;
+        VkDeviceSize m_EffectiveBudget = 0;
+        std::vector<StreamedTexture> m_Textures;
+        std::vector<RetiredResources> m_Retired;
+        VkDeviceSize m_ResidentBytes = 0;
+    };
+
+};
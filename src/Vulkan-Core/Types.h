@@ -1,16 +1,108 @@
 #pragma once
 
 #include "../Common.h"
+#include "HandlePool.h"
 
 #include <vulkan/vulkan.h>
 
 namespace VulkanCore
 {
+    class Image;
+
+    // How a buffer's initial contents reach it. Direct writes map the final allocation, which needs memory that is
+    // both device local and host visible (UMA devices and discrete GPUs with resizable BAR).
+    enum class UploadStrategy
+    {
+        None,
+        DirectWrite,
+        Staging
+    };
+
+    // Resources held by a ResourcePool, referred to by 32-bit generational handles.
+    struct BufferResource
+    {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkDeviceSize size = 0;
+        VkBufferUsageFlags usage = 0;
+        VkMemoryPropertyFlags properties = 0;
+        UploadStrategy upload = UploadStrategy::None;
+    };
+
+    struct PipelineResource
+    {
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        // Not owned, pipelines sharing a layout are common.
+        VkPipelineLayout layout = VK_NULL_HANDLE;
+        VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    };
+
+    struct SamplerResource
+    {
+        // Owned by the SamplerCache.
+        VkSampler sampler = VK_NULL_HANDLE;
+    };
+
+    using BufferHandle = Handle<BufferResource>;
+    using ImageHandle = Handle<Image>;
+    using PipelineHandle = Handle<PipelineResource>;
+    using SamplerHandle = Handle<SamplerResource>;
 
     struct QueueFamilyIndices
     {
         std::optional<uint32_t> graphicsFamily;
         std::optional<uint32_t> presentFamily;
+        // Dedicated compute family when the device exposes one, the graphics family otherwise.
+        std::optional<uint32_t> computeFamily;
+    };
+
+    // Device features negotiated through FeatureChain, see DeviceConfig::requiredFeatures.
+    enum class DeviceFeature
+    {
+        // Vulkan 1.0
+        TextureCompressionBC,
+        TextureCompressionASTC,
+        SamplerAnisotropy,
+        OcclusionQueryPrecise,
+        PipelineStatisticsQuery,
+        MultiDrawIndirect,
+        DrawIndirectFirstInstance,
+        ShaderInt64,
+        // Vulkan 1.1
+        ShaderDrawParameters,
+        // Vulkan 1.2
+        DrawIndirectCount,
+        DescriptorIndexing,
+        ShaderSampledImageArrayNonUniformIndexing,
+        DescriptorBindingPartiallyBound,
+        DescriptorBindingVariableDescriptorCount,
+        RuntimeDescriptorArray,
+        ScalarBlockLayout,
+        HostQueryReset,
+        TimelineSemaphore,
+        BufferDeviceAddress,
+        // Vulkan 1.3
+        Synchronization2,
+        DynamicRendering,
+        Maintenance4,
+        Count
+    };
+
+    // A physical device as ranked by Device::Create.
+    struct PhysicalDeviceCandidate
+    {
+        VkPhysicalDevice device = VK_NULL_HANDLE;
+        uint32_t index = 0;
+        std::string name;
+        VkPhysicalDeviceType type = VK_PHYSICAL_DEVICE_TYPE_OTHER;
+        uint64_t deviceLocalBytes = 0;
+        QueueFamilyIndices queueFamilies;
+        // Required extensions, plus the swapchain when presenting.
+        std::vector<const char *> extensions;
+        bool suitable = false;
+        // Why an unsuitable device was rejected.
+        std::string rejection;
+        int64_t score = 0;
     };
 
     struct SwapChainSupportDetails
@@ -35,15 +127,29 @@ namespace VulkanCore
         PFN_vkDebugUtilsMessengerCallbackEXT debugCallback = nullptr;
         const char *appName;
         const char *engineName;
-        uint32_t apiVersion;
+        uint32_t apiVersion = VK_API_VERSION_1_0;
+        // No window system, the surface extensions are not requested.
+        bool headless = false;
     };
 
     struct DeviceConfig
     {
         std::vector<const char *> requiredExtensions;
+        // Enabled when the selected device supports them, check Device::IsExtensionEnabled().
+        std::vector<const char *> optionalExtensions;
         bool requireGraphicsQueue;
         bool requirePresentQueue;
-        bool isDiscrete;
+        // Rejects integrated, virtual and CPU devices outright instead of ranking them below discrete GPUs.
+        bool requireDiscrete = false;
+        // CPU implementations (lavapipe, SwiftShader) rank last but keep display-less CI machines running.
+        bool allowSoftware = true;
+        // Index in enumeration order or a case-insensitive name substring. The VKS_DEVICE environment variable
+        // takes precedence, an override matching no suitable device falls back to the ranking.
+        std::string preferredDevice;
+        // Devices missing a required feature are rejected. Optional features are enabled when supported, check
+        // Device::IsFeatureEnabled(). Features past the negotiated API version count as unsupported.
+        std::vector<DeviceFeature> requiredFeatures;
+        std::vector<DeviceFeature> optionalFeatures;
     };
 
     struct SwapChainConfig
@@ -53,6 +159,81 @@ namespace VulkanCore
         VkPresentModeKHR presentMode;
         uint32_t width;
         uint32_t height;
+        // Usage on top of color attachment, dropped where the surface does not support it (see GetImageUsage).
+        VkImageUsageFlags imageUsage = 0;
+    };
+
+    struct ImageConfig
+    {
+        VkFormat format;
+        uint32_t width;
+        uint32_t height;
+        uint32_t mipLevels = 1;
+        VkImageUsageFlags usage;
+        VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+        VkMemoryPropertyFlags memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        // Used when none of the image's memory types has memoryProperties, 0 leaves no fallback.
+        VkMemoryPropertyFlags fallbackMemoryProperties = 0;
+        VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+    };
+
+    struct SamplerConfig
+    {
+        VkFilter magFilter = VK_FILTER_LINEAR;
+        VkFilter minFilter = VK_FILTER_LINEAR;
+        VkSamplerMipmapMode mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+        VkSamplerAddressMode addressMode = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        float maxAnisotropy = 1.0f;
+        float minLod = 0.0f;
+        float maxLod = VK_LOD_CLAMP_NONE;
+
+        bool operator==(const SamplerConfig &other) const
+        {
+            return magFilter == other.magFilter && minFilter == other.minFilter && mipmapMode == other.mipmapMode &&
+                   addressMode == other.addressMode && maxAnisotropy == other.maxAnisotropy &&
+                   minLod == other.minLod && maxLod == other.maxLod;
+        };
+    };
+
+    struct ComputePipelineConfig
+    {
+        std::string shaderPath;
+        std::vector<VkDescriptorSetLayoutBinding> bindings;
+        uint32_t pushConstantSize = 0;
+        // Must match local_size_x/y/z of the shader, used by DispatchThreads.
+        uint32_t localSizeX = 64;
+        uint32_t localSizeY = 1;
+        uint32_t localSizeZ = 1;
+    };
+
+    struct TextureConfig
+    {
+        std::string path;
+        bool generateMips = true;
+        bool streamed = false;
+    };
+
+    struct TextureStreamerConfig
+    {
+        VkDeviceSize memoryBudget = 256ull * 1024 * 1024;
+        VkDeviceSize uploadBudgetPerFrame = 8ull * 1024 * 1024;
+        uint32_t framesInFlight = 2;
+        uint32_t minResidentLevels = 1;
+        // Fractions of the heap budget. Past the soft limit uploads slow down, at the hard limit they stop and
+        // textures are evicted until the heap is back under it.
+        float heapSoftLimit = 0.8f;
+        float heapHardLimit = 0.9f;
+    };
+
+    struct HeapBudget
+    {
+        VkDeviceSize size = 0;
+        // What the process may allocate from the heap before the driver starts paging, 80% of the size when
+        // VK_EXT_memory_budget is missing.
+        VkDeviceSize budget = 0;
+        // Allocated by the process, including the driver's internal allocations. Zero when not tracked.
+        VkDeviceSize usage = 0;
+        bool deviceLocal = false;
     };
 
 };
\ No newline at end of file
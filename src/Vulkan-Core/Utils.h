@@ -4,6 +4,8 @@
 
 #include <vulkan/vulkan.h>
 #include "Types.h"
+#include "DeviceDispatch.h"
+#include "../Log.h"
 
 namespace VulkanCore
 {
@@ -36,11 +38,9 @@ namespace VulkanCore
             return swapChainDetails;
         };
 
-        inline std::optional<uint32_t> FindMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeFilter, VkMemoryPropertyFlags properties)
+        // memProperties is the Device's cached copy, they never change for the lifetime of the physical device.
+        inline std::optional<uint32_t> FindMemoryType(const VkPhysicalDeviceMemoryProperties &memProperties, uint32_t typeFilter, VkMemoryPropertyFlags properties)
         {
-            VkPhysicalDeviceMemoryProperties memProperties;
-            vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
-
             for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++)
             {
                 if ((typeFilter & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
@@ -51,5 +51,234 @@ namespace VulkanCore
 
             return {};
         };
+
+        inline std::optional<VkFormat> FindDepthFormat(VkPhysicalDevice physicalDevice)
+        {
+            // Ordered by preference, pure depth formats avoid paying for an unused stencil aspect.
+            const VkFormat candidates[] = {VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT, VK_FORMAT_D16_UNORM};
+
+            for (VkFormat format : candidates)
+            {
+                VkFormatProperties properties;
+                vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &properties);
+
+                if (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT)
+                {
+                    return format;
+                };
+            };
+
+            return {};
+        };
+
+        inline bool HasStencilComponent(VkFormat format)
+        {
+            return format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT || format == VK_FORMAT_D16_UNORM_S8_UINT || format == VK_FORMAT_S8_UINT;
+        };
+
+        // memoryTypeBits come from the resource's memory requirements, only those types can back it.
+        inline bool HasMemoryProperty(const VkPhysicalDeviceMemoryProperties &memProperties, uint32_t memoryTypeBits, VkMemoryPropertyFlags properties)
+        {
+            return FindMemoryType(memProperties, memoryTypeBits, properties).has_value();
+        };
+
+        inline const char *GetUploadStrategyName(UploadStrategy strategy)
+        {
+            switch (strategy)
+            {
+            case UploadStrategy::DirectWrite:
+                return "direct write";
+            case UploadStrategy::Staging:
+                return "staging copy";
+            default:
+                return "none";
+            };
+        };
+
+        // Without resizable BAR the host visible part of VRAM is a 256 MiB window the driver also draws from, only
+        // small buffers are written through it. Larger heaps are either resizable BAR or UMA, where every upload is
+        // written in place and a staging copy would only double the traffic. memoryTypeBits are the buffer's, when
+        // none of its types is host visible device local memory the upload is staged.
+        inline UploadStrategy ChooseUploadStrategy(const VkPhysicalDeviceMemoryProperties &memProperties, uint32_t memoryTypeBits, VkDeviceSize size)
+        {
+            constexpr VkDeviceSize barWindowSize = 256ull * 1024 * 1024;
+            constexpr VkDeviceSize barWindowUploadLimit = 64ull * 1024;
+            const VkMemoryPropertyFlags directFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+            std::optional<uint32_t> memoryType = FindMemoryType(memProperties, memoryTypeBits, directFlags);
+            if (!memoryType.has_value())
+            {
+                return UploadStrategy::Staging;
+            };
+
+            VkDeviceSize heapSize = memProperties.memoryHeaps[memProperties.memoryTypes[memoryType.value()].heapIndex].size;
+            if (heapSize > barWindowSize || size <= barWindowUploadLimit)
+            {
+                return UploadStrategy::DirectWrite;
+            };
+
+            return UploadStrategy::Staging;
+        };
+
+        // Buffers touched by more than one queue family (e.g. async compute and graphics) are created
+        // concurrent, which avoids explicit ownership transfers between the queues.
+        inline void CreateBuffer(VkDevice device, const VkPhysicalDeviceMemoryProperties &memProperties, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer &buffer, VkDeviceMemory &bufferMemory, const std::vector<uint32_t> &queueFamilies = {})
+        {
+            std::set<uint32_t> uniqueQueueFamilies(queueFamilies.begin(), queueFamilies.end());
+            std::vector<uint32_t> sharedQueueFamilies(uniqueQueueFamilies.begin(), uniqueQueueFamilies.end());
+
+            VkBufferCreateInfo bufferInfo{};
+            bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+            bufferInfo.size = size;
+            bufferInfo.usage = usage;
+
+            if (sharedQueueFamilies.size() > 1)
+            {
+                bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+                bufferInfo.queueFamilyIndexCount = static_cast<uint32_t>(sharedQueueFamilies.size());
+                bufferInfo.pQueueFamilyIndices = sharedQueueFamilies.data();
+            }
+            else
+            {
+                bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            };
+
+            VkResult result = vkCreateBuffer(device, &bufferInfo, nullptr, &buffer);
+
+            CORE_ASSERT(result == VK_SUCCESS, "Failed to create buffer!");
+
+            VkMemoryRequirements memRequirements;
+            vkGetBufferMemoryRequirements(device, buffer, &memRequirements);
+
+            std::optional<uint32_t> memoryTypeIndex = FindMemoryType(memProperties, memRequirements.memoryTypeBits, properties);
+
+            CORE_ASSERT(memoryTypeIndex.has_value(), "Failed to get memory type index!");
+
+            VkMemoryAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+            allocInfo.allocationSize = memRequirements.size;
+            allocInfo.memoryTypeIndex = memoryTypeIndex.value();
+
+            // Buffers read through device addresses need memory allocated for it.
+            VkMemoryAllocateFlagsInfo allocFlagsInfo{};
+            allocFlagsInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+            allocFlagsInfo.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+
+            if (usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT)
+            {
+                allocInfo.pNext = &allocFlagsInfo;
+            };
+
+            result = vkAllocateMemory(device, &allocInfo, nullptr, &bufferMemory);
+
+            CORE_ASSERT(result == VK_SUCCESS, "Failed to allocate buffer memory!");
+
+            vkBindBufferMemory(device, buffer, bufferMemory, 0);
+        };
+
+        inline void BufferBarrier(const DeviceDispatch &dispatch, VkCommandBuffer commandBuffer, VkBuffer buffer, VkPipelineStageFlags srcStage, VkAccessFlags srcAccess, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+        {
+            VkBufferMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            barrier.srcAccessMask = srcAccess;
+            barrier.dstAccessMask = dstAccess;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.buffer = buffer;
+            barrier.offset = 0;
+            barrier.size = VK_WHOLE_SIZE;
+
+            dispatch.vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+        };
+
+        inline void GlobalBarrier(const DeviceDispatch &dispatch, VkCommandBuffer commandBuffer, VkPipelineStageFlags srcStage, VkAccessFlags srcAccess, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+        {
+            VkMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            barrier.srcAccessMask = srcAccess;
+            barrier.dstAccessMask = dstAccess;
+
+            dispatch.vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+        };
+
+        inline void WriteBufferDescriptor(VkDevice device, VkDescriptorSet descriptorSet, uint32_t binding, VkDescriptorType type, VkBuffer buffer, VkDeviceSize range = VK_WHOLE_SIZE)
+        {
+            VkDescriptorBufferInfo bufferInfo{};
+            bufferInfo.buffer = buffer;
+            bufferInfo.offset = 0;
+            bufferInfo.range = range;
+
+            VkWriteDescriptorSet descriptorWrite{};
+            descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptorWrite.dstSet = descriptorSet;
+            descriptorWrite.dstBinding = binding;
+            descriptorWrite.dstArrayElement = 0;
+            descriptorWrite.descriptorType = type;
+            descriptorWrite.descriptorCount = 1;
+            descriptorWrite.pBufferInfo = &bufferInfo;
+
+            vkUpdateDescriptorSets(device, 1, &descriptorWrite, 0, nullptr);
+        };
+
+        inline VkCommandBuffer BeginSingleTimeCommands(VkDevice device, VkCommandPool commandPool)
+        {
+            VkCommandBufferAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandPool = commandPool;
+            allocInfo.commandBufferCount = 1;
+
+            VkCommandBuffer commandBuffer;
+            vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer);
+
+            VkCommandBufferBeginInfo beginInfo{};
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+            vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+            return commandBuffer;
+        };
+
+        inline void EndSingleTimeCommands(VkDevice device, VkCommandPool commandPool, VkQueue queue, VkCommandBuffer commandBuffer)
+        {
+            vkEndCommandBuffer(commandBuffer);
+
+            VkSubmitInfo submitInfo{};
+            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submitInfo.commandBufferCount = 1;
+            submitInfo.pCommandBuffers = &commandBuffer;
+
+            vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
+            vkQueueWaitIdle(queue);
+
+            vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
+        };
+
+        // EndSingleTimeCommands without the wait. The returned fence signals once the commands have executed, the
+        // caller then destroys it and frees the command buffer.
+        inline VkFence SubmitSingleTimeCommands(const DeviceDispatch &dispatch, VkDevice device, VkQueue queue, VkCommandBuffer commandBuffer)
+        {
+            dispatch.vkEndCommandBuffer(commandBuffer);
+
+            VkFenceCreateInfo fenceInfo{};
+            fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+            VkFence fence;
+            VkResult result = vkCreateFence(device, &fenceInfo, nullptr, &fence);
+
+            CORE_ASSERT(result == VK_SUCCESS, "Failed to create fence!");
+
+            VkSubmitInfo submitInfo{};
+            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submitInfo.commandBufferCount = 1;
+            submitInfo.pCommandBuffers = &commandBuffer;
+
+            result = dispatch.vkQueueSubmit(queue, 1, &submitInfo, fence);
+
+            CORE_ASSERT(result == VK_SUCCESS, "Failed to submit command buffer!");
+
+            return fence;
+        };
     };
 };
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdio>
+
+// Every tests/ executable is a main() calling its checks, exiting 1 when any of them failed. No device needed.
+namespace Test
+{
+    inline int s_Failures = 0;
+
+    inline void Check(bool condition, const char *test, const char *message)
+    {
+        if (!condition)
+        {
+            std::printf("FAILED %s: %s\n", test, message);
+            s_Failures++;
+        };
+    };
+
+    inline int Finish(const char *suite)
+    {
+        if (s_Failures > 0)
+        {
+            std::printf("%s: %d checks failed\n", suite, s_Failures);
+            return 1;
+        };
+
+        std::printf("%s: all checks passed\n", suite);
+        return 0;
+    };
+};
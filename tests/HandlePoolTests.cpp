@@ -0,0 +1,102 @@
+#include "Vulkan-Core/HandlePool.h"
+
+#include "Check.h"
+
+#include <vector>
+
+namespace
+{
+    using Test::Check;
+
+    struct Tag
+    {
+    };
+
+    using Pool = VulkanCore::HandlePool<Tag, int>;
+    using Handle = VulkanCore::Handle<Tag>;
+
+    void TestStaleHandles()
+    {
+        const char *test = "StaleHandles";
+
+        Pool pool;
+        Handle first = pool.Add(1);
+        Handle second = pool.Add(2);
+
+        int removed = 0;
+        Check(pool.Remove(first, &removed) && removed == 1, test, "removal did not return the entry");
+        Check(!pool.IsValid(first) && pool.Get(first) == nullptr, test, "removed handle still resolves");
+        Check(!pool.Remove(first), test, "removed twice");
+        Check(!pool.IsValid(Handle{}) && !pool.Remove(Handle{}), test, "the null handle resolves");
+
+        Handle reused = pool.Add(3);
+        Check(reused.GetIndex() == first.GetIndex() && reused != first, test, "the freed slot was not reused with a new generation");
+        Check(pool.Get(first) == nullptr, test, "stale handle resolves to the slot's new entry");
+        Check(pool.Get(reused) != nullptr && *pool.Get(reused) == 3, test, "reused handle does not resolve");
+        Check(pool.Get(second) != nullptr && *pool.Get(second) == 2, test, "the moved entry was lost");
+
+        pool.Clear();
+        Check(!pool.IsValid(second) && !pool.IsValid(reused) && pool.Size() == 0, test, "handles survived Clear");
+    };
+
+    // Removals fill their hole with the last entry, every survivor must still resolve to its own value.
+    void TestDensePacking()
+    {
+        const char *test = "DensePacking";
+
+        Pool pool;
+        std::vector<Handle> handles;
+        for (int i = 0; i < 100; i++)
+        {
+            handles.push_back(pool.Add(i));
+        };
+
+        for (int i = 0; i < 100; i += 3)
+        {
+            pool.Remove(handles[i]);
+        };
+
+        Check(pool.Size() == 66 && pool.GetEntries().size() == 66, test, "live entry count");
+        for (int i = 0; i < 100; i++)
+        {
+            const int *value = pool.Get(handles[i]);
+            Check((value == nullptr) == (i % 3 == 0), test, "liveness after removals");
+            Check(value == nullptr || *value == i, test, "handle resolves to another entry");
+        };
+    };
+
+    // A generation wraps after 4095 reuses of one slot, it must skip 0 so the null handle is never issued.
+    void TestGenerationWrap()
+    {
+        const char *test = "GenerationWrap";
+
+        Pool pool;
+        Handle first = pool.Add(0);
+        Handle previous = first;
+        pool.Remove(previous);
+
+        bool wrapped = false;
+        for (int i = 1; i < 5000; i++)
+        {
+            Handle handle = pool.Add(i);
+            Check(!handle.IsNull() && handle.GetGeneration() != 0, test, "issued the null handle");
+            Check(handle.GetIndex() == first.GetIndex() && handle != previous, test, "slot reuse repeated a generation");
+            wrapped = wrapped || handle.GetGeneration() < previous.GetGeneration();
+
+            pool.Remove(handle);
+            previous = handle;
+        };
+
+        Check(wrapped, test, "the generation never wrapped");
+    };
+
+};
+
+int main()
+{
+    TestStaleHandles();
+    TestDensePacking();
+    TestGenerationWrap();
+
+    return Test::Finish("HandlePool");
+};
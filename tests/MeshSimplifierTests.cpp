@@ -0,0 +1,232 @@
+#include "Renderer/MeshSimplifier.h"
+
+#include "Check.h"
+
+#include <glm/glm.hpp>
+
+#include <cmath>
+#include <map>
+#include <vector>
+
+namespace
+{
+    using Test::Check;
+
+    struct Mesh
+    {
+        std::vector<glm::vec3> positions;
+        std::vector<uint32_t> indices;
+    };
+
+    // Closed UV sphere, the seam and the poles share their vertices so no edge is an open border.
+    Mesh CreateSphere(uint32_t rings, uint32_t segments, float radius)
+    {
+        Mesh mesh;
+        mesh.positions.push_back(glm::vec3(0.0f, radius, 0.0f));
+        for (uint32_t ring = 1; ring < rings; ring++)
+        {
+            float polar = glm::radians(180.0f) * ring / rings;
+            for (uint32_t segment = 0; segment < segments; segment++)
+            {
+                float azimuth = glm::radians(360.0f) * segment / segments;
+                mesh.positions.push_back(radius * glm::vec3(std::sin(polar) * std::cos(azimuth), std::cos(polar), std::sin(polar) * std::sin(azimuth)));
+            };
+        };
+        mesh.positions.push_back(glm::vec3(0.0f, -radius, 0.0f));
+
+        uint32_t southPole = static_cast<uint32_t>(mesh.positions.size() - 1);
+        auto ringVertex = [segments](uint32_t ring, uint32_t segment)
+        { return 1 + (ring - 1) * segments + segment % segments; };
+
+        for (uint32_t segment = 0; segment < segments; segment++)
+        {
+            mesh.indices.insert(mesh.indices.end(), {0, ringVertex(1, segment + 1), ringVertex(1, segment)});
+            mesh.indices.insert(mesh.indices.end(), {southPole, ringVertex(rings - 1, segment), ringVertex(rings - 1, segment + 1)});
+        };
+        for (uint32_t ring = 1; ring + 1 < rings; ring++)
+        {
+            for (uint32_t segment = 0; segment < segments; segment++)
+            {
+                uint32_t i0 = ringVertex(ring, segment);
+                uint32_t i1 = ringVertex(ring, segment + 1);
+                uint32_t i2 = ringVertex(ring + 1, segment);
+                uint32_t i3 = ringVertex(ring + 1, segment + 1);
+                mesh.indices.insert(mesh.indices.end(), {i0, i1, i2, i1, i3, i2});
+            };
+        };
+
+        return mesh;
+    };
+
+    // Closed cube of cells x cells quads per face, welded along its edges.
+    Mesh CreateCube(uint32_t cells, float halfSize)
+    {
+        Mesh mesh;
+        std::map<uint32_t, uint32_t> welded;
+
+        auto vertex = [&](const glm::ivec3 &cell)
+        {
+            uint32_t key = (cell.x * (cells + 1) + cell.y) * (cells + 1) + cell.z;
+            auto it = welded.find(key);
+            if (it != welded.end())
+            {
+                return it->second;
+            };
+
+            uint32_t index = static_cast<uint32_t>(mesh.positions.size());
+            mesh.positions.push_back((glm::vec3(cell) / static_cast<float>(cells) * 2.0f - 1.0f) * halfSize);
+            welded.emplace(key, index);
+            return index;
+        };
+
+        int32_t n = static_cast<int32_t>(cells);
+        for (int32_t axis = 0; axis < 3; axis++)
+        {
+            for (int32_t side = 0; side < 2; side++)
+            {
+                for (int32_t u = 0; u < n; u++)
+                {
+                    for (int32_t v = 0; v < n; v++)
+                    {
+                        // Corner of the face's (u, v) cell, the face axis fixed at its side.
+                        auto corner = [&](int32_t du, int32_t dv)
+                        {
+                            glm::ivec3 cell;
+                            cell[axis] = side * n;
+                            cell[(axis + 1) % 3] = u + du;
+                            cell[(axis + 2) % 3] = v + dv;
+                            return vertex(cell);
+                        };
+
+                        uint32_t i0 = corner(0, 0);
+                        uint32_t i1 = corner(1, 0);
+                        uint32_t i2 = corner(0, 1);
+                        uint32_t i3 = corner(1, 1);
+                        if (side == 0)
+                        {
+                            mesh.indices.insert(mesh.indices.end(), {i0, i2, i1, i1, i2, i3});
+                        }
+                        else
+                        {
+                            mesh.indices.insert(mesh.indices.end(), {i0, i1, i2, i1, i3, i2});
+                        };
+                    };
+                };
+            };
+        };
+
+        return mesh;
+    };
+
+    // Every edge of a closed manifold is shared by exactly two triangles, in opposite directions.
+    bool IsClosed(const std::vector<uint32_t> &indices)
+    {
+        std::map<std::pair<uint32_t, uint32_t>, int32_t> edges;
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            for (size_t corner = 0; corner < 3; corner++)
+            {
+                uint32_t a = indices[i + corner];
+                uint32_t b = indices[i + (corner + 1) % 3];
+                edges[{(std::min)(a, b), (std::max)(a, b)}] += a < b ? 1 : -1;
+            };
+        };
+
+        for (const auto &edge : edges)
+        {
+            if (edge.second != 0)
+            {
+                return false;
+            };
+        };
+
+        return !edges.empty();
+    };
+
+    std::vector<uint32_t> Simplify(const Mesh &mesh, size_t targetIndexCount, float targetError, float &resultError)
+    {
+        Renderer::SimplifyConfig config;
+        config.targetIndexCount = targetIndexCount;
+        config.targetError = targetError;
+
+        return Renderer::MeshSimplifier::Simplify(&mesh.positions[0].x, mesh.positions.size(), sizeof(glm::vec3), mesh.indices, config, &resultError);
+    };
+
+    // A curved closed mesh loses most of its triangles, the reported error stays within the bound.
+    void TestSphere()
+    {
+        const char *test = "Sphere";
+
+        Mesh sphere = CreateSphere(32, 64, 1.0f);
+        Check(IsClosed(sphere.indices), test, "source mesh is not closed");
+
+        const float targetError = 0.01f;
+        float extent = Renderer::MeshSimplifier::ComputeExtent(&sphere.positions[0].x, sphere.positions.size(), sizeof(glm::vec3));
+        Check(std::fabs(extent - 2.0f) < 1e-4f, test, "extent of the unit sphere");
+
+        float error = -1.0f;
+        std::vector<uint32_t> simplified = Simplify(sphere, sphere.indices.size() / 4, targetError, error);
+
+        Check(simplified.size() % 3 == 0, test, "partial triangle");
+        Check(simplified.size() < sphere.indices.size() / 2, test, "index count not reduced");
+        Check(error >= 0.0f && error <= targetError * extent * 1.0001f, test, "error above targetError");
+        Check(IsClosed(simplified), test, "simplification opened the mesh");
+
+        bool inRange = true;
+        for (uint32_t index : simplified)
+        {
+            inRange = inRange && index < sphere.positions.size();
+        };
+        Check(inRange, test, "index out of the source vertex range");
+
+        // A tighter bound may not remove more.
+        float tightError = -1.0f;
+        std::vector<uint32_t> tight = Simplify(sphere, sphere.indices.size() / 4, targetError * 0.1f, tightError);
+        Check(tight.size() >= simplified.size(), test, "tighter targetError removed more triangles");
+        Check(tightError <= targetError * 0.1f * extent * 1.0001f, test, "error above the tighter targetError");
+    };
+
+    // Flat faces collapse without error, so a zero targetError still reduces the mesh but keeps every triangle
+    // on a face of the cube.
+    void TestFlatCube()
+    {
+        const char *test = "FlatCube";
+
+        const float halfSize = 1.0f;
+        Mesh cube = CreateCube(8, halfSize);
+        Check(IsClosed(cube.indices), test, "source mesh is not closed");
+
+        float error = -1.0f;
+        std::vector<uint32_t> simplified = Simplify(cube, 0, 0.0f, error);
+
+        Check(simplified.size() < cube.indices.size() / 4, test, "coplanar triangles not collapsed");
+        Check(simplified.size() >= 12 * 3, test, "simplified below the cube's 12 triangles");
+        Check(error >= 0.0f && error < 1e-4f, test, "error reported on exact collapses");
+        Check(IsClosed(simplified), test, "simplification opened the mesh");
+
+        bool onFaces = true;
+        for (size_t i = 0; i + 2 < simplified.size(); i += 3)
+        {
+            const glm::vec3 &a = cube.positions[simplified[i + 0]];
+            const glm::vec3 &b = cube.positions[simplified[i + 1]];
+            const glm::vec3 &c = cube.positions[simplified[i + 2]];
+
+            bool sharedFace = false;
+            for (int32_t axis = 0; axis < 3; axis++)
+            {
+                sharedFace = sharedFace || (std::fabs(std::fabs(a[axis]) - halfSize) < 1e-5f && a[axis] == b[axis] && a[axis] == c[axis]);
+            };
+            onFaces = onFaces && sharedFace;
+        };
+        Check(onFaces, test, "a triangle cuts across the cube");
+    };
+
+};
+
+int main()
+{
+    TestSphere();
+    TestFlatCube();
+
+    return Test::Finish("MeshSimplifier");
+};
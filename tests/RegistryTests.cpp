@@ -0,0 +1,133 @@
+#include "Scene/Registry.h"
+
+#include "Check.h"
+
+#include <vector>
+
+namespace
+{
+    using Test::Check;
+
+    struct Health
+    {
+        int32_t value;
+    };
+
+    struct Armor
+    {
+        int32_t value;
+    };
+
+    // Add, Remove and Destroy move rows between and within chunks, every component must stay with its entity.
+    void TestRowMoves()
+    {
+        const char *test = "RowMoves";
+
+        // Enough entities to span several chunks of each archetype.
+        const int32_t entityCount = 5000;
+
+        Scene::Registry registry;
+        std::vector<Scene::Entity> entities;
+        for (int32_t i = 0; i < entityCount; i++)
+        {
+            entities.push_back(registry.Create(Health{i}));
+        };
+
+        Check(registry.GetChunkCount() > 1, test, "entities fit a single chunk");
+
+        for (int32_t i = 0; i < entityCount; i += 3)
+        {
+            registry.Add(entities[i], Armor{-i});
+        };
+        for (int32_t i = 0; i < entityCount; i += 6)
+        {
+            registry.Remove<Armor>(entities[i]);
+        };
+        for (int32_t i = 1; i < entityCount; i += 5)
+        {
+            registry.Destroy(entities[i]);
+        };
+
+        Check(registry.GetArchetypeCount() == 2, test, "archetype count");
+
+        for (int32_t i = 0; i < entityCount; i++)
+        {
+            bool destroyed = i % 5 == 1;
+            bool armored = !destroyed && i % 3 == 0 && i % 6 != 0;
+
+            Check(registry.IsAlive(entities[i]) != destroyed, test, "entity liveness");
+            if (destroyed)
+            {
+                Check(registry.Get<Health>(entities[i]) == nullptr, test, "destroyed entity still resolves");
+                continue;
+            };
+
+            const Health *health = registry.Get<Health>(entities[i]);
+            Check(health != nullptr && health->value == i, test, "component lost or mixed up by a row move");
+            Check(registry.Has<Armor>(entities[i]) == armored, test, "component added or removed on the wrong entity");
+            if (armored)
+            {
+                Check(registry.Get<Armor>(entities[i])->value == -i, test, "added component lost by a row move");
+            };
+        };
+    };
+
+    // Only written chunks are visited, read-only queries stamp nothing.
+    void TestChangeTracking()
+    {
+        const char *test = "ChangeTracking";
+
+        Scene::Registry registry;
+        std::vector<Scene::Entity> entities;
+        for (int32_t i = 0; i < 5000; i++)
+        {
+            entities.push_back(registry.Create(Health{i}));
+        };
+
+        Check(registry.GetChunkCount() > 1, test, "entities fit a single chunk");
+
+        uint64_t version = registry.GetVersion();
+        uint32_t visited = 0;
+        registry.ForEachChangedChunk<Health, const Health>(version, [&visited](const Scene::Entity *, uint32_t, const Health *)
+                                                           { visited++; });
+        Check(visited == 0, test, "unchanged chunks visited");
+
+        registry.ForEach<const Health>([](Scene::Entity, const Health &) {});
+        registry.ForEachChangedChunk<Health, const Health>(version, [&visited](const Scene::Entity *, uint32_t, const Health *)
+                                                           { visited++; });
+        Check(visited == 0, test, "a read-only query stamped its chunks");
+
+        registry.Set(entities[2], Health{-1});
+
+        Scene::Entity changedEntity;
+        registry.ForEachChangedChunk<Health, const Health>(version, [&](const Scene::Entity *chunkEntities, uint32_t count, const Health *healths)
+                                                           {
+                                                               visited++;
+                                                               for (uint32_t i = 0; i < count; i++)
+                                                               {
+                                                                   if (healths[i].value == -1)
+                                                                   {
+                                                                       changedEntity = chunkEntities[i];
+                                                                   };
+                                                               };
+                                                           });
+        Check(visited == 1, test, "Set stamped other chunks than the entity's");
+        Check(changedEntity == entities[2], test, "the changed chunk does not hold the written entity");
+
+        version = registry.GetVersion();
+        registry.ForEach<Health>([](Scene::Entity, Health &) {});
+        visited = 0;
+        registry.ForEachChangedChunk<Health, const Health>(version, [&visited](const Scene::Entity *, uint32_t, const Health *)
+                                                           { visited++; });
+        Check(visited == registry.GetChunkCount(), test, "a writing query did not stamp every chunk it visited");
+    };
+
+};
+
+int main()
+{
+    TestRowMoves();
+    TestChangeTracking();
+
+    return Test::Finish("Registry");
+};
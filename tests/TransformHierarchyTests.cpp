@@ -0,0 +1,259 @@
+#include "Scene/TransformHierarchy.h"
+
+#include "Check.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace
+{
+    using Test::Check;
+
+    // Parents come before their children, -1 for roots. Nodes are added in this order, not sorted by depth.
+    struct RandomHierarchy
+    {
+        std::vector<Scene::Transform> locals;
+        std::vector<int32_t> parents;
+    };
+
+    Scene::Transform RandomTransform(std::mt19937 &generator)
+    {
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        std::uniform_real_distribution<float> scale(0.8f, 1.25f);
+
+        glm::vec3 axis(unit(generator), unit(generator), unit(generator));
+        if (glm::length(axis) < 1e-3f)
+        {
+            axis = glm::vec3(0.0f, 1.0f, 0.0f);
+        };
+
+        Scene::Transform transform;
+        transform.position = glm::vec3(unit(generator), unit(generator), unit(generator)) * 10.0f;
+        transform.rotation = glm::angleAxis(unit(generator) * glm::pi<float>(), glm::normalize(axis));
+        transform.scale = glm::vec3(scale(generator), scale(generator), scale(generator));
+        return transform;
+    };
+
+    RandomHierarchy CreateRandomHierarchy(uint32_t nodeCount, uint32_t rootCount, uint32_t seed)
+    {
+        std::mt19937 generator(seed);
+
+        RandomHierarchy hierarchy;
+        for (uint32_t i = 0; i < nodeCount; i++)
+        {
+            hierarchy.locals.push_back(RandomTransform(generator));
+            hierarchy.parents.push_back(i < rootCount ? -1 : static_cast<int32_t>(generator() % i));
+        };
+
+        return hierarchy;
+    };
+
+    std::vector<Scene::HierarchyNode> AddNodes(Scene::TransformHierarchy &hierarchy, const RandomHierarchy &source)
+    {
+        std::vector<Scene::HierarchyNode> nodes;
+        for (size_t i = 0; i < source.locals.size(); i++)
+        {
+            nodes.push_back(hierarchy.Add(source.locals[i], source.parents[i] < 0 ? Scene::HierarchyNode{} : nodes[source.parents[i]]));
+        };
+
+        return nodes;
+    };
+
+    glm::mat4 ComposeReference(const Scene::Transform &local)
+    {
+        return glm::translate(glm::mat4(1.0f), local.position) * glm::mat4_cast(local.rotation) * glm::scale(glm::mat4(1.0f), local.scale);
+    };
+
+    // World matrices with glm, one node at a time.
+    std::vector<glm::mat4> ComputeReference(const RandomHierarchy &source)
+    {
+        std::vector<glm::mat4> world(source.locals.size());
+        for (size_t i = 0; i < source.locals.size(); i++)
+        {
+            glm::mat4 local = ComposeReference(source.locals[i]);
+            world[i] = source.parents[i] < 0 ? local : world[source.parents[i]] * local;
+        };
+
+        return world;
+    };
+
+    bool NearlyEqual(float a, float b)
+    {
+        return std::abs(a - b) <= 1e-4f * (std::max)(1.0f, std::abs(b));
+    };
+
+    bool NearlyEqual(const Scene::WorldRows &a, const Scene::WorldRows &b)
+    {
+        for (int row = 0; row < 3; row++)
+        {
+            for (int column = 0; column < 4; column++)
+            {
+                if (!NearlyEqual(a.rows[row][column], b.rows[row][column]))
+                {
+                    return false;
+                };
+            };
+        };
+
+        return true;
+    };
+
+    // The rows are the transposed affine part of the column major matrix.
+    bool NearlyEqual(const Scene::WorldRows &a, const glm::mat4 &b)
+    {
+        for (int row = 0; row < 3; row++)
+        {
+            for (int column = 0; column < 4; column++)
+            {
+                if (!NearlyEqual(a.rows[row][column], b[column][row]))
+                {
+                    return false;
+                };
+            };
+        };
+
+        return true;
+    };
+
+    // Subtree membership of every node, parents being ahead of their children.
+    std::vector<bool> GetSubtree(const RandomHierarchy &source, uint32_t root)
+    {
+        std::vector<bool> subtree(source.parents.size(), false);
+        subtree[root] = true;
+        for (size_t i = root + 1; i < source.parents.size(); i++)
+        {
+            subtree[i] = source.parents[i] >= 0 && subtree[source.parents[i]];
+        };
+
+        return subtree;
+    };
+
+    // Most levels hold far more than four nodes, so the SSE batches run alongside the scalar tail of each level.
+    void TestSimdMatchesScalar()
+    {
+        const char *test = "SimdMatchesScalar";
+
+        RandomHierarchy source = CreateRandomHierarchy(1000, 16, 1);
+        std::vector<glm::mat4> reference = ComputeReference(source);
+
+        Scene::TransformHierarchy simd;
+        Scene::TransformHierarchy scalar;
+        scalar.SetSimdEnabled(false);
+
+        std::vector<Scene::HierarchyNode> simdNodes = AddNodes(simd, source);
+        std::vector<Scene::HierarchyNode> scalarNodes = AddNodes(scalar, source);
+
+        Check(simd.Propagate() == source.locals.size(), test, "the first propagation did not compute every node");
+        Check(scalar.Propagate() == source.locals.size(), test, "the first scalar propagation did not compute every node");
+        Check(simd.GetLevelCount() > 2, test, "the random hierarchy is too shallow");
+
+        for (size_t i = 0; i < source.locals.size(); i++)
+        {
+            Check(NearlyEqual(simd.GetWorld(simdNodes[i]), scalar.GetWorld(scalarNodes[i])), test, "SSE and scalar world matrices differ");
+            Check(NearlyEqual(scalar.GetWorld(scalarNodes[i]), reference[i]), test, "scalar world matrix differs from glm");
+        };
+    };
+
+    void TestDirtySubtree()
+    {
+        const char *test = "DirtySubtree";
+
+        RandomHierarchy source = CreateRandomHierarchy(500, 8, 2);
+
+        Scene::TransformHierarchy hierarchy;
+        std::vector<Scene::HierarchyNode> nodes = AddNodes(hierarchy, source);
+        hierarchy.Propagate();
+
+        Check(hierarchy.Propagate() == 0, test, "a clean hierarchy was recomputed");
+
+        // A node with descendants of its own, away from the roots.
+        uint32_t changed = 0;
+        for (uint32_t i = 8; i < source.parents.size() && changed == 0; i++)
+        {
+            std::vector<bool> subtree = GetSubtree(source, i);
+            if (std::count(subtree.begin(), subtree.end(), true) > 4)
+            {
+                changed = i;
+            };
+        };
+
+        Check(changed != 0, test, "no node with a subtree to change");
+
+        std::mt19937 generator(3);
+        source.locals[changed] = RandomTransform(generator);
+        hierarchy.SetLocal(nodes[changed], source.locals[changed]);
+
+        std::vector<bool> subtree = GetSubtree(source, changed);
+        uint32_t subtreeSize = static_cast<uint32_t>(std::count(subtree.begin(), subtree.end(), true));
+
+        Check(hierarchy.Propagate() == subtreeSize, test, "recomputed more or less than the changed subtree");
+
+        std::vector<glm::mat4> reference = ComputeReference(source);
+        for (size_t i = 0; i < source.locals.size(); i++)
+        {
+            bool recomputed = hierarchy.GetWorldVersion(nodes[i]) == hierarchy.GetVersion();
+            Check(recomputed == subtree[i], test, "world version does not match subtree membership");
+            Check(NearlyEqual(hierarchy.GetWorld(nodes[i]), reference[i]), test, "world matrix is stale after the change");
+        };
+
+        // Only the rows written since the first propagation are copied out.
+        std::vector<Scene::WorldRows> instances(hierarchy.GetInstanceCapacity());
+        uint64_t version = hierarchy.WriteInstances(instances.data(), 0);
+        hierarchy.SetLocal(nodes[changed], source.locals[changed]);
+        hierarchy.Propagate();
+
+        std::vector<Scene::WorldRows> written(hierarchy.GetInstanceCapacity());
+        hierarchy.WriteInstances(written.data(), version);
+        for (size_t i = 0; i < source.locals.size(); i++)
+        {
+            bool wasWritten = written[hierarchy.GetInstance(nodes[i])].rows[0] != glm::vec4(0.0f);
+            Check(wasWritten == subtree[i], test, "instance rows written outside the changed subtree");
+        };
+    };
+
+    // Removing a node takes its subtree with it, the remaining worlds are untouched.
+    void TestRemovedSubtree()
+    {
+        const char *test = "RemovedSubtree";
+
+        RandomHierarchy source = CreateRandomHierarchy(200, 4, 4);
+        std::vector<glm::mat4> reference = ComputeReference(source);
+
+        Scene::TransformHierarchy hierarchy;
+        std::vector<Scene::HierarchyNode> nodes = AddNodes(hierarchy, source);
+        hierarchy.Propagate();
+
+        uint32_t removedNode = 10;
+        std::vector<bool> subtree = GetSubtree(source, removedNode);
+        size_t subtreeSize = static_cast<size_t>(std::count(subtree.begin(), subtree.end(), true));
+
+        hierarchy.Remove(nodes[removedNode]);
+        hierarchy.Propagate();
+
+        Check(hierarchy.Size() == source.locals.size() - subtreeSize, test, "node count after removing a subtree");
+        for (size_t i = 0; i < source.locals.size(); i++)
+        {
+            Check(hierarchy.IsValid(nodes[i]) != subtree[i], test, "subtree handles not invalidated");
+            if (!subtree[i])
+            {
+                Check(NearlyEqual(hierarchy.GetWorld(nodes[i]), reference[i]), test, "world matrix changed by an unrelated removal");
+            };
+        };
+
+        Scene::HierarchyNode added = hierarchy.Add(Scene::Transform{}, nodes[0]);
+        Check(hierarchy.IsValid(added) && !hierarchy.IsValid(nodes[removedNode]), test, "a new node revived a removed handle");
+    };
+
+};
+
+int main()
+{
+    TestSimdMatchesScalar();
+    TestDirtySubtree();
+    TestRemovedSubtree();
+
+    return Test::Finish("TransformHierarchy");
+};